@@ -36,6 +36,21 @@ int cfb8_decrypt(EVP_CIPHER_CTX* d, byte_t* restrict data, size_t len, byte_t* r
 
 }
 
+// cfb8 works a byte at a time so the output can overwrite the input
+int cfb8_encrypt_in_place(EVP_CIPHER_CTX* e, byte_t* data, size_t len) {
+
+	int out_len = len;
+	return EVP_EncryptUpdate(e, data, &out_len, data, len);
+
+}
+
+int cfb8_decrypt_in_place(EVP_CIPHER_CTX* d, byte_t* data, size_t len) {
+
+	int out_len = len;
+	return EVP_DecryptUpdate(d, data, &out_len, data, len);
+
+}
+
 int cfb8_done(EVP_CIPHER_CTX* e, EVP_CIPHER_CTX* d) {
 
 	EVP_CIPHER_CTX_free(e);
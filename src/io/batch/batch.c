@@ -0,0 +1,336 @@
+#include "batch.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define IO_BATCH_X86 1
+#include <immintrin.h>
+#endif
+
+const uint8_t io_values_per_long[65] = {
+	0, 64, 32, 21, 16, 12, 10, 9,
+	8, 7, 6, 5, 5, 4, 4, 4,
+	4, 3, 3, 3, 3, 3, 2, 2,
+	2, 2, 2, 2, 2, 2, 2, 2,
+	2, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1,
+	1
+};
+
+static inline void io_store_long_be(byte_t* out, uint64_t value) {
+
+	if (__ENDIANNESS__ == io_little_endian) {
+		value = __builtin_bswap64(value);
+	}
+
+	memcpy(out, &value, sizeof(value));
+
+}
+
+size_t io_pack_bytes_scalar(const uint8_t* values, size_t count, uint8_t bits, byte_t* out) {
+
+	assert(bits > 0 && bits <= 8);
+
+	const uint8_t values_per_long = io_values_per_long[bits];
+	const size_t longs = io_packed_longs(count, bits);
+
+	for (size_t i = 0; i < longs; ++i) {
+
+		const size_t start = i * values_per_long;
+		const size_t end = start + values_per_long < count ? start + values_per_long : count;
+
+		uint64_t packed = 0;
+		for (size_t j = start, shift = 0; j < end; ++j, shift += bits) {
+			packed |= (uint64_t) values[j] << shift;
+		}
+
+		io_store_long_be(out + (i << 3), packed);
+
+	}
+
+	return longs;
+
+}
+
+size_t io_pack_shorts_scalar(const uint16_t* values, size_t count, uint8_t bits, byte_t* out) {
+
+	assert(bits > 0 && bits <= 16);
+
+	const uint8_t values_per_long = io_values_per_long[bits];
+	const size_t longs = io_packed_longs(count, bits);
+
+	for (size_t i = 0; i < longs; ++i) {
+
+		const size_t start = i * values_per_long;
+		const size_t end = start + values_per_long < count ? start + values_per_long : count;
+
+		uint64_t packed = 0;
+		for (size_t j = start, shift = 0; j < end; ++j, shift += bits) {
+			packed |= (uint64_t) values[j] << shift;
+		}
+
+		io_store_long_be(out + (i << 3), packed);
+
+	}
+
+	return longs;
+
+}
+
+size_t io_write_var_ints_scalar(byte_t* buffer, const uint32_t* values, size_t count) {
+
+	size_t length = 0;
+
+	for (size_t i = 0; i < count; ++i) {
+		length += io_write_var_int(buffer + length, values[i], 5);
+	}
+
+	return length;
+
+}
+
+size_t io_write_var_shorts_scalar(byte_t* buffer, const uint16_t* values, size_t count) {
+
+	size_t length = 0;
+
+	for (size_t i = 0; i < count; ++i) {
+		length += io_write_var_int(buffer + length, values[i], 3);
+	}
+
+	return length;
+
+}
+
+size_t io_read_var_ints_scalar(const byte_t* buffer, size_t max_length, uint32_t* values, size_t count) {
+
+	size_t length = 0;
+
+	for (size_t i = 0; i < count; ++i) {
+
+		uint32_t value = 0;
+		size_t j = 0;
+		byte_t read;
+
+		do {
+			if (length + j >= max_length || j == 5) {
+				return 0;
+			}
+			read = buffer[length + j];
+			value |= (uint32_t) (read & 0x7F) << (7 * j);
+			j++;
+		} while (read & 0x80);
+
+		values[i] = value;
+		length += j;
+
+	}
+
+	return length;
+
+}
+
+#ifdef IO_BATCH_X86
+
+// reverses the bytes of each long in a 128 bit lane, turning little endian longs big endian
+#define IO_BATCH_BSWAP64_MASK 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8
+
+__attribute__((target("avx2")))
+static size_t io_pack_bytes_8_avx2(const uint8_t* values, size_t count, byte_t* out) {
+
+	const __m256i swap = _mm256_setr_epi8(IO_BATCH_BSWAP64_MASK, IO_BATCH_BSWAP64_MASK);
+
+	size_t i = 0;
+	for (; i + 32 <= count; i += 32) {
+		const __m256i in = _mm256_loadu_si256((const __m256i*) (values + i));
+		_mm256_storeu_si256((__m256i*) (out + i), _mm256_shuffle_epi8(in, swap));
+	}
+
+	return i;
+
+}
+
+__attribute__((target("ssse3")))
+static size_t io_pack_bytes_8_ssse3(const uint8_t* values, size_t count, byte_t* out) {
+
+	const __m128i swap = _mm_setr_epi8(IO_BATCH_BSWAP64_MASK);
+
+	size_t i = 0;
+	for (; i + 16 <= count; i += 16) {
+		const __m128i in = _mm_loadu_si128((const __m128i*) (values + i));
+		_mm_storeu_si128((__m128i*) (out + i), _mm_shuffle_epi8(in, swap));
+	}
+
+	return i;
+
+}
+
+__attribute__((target("avx2")))
+static size_t io_pack_bytes_4_avx2(const uint8_t* values, size_t count, byte_t* out) {
+
+	// low nibble + high nibble * 16 for every pair of values
+	const __m256i nibbles = _mm256_set1_epi16(0x1001);
+	const __m256i swap = _mm256_setr_epi8(IO_BATCH_BSWAP64_MASK, IO_BATCH_BSWAP64_MASK);
+
+	size_t i = 0;
+	for (; i + 64 <= count; i += 64) {
+		const __m256i a = _mm256_maddubs_epi16(_mm256_loadu_si256((const __m256i*) (values + i)), nibbles);
+		const __m256i b = _mm256_maddubs_epi16(_mm256_loadu_si256((const __m256i*) (values + i + 32)), nibbles);
+		// packus interleaves the 128 bit lanes, put them back in order
+		const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+		_mm256_storeu_si256((__m256i*) (out + (i >> 1)), _mm256_shuffle_epi8(packed, swap));
+	}
+
+	return i;
+
+}
+
+__attribute__((target("ssse3")))
+static size_t io_pack_bytes_4_ssse3(const uint8_t* values, size_t count, byte_t* out) {
+
+	const __m128i nibbles = _mm_set1_epi16(0x1001);
+	const __m128i swap = _mm_setr_epi8(IO_BATCH_BSWAP64_MASK);
+
+	size_t i = 0;
+	for (; i + 32 <= count; i += 32) {
+		const __m128i a = _mm_maddubs_epi16(_mm_loadu_si128((const __m128i*) (values + i)), nibbles);
+		const __m128i b = _mm_maddubs_epi16(_mm_loadu_si128((const __m128i*) (values + i + 16)), nibbles);
+		_mm_storeu_si128((__m128i*) (out + (i >> 1)), _mm_shuffle_epi8(_mm_packus_epi16(a, b), swap));
+	}
+
+	return i;
+
+}
+
+#endif
+
+size_t io_pack_bytes(const uint8_t* values, size_t count, uint8_t bits, byte_t* out) {
+
+	size_t done = 0;
+
+#ifdef IO_BATCH_X86
+	// the vector paths only handle whole longs, the scalar path picks up the rest
+	if (__ENDIANNESS__ == io_little_endian && (bits == 4 || bits == 8)) {
+		if (__builtin_cpu_supports("avx2")) {
+			done = bits == 8 ? io_pack_bytes_8_avx2(values, count, out) : io_pack_bytes_4_avx2(values, count, out);
+		} else if (__builtin_cpu_supports("ssse3")) {
+			done = bits == 8 ? io_pack_bytes_8_ssse3(values, count, out) : io_pack_bytes_4_ssse3(values, count, out);
+		}
+	}
+#endif
+
+	if (done == count) {
+		return io_packed_longs(count, bits);
+	}
+
+	return (done / io_values_per_long[bits]) + io_pack_bytes_scalar(values + done, count - done, bits, out + ((done / io_values_per_long[bits]) << 3));
+
+}
+
+size_t io_pack_shorts(const uint16_t* values, size_t count, uint8_t bits, byte_t* out) {
+
+	// no vector path yet, the direct palette is rare
+	return io_pack_shorts_scalar(values, count, bits, out);
+
+}
+
+size_t io_write_var_ints(byte_t* buffer, const uint32_t* values, size_t count) {
+
+	size_t i = 0, length = 0;
+
+#ifdef __SSE2__
+	// runs of 16 single byte values are packed straight down to bytes
+	const __m128i high = _mm_set1_epi32(~0x7F);
+	while (i + 16 <= count) {
+		const __m128i a = _mm_loadu_si128((const __m128i*) (values + i));
+		const __m128i b = _mm_loadu_si128((const __m128i*) (values + i + 4));
+		const __m128i c = _mm_loadu_si128((const __m128i*) (values + i + 8));
+		const __m128i d = _mm_loadu_si128((const __m128i*) (values + i + 12));
+		const __m128i any = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), high);
+		if (_mm_movemask_epi8(_mm_cmpeq_epi32(any, _mm_setzero_si128())) != 0xFFFF) {
+			// at least one needs more bytes, write the next value the long way
+			length += io_write_var_int(buffer + length, values[i++], 5);
+			continue;
+		}
+		const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+		_mm_storeu_si128((__m128i*) (buffer + length), packed);
+		length += 16;
+		i += 16;
+	}
+#endif
+
+	return length + io_write_var_ints_scalar(buffer + length, values + i, count - i);
+
+}
+
+size_t io_write_var_shorts(byte_t* buffer, const uint16_t* values, size_t count) {
+
+	size_t i = 0, length = 0;
+
+#ifdef __SSE2__
+	const __m128i high = _mm_set1_epi16(~0x7F);
+	while (i + 16 <= count) {
+		const __m128i a = _mm_loadu_si128((const __m128i*) (values + i));
+		const __m128i b = _mm_loadu_si128((const __m128i*) (values + i + 8));
+		const __m128i any = _mm_and_si128(_mm_or_si128(a, b), high);
+		if (_mm_movemask_epi8(_mm_cmpeq_epi16(any, _mm_setzero_si128())) != 0xFFFF) {
+			length += io_write_var_int(buffer + length, values[i++], 3);
+			continue;
+		}
+		_mm_storeu_si128((__m128i*) (buffer + length), _mm_packus_epi16(a, b));
+		length += 16;
+		i += 16;
+	}
+#endif
+
+	return length + io_write_var_shorts_scalar(buffer + length, values + i, count - i);
+
+}
+
+size_t io_read_var_ints(const byte_t* buffer, size_t max_length, uint32_t* values, size_t count) {
+
+	size_t i = 0, length = 0;
+
+#ifdef __SSE2__
+	const __m128i zero = _mm_setzero_si128();
+	while (i + 16 <= count && length + 16 <= max_length) {
+
+		const __m128i in = _mm_loadu_si128((const __m128i*) (buffer + length));
+		const uint32_t continued = _mm_movemask_epi8(in);
+
+		// bytes before the first continuation bit are whole values
+		const uint32_t single = continued == 0 ? 16 : __builtin_ctz(continued);
+		if (single == 16) {
+			const __m128i lo = _mm_unpacklo_epi8(in, zero);
+			const __m128i hi = _mm_unpackhi_epi8(in, zero);
+			_mm_storeu_si128((__m128i*) (values + i), _mm_unpacklo_epi16(lo, zero));
+			_mm_storeu_si128((__m128i*) (values + i + 4), _mm_unpackhi_epi16(lo, zero));
+			_mm_storeu_si128((__m128i*) (values + i + 8), _mm_unpacklo_epi16(hi, zero));
+			_mm_storeu_si128((__m128i*) (values + i + 12), _mm_unpackhi_epi16(hi, zero));
+			i += 16;
+			length += 16;
+			continue;
+		}
+
+		for (uint32_t j = 0; j < single; ++j) {
+			values[i++] = buffer[length++];
+		}
+
+		const size_t read = io_read_var_ints_scalar(buffer + length, max_length - length, values + i, 1);
+		if (read == 0) {
+			return 0;
+		}
+		i += 1;
+		length += read;
+
+	}
+#endif
+
+	if (i == count) {
+		return length;
+	}
+
+	const size_t read = io_read_var_ints_scalar(buffer + length, max_length - length, values + i, count - i);
+
+	return read == 0 ? 0 : length + read;
+
+}
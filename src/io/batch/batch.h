@@ -0,0 +1,53 @@
+#pragma once
+#include "../../main.h"
+#include "../io.h"
+
+/*
+	Batched codecs for the hot paths of chunk and metadata encoding
+
+	Every function has a scalar version (_scalar) that is used on other architectures and
+	as a reference, on x86 SSE2/SSSE3/AVX2 paths are picked at runtime
+*/
+
+extern const uint8_t io_values_per_long[65];
+
+/*
+Number of longs needed to pack `count` values of `bits` bits, values never span two longs
+*/
+static inline size_t io_packed_longs(size_t count, uint8_t bits) {
+
+	const uint8_t values_per_long = io_values_per_long[bits];
+
+	return (count + values_per_long - 1) / values_per_long;
+
+}
+
+/*
+Pack values into big endian longs, the first value goes in the lowest bits
+Every value has to fit in `bits` bits
+Returns the number of longs written
+*/
+extern size_t io_pack_bytes(const uint8_t* values, size_t count, uint8_t bits, byte_t* out);
+extern size_t io_pack_shorts(const uint16_t* values, size_t count, uint8_t bits, byte_t* out);
+
+extern size_t io_pack_bytes_scalar(const uint8_t* values, size_t count, uint8_t bits, byte_t* out);
+extern size_t io_pack_shorts_scalar(const uint16_t* values, size_t count, uint8_t bits, byte_t* out);
+
+/*
+Write var ints back to back
+`buffer` needs room for 5 bytes per value (3 for shorts)
+Returns the number of bytes written
+*/
+extern size_t io_write_var_ints(byte_t* buffer, const uint32_t* values, size_t count);
+extern size_t io_write_var_shorts(byte_t* buffer, const uint16_t* values, size_t count);
+
+extern size_t io_write_var_ints_scalar(byte_t* buffer, const uint32_t* values, size_t count);
+extern size_t io_write_var_shorts_scalar(byte_t* buffer, const uint16_t* values, size_t count);
+
+/*
+Read `count` var ints back to back
+Returns the number of bytes read or 0 if the buffer ends first
+*/
+extern size_t io_read_var_ints(const byte_t* buffer, size_t max_length, uint32_t* values, size_t count);
+
+extern size_t io_read_var_ints_scalar(const byte_t* buffer, size_t max_length, uint32_t* values, size_t count);
@@ -424,27 +424,28 @@ size_t cht_server_list_ping(char* message) {
 
 	mjson_obj_add(players, mjson_string(doc, UTL_CSTRTOARG("max")), mjson_int(doc, ltg_get_online_max(sky_get_listener())));
 
-	const uint32_t online_count = ltg_get_online_count(sky_get_listener());
+	reg_enter();
 
-	mjson_obj_add(players, mjson_string(doc, UTL_CSTRTOARG("online")), mjson_int(doc, online_count));
+	const reg_snapshot_t* online = ltg_get_online(sky_get_listener());
+
+	mjson_obj_add(players, mjson_string(doc, UTL_CSTRTOARG("online")), mjson_int(doc, online->count));
 	
-	if (online_count > 0) {
+	if (online->count > 0) {
 		mjson_val* sample = mjson_arr(doc);
-		const uint32_t online_length = ltg_get_online_length(sky_get_listener());
-		for (uint32_t i = 0; i < online_length; ++i) {
-			ltg_client_t* player = ltg_get_online_client(sky_get_listener(), i);
-			if (player != NULL) {
-				mjson_val* val = mjson_obj(doc);
-				mjson_obj_add(val, mjson_string(doc, UTL_CSTRTOARG("name")), mjson_string(doc, UTL_STRTOARG(ltg_client_get_username(player))));
-				char uuid[37];
-				ltg_uuid_to_string(ltg_client_get_uuid(player), uuid);
-				mjson_obj_add(val, mjson_string(doc, UTL_CSTRTOARG("id")), mjson_string(doc, uuid, 36));
-				mjson_arr_append(sample, val);
-			}
+		for (uint32_t i = 0; i < online->count; ++i) {
+			ltg_client_t* player = online->clients[i];
+			mjson_val* val = mjson_obj(doc);
+			mjson_obj_add(val, mjson_string(doc, UTL_CSTRTOARG("name")), mjson_string(doc, UTL_STRTOARG(ltg_client_get_username(player))));
+			char uuid[37];
+			ltg_uuid_to_string(ltg_client_get_uuid(player), uuid);
+			mjson_obj_add(val, mjson_string(doc, UTL_CSTRTOARG("id")), mjson_string(doc, uuid, 36));
+			mjson_arr_append(sample, val);
 		}
 		mjson_obj_add(players, mjson_string(doc, UTL_CSTRTOARG("sample")), sample);
 	}
 
+	reg_exit();
+
 	mjson_obj_add(obj, mjson_string(doc, UTL_CSTRTOARG("players")), players);
 
 	mjson_val* description = mjson_obj(doc);
@@ -1,6 +1,7 @@
 #include "graph.h"
 
 pck_packet_t* cmd_graph = NULL;
+_Atomic uint32_t cmd_graph_version = 0;
 
 pck_packet_t* cmd_get_graph() {
 
@@ -115,4 +116,7 @@ void cmd_reset_graph() {
 	if (cmd_graph != NULL)
 		free(cmd_graph);
 
+	cmd_graph = NULL;
+	cmd_graph_version++;
+
 }
\ No newline at end of file
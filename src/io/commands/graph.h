@@ -44,5 +44,8 @@ struct cmd_node {
 
 };
 
+// changes every time the graph is reset, for anything caching what it was built from
+extern _Atomic uint32_t cmd_graph_version;
+
 extern pck_packet_t* cmd_get_graph();
 extern void cmd_reset_graph();
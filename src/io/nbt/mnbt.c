@@ -8,25 +8,108 @@ mnbt_doc* mnbt_new() {
 	return calloc(1, sizeof(mnbt_doc));
 }
 
+mnbt_doc* mnbt_new_arena(void* buffer, size_t size) {
+
+	if (size < sizeof(mnbt_arena) + sizeof(mnbt_doc)) {
+		return NULL;
+	}
+
+	uint8_t owned = 0;
+	if (buffer == NULL) {
+		buffer = malloc(size);
+		owned = 1;
+	}
+
+	mnbt_arena* arena = buffer;
+	arena->next = NULL;
+	arena->size = size - sizeof(mnbt_arena);
+	arena->used = 0;
+	arena->owned = owned;
+
+	mnbt_doc* doc = (mnbt_doc*) arena->bytes;
+	memset(doc, 0, sizeof(mnbt_doc));
+	arena->used = (sizeof(mnbt_doc) + 15) & ~(size_t) 15;
+	doc->arena = arena;
+
+	return doc;
+
+}
+
+void* mnbt_alloc(mnbt_doc* document, size_t size) {
+
+	mnbt_arena* arena = document->arena;
+
+	if (arena == NULL) {
+		return malloc(size);
+	}
+
+	size = (size + 15) & ~(size_t) 15;
+
+	if (arena->size - arena->used < size) {
+
+		// chain a new block at least as large as the last one
+		const size_t block_size = arena->size > size ? arena->size : size;
+		mnbt_arena* block = malloc(sizeof(mnbt_arena) + block_size);
+		block->next = arena;
+		block->size = block_size;
+		block->used = 0;
+		block->owned = 1;
+
+		document->arena = arena = block;
+
+	}
+
+	void* ptr = arena->bytes + arena->used;
+	arena->used += size;
+
+	return ptr;
+
+}
+
+void* _mnbt_realloc(mnbt_doc* document, void* ptr, size_t old_size, size_t new_size) {
+
+	if (document->arena == NULL) {
+		return realloc(ptr, new_size);
+	}
+
+	void* new_ptr = mnbt_alloc(document, new_size);
+	if (ptr != NULL) {
+		memcpy(new_ptr, ptr, old_size);
+	}
+
+	return new_ptr;
+
+}
+
 mnbt_doc* mnbt_read(const uint8_t* bytes, size_t length, size_t* length_read, mnbt_compression compression) {
 
-	size_t i = 0;
+	return _mnbt_read_into(mnbt_new(), bytes, length, length_read, compression);
+
+}
+
+mnbt_doc* mnbt_read_arena(const uint8_t* bytes, size_t length, size_t* length_read, mnbt_compression compression, void* buffer, size_t size) {
+
+	mnbt_doc* doc = mnbt_new_arena(buffer, size);
+
+	if (doc == NULL) {
+		return NULL;
+	}
+
+	return _mnbt_read_into(doc, bytes, length, length_read, compression);
+
+}
+
+mnbt_doc* _mnbt_read_into(mnbt_doc* doc, const uint8_t* bytes, size_t length, size_t* length_read, mnbt_compression compression) {
+
 	size_t len = 0;
 
 	switch (compression) {
 		case MNBT_NONE: {
 
-			mnbt_doc* doc = mnbt_new();
-			do {
-			   i +=  _mnbt_read_tag(doc, NULL, bytes + i);
-			} while (i < length);
+			len = _mnbt_read_doc(doc, bytes, length);
 
 			if (length_read != NULL)
-				*length_read = i;
-
-			if (doc->count != 0) {
-				doc->root = doc->tags[doc->count - 1];
-			}
+				*length_read = len;
 
 			return doc;
 		}
@@ -36,23 +119,17 @@ mnbt_doc* mnbt_read(const uint8_t* bytes, size_t length, size_t* length_read, mn
 			
 			if (libdeflate_gzip_decompress(decompressor, bytes, length, d_bytes, length << 2, &len) != LIBDEFLATE_SUCCESS) {
 				libdeflate_free_decompressor(decompressor);
+				mnbt_free(doc);
 				return NULL;
 			}
 			
 			libdeflate_free_decompressor(decompressor);
 
-			mnbt_doc* doc = mnbt_new();
-			do {
-				i += _mnbt_read_tag(doc, NULL, d_bytes + i);
-			} while (i < len);
+			_mnbt_read_doc(doc, d_bytes, len);
 
 			if (length_read != NULL)
 				*length_read = len;
 
-			if (doc->count != 0) {
-				doc->root = doc->tags[doc->count - 1];
-			}
-
 			return doc;
 		}
 		case MNBT_ZLIB: {
@@ -60,34 +137,45 @@ mnbt_doc* mnbt_read(const uint8_t* bytes, size_t length, size_t* length_read, mn
 			uint8_t d_bytes[length * 4];
 			if (libdeflate_zlib_decompress(decompressor, bytes, length, d_bytes, length << 2, &len) != LIBDEFLATE_SUCCESS) {
 				libdeflate_free_decompressor(decompressor);
+				mnbt_free(doc);
 				return NULL;
 			}
 			
 			libdeflate_free_decompressor(decompressor);
 
-			mnbt_doc* doc = mnbt_new();
-			do {
-				i += _mnbt_read_tag(doc, NULL, d_bytes + i);
-			} while (i < len);
+			_mnbt_read_doc(doc, d_bytes, len);
 			
 			if (length_read != NULL)
 				*length_read = len;
 
-			if (doc->count != 0) {
-				doc->root = doc->tags[doc->count - 1];
-			}
-
 			return doc;
 		}
 		default: {
 			if (length_read != NULL)
 				*length_read = 0;
+			mnbt_free(doc);
 			return NULL;
 		}
 	}
 
 }
 
+size_t _mnbt_read_doc(mnbt_doc* document, const uint8_t* bytes, size_t length) {
+
+	size_t i = 0;
+	mnbt_tag* tag = NULL;
+
+	do {
+		i += _mnbt_read_tag(document, &tag, bytes + i);
+	} while (i < length);
+
+	// the last tag in the root becomes the root
+	document->root = tag;
+
+	return i;
+
+}
+
 mnbt_doc* mnbt_read_file(const char* file, mnbt_compression compression) {
 
 	FILE* f = fopen(file, "rb");
@@ -118,7 +206,7 @@ mnbt_doc* mnbt_read_file(const char* file, mnbt_compression compression) {
 
 size_t _mnbt_read_tag(mnbt_doc* document, mnbt_tag** tag_out, const uint8_t* bytes) {
 
-	mnbt_tag* tag = malloc(sizeof(mnbt_tag));
+	mnbt_tag* tag = mnbt_alloc(document, sizeof(mnbt_tag));
 
 	if (tag_out != NULL) {
 		*tag_out = tag;
@@ -136,7 +224,7 @@ size_t _mnbt_read_tag(mnbt_doc* document, mnbt_tag** tag_out, const uint8_t* byt
 
 	tag->label_length = _mnbt_reverse_short(*((uint16_t*) (bytes + 1)));
 
-	tag->label = malloc(tag->label_length + 1);
+	tag->label = mnbt_alloc(document, tag->label_length + 1);
 	memcpy(tag->label, bytes + 3, tag->label_length);
 	tag->label[tag->label_length] = 0;
 	size_t length = 3 + tag->label_length;
@@ -151,12 +239,12 @@ size_t _mnbt_read_tag(mnbt_doc* document, mnbt_tag** tag_out, const uint8_t* byt
 
 mnbt_tag* mnbt_new_tag(mnbt_doc* document, const char* label, uint16_t label_length, mnbt_type type, mnbt_val value) {
 
-	mnbt_tag* tag = malloc(sizeof(mnbt_tag));
+	mnbt_tag* tag = mnbt_alloc(document, sizeof(mnbt_tag));
 
 	tag->type = type;
 
 	tag->label_length = label_length;
-	tag->label = malloc(label_length + 1);
+	tag->label = mnbt_alloc(document, label_length + 1);
 	memcpy(tag->label, label, label_length);
 	tag->label[label_length] = 0;
 
@@ -205,14 +293,14 @@ size_t _mnbt_read_val(mnbt_doc* document, mnbt_type type, mnbt_val* value, const
 		case MNBT_BYTE_ARRAY: {
 			value->Byte_Array.size = _mnbt_reverse_int(*((uint32_t*) bytes));
 			bytes += 4;
-			value->Byte_Array.bytes = malloc(value->Byte_Array.size);
+			value->Byte_Array.bytes = mnbt_alloc(document, value->Byte_Array.size);
 			memcpy(value->Byte_Array.bytes, bytes, value->Byte_Array.size);
 			return value->Byte_Array.size + 4;
 		}
 		case MNBT_STRING: {
 			value->String.length = _mnbt_reverse_short(*((uint16_t*) bytes));
 			bytes += 2;
-			value->String.string = malloc(value->String.length + 1);
+			value->String.string = mnbt_alloc(document, value->String.length + 1);
 			memcpy(value->String.string, bytes, value->String.length);
 			value->String.string[value->String.length] = 0;
 			return value->String.length + 2;
@@ -223,7 +311,7 @@ size_t _mnbt_read_val(mnbt_doc* document, mnbt_type type, mnbt_val* value, const
 			value->List.size = _mnbt_reverse_int(*((uint32_t*) bytes));
 			bytes += 4;
 
-			value->List.list = malloc(sizeof(mnbt_val) * value->List.size);
+			value->List.list = mnbt_alloc(document, sizeof(mnbt_val) * value->List.size);
 			
 			size_t length = 0;
 			for (uint32_t i = 0; i < value->List.size; ++i) {
@@ -240,7 +328,7 @@ size_t _mnbt_read_val(mnbt_doc* document, mnbt_type type, mnbt_val* value, const
 			size_t length = 0;
 			
 			value->Compound.cap = 2;
-			value->Compound.tags = malloc(sizeof(mnbt_tag) * 2);
+			value->Compound.tags = mnbt_alloc(document, sizeof(mnbt_tag*) * 2);
 
 			for(;;) {
 
@@ -252,7 +340,7 @@ size_t _mnbt_read_val(mnbt_doc* document, mnbt_type type, mnbt_val* value, const
 
 				if (value->Compound.size == value->Compound.cap) {
 					value->Compound.cap *= 2;
-					value->Compound.tags = realloc(value->Compound.tags, sizeof(mnbt_tag) * value->Compound.cap);
+					value->Compound.tags = _mnbt_realloc(document, value->Compound.tags, sizeof(mnbt_tag*) * value->Compound.size, sizeof(mnbt_tag*) * value->Compound.cap);
 				}
 
 				value->Compound.tags[value->Compound.size++] = tag; 
@@ -264,7 +352,7 @@ size_t _mnbt_read_val(mnbt_doc* document, mnbt_type type, mnbt_val* value, const
 		case MNBT_INT_ARRAY: {
 			value->Int_Array.size = _mnbt_reverse_int(*((uint32_t*) bytes));
 			bytes += 4;
-			value->Int_Array.ints = malloc(value->Int_Array.size * 4);
+			value->Int_Array.ints = mnbt_alloc(document, value->Int_Array.size * 4);
 			for (uint32_t i = 0; i < value->Int_Array.size; ++i) {
 				value->Int_Array.ints[i] = _mnbt_reverse_int(((uint32_t*) bytes)[i]);
 			}
@@ -273,7 +361,7 @@ size_t _mnbt_read_val(mnbt_doc* document, mnbt_type type, mnbt_val* value, const
 		case MNBT_LONG_ARRAY: {
 			value->Long_Array.size = _mnbt_reverse_int(*((uint32_t*) bytes));
 			bytes += 4;
-			value->Long_Array.longs = malloc(value->Long_Array.size * 8);
+			value->Long_Array.longs = mnbt_alloc(document, value->Long_Array.size * 8);
 			for (uint32_t i = 0; i < value->Long_Array.size; ++i) {
 				value->Long_Array.longs[i] = _mnbt_reverse_long(((uint64_t*) bytes)[i]);
 			}
@@ -288,6 +376,11 @@ size_t _mnbt_read_val(mnbt_doc* document, mnbt_type type, mnbt_val* value, const
 
 void _mnbt_add(mnbt_doc* document, mnbt_tag* tag) {
 
+	// arena documents free everything at once, no need to track tags
+	if (document->arena != NULL) {
+		return;
+	}
+
 	if (document->count == document->cap) {
 		document->cap = (document->cap > 0 ? document->cap << 1 : 2);
 		document->tags = realloc(document->tags, sizeof(mnbt_tag*) * document->cap);
@@ -392,7 +485,7 @@ size_t _mnbt_write_val(mnbt_type type, mnbt_val val, uint8_t* bytes) {
 			return 4;
 		}
 		case MNBT_DOUBLE: {
-			double temp = _mnbt_reverse_float(val.Double);
+			double temp = _mnbt_reverse_double(val.Double);
 			memcpy(bytes, &temp, sizeof(temp));
 			return 8;
 		}
@@ -463,6 +556,111 @@ size_t _mnbt_write_val(mnbt_type type, mnbt_val val, uint8_t* bytes) {
 
 }
 
+// where the next 'length' bytes go, NULL if they don't fit
+static inline uint8_t* _mnbt_writer_reserve(mnbt_writer* writer, size_t length) {
+
+	if (writer->overflow || writer->capacity - writer->length < length) {
+		writer->overflow = true;
+		return NULL;
+	}
+
+	return writer->bytes + writer->length;
+
+}
+
+static inline void _mnbt_writer_val(mnbt_writer* writer, mnbt_type type, mnbt_val val, size_t length) {
+
+	uint8_t* bytes = _mnbt_writer_reserve(writer, length);
+
+	if (bytes != NULL) {
+		writer->length += _mnbt_write_val(type, val, bytes);
+	}
+
+}
+
+void mnbt_writer_tag(mnbt_writer* writer, mnbt_type type, const char* label, uint16_t label_length) {
+
+	uint8_t* bytes = _mnbt_writer_reserve(writer, 3 + (size_t) label_length);
+	if (bytes == NULL) {
+		return;
+	}
+
+	bytes[0] = (uint8_t) type;
+	*((uint16_t*) (bytes + 1)) = _mnbt_reverse_short(label_length);
+	memcpy(bytes + 3, label, label_length);
+
+	writer->length += 3 + label_length;
+
+}
+
+void mnbt_writer_byte(mnbt_writer* writer, int8_t value) {
+	_mnbt_writer_val(writer, MNBT_BYTE, mnbt_val_byte(value), 1);
+}
+
+void mnbt_writer_short(mnbt_writer* writer, int16_t value) {
+	_mnbt_writer_val(writer, MNBT_SHORT, mnbt_val_short(value), 2);
+}
+
+void mnbt_writer_int(mnbt_writer* writer, int32_t value) {
+	_mnbt_writer_val(writer, MNBT_INT, mnbt_val_int(value), 4);
+}
+
+void mnbt_writer_long(mnbt_writer* writer, int64_t value) {
+	_mnbt_writer_val(writer, MNBT_LONG, mnbt_val_long(value), 8);
+}
+
+void mnbt_writer_float(mnbt_writer* writer, float value) {
+	_mnbt_writer_val(writer, MNBT_FLOAT, mnbt_val_float(value), 4);
+}
+
+void mnbt_writer_double(mnbt_writer* writer, double value) {
+	_mnbt_writer_val(writer, MNBT_DOUBLE, mnbt_val_double(value), 8);
+}
+
+void mnbt_writer_string(mnbt_writer* writer, const char* string, uint16_t length) {
+	_mnbt_writer_val(writer, MNBT_STRING, mnbt_val_string_ref((char*) string, length), 2 + (size_t) length);
+}
+
+void mnbt_writer_byte_array(mnbt_writer* writer, const int8_t* bytes, uint32_t size) {
+	_mnbt_writer_val(writer, MNBT_BYTE_ARRAY, mnbt_val_byte_array_ref((int8_t*) bytes, size), 4 + (size_t) size);
+}
+
+void mnbt_writer_int_array(mnbt_writer* writer, const int32_t* ints, uint32_t size) {
+	_mnbt_writer_val(writer, MNBT_INT_ARRAY, mnbt_val_int_array_ref((int32_t*) ints, size), 4 + ((size_t) size << 2));
+}
+
+void mnbt_writer_long_array(mnbt_writer* writer, const int64_t* longs, uint32_t size) {
+	_mnbt_writer_val(writer, MNBT_LONG_ARRAY, mnbt_val_long_array_ref((int64_t*) longs, size), 4 + ((size_t) size << 3));
+}
+
+void mnbt_writer_long_array_be(mnbt_writer* writer, const uint64_t* longs, uint32_t size) {
+
+	uint8_t* bytes = _mnbt_writer_reserve(writer, 4 + ((size_t) size << 3));
+	if (bytes == NULL) {
+		return;
+	}
+
+	*((uint32_t*) bytes) = _mnbt_reverse_int(size);
+	memcpy(bytes + 4, longs, (size_t) size << 3);
+
+	writer->length += 4 + ((size_t) size << 3);
+
+}
+
+void mnbt_writer_list(mnbt_writer* writer, mnbt_type type, uint32_t size) {
+
+	uint8_t* bytes = _mnbt_writer_reserve(writer, 5);
+	if (bytes == NULL) {
+		return;
+	}
+
+	bytes[0] = (uint8_t) type;
+	*((uint32_t*) (bytes + 1)) = _mnbt_reverse_int(size);
+
+	writer->length += 5;
+
+}
+
 mnbt_val mnbt_val_string(const char* string, uint16_t length) {
 	mnbt_val val = {
 		.String = {
@@ -522,7 +720,7 @@ void mnbt_val_push_tag(mnbt_val* value, mnbt_tag* tag) {
 void mnbt_val_list_push(mnbt_val* list, mnbt_val val) {
 
 	if (list->List.size == list->List.cap) {
-		list->Compound.cap = (list->Compound.cap > 0 ? list->Compound.cap << 1 : 2);
+		list->List.cap = (list->List.cap > 0 ? list->List.cap << 1 : 2);
 		list->List.list = realloc(list->List.list, sizeof(mnbt_val) * list->List.cap);
 	}
 
@@ -530,6 +728,32 @@ void mnbt_val_list_push(mnbt_val* list, mnbt_val val) {
 
 }
 
+void mnbt_doc_push_tag(mnbt_doc* document, mnbt_tag* tag, mnbt_tag* value) {
+
+	mnbt_val* compound = &tag->value;
+
+	if (compound->Compound.size == compound->Compound.cap) {
+		compound->Compound.cap = (compound->Compound.cap > 0 ? compound->Compound.cap << 1 : 2);
+		compound->Compound.tags = _mnbt_realloc(document, compound->Compound.tags, sizeof(mnbt_tag*) * compound->Compound.size, sizeof(mnbt_tag*) * compound->Compound.cap);
+	}
+
+	compound->Compound.tags[compound->Compound.size++] = value;
+
+}
+
+void mnbt_doc_list_push(mnbt_doc* document, mnbt_tag* tag, mnbt_val val) {
+
+	mnbt_val* list = &tag->value;
+
+	if (list->List.size == list->List.cap) {
+		list->List.cap = (list->List.cap > 0 ? list->List.cap << 1 : 2);
+		list->List.list = _mnbt_realloc(document, list->List.list, sizeof(mnbt_val) * list->List.size, sizeof(mnbt_val) * list->List.cap);
+	}
+
+	list->List.list[list->List.size++] = val;
+
+}
+
 void _mnbt_free_val(mnbt_type type, mnbt_val val) {
 
 	switch (type) {
@@ -569,6 +793,22 @@ void _mnbt_free_val(mnbt_type type, mnbt_val val) {
 
 void mnbt_free(mnbt_doc* document) {
 
+	if (document->arena != NULL) {
+
+		// the document itself lives in the first block
+		mnbt_arena* arena = document->arena;
+		while (arena != NULL) {
+			mnbt_arena* next = arena->next;
+			if (arena->owned) {
+				free(arena);
+			}
+			arena = next;
+		}
+
+		return;
+
+	}
+
 	for (uint32_t i = 0; i < document->count; ++i) {
 		
 		mnbt_tag* tag = document->tags[i];
@@ -584,4 +824,433 @@ void mnbt_free(mnbt_doc* document) {
 	free(document->tags);
 	free(document);
 
-}
\ No newline at end of file
+}
+static inline uint8_t _mnbt_fixed_size(mnbt_type type) {
+
+	switch (type) {
+		case MNBT_BYTE:
+			return 1;
+		case MNBT_SHORT:
+			return 2;
+		case MNBT_INT:
+		case MNBT_FLOAT:
+			return 4;
+		case MNBT_LONG:
+		case MNBT_DOUBLE:
+			return 8;
+		default:
+			return 0;
+	}
+
+}
+
+const uint8_t* _mnbt_skip_val(mnbt_type type, const uint8_t* bytes, const uint8_t* end, uint32_t depth) {
+
+	if (bytes == NULL || depth > MNBT_MAX_DEPTH) {
+		return NULL;
+	}
+
+	const size_t left = end - bytes;
+
+	switch (type) {
+		case MNBT_END: {
+			return bytes;
+		}
+		case MNBT_BYTE:
+		case MNBT_SHORT:
+		case MNBT_INT:
+		case MNBT_LONG:
+		case MNBT_FLOAT:
+		case MNBT_DOUBLE: {
+			const size_t size = _mnbt_fixed_size(type);
+			return left >= size ? bytes + size : NULL;
+		}
+		case MNBT_BYTE_ARRAY:
+		case MNBT_INT_ARRAY:
+		case MNBT_LONG_ARRAY: {
+			if (left < 4) {
+				return NULL;
+			}
+			const size_t size = (size_t) _mnbt_load_int(bytes) * (type == MNBT_BYTE_ARRAY ? 1 : type == MNBT_INT_ARRAY ? 4 : 8);
+			return left - 4 >= size ? bytes + 4 + size : NULL;
+		}
+		case MNBT_STRING: {
+			if (left < 2) {
+				return NULL;
+			}
+			const size_t size = _mnbt_load_short(bytes);
+			return left - 2 >= size ? bytes + 2 + size : NULL;
+		}
+		case MNBT_LIST: {
+			if (left < 5) {
+				return NULL;
+			}
+			const mnbt_type element_type = bytes[0];
+			const uint32_t size = _mnbt_load_int(bytes + 1);
+			bytes += 5;
+
+			// end tags take no bytes, a list of them could keep us busy for 2^32 rounds
+			if (element_type == MNBT_END && size != 0) {
+				return NULL;
+			}
+
+			const size_t fixed_size = _mnbt_fixed_size(element_type);
+			if (fixed_size != 0) {
+				return left - 5 >= fixed_size * size ? bytes + fixed_size * size : NULL;
+			}
+
+			for (uint32_t i = 0; i < size && bytes != NULL; ++i) {
+				bytes = _mnbt_skip_val(element_type, bytes, end, depth + 1);
+			}
+
+			return bytes;
+		}
+		case MNBT_COMPOUND: {
+			mnbt_cursor child;
+			while (_mnbt_cursor_header(&child, bytes, end)) {
+				if (child.type == MNBT_END) {
+					return child.value;
+				}
+				bytes = _mnbt_skip_val(child.type, child.value, end, depth + 1);
+			}
+			return NULL;
+		}
+		default: {
+			return NULL;
+		}
+	}
+
+}
+
+bool _mnbt_cursor_header(mnbt_cursor* cursor, const uint8_t* bytes, const uint8_t* end) {
+
+	if (bytes == NULL || bytes >= end) {
+		return false;
+	}
+
+	cursor->end = end;
+	cursor->type = bytes[0];
+
+	if (cursor->type == MNBT_END) {
+		cursor->label = NULL;
+		cursor->label_length = 0;
+		cursor->value = bytes + 1;
+		return true;
+	}
+
+	if (cursor->type > MNBT_LONG_ARRAY || end - bytes < 3) {
+		return false;
+	}
+
+	cursor->label_length = _mnbt_load_short(bytes + 1);
+	if ((size_t) (end - bytes - 3) < cursor->label_length) {
+		return false;
+	}
+	cursor->label = (const char*) bytes + 3;
+	cursor->value = bytes + 3 + cursor->label_length;
+
+	return true;
+
+}
+
+bool mnbt_cursor_open(mnbt_cursor* cursor, const uint8_t* bytes, size_t length) {
+
+	return _mnbt_cursor_header(cursor, bytes, bytes + length) && cursor->type != MNBT_END;
+
+}
+
+size_t mnbt_cursor_length(const mnbt_cursor* cursor) {
+
+	const uint8_t* after = _mnbt_skip_val(cursor->type, cursor->value, cursor->end, 0);
+
+	return after != NULL ? (size_t) (after - cursor->value) : 0;
+
+}
+
+bool mnbt_cursor_first(const mnbt_cursor* compound, mnbt_cursor* child) {
+
+	if (compound->type != MNBT_COMPOUND) {
+		return false;
+	}
+
+	return _mnbt_cursor_header(child, compound->value, compound->end) && child->type != MNBT_END;
+
+}
+
+bool mnbt_cursor_next(mnbt_cursor* child) {
+
+	const uint8_t* next = _mnbt_skip_val(child->type, child->value, child->end, 0);
+
+	return _mnbt_cursor_header(child, next, child->end) && child->type != MNBT_END;
+
+}
+
+bool mnbt_cursor_child(const mnbt_cursor* compound, const char* label, uint16_t label_length, mnbt_cursor* child) {
+
+	if (!mnbt_cursor_first(compound, child)) {
+		return false;
+	}
+
+	do {
+		if (child->label_length == label_length && memcmp(child->label, label, label_length) == 0) {
+			return true;
+		}
+	} while (mnbt_cursor_next(child));
+
+	return false;
+
+}
+
+bool mnbt_cursor_element(const mnbt_cursor* list, uint32_t idx, mnbt_cursor* element) {
+
+	if (list->type != MNBT_LIST || list->end - list->value < 5) {
+		return false;
+	}
+
+	const uint32_t size = _mnbt_load_int(list->value + 1);
+	if (idx >= size || list->value[0] == MNBT_END) {
+		return false;
+	}
+
+	element->type = list->value[0];
+	element->end = list->end;
+	element->label = NULL;
+	element->label_length = 0;
+
+	const uint8_t* bytes = list->value + 5;
+	const size_t fixed_size = _mnbt_fixed_size(element->type);
+
+	if (fixed_size != 0) {
+		bytes += fixed_size * idx;
+		if ((size_t) (list->end - bytes) < fixed_size) {
+			return false;
+		}
+	} else {
+		for (uint32_t i = 0; i < idx && bytes != NULL; ++i) {
+			bytes = _mnbt_skip_val(element->type, bytes, list->end, 0);
+		}
+		if (bytes == NULL) {
+			return false;
+		}
+	}
+
+	element->value = bytes;
+
+	return true;
+
+}
+
+uint32_t mnbt_cursor_index(const mnbt_cursor* container, mnbt_cursor* entries, uint32_t max) {
+
+	uint32_t count = 0;
+
+	switch (container->type) {
+		case MNBT_COMPOUND: {
+			if (max == 0 || !mnbt_cursor_first(container, &entries[0])) {
+				return 0;
+			}
+			count = 1;
+			while (count < max) {
+				entries[count] = entries[count - 1];
+				if (!mnbt_cursor_next(&entries[count])) {
+					break;
+				}
+				count++;
+			}
+			return count;
+		}
+		case MNBT_LIST: {
+			if (max == 0 || !mnbt_cursor_element(container, 0, &entries[0])) {
+				return 0;
+			}
+			const uint32_t list_size = _mnbt_load_int(container->value + 1);
+			const uint32_t size = list_size < max ? list_size : max;
+			for (count = 1; count < size; ++count) {
+				entries[count] = entries[count - 1];
+				entries[count].value = _mnbt_skip_val(entries[count].type, entries[count - 1].value, container->end, 0);
+				if (entries[count].value == NULL) {
+					break;
+				}
+			}
+			return count;
+		}
+		default: {
+			return 0;
+		}
+	}
+
+}
+
+const mnbt_cursor* mnbt_index_find(const mnbt_cursor* entries, uint32_t count, const char* label, uint16_t label_length) {
+
+	for (uint32_t i = 0; i < count; ++i) {
+		if (entries[i].label_length == label_length && memcmp(entries[i].label, label, label_length) == 0) {
+			return &entries[i];
+		}
+	}
+
+	return NULL;
+
+}
+
+bool mnbt_cursor_path(const mnbt_cursor* root, const char* path, mnbt_cursor* out) {
+
+	mnbt_cursor current = *root;
+	mnbt_cursor next;
+
+	while (*path) {
+
+		// label up to the next '.' or '['
+		size_t label_length = strcspn(path, ".[");
+		if (label_length > 0) {
+			if (!mnbt_cursor_child(&current, path, label_length, &next)) {
+				return false;
+			}
+			current = next;
+			path += label_length;
+		}
+
+		// any number of list indices
+		while (*path == '[') {
+			char* index_end;
+			const unsigned long idx = strtoul(path + 1, &index_end, 10);
+			if (*index_end != ']' || index_end == path + 1 || !mnbt_cursor_element(&current, idx, &next)) {
+				return false;
+			}
+			current = next;
+			path = index_end + 1;
+		}
+
+		if (*path == '.') {
+			path++;
+		} else if (*path != '\0') {
+			return false;
+		}
+
+	}
+
+	*out = current;
+
+	return true;
+
+}
+
+// if the first 'size' bytes of the value are there, children are only checked up to their header
+static inline bool _mnbt_cursor_has(const mnbt_cursor* cursor, size_t size) {
+	return cursor->value <= cursor->end && (size_t) (cursor->end - cursor->value) >= size;
+}
+
+// if the whole string or array is there, after its length
+static inline bool _mnbt_cursor_has_array(const mnbt_cursor* cursor) {
+
+	switch (cursor->type) {
+		case MNBT_STRING:
+			return _mnbt_cursor_has(cursor, 2) && _mnbt_cursor_has(cursor, 2 + (size_t) _mnbt_load_short(cursor->value));
+		case MNBT_BYTE_ARRAY:
+			return _mnbt_cursor_has(cursor, 4) && _mnbt_cursor_has(cursor, 4 + (size_t) _mnbt_load_int(cursor->value));
+		case MNBT_INT_ARRAY:
+			return _mnbt_cursor_has(cursor, 4) && _mnbt_cursor_has(cursor, 4 + ((size_t) _mnbt_load_int(cursor->value) << 2));
+		case MNBT_LONG_ARRAY:
+			return _mnbt_cursor_has(cursor, 4) && _mnbt_cursor_has(cursor, 4 + ((size_t) _mnbt_load_int(cursor->value) << 3));
+		default:
+			return false;
+	}
+
+}
+
+uint32_t mnbt_cursor_get_size(const mnbt_cursor* cursor) {
+
+	switch (cursor->type) {
+		case MNBT_STRING:
+			return _mnbt_cursor_has_array(cursor) ? _mnbt_load_short(cursor->value) : 0;
+		case MNBT_LIST: {
+			if (!_mnbt_cursor_has(cursor, 5)) {
+				return 0;
+			}
+			// elements that aren't numbers are checked when they are looked up
+			const uint32_t size = _mnbt_load_int(cursor->value + 1);
+			return _mnbt_cursor_has(cursor, 5 + (size_t) _mnbt_fixed_size(cursor->value[0]) * size) ? size : 0;
+		}
+		case MNBT_BYTE_ARRAY:
+		case MNBT_INT_ARRAY:
+		case MNBT_LONG_ARRAY:
+			return _mnbt_cursor_has_array(cursor) ? _mnbt_load_int(cursor->value) : 0;
+		default:
+			return 0;
+	}
+
+}
+
+int8_t mnbt_cursor_get_byte(const mnbt_cursor* cursor) {
+	return _mnbt_cursor_has(cursor, 1) ? (int8_t) cursor->value[0] : 0;
+}
+
+int16_t mnbt_cursor_get_short(const mnbt_cursor* cursor) {
+	return _mnbt_cursor_has(cursor, 2) ? (int16_t) _mnbt_load_short(cursor->value) : 0;
+}
+
+int32_t mnbt_cursor_get_int(const mnbt_cursor* cursor) {
+	return _mnbt_cursor_has(cursor, 4) ? (int32_t) _mnbt_load_int(cursor->value) : 0;
+}
+
+int64_t mnbt_cursor_get_long(const mnbt_cursor* cursor) {
+	return _mnbt_cursor_has(cursor, 8) ? (int64_t) _mnbt_load_long(cursor->value) : 0;
+}
+
+float mnbt_cursor_get_float(const mnbt_cursor* cursor) {
+	const uint32_t num = _mnbt_cursor_has(cursor, 4) ? _mnbt_load_int(cursor->value) : 0;
+	float val;
+	memcpy(&val, &num, sizeof(val));
+	return val;
+}
+
+double mnbt_cursor_get_double(const mnbt_cursor* cursor) {
+	const uint64_t num = _mnbt_cursor_has(cursor, 8) ? _mnbt_load_long(cursor->value) : 0;
+	double val;
+	memcpy(&val, &num, sizeof(val));
+	return val;
+}
+
+const char* mnbt_cursor_get_string(const mnbt_cursor* cursor) {
+	return cursor->type == MNBT_STRING && _mnbt_cursor_has_array(cursor) ? (const char*) cursor->value + 2 : NULL;
+}
+
+const void* mnbt_cursor_get_array(const mnbt_cursor* cursor) {
+	return cursor->type != MNBT_STRING && _mnbt_cursor_has_array(cursor) ? cursor->value + 4 : NULL;
+}
+
+int32_t mnbt_cursor_get_int_at(const mnbt_cursor* cursor, uint32_t idx) {
+	return cursor->type == MNBT_INT_ARRAY && idx < mnbt_cursor_get_size(cursor) ? (int32_t) _mnbt_load_int(cursor->value + 4 + ((size_t) idx << 2)) : 0;
+}
+
+int64_t mnbt_cursor_get_long_at(const mnbt_cursor* cursor, uint32_t idx) {
+	return cursor->type == MNBT_LONG_ARRAY && idx < mnbt_cursor_get_size(cursor) ? (int64_t) _mnbt_load_long(cursor->value + 4 + ((size_t) idx << 3)) : 0;
+}
+
+void mnbt_cursor_read_ints(const mnbt_cursor* cursor, int32_t* out) {
+
+	if (cursor->type != MNBT_INT_ARRAY) {
+		return;
+	}
+
+	const uint32_t size = mnbt_cursor_get_size(cursor);
+
+	for (uint32_t i = 0; i < size; ++i) {
+		out[i] = (int32_t) _mnbt_load_int(cursor->value + 4 + ((size_t) i << 2));
+	}
+
+}
+
+void mnbt_cursor_read_longs(const mnbt_cursor* cursor, int64_t* out) {
+
+	if (cursor->type != MNBT_LONG_ARRAY) {
+		return;
+	}
+
+	const uint32_t size = mnbt_cursor_get_size(cursor);
+
+	for (uint32_t i = 0; i < size; ++i) {
+		out[i] = (int64_t) _mnbt_load_long(cursor->value + 4 + ((size_t) i << 3));
+	}
+
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -96,6 +97,26 @@ struct mnbt_tag {
 
 };
 
+/*
+A block of memory that arena documents allocate from
+Blocks are chained when the first one runs out and are all released by mnbt_free
+*/
+typedef struct mnbt_arena mnbt_arena;
+
+struct mnbt_arena {
+
+	mnbt_arena* next;
+
+	size_t size;
+	size_t used;
+
+	// false when the block was supplied by the caller
+	uint8_t owned;
+
+	_Alignas(16) uint8_t bytes[];
+
+};
+
 /*
 A NBT document
 Holds references to all allocated tags and the root tag for traversing through the document
@@ -112,6 +133,9 @@ typedef struct {
 
 	mnbt_tag* root;
 
+	// NULL when tags and values are allocated individually on the heap
+	mnbt_arena* arena;
+
 } mnbt_doc;
 
 /*
@@ -119,12 +143,31 @@ Create a fresh NBT document for reading and writing
 */
 mnbt_doc* mnbt_new();
 
+/*
+Create a document whose tags, labels and values are bump allocated from 'buffer'
+If 'buffer' is NULL, 'size' bytes are allocated for it
+Extra blocks are allocated if the buffer runs out and everything is released at once by mnbt_free
+Values passed to tags in arena documents are never freed, use mnbt_alloc or the _ref value constructors
+Returns NULL if 'buffer' is too small to hold the document
+*/
+mnbt_doc* mnbt_new_arena(void* buffer, size_t size);
+
+/*
+Allocate memory that lives as long as the document
+*/
+void* mnbt_alloc(mnbt_doc* document, size_t size);
+
 /*
 Read vlaues 'bytes' byte array until 'length' has been reached
 'length_read' will return the length of the uncompressed document
 */
 mnbt_doc* mnbt_read(const uint8_t* bytes, size_t length, size_t* length_read, mnbt_compression compression);
 
+/*
+Same as mnbt_read but into an arena document created with mnbt_new_arena(buffer, size)
+*/
+mnbt_doc* mnbt_read_arena(const uint8_t* bytes, size_t length, size_t* length_read, mnbt_compression compression, void* buffer, size_t size);
+
 /*
 Read file as NBT document for reading and editing
 */
@@ -142,6 +185,165 @@ Returns the length of the resulting file or 0 on error
 */
 size_t mnbt_write_file(mnbt_doc* document, const char* file, size_t max_length, mnbt_compression compression);
 
+/*
+Streams NBT straight into a byte array without building a document
+Every named tag is a call to mnbt_writer_tag followed by the value, compounds are closed with mnbt_writer_end
+List elements are values without a tag header
+Nothing is written past 'capacity', once something does not fit 'overflow' is set and everything after it is dropped
+*/
+typedef struct {
+
+	uint8_t* bytes;
+	size_t length;
+	size_t capacity;
+
+	bool overflow;
+
+} mnbt_writer;
+
+static inline mnbt_writer mnbt_new_writer(uint8_t* bytes, size_t capacity) {
+	mnbt_writer writer = {
+		.bytes = bytes,
+		.length = 0,
+		.capacity = capacity,
+		.overflow = false
+	};
+
+	return writer;
+}
+
+void mnbt_writer_tag(mnbt_writer* writer, mnbt_type type, const char* label, uint16_t label_length);
+
+static inline void mnbt_writer_end(mnbt_writer* writer) {
+	if (writer->overflow || writer->length == writer->capacity) {
+		writer->overflow = true;
+		return;
+	}
+	writer->bytes[writer->length++] = MNBT_END;
+}
+
+void mnbt_writer_byte(mnbt_writer* writer, int8_t value);
+void mnbt_writer_short(mnbt_writer* writer, int16_t value);
+void mnbt_writer_int(mnbt_writer* writer, int32_t value);
+void mnbt_writer_long(mnbt_writer* writer, int64_t value);
+void mnbt_writer_float(mnbt_writer* writer, float value);
+void mnbt_writer_double(mnbt_writer* writer, double value);
+void mnbt_writer_string(mnbt_writer* writer, const char* string, uint16_t length);
+void mnbt_writer_byte_array(mnbt_writer* writer, const int8_t* bytes, uint32_t size);
+void mnbt_writer_int_array(mnbt_writer* writer, const int32_t* ints, uint32_t size);
+void mnbt_writer_long_array(mnbt_writer* writer, const int64_t* longs, uint32_t size);
+
+/*
+Write a long array that is already stored big endian, copied as is
+*/
+void mnbt_writer_long_array_be(mnbt_writer* writer, const uint64_t* longs, uint32_t size);
+
+/*
+Start a list of 'size' values of 'type'
+*/
+void mnbt_writer_list(mnbt_writer* writer, mnbt_type type, uint32_t size);
+
+/*
+Points at a tag inside an uncompressed NBT byte array without parsing it
+Labels, strings and arrays are read in place, nothing is copied until asked for
+Labels and strings are NOT null terminated
+*/
+typedef struct {
+
+	// start of the value
+	const uint8_t* value;
+	// end of the byte array, nothing past it is read
+	const uint8_t* end;
+
+	const char* label;
+	uint16_t label_length;
+
+	mnbt_type type;
+
+} mnbt_cursor;
+
+/*
+Point a cursor at the root tag of 'bytes'
+Returns false if the root tag is malformed
+*/
+bool mnbt_cursor_open(mnbt_cursor* cursor, const uint8_t* bytes, size_t length);
+
+/*
+Get the length of the value in bytes, for skipping over it
+Returns 0 if the value is malformed or runs past the end
+*/
+size_t mnbt_cursor_length(const mnbt_cursor* cursor);
+
+/*
+Get the first child of a compound, or move to the next child of the same compound
+Returns false once the end of the compound is reached
+*/
+bool mnbt_cursor_first(const mnbt_cursor* compound, mnbt_cursor* child);
+bool mnbt_cursor_next(mnbt_cursor* child);
+
+/*
+Find the child of a compound with the label
+*/
+bool mnbt_cursor_child(const mnbt_cursor* compound, const char* label, uint16_t label_length, mnbt_cursor* child);
+
+/*
+Get an element of a list, elements have no label
+O(1) for lists of numbers, otherwise the elements before it are skipped
+*/
+bool mnbt_cursor_element(const mnbt_cursor* list, uint32_t idx, mnbt_cursor* element);
+
+/*
+Build a skip index of every child of a compound or element of a list in one pass
+Entries can then be read by index or with mnbt_index_find without skipping over values again
+Returns the number of entries, at most 'max'
+*/
+uint32_t mnbt_cursor_index(const mnbt_cursor* container, mnbt_cursor* entries, uint32_t max);
+
+const mnbt_cursor* mnbt_index_find(const mnbt_cursor* entries, uint32_t count, const char* label, uint16_t label_length);
+
+/*
+Follow a path of labels and list indices from a compound, ie. "Level.sections[3].block_states"
+*/
+bool mnbt_cursor_path(const mnbt_cursor* root, const char* path, mnbt_cursor* out);
+
+/*
+Get the size of a list or array, or the length of a string
+Returns 0 if it runs past the end, getters never read past it and return 0 or NULL instead
+*/
+uint32_t mnbt_cursor_get_size(const mnbt_cursor* cursor);
+
+int8_t mnbt_cursor_get_byte(const mnbt_cursor* cursor);
+int16_t mnbt_cursor_get_short(const mnbt_cursor* cursor);
+int32_t mnbt_cursor_get_int(const mnbt_cursor* cursor);
+int64_t mnbt_cursor_get_long(const mnbt_cursor* cursor);
+float mnbt_cursor_get_float(const mnbt_cursor* cursor);
+double mnbt_cursor_get_double(const mnbt_cursor* cursor);
+
+/*
+Get the string in place, use mnbt_cursor_get_size for the length
+Returns NULL if it is not a string or runs past the end
+*/
+const char* mnbt_cursor_get_string(const mnbt_cursor* cursor);
+
+/*
+Get the raw big endian data of a byte, int or long array in place
+Returns NULL if it is not an array or runs past the end
+*/
+const void* mnbt_cursor_get_array(const mnbt_cursor* cursor);
+
+/*
+Decode single values of int and long arrays on demand
+*/
+int32_t mnbt_cursor_get_int_at(const mnbt_cursor* cursor, uint32_t idx);
+int64_t mnbt_cursor_get_long_at(const mnbt_cursor* cursor, uint32_t idx);
+
+/*
+Decode a whole int or long array into 'out', which must fit mnbt_cursor_get_size values
+Nothing is decoded if the array runs past the end
+*/
+void mnbt_cursor_read_ints(const mnbt_cursor* cursor, int32_t* out);
+void mnbt_cursor_read_longs(const mnbt_cursor* cursor, int64_t* out);
+
 /*
 Create new tag with label and value
 */
@@ -355,6 +557,54 @@ static inline int64_t* mnbt_val_get_long_array(mnbt_val val) {
 
 mnbt_val mnbt_val_long_array(int64_t* longs, uint32_t size);
 
+/*
+Reference values without copying them
+Only for arena documents, the memory has to outlive the document
+*/
+static inline mnbt_val mnbt_val_string_ref(char* string, uint16_t length) {
+	mnbt_val val = {
+		.String = {
+			.length = length,
+			.string = string
+		}
+	};
+
+	return val;
+}
+
+static inline mnbt_val mnbt_val_byte_array_ref(int8_t* bytes, uint32_t size) {
+	mnbt_val val = {
+		.Byte_Array = {
+			.size = size,
+			.bytes = bytes
+		}
+	};
+
+	return val;
+}
+
+static inline mnbt_val mnbt_val_int_array_ref(int32_t* ints, uint32_t size) {
+	mnbt_val val = {
+		.Int_Array = {
+			.size = size,
+			.ints = ints
+		}
+	};
+
+	return val;
+}
+
+static inline mnbt_val mnbt_val_long_array_ref(int64_t* longs, uint32_t size) {
+	mnbt_val val = {
+		.Long_Array = {
+			.size = size,
+			.longs = longs
+		}
+	};
+
+	return val;
+}
+
 static inline mnbt_tag* mnbt_get_tag(mnbt_tag* tag, uint32_t idx) {
 	return tag->value.Compound.tags[idx];
 }
@@ -373,6 +623,12 @@ static inline void mnbt_push_tag(mnbt_tag* tag, mnbt_tag* value) {
 	mnbt_val_push_tag(&tag->value, value);
 }
 
+/*
+Push a tag to a compound, growing it with the document's allocator
+Use instead of mnbt_push_tag for arena documents
+*/
+void mnbt_doc_push_tag(mnbt_doc* document, mnbt_tag* tag, mnbt_tag* value);
+
 static inline void mnbt_set_tag(mnbt_tag* tag, uint32_t idx, mnbt_tag* value) {
 	tag->value.Compound.tags[idx] = value;
 }
@@ -424,4 +680,10 @@ static inline void mnbt_list_push(mnbt_tag* tag, mnbt_val val) {
 	mnbt_val_list_push(&tag->value, val);
 }
 
+/*
+Push a value to a list, growing it with the document's allocator
+Use instead of mnbt_list_push for arena documents
+*/
+void mnbt_doc_list_push(mnbt_doc* document, mnbt_tag* tag, mnbt_val val);
+
 void mnbt_free(mnbt_doc* document);
\ No newline at end of file
@@ -7,11 +7,22 @@ size_t _mnbt_read_val(mnbt_doc* document, mnbt_type type, mnbt_val* value, const
 
 void _mnbt_add(mnbt_doc* document, mnbt_tag* tag);
 
+mnbt_doc* _mnbt_read_into(mnbt_doc* document, const uint8_t* bytes, size_t length, size_t* length_read, mnbt_compression compression);
+size_t _mnbt_read_doc(mnbt_doc* document, const uint8_t* bytes, size_t length);
+
+void* _mnbt_realloc(mnbt_doc* document, void* ptr, size_t old_size, size_t new_size);
+
 size_t _mnbt_write_tag(mnbt_tag* tag, uint8_t* bytes);
 size_t _mnbt_write_val(mnbt_type type, mnbt_val val, uint8_t* bytes);
 
 void _mnbt_free_val(mnbt_type type, mnbt_val val);
 
+// nesting deeper than this is treated as malformed by the cursor
+#define MNBT_MAX_DEPTH 512
+
+const uint8_t* _mnbt_skip_val(mnbt_type type, const uint8_t* bytes, const uint8_t* end, uint32_t depth);
+bool _mnbt_cursor_header(mnbt_cursor* cursor, const uint8_t* bytes, const uint8_t* end);
+
 static inline uint16_t _mnbt_reverse_short(uint16_t num) {
 #if __ENDIANNESS__
 	return num;
@@ -34,12 +45,12 @@ static inline uint64_t _mnbt_reverse_long(uint64_t num) {
 #else
 	return
 		((num & 0xff00000000000000L) >> 56) |
-		((num & 0x00ff000000000000L) >> 48) |
+		((num & 0x00ff000000000000L) >> 40) |
 		((num & 0x0000ff0000000000L) >> 24) |
 		((num & 0x000000ff00000000L) >> 8) |
 		((num & 0x00000000ff000000L) << 8) |
 		((num & 0x0000000000ff0000L) << 24) |
-		((num & 0x000000000000ff00L) << 48) |
+		((num & 0x000000000000ff00L) << 40) |
 		(num << 56);
 #endif
 }
@@ -70,4 +81,21 @@ static inline double _mnbt_reverse_double(double val) {
 
 	return out;
 #endif
-}
\ No newline at end of file
+}
+static inline uint16_t _mnbt_load_short(const uint8_t* bytes) {
+	uint16_t num;
+	memcpy(&num, bytes, sizeof(num));
+	return _mnbt_reverse_short(num);
+}
+
+static inline uint32_t _mnbt_load_int(const uint8_t* bytes) {
+	uint32_t num;
+	memcpy(&num, bytes, sizeof(num));
+	return _mnbt_reverse_int(num);
+}
+
+static inline uint64_t _mnbt_load_long(const uint8_t* bytes) {
+	uint64_t num;
+	memcpy(&num, bytes, sizeof(num));
+	return _mnbt_reverse_long(num);
+}
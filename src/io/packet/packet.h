@@ -1,6 +1,7 @@
 #pragma once
 #include "../../main.h"
 #include "../io.h"
+#include "../batch/batch.h"
 #include "../nbt/mnbt.h"
 #include <assert.h>
 
@@ -234,6 +235,41 @@ static inline void pck_write_bytes(pck_packet_t* packet, const byte_t* bytes, in
 
 }
 
+static inline void pck_write_var_shorts(pck_packet_t* packet, const uint16_t* values, size_t count) {
+
+	assert(packet->length - packet->cursor >= count * 3);
+
+	packet->cursor += io_write_var_shorts(packet->bytes + packet->cursor, values, count);
+
+}
+
+static inline void pck_write_var_ints(pck_packet_t* packet, const uint32_t* values, size_t count) {
+
+	assert(packet->length - packet->cursor >= count * 5);
+
+	packet->cursor += io_write_var_ints(packet->bytes + packet->cursor, values, count);
+
+}
+
+/*
+Write values packed into big endian longs, see io_pack_bytes
+*/
+static inline void pck_write_packed_bytes(pck_packet_t* packet, const uint8_t* values, size_t count, uint8_t bits) {
+
+	assert(packet->length - packet->cursor >= io_packed_longs(count, bits) << 3);
+
+	packet->cursor += io_pack_bytes(values, count, bits, packet->bytes + packet->cursor) << 3;
+
+}
+
+static inline void pck_write_packed_shorts(pck_packet_t* packet, const uint16_t* values, size_t count, uint8_t bits) {
+
+	assert(packet->length - packet->cursor >= io_packed_longs(count, bits) << 3);
+
+	packet->cursor += io_pack_shorts(values, count, bits, packet->bytes + packet->cursor) << 3;
+
+}
+
 static inline void pck_write_string(pck_packet_t* packet, const char* string, size_t length) {
 
 	pck_write_var_int(packet, length);
@@ -247,6 +283,30 @@ static inline void pck_write_nbt(pck_packet_t* packet, mnbt_doc* doc) {
 
 }
 
+/*
+Start streaming NBT at the packet cursor, up to the end of the packet, the cursor is moved by pck_end_nbt
+*/
+static inline mnbt_writer pck_begin_nbt(pck_packet_t* packet) {
+
+	return mnbt_new_writer(packet->bytes + packet->cursor, packet->length - packet->cursor);
+
+}
+
+/*
+Returns false if the NBT did not fit in the packet, the cursor is left where it was then
+*/
+static inline bool pck_end_nbt(pck_packet_t* packet, const mnbt_writer* writer) {
+
+	if (writer->overflow) {
+		return false;
+	}
+
+	packet->cursor += writer->length;
+
+	return true;
+
+}
+
 static inline void pck_write_position(pck_packet_t* packet, pck_position_t position) {
 
 	pck_write_int64(packet, ((uint64_t) (position.x & 0x3FFFFFF) << 38) | ((uint64_t) (position.z & 0x3FFFFFF) << 12) | ((uint64_t) position.y & 0xFFF));
@@ -6,9 +6,6 @@
 // TODO keep track of job traffic (increases everytime jobs aren't completed, decreases everytime they are)
 
 // default handler vectors
-UTL_VECTOR_DEFAULT(job_keep_alive_handlers, job_handler_t, 
-	job_handle_keep_alive
-);
 UTL_VECTOR_DEFAULT(job_global_chat_message_handlers, job_handler_t,
 	job_handle_global_chat_message
 );
@@ -53,7 +50,6 @@ UTL_VECTOR_DEFAULT(job_tick_world_handlers, job_handler_t,
 );
 
 UTL_VECTOR_DEFAULT(job_handlers, utl_vector_t*,
-	&job_keep_alive_handlers,
 	&job_global_chat_message_handlers,
 	&job_player_join_handlers,
 	&job_player_leave_handlers,
@@ -4,7 +4,6 @@ typedef struct job_board job_board_t;
 
 typedef enum {
 
-	job_keep_alive,
 	job_global_chat_message,
 	job_player_join,
 	job_player_leave,
@@ -1,4 +1,3 @@
-#include <time.h>
 #include "handlers.h"
 #include "../listening/phd/play.h"
 #include "../io/chat/translation.h"
@@ -6,24 +5,6 @@
 #include "../motor.h"
 #include "../world/entity/living/player/player.h"
 
-bool job_handle_keep_alive(job_payload_t* payload) {
-	
-	// what if the client disconnects by the time this is handled? TODO
-
-	struct timespec time;
-	clock_gettime(CLOCK_REALTIME, &time);
-	const int64_t out_ms = time.tv_sec * 1000 + time.tv_nsec / 0xF4240;
-
-	if (out_ms - ltg_client_get_last_receive(payload->client) >= 30000) {
-		ltg_disconnect(payload->client);
-		return false;
-	} else {
-		phd_send_keep_alive(payload->client, out_ms);
-		return true;
-	}
-
-}
-
 bool job_handle_global_chat_message(job_payload_t* payload) {
 
 	// what if the client disconnects by the time this is handled? TODO
@@ -42,13 +23,12 @@ bool job_handle_global_chat_message(job_payload_t* payload) {
 	char out[1536];
 	const size_t out_len = cht_write_translation(&translation, out);
 
-	const uint32_t online_length = ltg_get_online_length(sky_get_listener());
-	for (uint32_t i = 0; i < online_length; ++i) {
-		ltg_client_t* client = ltg_get_online_client(sky_get_listener(), i);
-		if (client != NULL) {
-			phd_send_chat_message(client, out, out_len, ltg_client_get_uuid(payload->global_chat_message.client));
-		}
+	reg_enter();
+	const reg_snapshot_t* online = ltg_get_online(sky_get_listener());
+	for (uint32_t i = 0; i < online->count; ++i) {
+		phd_send_chat_message(online->clients[i], out, out_len, ltg_client_get_uuid(payload->global_chat_message.client));
 	}
+	reg_exit();
 	cht_term_translation(&translation);
 
 	free(payload->global_chat_message.message.value);
@@ -81,15 +61,17 @@ bool job_handle_player_join(job_payload_t* payload) {
 
 	char out[128];
 	const size_t out_len = cht_write_translation(&translation, out);
-	// lock client vector
-	const uint32_t online_length = ltg_get_online_length(sky_get_listener());
-	for (uint32_t i = 0; i < online_length; ++i) {
-		ltg_client_t* client = ltg_get_online_client(sky_get_listener(), i);
-		if (client != NULL) {
-			phd_send_player_info_add_player(client, payload->client);
-			phd_send_system_chat_message(client, out, out_len);
-		}
+	ltg_blob_t* player_info = phd_create_player_info_add_player(payload->client);
+
+	reg_enter();
+	const reg_snapshot_t* online = ltg_get_online(sky_get_listener());
+	for (uint32_t i = 0; i < online->count; ++i) {
+		ltg_send_blob(online->clients[i], player_info);
+		phd_send_system_chat_message(online->clients[i], out, out_len);
 	}
+	reg_exit();
+
+	ltg_release_blob(player_info);
 
 	cht_term_translation(&translation);
 
@@ -118,14 +100,17 @@ bool job_handle_player_leave(job_payload_t* payload) {
 	char out[128];
 	const size_t out_len = cht_write_translation(&translation, out);
 	
-	const uint32_t online_length = ltg_get_online_length(sky_get_listener());
-	for (uint32_t i = 0; i < online_length; ++i) {
-		ltg_client_t* client = ltg_get_online_client(sky_get_listener(), i);
-		if (client != NULL) {
-			phd_send_player_info_remove_player(client, payload->player_leave.uuid);
-			phd_send_system_chat_message(client, out, out_len);
-		}
+	ltg_blob_t* player_info = phd_create_player_info_remove_player(payload->player_leave.uuid);
+
+	reg_enter();
+	const reg_snapshot_t* online = ltg_get_online(sky_get_listener());
+	for (uint32_t i = 0; i < online->count; ++i) {
+		ltg_send_blob(online->clients[i], player_info);
+		phd_send_system_chat_message(online->clients[i], out, out_len);
 	}
+	reg_exit();
+
+	ltg_release_blob(player_info);
 
 	cht_term_translation(&translation);
 
@@ -135,14 +120,21 @@ bool job_handle_player_leave(job_payload_t* payload) {
 
 bool job_handle_send_update_pings(__attribute__((unused)) job_payload_t* payload) {
 
-	const uint32_t online_length = ltg_get_online_length(sky_get_listener());
-	for (uint32_t i = 0; i < online_length; ++i) {
-		ltg_client_t* client = ltg_get_online_client(sky_get_listener(), i);
-		if (client != NULL) {
-			phd_send_player_info_update_latency(client);
+	reg_enter();
+
+	const reg_snapshot_t* online = ltg_get_online(sky_get_listener());
+
+	// one packet with only the pings that changed, shared by everyone
+	ltg_blob_t* latency = phd_create_player_info_update_latency(online);
+	if (latency != NULL) {
+		for (uint32_t i = 0; i < online->count; ++i) {
+			ltg_send_blob(online->clients[i], latency);
 		}
+		ltg_release_blob(latency);
 	}
 
+	reg_exit();
+
 	return true;
 
 }
@@ -152,6 +144,7 @@ bool job_handle_tick_region(job_payload_t* payload) {
 	// TODO what if this region is unloaded by the time this is handled?
 
 	const mat_dimension_t* dimension = mat_get_dimension_by_type(wld_get_environment(wld_region_get_world(payload->region)));
+	const uint8_t random_tick_speed = wld_get_random_tick_speed(wld_region_get_world(payload->region));
 	
 	for (uint32_t i = 0; i < 32 * 32; ++i) {
 
@@ -183,6 +176,7 @@ bool job_handle_tick_region(job_payload_t* payload) {
 
 			if (wld_chunk_get_ticket(chunk) <= WLD_TICKET_TICK) {
 				// tick
+				upd_random_tick_chunk(chunk, random_tick_speed);
 			}
 
 			if (wld_chunk_get_ticket(chunk) <= WLD_TICKET_BORDER) {
@@ -191,6 +185,12 @@ bool job_handle_tick_region(job_payload_t* payload) {
 		}
 	}
 
+	// block updates
+	upd_tick_region(payload->region);
+
+	// everything that changed this tick
+	wld_send_region_changes(payload->region);
+
 	return true;
 
 }
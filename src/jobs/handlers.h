@@ -2,7 +2,6 @@
 #include "../main.h"
 #include "board.h"
 
-extern bool job_handle_keep_alive(job_payload_t* payload);
 extern bool job_handle_global_chat_message(job_payload_t* payload);
 extern bool job_handle_player_join(job_payload_t* payload);
 extern bool job_handle_player_leave(job_payload_t* payload);
@@ -0,0 +1,393 @@
+#include <curl/curl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include "auth.h"
+#include "../listening.h"
+#include "../../util/util.h"
+#include "../../util/lock_util.h"
+#include "../../io/logger/logger.h"
+
+typedef struct ath_request ath_request_t;
+
+struct ath_request {
+
+	ath_request_t* next;
+
+	CURL* curl;
+
+	ltg_client_t* client;
+
+	string_t response;
+	ath_result_t result;
+
+	bool canceled;
+
+};
+
+static struct {
+
+	pthread_t thread;
+
+	// guards the request lists and the settings
+	pthread_mutex_t lock;
+
+	// signalled when a request finishes or is cancelled
+	pthread_cond_t finished_wait;
+
+	CURLM* multi;
+
+	// waiting to be added to the multi handle by the auth thread
+	ath_request_t* submitted;
+	ath_request_t* active;
+
+	// done, waiting to be taken by the client's thread
+	ath_request_t* finished;
+
+	char base_url[ATH_MAX_BASE_URL];
+	uint32_t timeout;
+
+	_Atomic bool running;
+
+} ath = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.finished_wait = PTHREAD_COND_INITIALIZER,
+	.multi = NULL,
+	.submitted = NULL,
+	.active = NULL,
+	.finished = NULL,
+	.base_url = ATH_DEFAULT_BASE_URL,
+	.timeout = ATH_DEFAULT_TIMEOUT,
+	.running = false
+};
+
+static size_t ath_write(void* ptr, size_t size, size_t nmemb, string_t* response) {
+
+	const size_t new_length = response->length + size * nmemb;
+	response->value = realloc(response->value, new_length + 1);
+
+	memcpy(response->value + response->length, ptr, size * nmemb);
+	response->value[new_length] = '\0';
+	response->length = new_length;
+
+	return size * nmemb;
+
+}
+
+static void ath_free_request(ath_request_t* request) {
+
+	curl_easy_cleanup(request->curl);
+	free(request->response.value);
+	free(request);
+
+}
+
+// unlink a request from a list, the auth lock has to be held
+static void ath_unlink(ath_request_t** list, ath_request_t* request) {
+
+	for (ath_request_t** node = list; *node != NULL; node = &(*node)->next) {
+		if (*node == request) {
+			*node = request->next;
+			return;
+		}
+	}
+
+}
+
+// hand the result to the client's thread, nothing that can take long happens here
+static void ath_finish(ath_request_t* request, CURLcode code) {
+
+	request->result = (ath_result_t) {
+		.status = ath_failed,
+		.http_code = 0,
+		.body = request->response
+	};
+
+	if (code == CURLE_OK) {
+		curl_easy_getinfo(request->curl, CURLINFO_RESPONSE_CODE, &request->result.http_code);
+		request->result.status = request->result.http_code == 200 ? ath_ok : ath_invalid;
+	} else {
+		log_error("Could not authenticate client: %s", curl_easy_strerror(code));
+	}
+
+	curl_easy_cleanup(request->curl);
+	request->curl = NULL;
+
+	bool canceled = false;
+
+	with_lock (&ath.lock) {
+
+		ath_unlink(&ath.active, request);
+
+		canceled = request->canceled;
+		if (!canceled) {
+			request->next = ath.finished;
+			ath.finished = request;
+			pthread_cond_broadcast(&ath.finished_wait);
+		}
+
+	}
+
+	if (canceled) {
+		ath_free_request(request);
+	}
+
+}
+
+static void* t_ath_run(__attribute__((unused)) void* args) {
+
+	while (ath.running) {
+
+		// only this thread touches the multi handle
+		with_lock (&ath.lock) {
+			while (ath.submitted != NULL) {
+				ath_request_t* request = ath.submitted;
+				ath.submitted = request->next;
+				request->next = ath.active;
+				ath.active = request;
+				curl_multi_add_handle(ath.multi, request->curl);
+			}
+		}
+
+		int running = 0;
+		curl_multi_perform(ath.multi, &running);
+
+		CURLMsg* message;
+		int left = 0;
+		while ((message = curl_multi_info_read(ath.multi, &left)) != NULL) {
+
+			if (message->msg != CURLMSG_DONE) {
+				continue;
+			}
+
+			ath_request_t* request = NULL;
+			const CURLcode code = message->data.result;
+			curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, (char**) &request);
+			curl_multi_remove_handle(ath.multi, request->curl);
+
+			ath_finish(request, code);
+
+		}
+
+		curl_multi_poll(ath.multi, NULL, 0, 1000, NULL);
+
+	}
+
+	return NULL;
+
+}
+
+void ath_init() {
+
+	if (ath.running) {
+		return;
+	}
+
+	ath.multi = curl_multi_init();
+	ath.running = true;
+
+	pthread_create(&ath.thread, NULL, t_ath_run, NULL);
+
+}
+
+void ath_term() {
+
+	if (!ath.running) {
+		return;
+	}
+
+	ath.running = false;
+	curl_multi_wakeup(ath.multi);
+	pthread_join(ath.thread, NULL);
+
+	// whatever is left never gets an answer
+	while (ath.active != NULL) {
+		ath_request_t* request = ath.active;
+		ath.active = request->next;
+		curl_multi_remove_handle(ath.multi, request->curl);
+		ath_free_request(request);
+	}
+	while (ath.submitted != NULL) {
+		ath_request_t* request = ath.submitted;
+		ath.submitted = request->next;
+		ath_free_request(request);
+	}
+	while (ath.finished != NULL) {
+		ath_request_t* request = ath.finished;
+		ath.finished = request->next;
+		ath_free_request(request);
+	}
+
+	// nobody waits for the ones that are gone
+	with_lock (&ath.lock) {
+		pthread_cond_broadcast(&ath.finished_wait);
+	}
+
+	curl_multi_cleanup(ath.multi);
+	ath.multi = NULL;
+
+}
+
+void ath_set_base_url(const char* url) {
+
+	with_lock (&ath.lock) {
+		snprintf(ath.base_url, ATH_MAX_BASE_URL, "%s", url);
+	}
+
+}
+
+void ath_set_timeout(uint32_t millis) {
+
+	with_lock (&ath.lock) {
+		ath.timeout = millis;
+	}
+
+}
+
+bool ath_has_joined(ltg_client_t* client, const char* username, const char* server_id) {
+
+	if (!ath.running) {
+		return false;
+	}
+
+	ath_request_t* request = calloc(1, sizeof(ath_request_t));
+	request->client = client;
+
+	request->curl = curl_easy_init();
+	if (request->curl == NULL) {
+		log_error("Failed to initialize cURL");
+		free(request);
+		return false;
+	}
+
+	// both come from the client
+	char* escaped_username = curl_easy_escape(request->curl, username, 0);
+	char* escaped_server_id = curl_easy_escape(request->curl, server_id, 0);
+	if (escaped_username == NULL || escaped_server_id == NULL) {
+		curl_free(escaped_username);
+		curl_free(escaped_server_id);
+		ath_free_request(request);
+		return false;
+	}
+
+	request->response.value = malloc(1);
+	request->response.value[0] = '\0';
+
+	with_lock (&ath.lock) {
+
+		// escaping can triple the length
+		char url[ATH_MAX_BASE_URL + 256];
+		snprintf(url, sizeof(url), "%s/session/minecraft/hasJoined?username=%s&serverId=%s", ath.base_url, escaped_username, escaped_server_id);
+
+		curl_easy_setopt(request->curl, CURLOPT_URL, url);
+		curl_easy_setopt(request->curl, CURLOPT_TIMEOUT_MS, (long) ath.timeout);
+		curl_easy_setopt(request->curl, CURLOPT_CONNECTTIMEOUT_MS, (long) ath.timeout);
+
+		curl_easy_setopt(request->curl, CURLOPT_TCP_FASTOPEN, 1L);
+		curl_easy_setopt(request->curl, CURLOPT_IPRESOLVE, CURL_IPRESOLVE_V4);
+		curl_easy_setopt(request->curl, CURLOPT_NOSIGNAL, 1L);
+		curl_easy_setopt(request->curl, CURLOPT_WRITEFUNCTION, ath_write);
+		curl_easy_setopt(request->curl, CURLOPT_WRITEDATA, &request->response);
+		curl_easy_setopt(request->curl, CURLOPT_PRIVATE, request);
+
+		request->next = ath.submitted;
+		ath.submitted = request;
+
+	}
+
+	curl_free(escaped_username);
+	curl_free(escaped_server_id);
+
+	curl_multi_wakeup(ath.multi);
+
+	return true;
+
+}
+
+// a finished request of the client, unlinked, the auth lock has to be held
+static ath_request_t* ath_take_finished(ltg_client_t* client) {
+
+	for (ath_request_t** node = &ath.finished; *node != NULL; node = &(*node)->next) {
+		ath_request_t* request = *node;
+		if (request->client == client) {
+			*node = request->next;
+			return request;
+		}
+	}
+
+	return NULL;
+
+}
+
+// if the client still has a request on the way, the auth lock has to be held
+static bool ath_is_pending(ltg_client_t* client) {
+
+	for (ath_request_t* request = ath.submitted; request != NULL; request = request->next) {
+		if (request->client == client && !request->canceled) {
+			return true;
+		}
+	}
+	for (ath_request_t* request = ath.active; request != NULL; request = request->next) {
+		if (request->client == client && !request->canceled) {
+			return true;
+		}
+	}
+
+	return false;
+
+}
+
+bool ath_wait(ltg_client_t* client, ath_callback_t callback) {
+
+	ath_request_t* request = NULL;
+
+	with_lock (&ath.lock) {
+		for (;;) {
+			request = ath_take_finished(client);
+			if (request != NULL || !ath.running || !ath_is_pending(client)) {
+				break;
+			}
+			pthread_cond_wait(&ath.finished_wait, &ath.lock);
+		}
+	}
+
+	if (request == NULL) {
+		return false;
+	}
+
+	const bool ok = callback(client, &request->result);
+	ath_free_request(request);
+
+	return ok;
+
+}
+
+void ath_cancel(ltg_client_t* client) {
+
+	ath_request_t* finished = NULL;
+
+	with_lock (&ath.lock) {
+		for (ath_request_t* request = ath.submitted; request != NULL; request = request->next) {
+			if (request->client == client) {
+				request->canceled = true;
+			}
+		}
+		for (ath_request_t* request = ath.active; request != NULL; request = request->next) {
+			if (request->client == client) {
+				request->canceled = true;
+			}
+		}
+		ath_request_t* request;
+		while ((request = ath_take_finished(client)) != NULL) {
+			request->next = finished;
+			finished = request;
+		}
+		pthread_cond_broadcast(&ath.finished_wait);
+	}
+
+	while (finished != NULL) {
+		ath_request_t* request = finished;
+		finished = request->next;
+		ath_free_request(request);
+	}
+
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "../../main.h"
+#include "../listening.d.h"
+
+/*
+	Session server authentication
+
+	hasJoined requests run concurrently on a curl multi handle on the auth thread, which only
+	hands the results back. The client's own thread waits for its result and continues the login,
+	so nothing slow ever runs on the auth thread.
+
+	Results are never cached, the server id is new for every connection and only the session
+	server can tell whether the client behind it really joined.
+*/
+
+#define ATH_DEFAULT_BASE_URL "https://sessionserver.mojang.com"
+#define ATH_DEFAULT_TIMEOUT 10000 // milliseconds
+#define ATH_MAX_BASE_URL 256
+
+typedef enum {
+
+	ath_ok = 0, // session is valid, `body` has the profile
+	ath_invalid = 1, // the session server did not know the session
+	ath_failed = 2 // the request failed or timed out
+
+} ath_status_t;
+
+typedef struct {
+
+	ath_status_t status;
+
+	long http_code;
+
+	// only valid during the callback
+	string_t body;
+
+} ath_result_t;
+
+/*
+Called by ath_wait on the thread waiting for the result
+*/
+typedef bool (*ath_callback_t) (ltg_client_t* client, const ath_result_t* result);
+
+extern void ath_init();
+extern void ath_term();
+
+extern void ath_set_base_url(const char* url);
+extern void ath_set_timeout(uint32_t millis);
+
+/*
+Ask the session server if `username` joined `server_id`
+Returns false if the request could not be started
+*/
+extern bool ath_has_joined(ltg_client_t* client, const char* username, const char* server_id);
+
+/*
+Wait for the result of a client's request and run the callback with it on this thread
+Returns false if the request was cancelled, or the result of the callback
+*/
+extern bool ath_wait(ltg_client_t* client, ath_callback_t callback);
+
+/*
+Drop all requests of a client and wake up whoever is waiting for them, the callback will not run
+*/
+extern void ath_cancel(ltg_client_t* client);
@@ -0,0 +1,272 @@
+#include <libdeflate.h>
+#include <string.h>
+#include <time.h>
+#include "compression.h"
+#include "../../motor.h"
+
+static cmp_policy_t cmp_policies[CMP_CLASS_COUNT] = {
+	[cmp_chunk] = { .level = 6, .min_level = 1, .threshold = 0 },
+	// entity deltas are tiny and sent often, barely worth the effort
+	[cmp_entity] = { .level = 1, .min_level = 0, .threshold = 512 },
+	[cmp_chat] = { .level = 6, .min_level = 1, .threshold = 0 },
+	// compresses really well, but past 6 deflate only gets slower on these
+	[cmp_bulk] = { .level = 6, .min_level = 4, .threshold = 0 },
+	[cmp_other] = { .level = 6, .min_level = 1, .threshold = 0 }
+};
+
+static struct {
+
+	_Atomic uint64_t packets;
+	_Atomic uint64_t skipped;
+	_Atomic uint64_t bytes_in;
+	_Atomic uint64_t bytes_out;
+	_Atomic uint64_t nanos;
+
+} cmp_stats[CMP_CLASS_COUNT];
+
+static _Atomic uint8_t cmp_pressure = 0;
+
+// nanoseconds spent compressing since the last tick
+static _Atomic uint64_t cmp_tick_nanos = 0;
+
+// ticks in a row that stayed well under budget
+static uint32_t cmp_calm_ticks = 0;
+
+static inline uint64_t cmp_nanos() {
+
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return sky_to_nanos(time);
+
+}
+
+cmp_class_t cmp_classify(ltg_client_state_t state, const byte_t* bytes, size_t length) {
+
+	if (state != ltg_play || length == 0) {
+		return cmp_other;
+	}
+
+	// every play packet id fits in a single var int byte
+	switch (bytes[0]) {
+		case 0x22: // chunk data and update light
+		case 0x25: // update light
+			return cmp_chunk;
+		case 0x04: // spawn player
+		case 0x1b: // entity status
+		case 0x29: // entity position
+		case 0x2a: // entity position and rotation
+		case 0x2b: // entity rotation
+		case 0x3a: // destroy entities
+		case 0x3e: // entity head look
+		case 0x62: // entity teleport
+			return cmp_entity;
+		case 0x0f: // chat message
+		case 0x1a: // disconnect
+		case 0x35: // death combat event
+			return cmp_chat;
+		case 0x12: // declare commands
+		case 0x14: // window items
+		case 0x26: // join game
+		case 0x36: // player info
+		case 0x39: // unlock recipes
+		case 0x66: // declare recipes
+		case 0x67: // tags
+			return cmp_bulk;
+		default:
+			return cmp_other;
+	}
+
+}
+
+cmp_policy_t cmp_get_policy(cmp_class_t class) {
+	return cmp_policies[class];
+}
+
+void cmp_set_policy(cmp_class_t class, cmp_policy_t policy) {
+
+	policy.level = UTL_MIN(policy.level, CMP_MAX_LEVEL);
+	policy.min_level = UTL_MIN(policy.min_level, policy.level);
+
+	cmp_policies[class] = policy;
+
+}
+
+uint8_t cmp_get_level(cmp_class_t class, size_t length, size_t threshold) {
+
+	const cmp_policy_t policy = cmp_policies[class];
+	const uint8_t pressure = cmp_pressure;
+
+	// small packets are the first to go uncompressed under pressure
+	const size_t minimum = threshold > policy.threshold ? threshold : policy.threshold;
+	if (length < minimum * (pressure + 1)) {
+		return 0;
+	}
+
+	if (policy.level <= pressure) {
+		return policy.min_level;
+	}
+
+	return UTL_MAX(policy.level - pressure, policy.min_level);
+
+}
+
+bool cmp_is_incompressible(const byte_t* bytes, size_t length) {
+
+	if (length < CMP_PROBE_LENGTH) {
+		return false;
+	}
+
+	// 512 bytes spread over the payload, random data shows ~221 distinct values
+	// while anything deflate can shrink by a useful amount stays well below 200
+	uint64_t seen[4] = { 0, 0, 0, 0 };
+	const size_t stride = length / 512;
+
+	for (size_t i = 0; i < 512; ++i) {
+		const byte_t byte = bytes[i * stride];
+		seen[byte >> 6] |= (uint64_t) 1 << (byte & 0x3F);
+	}
+
+	const uint32_t distinct = __builtin_popcountll(seen[0]) + __builtin_popcountll(seen[1]) + __builtin_popcountll(seen[2]) + __builtin_popcountll(seen[3]);
+
+	return distinct > 200;
+
+}
+
+static inline void cmp_record(cmp_class_t class, size_t in, size_t out, uint64_t nanos, bool skipped) {
+
+	cmp_stats[class].packets += 1;
+	cmp_stats[class].skipped += skipped;
+	cmp_stats[class].bytes_in += in;
+	cmp_stats[class].bytes_out += out;
+	cmp_stats[class].nanos += nanos;
+
+	cmp_tick_nanos += nanos;
+
+}
+
+static struct libdeflate_compressor* cmp_get_compressor(cmp_compressors_t* compressors, uint8_t level) {
+
+	for (uint8_t i = 0; i < CMP_COMPRESSOR_SLOTS; ++i) {
+		if (compressors->compressor[i] != NULL && compressors->level[i] == level) {
+			compressors->last = i;
+			return compressors->compressor[i];
+		}
+	}
+
+	// an empty slot, otherwise the one after the last used
+	uint8_t slot = (compressors->last + 1) % CMP_COMPRESSOR_SLOTS;
+	for (uint8_t i = 0; i < CMP_COMPRESSOR_SLOTS; ++i) {
+		if (compressors->compressor[i] == NULL) {
+			slot = i;
+			break;
+		}
+	}
+
+	libdeflate_free_compressor(compressors->compressor[slot]);
+	compressors->compressor[slot] = libdeflate_alloc_compressor(level);
+	compressors->level[slot] = level;
+	compressors->last = slot;
+
+	return compressors->compressor[slot];
+
+}
+
+size_t cmp_compress(cmp_compressors_t* compressors, cmp_class_t class, const byte_t* bytes, size_t length, size_t threshold, byte_t* out) {
+
+	const uint8_t level = cmp_get_level(class, length, threshold);
+
+	if (level == 0) {
+		cmp_record(class, length, length, 0, true);
+		return 0;
+	}
+
+	const uint64_t start = cmp_nanos();
+
+	if (cmp_is_incompressible(bytes, length)) {
+		cmp_record(class, length, length, cmp_nanos() - start, true);
+		return 0;
+	}
+
+	struct libdeflate_compressor* compressor = cmp_get_compressor(compressors, level);
+
+	if (compressor == NULL) {
+		cmp_record(class, length, length, cmp_nanos() - start, true);
+		return 0;
+	}
+
+	// libdeflate gives up and returns 0 when the result would not fit in `length` bytes
+	const size_t compressed_length = libdeflate_zlib_compress(compressor, bytes, length, out, length);
+
+	cmp_record(class, length, compressed_length == 0 ? length : compressed_length, cmp_nanos() - start, compressed_length == 0);
+
+	return compressed_length;
+
+}
+
+void cmp_free_compressors(cmp_compressors_t* compressors) {
+
+	for (uint32_t i = 0; i < CMP_COMPRESSOR_SLOTS; ++i) {
+		libdeflate_free_compressor(compressors->compressor[i]);
+		compressors->compressor[i] = NULL;
+	}
+
+}
+
+void cmp_tick(uint64_t behind) {
+
+	const uint64_t spent = atomic_exchange(&cmp_tick_nanos, 0);
+	const uint8_t pressure = cmp_pressure;
+
+	if (behind > 0 || spent > CMP_TICK_BUDGET) {
+
+		// react quickly when over budget
+		cmp_calm_ticks = 0;
+		if (pressure < CMP_MAX_PRESSURE) {
+			cmp_pressure = pressure + 1;
+		}
+
+	} else if (spent < CMP_TICK_BUDGET / 2 && pressure > 0) {
+
+		// but only back off after a second of quiet
+		if (++cmp_calm_ticks >= 20) {
+			cmp_calm_ticks = 0;
+			cmp_pressure = pressure - 1;
+		}
+
+	}
+
+}
+
+uint8_t cmp_get_pressure() {
+	return cmp_pressure;
+}
+
+void cmp_set_pressure(uint8_t pressure) {
+	cmp_pressure = UTL_MIN(pressure, CMP_MAX_PRESSURE);
+	cmp_calm_ticks = 0;
+}
+
+cmp_stats_t cmp_get_stats(cmp_class_t class) {
+
+	return (cmp_stats_t) {
+		.packets = cmp_stats[class].packets,
+		.skipped = cmp_stats[class].skipped,
+		.bytes_in = cmp_stats[class].bytes_in,
+		.bytes_out = cmp_stats[class].bytes_out,
+		.nanos = cmp_stats[class].nanos
+	};
+
+}
+
+void cmp_reset_stats() {
+
+	for (uint32_t i = 0; i < CMP_CLASS_COUNT; ++i) {
+		cmp_stats[i].packets = 0;
+		cmp_stats[i].skipped = 0;
+		cmp_stats[i].bytes_in = 0;
+		cmp_stats[i].bytes_out = 0;
+		cmp_stats[i].nanos = 0;
+	}
+
+}
@@ -0,0 +1,121 @@
+#pragma once
+#include "../../main.h"
+#include "../listening.d.h"
+
+/*
+	Compression policy for outbound packets
+
+	Packets are put into classes by their id, every class has its own deflate level and
+	threshold. When ticks run late or compression eats too much of a tick the pressure goes up,
+	which lowers levels and raises thresholds until things calm down again
+*/
+
+typedef enum {
+
+	cmp_chunk = 0, // chunk data, light
+	cmp_entity = 1, // entity movement, spawns and despawns
+	cmp_chat = 2, // chat, disconnects, death messages
+	cmp_bulk = 3, // join game, tags, recipes, commands, player info
+	cmp_other = 4
+
+} cmp_class_t;
+
+#define CMP_CLASS_COUNT 5
+
+// highest level we ever pick, libdeflate goes up to 12 but the last few are not worth it
+#define CMP_MAX_LEVEL 9
+
+#define CMP_MAX_PRESSURE 8
+
+// compression can use this much of a tick before the pressure goes up
+#define CMP_TICK_BUDGET (SKY_NANOS_PER_TICK / 4)
+
+// payloads this large are sampled before compressing them
+#define CMP_PROBE_LENGTH 1024
+
+typedef struct {
+
+	// level with no pressure
+	uint8_t level;
+
+	// lowest level under pressure, 0 means the class is sent uncompressed at that point
+	uint8_t min_level;
+
+	// smallest payload worth compressing, the network threshold still applies
+	uint16_t threshold;
+
+} cmp_policy_t;
+
+typedef struct {
+
+	uint64_t packets;
+
+	// packets sent uncompressed because of the policy, the probe or because deflate did not help
+	uint64_t skipped;
+
+	uint64_t bytes_in;
+	uint64_t bytes_out;
+
+	uint64_t nanos;
+
+} cmp_stats_t;
+
+// compressors kept per client, a compressor of the highest level takes about a megabyte
+#define CMP_COMPRESSOR_SLOTS 2
+
+#define CMP_COMPRESSORS_INITIALIZER (cmp_compressors_t) { .compressor = { NULL } }
+
+// compressors of a client, libdeflate fixes the level on allocation so a level change replaces the one used least recently
+typedef struct {
+
+	struct libdeflate_compressor* compressor[CMP_COMPRESSOR_SLOTS];
+	uint8_t level[CMP_COMPRESSOR_SLOTS];
+
+	// slot used last
+	uint8_t last;
+
+} cmp_compressors_t;
+
+extern cmp_class_t cmp_classify(ltg_client_state_t state, const byte_t* bytes, size_t length);
+
+extern cmp_policy_t cmp_get_policy(cmp_class_t class);
+extern void cmp_set_policy(cmp_class_t class, cmp_policy_t policy);
+
+/*
+Level to use for a payload of `length` bytes right now, 0 if it should not be compressed
+*/
+extern uint8_t cmp_get_level(cmp_class_t class, size_t length, size_t threshold);
+
+/*
+Cheap check for payloads deflate can't do anything with (already compressed or random data)
+*/
+extern bool cmp_is_incompressible(const byte_t* bytes, size_t length);
+
+/*
+Compress `length` bytes into `out` following the policy of `class`
+`out` needs room for `length` bytes, returns the compressed length or 0 if the packet should be sent uncompressed
+*/
+extern size_t cmp_compress(cmp_compressors_t* compressors, cmp_class_t class, const byte_t* bytes, size_t length, size_t threshold, byte_t* out);
+
+extern void cmp_free_compressors(cmp_compressors_t* compressors);
+
+/*
+Called once per tick with how far behind the server is, adjusts the pressure
+*/
+extern void cmp_tick(uint64_t behind);
+
+extern uint8_t cmp_get_pressure();
+extern void cmp_set_pressure(uint8_t pressure);
+
+extern cmp_stats_t cmp_get_stats(cmp_class_t class);
+extern void cmp_reset_stats();
+
+static inline float cmp_get_ratio(const cmp_stats_t* stats) {
+
+	if (stats->bytes_in == 0) {
+		return 1;
+	}
+
+	return (float) stats->bytes_out / stats->bytes_in;
+
+}
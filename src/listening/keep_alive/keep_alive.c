@@ -0,0 +1,235 @@
+#include <pthread.h>
+#include <time.h>
+#include "keep_alive.h"
+#include "../listening.h"
+#include "../phd/play.h"
+#include "../../motor.h"
+#include "../../util/lock_util.h"
+#include "../../util/vector.h"
+
+static struct {
+
+	pthread_t thread;
+
+	// guards the slots and the links of every client in them
+	pthread_mutex_t lock;
+
+	ltg_client_t* slots[KAL_SLOTS];
+
+	_Atomic uint64_t tick;
+	_Atomic uint32_t count;
+
+	_Atomic bool running;
+
+} kal = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.tick = 0,
+	.count = 0,
+	.running = false
+};
+
+static inline int64_t kal_millis() {
+
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return time.tv_sec * 1000 + time.tv_nsec / 1000000;
+
+}
+
+// the wheel lock has to be held
+static void kal_unlink(ltg_client_t* client) {
+
+	if (client->keep_alive.previous != NULL) {
+		client->keep_alive.previous->keep_alive.next = client->keep_alive.next;
+	} else {
+		kal.slots[client->keep_alive.slot] = client->keep_alive.next;
+	}
+
+	if (client->keep_alive.next != NULL) {
+		client->keep_alive.next->keep_alive.previous = client->keep_alive.previous;
+	}
+
+	client->keep_alive.previous = NULL;
+	client->keep_alive.next = NULL;
+	client->keep_alive.linked = false;
+
+	kal.count -= 1;
+
+}
+
+static void* t_kal_run(__attribute__((unused)) void* args) {
+
+	struct timespec next;
+	clock_gettime(CLOCK_MONOTONIC, &next);
+
+	while (kal.running) {
+
+		next.tv_nsec += SKY_NANOS_PER_TICK;
+		if (next.tv_nsec >= SKY_NANOS_PER_SECOND) {
+			next.tv_nsec -= SKY_NANOS_PER_SECOND;
+			next.tv_sec += 1;
+		}
+
+		struct timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+
+		if (sky_to_nanos(now) < sky_to_nanos(next)) {
+			const uint64_t left = sky_to_nanos(next) - sky_to_nanos(now);
+			const struct timespec sleep = { .tv_sec = left / SKY_NANOS_PER_SECOND, .tv_nsec = left % SKY_NANOS_PER_SECOND };
+			nanosleep(&sleep, NULL);
+		} else if (sky_to_nanos(now) - sky_to_nanos(next) > SKY_NANOS_PER_SECOND) {
+			// way behind, don't try to catch up on every missed tick
+			next = now;
+		}
+
+		kal_tick();
+
+	}
+
+	return NULL;
+
+}
+
+void kal_init() {
+
+	if (kal.running) {
+		return;
+	}
+
+	kal.running = true;
+
+	pthread_create(&kal.thread, NULL, t_kal_run, NULL);
+
+}
+
+void kal_term() {
+
+	if (!kal.running) {
+		return;
+	}
+
+	kal.running = false;
+	pthread_join(kal.thread, NULL);
+
+}
+
+void kal_add(ltg_client_t* client) {
+
+	with_lock (&kal.lock) {
+
+		if (!client->keep_alive.linked) {
+
+			// the current slot comes up again in KAL_SLOTS ticks
+			const uint16_t slot = kal.tick % KAL_SLOTS;
+
+			client->keep_alive.outstanding = 0;
+			client->keep_alive.answered = kal.tick;
+			client->keep_alive.slot = slot;
+			client->keep_alive.previous = NULL;
+			client->keep_alive.next = kal.slots[slot];
+			client->keep_alive.linked = true;
+
+			if (kal.slots[slot] != NULL) {
+				kal.slots[slot]->keep_alive.previous = client;
+			}
+			kal.slots[slot] = client;
+
+			kal.count += 1;
+
+		}
+
+	}
+
+}
+
+void kal_remove(ltg_client_t* client) {
+
+	with_lock (&kal.lock) {
+		if (client->keep_alive.linked) {
+			kal_unlink(client);
+		}
+	}
+
+}
+
+bool kal_receive(ltg_client_t* client, int64_t id) {
+
+	// only the last keep alive counts and only once, an old id would let the client fake its ping
+	int64_t outstanding = id;
+	if (id <= 0 || !atomic_compare_exchange_strong(&client->keep_alive.outstanding, &outstanding, 0)) {
+		return false;
+	}
+
+	client->keep_alive.answered = kal.tick;
+
+	const int64_t sample = kal_millis() - id;
+	const int64_t ping = ltg_client_get_ping(client);
+
+	ltg_client_set_ping(client, ping == 0 ? sample : (ping * (KAL_PING_WEIGHT - 1) + sample) / KAL_PING_WEIGHT);
+
+	return true;
+
+}
+
+void kal_tick() {
+
+	const int64_t id = kal_millis();
+
+	// sending can block, so the clients that are due are only picked under the lock
+	utl_vector_t due = UTL_VECTOR_INITIALIZER(ltg_client_t*);
+	utl_vector_t timed_out = UTL_VECTOR_INITIALIZER(ltg_client_t*);
+
+	// entered before letting go of the lock, so a client that is removed now isn't freed before we're done
+	reg_enter();
+
+	with_lock (&kal.lock) {
+
+		const uint64_t tick = ++kal.tick;
+
+		ltg_client_t* next = NULL;
+		for (ltg_client_t* client = kal.slots[tick % KAL_SLOTS]; client != NULL; client = next) {
+
+			next = client->keep_alive.next;
+
+			if (tick - client->keep_alive.answered >= KAL_TIMEOUT) {
+				kal_unlink(client);
+				utl_vector_push(&timed_out, &client);
+				continue;
+			}
+
+			client->keep_alive.outstanding = id;
+			utl_vector_push(&due, &client);
+
+		}
+
+	}
+
+	// the client thread does the rest once its socket is shut down
+	for (uint32_t i = 0; i < timed_out.size; ++i) {
+		ltg_disconnect(UTL_VECTOR_GET_AS(ltg_client_t*, &timed_out, i));
+	}
+
+	// everyone due this tick gets the same packet
+	if (due.size != 0) {
+
+		ltg_blob_t* keep_alive = phd_create_keep_alive(id);
+
+		for (uint32_t i = 0; i < due.size; ++i) {
+			ltg_send_blob(UTL_VECTOR_GET_AS(ltg_client_t*, &due, i), keep_alive);
+		}
+
+		ltg_release_blob(keep_alive);
+
+	}
+
+	reg_exit();
+
+	utl_term_vector(&due);
+	utl_term_vector(&timed_out);
+
+}
+
+uint32_t kal_get_count() {
+	return kal.count;
+}
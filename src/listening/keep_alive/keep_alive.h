@@ -0,0 +1,43 @@
+#pragma once
+#include "../../main.h"
+#include "../listening.d.h"
+
+/*
+	Keep alive wheel
+
+	Play clients hang in one of KAL_SLOTS slots, one slot comes up every tick and everyone in it
+	gets the same keep alive, so a tick only touches the clients that are due. Clients that did
+	not answer for KAL_TIMEOUT ticks get disconnected
+*/
+
+#define KAL_SLOTS 200 // ticks between keep alives
+#define KAL_TIMEOUT 600 // ticks without an answer before a client is dropped
+
+// round trip times are smoothed over the last few answers
+#define KAL_PING_WEIGHT 4
+
+extern void kal_init();
+extern void kal_term();
+
+/*
+Start keeping `client` alive, the first keep alive goes out KAL_SLOTS ticks from now
+*/
+extern void kal_add(ltg_client_t* client);
+
+/*
+Stop keeping `client` alive, once this returns the wheel picks it no more
+A tick that already picked it sends inside a read section, so it is only safe to free after `reg_synchronize`
+*/
+extern void kal_remove(ltg_client_t* client);
+
+/*
+Handle an answer to keep alive `id`, returns false unless it is the last one sent and was not answered yet
+*/
+extern bool kal_receive(ltg_client_t* client, int64_t id);
+
+/*
+Advance the wheel by one tick, the keep alive thread calls this on its own
+*/
+extern void kal_tick();
+
+extern uint32_t kal_get_count();
@@ -0,0 +1,77 @@
+#include <string.h>
+#include <time.h>
+#include "limiter.h"
+#include "../../motor.h"
+#include "../../util/lock_util.h"
+
+static inline uint64_t lim_nanos() {
+
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return sky_to_nanos(time);
+
+}
+
+bool lim_take(lim_limiter_t* limiter, uint32_t address) {
+
+	const uint64_t now = lim_nanos();
+
+	// fibonacci hashing, neighbouring addresses end up in different sets
+	lim_bucket_t* set = limiter->buckets[(uint32_t) (address * 0x9E3779B1u) >> (32 - __builtin_ctz(LIM_SETS))];
+
+	bool allowed = false;
+
+	with_lock (&limiter->lock) {
+
+		const uint64_t interval = SKY_NANOS_PER_SECOND / limiter->rate;
+
+		lim_bucket_t* bucket = NULL;
+		lim_bucket_t* idle = &set[0];
+
+		for (uint32_t i = 0; i < LIM_WAYS; ++i) {
+			if (set[i].full != 0 && set[i].address == address) {
+				bucket = &set[i];
+			}
+			if (set[i].full < idle->full) {
+				idle = &set[i];
+			}
+		}
+
+		if (bucket == NULL) {
+			bucket = idle;
+			bucket->address = address;
+			bucket->full = now;
+		}
+
+		// every token pushes the time the bucket is full again one interval further
+		const uint64_t full = (bucket->full > now ? bucket->full : now) + interval;
+
+		if (full - now <= interval * limiter->burst) {
+			bucket->full = full;
+			allowed = true;
+		}
+
+	}
+
+	return allowed;
+
+}
+
+void lim_set(lim_limiter_t* limiter, uint32_t rate, uint32_t burst) {
+
+	with_lock (&limiter->lock) {
+		// a bucket that never refills would divide by zero, one token a second is the slowest there is
+		limiter->rate = rate != 0 ? rate : 1;
+		limiter->burst = burst;
+	}
+
+}
+
+void lim_clear(lim_limiter_t* limiter) {
+
+	with_lock (&limiter->lock) {
+		memset(limiter->buckets, 0, sizeof(limiter->buckets));
+	}
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <pthread.h>
+#include "../../main.h"
+
+/*
+	Per address rate limiting
+
+	Every IPv4 address gets a token bucket, kept as the time its bucket will be full again.
+	Buckets live in a small set associative table, when a set is full the most idle bucket
+	is dropped, which at worst hands a busy address a fresh bucket
+*/
+
+#define LIM_SETS 1024 // power of two
+#define LIM_WAYS 4
+
+#define LIM_INITIALIZER(r, b) (lim_limiter_t) { .lock = PTHREAD_MUTEX_INITIALIZER, .rate = r, .burst = b }
+
+typedef struct {
+
+	uint32_t address;
+
+	// nanoseconds, the bucket is full from then on, 0 if the slot is unused
+	uint64_t full;
+
+} lim_bucket_t;
+
+typedef struct {
+
+	pthread_mutex_t lock;
+
+	// tokens per second
+	uint32_t rate;
+
+	// tokens a full bucket holds
+	uint32_t burst;
+
+	lim_bucket_t buckets[LIM_SETS][LIM_WAYS];
+
+} lim_limiter_t;
+
+/*
+Take a token from the bucket of `address`, returns false if it is empty
+*/
+extern bool lim_take(lim_limiter_t* limiter, uint32_t address);
+
+/*
+Change the limits, a rate of 0 is taken as 1
+*/
+extern void lim_set(lim_limiter_t* limiter, uint32_t rate, uint32_t burst);
+
+extern void lim_clear(lim_limiter_t* limiter);
@@ -1,13 +1,18 @@
+#include <errno.h>
 #include <libdeflate.h>
+#include <time.h>
 #include "listening.h"
 #include "../motor.h"
 #include "../jobs/board.h"
-#include "../jobs/scheduler/scheduler.h"
 #include "../util/util.h"
+#include "../util/vector.h"
+#include "../util/list.h"
 #include "../io/logger/logger.h"
 #include "../io/io.h"
 #include "../io/chat/chat.h"
 #include "../io/chat/translation.h"
+#include "auth/auth.h"
+#include "keep_alive/keep_alive.h"
 
 // packet handlers
 #include "phd/handshake.h"
@@ -15,6 +20,8 @@
 #include "phd/login.h"
 #include "phd/play.h"
 
+_Atomic uint32_t ltg_status_version = 0;
+
 void ltg_init(ltg_listener_t* listener) {
 
 	log_info("Starting listener...");
@@ -22,11 +29,209 @@ void ltg_init(ltg_listener_t* listener) {
 	// generate RSA keypair
 	cry_rsa_gen_key_pair(&listener->keypair);
 
+	// start compressing big packets off the tick threads
+	ltg_start_compression_pool(LTG_COMPRESSION_THREADS);
+
+	// start the session server auth thread
+	ath_init();
+
+	// encode and compress the join packets everyone gets
+	phd_init_blobs();
+
+	// start sending keep alives
+	kal_init();
+
 	// start listening thread
+	listener->running = true;
 	pthread_create(&listener->thread, NULL, t_ltg_run, listener);
 
 }
 
+static inline uint64_t ltg_nanos() {
+
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return sky_to_nanos(time);
+
+}
+
+// returns false once the backlog is empty
+static bool ltg_add_pending(ltg_listener_t* listener, uint64_t now) {
+
+	int32_t socket;
+	struct sockaddr_in address;
+	int address_size = sizeof(struct sockaddr_in);
+	socket = sck_accept(listener->address.socket, (struct sockaddr*) &address, &address_size);
+
+	if (socket == SCK_FAILED) {
+		// the backlog stays readable without file descriptors, polling it would spin until some are closed
+		if (errno == EMFILE || errno == ENFILE) {
+			listener->pending.fds[0].events = 0;
+			listener->pending.resume = now + LTG_ACCEPT_BACKOFF;
+			return false;
+		}
+		// nothing left or the client gave up already
+		return errno == ECONNABORTED;
+	}
+
+	// floods get closed right away, before anything is allocated for them
+	if (listener->pending.count == LTG_MAX_PENDING || !lim_take(&listener->limiter, address.sin_addr.s_addr)) {
+		sck_close(socket);
+		return true;
+	}
+
+	if (listener->pending.count == listener->pending.capacity) {
+		listener->pending.capacity <<= 1;
+		listener->pending.fds = realloc(listener->pending.fds, sizeof(struct pollfd) * (listener->pending.capacity + 1));
+		listener->pending.connections = realloc(listener->pending.connections, sizeof(ltg_pending_t) * listener->pending.capacity);
+	}
+
+	const uint32_t index = listener->pending.count++;
+
+	listener->pending.fds[index + 1] = (struct pollfd) {
+		.fd = socket,
+		.events = POLLIN,
+		.revents = 0
+	};
+	listener->pending.connections[index] = (ltg_pending_t) {
+		.addr = address,
+		.socket = socket,
+		.addr_size = address_size,
+		.deadline = now + listener->pending.timeout,
+		.bytes = NULL,
+		.length = 0
+	};
+
+	return true;
+
+}
+
+// swaps the last one in, the socket is left alone
+static void ltg_remove_pending(ltg_listener_t* listener, uint32_t index) {
+
+	const uint32_t last = --listener->pending.count;
+
+	listener->pending.fds[index + 1] = listener->pending.fds[last + 1];
+	listener->pending.connections[index] = listener->pending.connections[last];
+
+}
+
+static void ltg_drop_pending(ltg_listener_t* listener, uint32_t index) {
+
+	ltg_pending_t* pending = &listener->pending.connections[index];
+
+	sck_close(pending->socket);
+	free(pending->bytes);
+
+	ltg_remove_pending(listener, index);
+
+}
+
+typedef enum {
+
+	ltg_handshake_waiting = 0,
+	ltg_handshake_valid = 1,
+	ltg_handshake_invalid = 2
+
+} ltg_handshake_status_t;
+
+// checks the first frame of a connection without decoding more than its length
+static ltg_handshake_status_t ltg_check_handshake(const byte_t* bytes, size_t length) {
+
+	// legacy server list ping, handled by the handshake handler
+	if (bytes[0] == 0xFE) {
+		return ltg_handshake_valid;
+	}
+
+	uint32_t frame_length = 0;
+	size_t i = 0;
+	for (;; ++i) {
+		if (i == length) {
+			return ltg_handshake_waiting;
+		}
+		if (i == 3) {
+			return ltg_handshake_invalid;
+		}
+		frame_length |= (uint32_t) (bytes[i] & 0x7F) << (7 * i);
+		if (!(bytes[i] & 0x80)) {
+			break;
+		}
+	}
+
+	const size_t header = i + 1;
+
+	if (frame_length < 2 || header + frame_length > LTG_MAX_HANDSHAKE) {
+		return ltg_handshake_invalid;
+	}
+
+	// packet id 0x00, anything else can go before the rest arrives
+	if (length > header && bytes[header] != 0x00) {
+		return ltg_handshake_invalid;
+	}
+
+	if (length < header + frame_length) {
+		return ltg_handshake_waiting;
+	}
+
+	// it has to end with the next state, status or login
+	const byte_t next_state = bytes[header + frame_length - 1];
+	if (next_state != ltg_status && next_state != ltg_login) {
+		return ltg_handshake_invalid;
+	}
+
+	return ltg_handshake_valid;
+
+}
+
+static void ltg_read_pending(ltg_listener_t* listener, uint32_t index) {
+
+	ltg_pending_t* pending = &listener->pending.connections[index];
+
+	byte_t buffer[LTG_MAX_HANDSHAKE];
+	const int32_t received = sck_recv(pending->socket, (char*) buffer, LTG_MAX_HANDSHAKE - pending->length);
+
+	if (received <= 0) {
+		ltg_drop_pending(listener, index);
+		return;
+	}
+
+	pending->bytes = realloc(pending->bytes, pending->length + received);
+	memcpy(pending->bytes + pending->length, buffer, received);
+	pending->length += received;
+
+	switch (ltg_check_handshake(pending->bytes, pending->length)) {
+		case ltg_handshake_waiting: {
+			// more to come
+		} break;
+		case ltg_handshake_invalid: {
+			ltg_drop_pending(listener, index);
+		} break;
+		case ltg_handshake_valid: {
+
+			// allocate new client and set address and socket
+			ltg_client_t* client = calloc(1, sizeof(ltg_client_t));
+			client->listener = listener;
+			client->socket = pending->socket;
+			pthread_mutex_init(&client->lock, NULL);
+			pthread_cond_init(&client->outbound.done, NULL);
+			sck_create_wake(client->wake);
+			client->address.addr = pending->addr;
+			client->address.size = pending->addr_size;
+			client->state = ltg_handshake;
+			client->handshake.bytes = pending->bytes;
+			client->handshake.length = pending->length;
+
+			ltg_remove_pending(listener, index);
+
+			// accept the client
+			ltg_accept(client);
+
+		} break;
+	}
+
+}
+
 void* t_ltg_run(void* args) {
 
 	ltg_listener_t* listener = args;
@@ -53,43 +258,77 @@ void* t_ltg_run(void* args) {
 	if (sck_listen(listener->address.socket) != SCK_OK) {
 		return NULL;
 	}
-	log_info("Listening on port %u", listener->address.port);
 
-	for (;;) {
+	// so the backlog can be emptied without blocking
+	sck_set_blocking(listener->address.socket, false);
 
-		// forever
+	// port 0 lets the system pick one
+	if (listener->address.port == 0) {
+		socklen_t address_size = sizeof(struct sockaddr_in);
+		getsockname(listener->address.socket, (struct sockaddr*) &listener->address.addr, &address_size);
+		listener->address.port = io_htons(listener->address.addr.sin_port);
+	}
+	log_info("Listening on port %u", listener->address.port);
 
-		int32_t socket;
-		struct sockaddr_in address;
-		int address_size = sizeof(struct sockaddr_in);
-		socket = sck_accept(listener->address.socket, (struct sockaddr*) &address, &address_size);
+	listener->pending.capacity = 64;
+	listener->pending.fds = malloc(sizeof(struct pollfd) * (listener->pending.capacity + 1));
+	listener->pending.connections = malloc(sizeof(ltg_pending_t) * listener->pending.capacity);
+	listener->pending.fds[0] = (struct pollfd) {
+		.fd = listener->address.socket,
+		.events = POLLIN,
+		.revents = 0
+	};
 
-		if (socket == SCK_FAILED) {
+	while (listener->running) {
 
-			// something failed when connecting a client
-			break;
+		if (sck_poll(listener->pending.fds, listener->pending.count + 1, LTG_POLL_INTERVAL) < 0) {
+			continue;
+		}
 
-		} else {
+		const uint64_t now = ltg_nanos();
 
-			// allocate new client and set address and socket
-			ltg_client_t* client = calloc(1, sizeof(ltg_client_t));
-			client->listener = listener;
-			client->socket = socket;
-			pthread_mutex_init(&client->lock, NULL);
-			client->address.addr = address;
-			client->address.size = address_size;
-			client->state = ltg_handshake;
+		if (listener->pending.fds[0].events == 0 && listener->pending.resume <= now) {
+			listener->pending.fds[0].events = POLLIN;
+		}
 
-			// accept the client
-			ltg_accept(client);
+		// the ones accepted now were not polled yet, so their revents are still 0
+		if (listener->pending.fds[0].revents & POLLIN) {
+			for (uint32_t i = 0; i < LTG_MAX_ACCEPTS && ltg_add_pending(listener, now); ++i);
+		}
 
+		// backwards, so the connection swapped in on removal was already looked at
+		for (uint32_t i = listener->pending.count; i > 0; --i) {
+			if (listener->pending.fds[i].revents != 0) {
+				ltg_read_pending(listener, i - 1);
+			} else if (listener->pending.connections[i - 1].deadline < now) {
+				ltg_drop_pending(listener, i - 1);
+			}
 		}
+
 	}
 
 	return (void*) 1;
 
 }
 
+void ltg_stop_listening(ltg_listener_t* listener) {
+
+	listener->running = false;
+	pthread_join(listener->thread, NULL);
+
+	sck_close(listener->address.socket);
+
+	while (listener->pending.count > 0) {
+		ltg_drop_pending(listener, 0);
+	}
+
+	free(listener->pending.fds);
+	free(listener->pending.connections);
+	listener->pending.fds = NULL;
+	listener->pending.connections = NULL;
+
+}
+
 void ltg_accept(ltg_client_t* client) {
 
 	// lock clients
@@ -102,6 +341,14 @@ void ltg_accept(ltg_client_t* client) {
 
 }
 
+void ltg_add_online(ltg_listener_t* listener, ltg_client_t* client) {
+
+	reg_add(&listener->online.registry, client, ent_get_id(ent_player_get_entity(client->entity)));
+
+	ltg_invalidate_status();
+
+}
+
 void* t_ltg_client(void* args) {
 
 	ltg_client_t* client = args;
@@ -109,10 +356,42 @@ void* t_ltg_client(void* args) {
 	// create receive packet (on stack)
 	PCK_INLINE(recvd, LTG_MAX_RECEIVE, io_big_endian);
 
+	struct pollfd fds[2] = {
+		{ .fd = client->socket, .events = POLLIN, .revents = 0 },
+		{ .fd = client->wake[0], .events = POLLIN, .revents = 0 }
+	};
+
 	for (;;) {
 
-		// receive packet
-		recvd->length = sck_recv(client->socket, (char*) recvd->bytes, LTG_MAX_RECEIVE);
+		// receive packet, the first bytes were already read by the listener
+		if (client->handshake.bytes != NULL) {
+			memcpy(recvd->bytes, client->handshake.bytes, client->handshake.length);
+			recvd->length = client->handshake.length;
+			free(client->handshake.bytes);
+			client->handshake.bytes = NULL;
+		} else {
+
+			// sleep until the client sends something or the compression pool finished a frame for it
+			if (client->wake[0] != SCK_FAILED) {
+
+				if (sck_poll(fds, 2, -1) < 0) {
+					continue;
+				}
+
+				if (fds[1].revents & POLLIN) {
+					sck_clear_wake(client->wake[0]);
+					ltg_send_ready(client);
+				}
+
+				if (fds[0].revents == 0) {
+					continue;
+				}
+
+			}
+
+			recvd->length = sck_recv(client->socket, (char*) recvd->bytes, LTG_MAX_RECEIVE);
+
+		}
 
 		if ((int32_t) recvd->length <= 0) {
 			// client disconnected
@@ -121,21 +400,13 @@ void* t_ltg_client(void* args) {
 			// handle packet
 			recvd->cursor = 0;
 
-			if (client->encryption.enabled) {
-				PCK_INLINE(decrypted, recvd->length, io_big_endian);
-				if (cfb8_decrypt(client->encryption.decrypt, recvd->bytes, recvd->length, decrypted->bytes) != 1) {
-					log_error("Decryption failed");
-					break;
-				}
-				decrypted->length = recvd->length;
+			if (client->encryption.enabled && cfb8_decrypt_in_place(client->encryption.decrypt, recvd->bytes, recvd->length) != 1) {
+				log_error("Decryption failed");
+				break;
+			}
 
-				if (!ltg_handle_packet(client, decrypted)) {
-					break;
-				}
-			} else {
-				if (!ltg_handle_packet(client, recvd)) {
-					break;
-				}
+			if (!ltg_handle_packet(client, recvd)) {
+				break;
 			}
 
 		}
@@ -256,84 +527,396 @@ bool ltg_handle_packet(ltg_client_t* client, pck_packet_t* packet) {
 
 }
 
-// send encryption step (used in compressed and uncompressed)
-static inline void ltg_send_e(ltg_client_t* client, byte_t* bytes, size_t length) {
-	
+// make room for `length` more bytes in the client's send buffer, the client has to be locked
+static inline byte_t* ltg_reserve(ltg_client_t* client, size_t length) {
+
+	if (client->send_buffer.length + length > client->send_buffer.capacity) {
+		client->send_buffer.capacity = (client->send_buffer.length + length) * 2;
+		client->send_buffer.bytes = realloc(client->send_buffer.bytes, client->send_buffer.capacity);
+	}
+
+	return client->send_buffer.bytes + client->send_buffer.length;
+
+}
+
+// encrypt everything in the send buffer in one go and send it, the client has to be locked
+static void ltg_flush(ltg_client_t* client) {
+
+	if (client->send_buffer.length == 0) {
+		return;
+	}
+
 	if (client->encryption.enabled) {
+		cfb8_encrypt_in_place(client->encryption.encrypt, client->send_buffer.bytes, client->send_buffer.length);
+	}
 
-		// encrypt packet
-		byte_t encrypted[length];
+	size_t sent = 0;
+	while (sent < client->send_buffer.length) {
+		const int32_t result = sck_send(client->socket, (char*) client->send_buffer.bytes + sent, client->send_buffer.length - sent);
+		if (result <= 0) {
+			break;
+		}
+		sent += result;
+	}
 
-		cfb8_encrypt(client->encryption.encrypt, bytes, length, encrypted);
+	client->send_buffer.length = 0;
 
-		sck_send(client->socket, (char*) encrypted, length);
+	// don't hold on to the memory of a burst of chunks forever
+	if (client->send_buffer.capacity > LTG_SEND_BUFFER_KEEP) {
+		client->send_buffer.capacity = LTG_SEND_BUFFER_KEEP;
+		client->send_buffer.bytes = realloc(client->send_buffer.bytes, LTG_SEND_BUFFER_KEEP);
+	}
+
+}
+
+/*
+Frame `length` bytes of payload for the wire, compressing it if the policy says so
+`payload` needs room for the packet length in front of it and `out` room for `length + LTG_FRAME_HEADER` bytes
+Returns where the framed bytes start (in `payload` or `out`) and updates `length`
+*/
+static byte_t* ltg_frame(bool compression, cmp_compressors_t* compressors, cmp_class_t class, byte_t* payload, size_t* length, byte_t* out) {
+
+	byte_t* bytes = NULL;
+
+	if (compression) {
+
+		if (*length >= sky_get_network_compression_threshold()) { // compress the packet
+
+			bytes = out + LTG_FRAME_HEADER;
+
+			// it's zlib compression time, the policy picks the level or skips it altogether
+			const size_t compressed_length = cmp_compress(compressors, class, payload, *length, sky_get_network_compression_threshold(), bytes);
+
+			if (compressed_length != 0) {
+
+				const size_t data_length_length = io_var_int_length(*length);
+				const size_t packet_length_length = io_var_int_length(compressed_length + data_length_length);
+
+				bytes = bytes - data_length_length - packet_length_length;
+				io_write_var_int(bytes, compressed_length + data_length_length, 5);
+				io_write_var_int(bytes + packet_length_length, *length, 5);
+				*length = compressed_length + data_length_length + packet_length_length;
+
+				return bytes;
+
+			}
+
+		}
+
+		// do not compress the packet
+		const size_t length_length = io_var_int_length(*length + 1);
+		bytes = payload - length_length - 1;
+		io_write_var_int(bytes, *length + 1, 5);
+		bytes[length_length] = 0;
+		*length += length_length + 1;
 
 	} else {
-		sck_send(client->socket, (char*) bytes, length);
+
+		const size_t length_length = io_var_int_length(*length);
+		bytes = payload - length_length;
+		io_write_var_int(bytes, *length, 5);
+		*length += length_length;
+
+	}
+
+	return bytes;
+
+}
+
+// add a frame to the back of the client's queue, the client has to be locked
+static inline void ltg_queue_frame(ltg_client_t* client, ltg_frame_t* frame) {
+
+	frame->next = NULL;
+
+	if (client->outbound.last == NULL) {
+		client->outbound.first = frame;
+	} else {
+		client->outbound.last->next = frame;
+	}
+	client->outbound.last = frame;
+
+}
+
+// queue a copy of an already framed packet behind the ones still being compressed, the client has to be locked
+static void ltg_queue_framed(ltg_client_t* client, cmp_class_t class, const byte_t* bytes, size_t length) {
+
+	ltg_frame_t* frame = malloc(sizeof(ltg_frame_t) + length);
+	frame->client = client;
+	frame->class = class;
+	frame->ready = true;
+	frame->bytes = frame->data;
+	frame->length = length;
+	memcpy(frame->bytes, bytes, length);
+
+	ltg_queue_frame(client, frame);
+
+}
+
+// move every ready frame at the front of the client's queue to the send buffer, the client has to be locked
+static void ltg_collect_frames(ltg_client_t* client) {
+
+	while (client->outbound.first != NULL && client->outbound.first->ready) {
+
+		ltg_frame_t* frame = client->outbound.first;
+
+		memcpy(ltg_reserve(client, frame->length), frame->bytes, frame->length);
+		client->send_buffer.length += frame->length;
+
+		client->outbound.first = frame->next;
+		if (client->outbound.first == NULL) {
+			client->outbound.last = NULL;
+		}
+
+		free(frame);
+
+	}
+
+}
+
+void ltg_send_ready(ltg_client_t* client) {
+
+	with_lock (&client->lock) {
+		ltg_collect_frames(client);
+		ltg_flush(client);
+	}
+
+}
+
+/*
+	Compression pool
+
+	Big packets are compressed here instead of on the thread sending them (usually a tick job),
+	every thread keeps its own compressors and frames are sent in the order they were queued.
+	The pool never sends anything itself, a slow client would hold up everyone else's packets.
+	Finished frames go back to the client's thread, or out with the next packet sent to the client
+*/
+static struct {
+
+	pthread_mutex_t lock;
+	pthread_cond_t wait;
+	utl_list_t list;
+
+	utl_vector_t threads;
+
+	bool running;
+
+} ltg_pool = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.wait = PTHREAD_COND_INITIALIZER,
+	.list = UTL_LIST_INITIALIZER(ltg_frame_t*),
+	.threads = UTL_VECTOR_INITIALIZER(pthread_t),
+	.running = false
+};
+
+static void* t_ltg_compress(__attribute__((unused)) void* args) {
+
+	cmp_compressors_t compressors = CMP_COMPRESSORS_INITIALIZER;
+
+	size_t scratch_size = 0;
+	byte_t* scratch = NULL;
+
+	for (;;) {
+
+		ltg_frame_t* frame = NULL;
+
+		with_lock (&ltg_pool.lock) {
+			while (ltg_pool.list.length == 0 && ltg_pool.running) {
+				pthread_cond_wait(&ltg_pool.wait, &ltg_pool.lock);
+			}
+			// keep going until the queue is empty, even when stopping
+			if (ltg_pool.list.length != 0) {
+				memcpy(&frame, utl_list_first(&ltg_pool.list), sizeof(ltg_frame_t*));
+				utl_list_shift(&ltg_pool.list);
+			}
+		}
+
+		if (frame == NULL) {
+			break;
+		}
+
+		if (scratch_size < frame->length + LTG_FRAME_HEADER) {
+			scratch_size = (frame->length + LTG_FRAME_HEADER) * 2;
+			scratch = realloc(scratch, scratch_size);
+		}
+
+		size_t length = frame->length;
+		byte_t* bytes = ltg_frame(true, &compressors, frame->class, frame->bytes, &length, scratch);
+
+		// compressed frames are never longer than the payload and its header
+		if (bytes >= scratch && bytes < scratch + scratch_size) {
+			memcpy(frame->data, bytes, length);
+			bytes = frame->data;
+		}
+
+		ltg_client_t* client = frame->client;
+
+		with_lock (&client->lock) {
+			frame->bytes = bytes;
+			frame->length = length;
+			frame->ready = true;
+			// while still pending, the client can't be freed before it's woken up
+			sck_wake(client->wake[1]);
+			client->outbound.pending--;
+			pthread_cond_broadcast(&client->outbound.done);
+		}
+
+	}
+
+	cmp_free_compressors(&compressors);
+	free(scratch);
+
+	return NULL;
+
+}
+
+void ltg_start_compression_pool(uint32_t threads) {
+
+	with_lock (&ltg_pool.lock) {
+		ltg_pool.running = true;
+	}
+
+	for (uint32_t i = 0; i < threads; ++i) {
+		pthread_t thread;
+		pthread_create(&thread, NULL, t_ltg_compress, NULL);
+		utl_vector_push(&ltg_pool.threads, &thread);
 	}
 
 }
 
+void ltg_stop_compression_pool() {
+
+	with_lock (&ltg_pool.lock) {
+		ltg_pool.running = false;
+		pthread_cond_broadcast(&ltg_pool.wait);
+	}
+
+	for (uint32_t i = 0; i < ltg_pool.threads.size; ++i) {
+		pthread_join(UTL_VECTOR_GET_AS(pthread_t, &ltg_pool.threads, i), NULL);
+	}
+
+	utl_term_vector(&ltg_pool.threads);
+
+}
+
 // sends the packet to the client specified
 void ltg_send(ltg_client_t* client, pck_packet_t* packet) {
 
 	with_lock (&client->lock) {
 
 		size_t length = packet->cursor;
-		byte_t* bytes = NULL;
+		const cmp_class_t class = cmp_classify(client->state, packet->bytes, length);
 
-		if (client->compression_enabled) {
+		if (client->compression_enabled && length >= LTG_POOL_LENGTH && ltg_pool.running && client->wake[1] != SCK_FAILED) {
 
-			if (length >= sky_get_network_compression_threshold()) { // compress the packet
-			
-				byte_t compressed[length + 10];
-				size_t compressed_length = 0;
+			// copy the payload and let the pool compress it
+			ltg_frame_t* frame = malloc(sizeof(ltg_frame_t) + LTG_FRAME_HEADER + length);
+			frame->client = client;
+			frame->class = class;
+			frame->ready = false;
+			frame->bytes = frame->data + LTG_FRAME_HEADER;
+			frame->length = length;
+			memcpy(frame->bytes, packet->bytes, length);
 
-				bytes = compressed + 10;
-				
-				// it's zlib compression time
-				if (client->compression.compressor == NULL) {
-					client->compression.compressor = libdeflate_alloc_compressor(6);
-				}
+			ltg_queue_frame(client, frame);
+			client->outbound.pending++;
 
-				compressed_length = libdeflate_zlib_compress(client->compression.compressor, packet->bytes, length, bytes, length);
+			with_lock (&ltg_pool.lock) {
+				utl_list_push(&ltg_pool.list, &frame);
+				pthread_cond_signal(&ltg_pool.wait);
+			}
 
-				if (compressed_length != 0) {
+		} else {
 
-					const size_t data_length_length = io_var_int_length(length);
-					const size_t packet_length_length = io_var_int_length(compressed_length + data_length_length);
-					
-					bytes = bytes - data_length_length - packet_length_length;
-					io_write_var_int(bytes, compressed_length + data_length_length, 5);
-					io_write_var_int(bytes + packet_length_length, length, 5);
-					length = compressed_length + data_length_length + packet_length_length;
+			// compressed packets are written straight into the send buffer
+			byte_t* out = ltg_reserve(client, length + LTG_FRAME_HEADER);
+			byte_t* bytes = ltg_frame(client->compression_enabled, &client->compression.compressors, class, packet->bytes, &length, out);
 
-					ltg_send_e(client, bytes, length);
+			if (client->outbound.first == NULL) {
+				memmove(out, bytes, length);
+				client->send_buffer.length += length;
+			} else {
+				// take whatever the pool finished along
+				ltg_queue_framed(client, class, bytes, length);
+				ltg_collect_frames(client);
+			}
 
-					pthread_mutex_unlock(&client->lock);
-					return;
+			ltg_flush(client);
 
-				}
+		}
 
-			}
-			
-			// do not compress the packet
-			const size_t length_length = io_var_int_length(length + 1);
-			bytes = packet->bytes - length_length - 1;
-			io_write_var_int(bytes, length + 1, 5);
-			bytes[length_length] = 0;
-			length += length_length + 1;
+	}
 
-		} else {
+}
+
+// allocating a compressor costs about as much as using it, so blobs share theirs
+static struct {
+
+	pthread_mutex_t lock;
+	cmp_compressors_t compressors;
+
+} ltg_blob_compressors = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.compressors = CMP_COMPRESSORS_INITIALIZER
+};
+
+ltg_blob_t* ltg_create_blob(const pck_packet_t* packet) {
 
-			const size_t length_length = io_var_int_length(length);
-			bytes = packet->bytes - length_length;
-			io_write_var_int(bytes, length, 5);
-			length += length_length;
+	const size_t length = packet->cursor;
 
+	// room for both framings, the compressed one is never longer than the payload and its header
+	ltg_blob_t* blob = malloc(sizeof(ltg_blob_t) + (length + LTG_FRAME_HEADER) * 2);
+	blob->references = 1;
+
+	// without compression
+	const size_t length_length = io_var_int_length(length);
+	blob->uncompressed = blob->bytes;
+	blob->uncompressed_length = length_length + length;
+	io_write_var_int(blob->uncompressed, length, 5);
+	memcpy(blob->uncompressed + length_length, packet->bytes, length);
+
+	// with compression
+	blob->compressed = blob->uncompressed + blob->uncompressed_length;
+	size_t compressed_length = 0;
+	with_lock (&ltg_blob_compressors.lock) {
+		compressed_length = cmp_compress(&ltg_blob_compressors.compressors, cmp_bulk, packet->bytes, length, sky_get_network_compression_threshold(), blob->compressed + LTG_FRAME_HEADER);
+	}
+
+	if (compressed_length != 0) {
+		const size_t data_length_length = io_var_int_length(length);
+		const size_t packet_length_length = io_var_int_length(compressed_length + data_length_length);
+		byte_t* bytes = blob->compressed + LTG_FRAME_HEADER - data_length_length - packet_length_length;
+		io_write_var_int(bytes, compressed_length + data_length_length, 5);
+		io_write_var_int(bytes + packet_length_length, length, 5);
+		blob->compressed = bytes;
+		blob->compressed_length = compressed_length + data_length_length + packet_length_length;
+	} else {
+		const size_t packet_length_length = io_var_int_length(length + 1);
+		io_write_var_int(blob->compressed, length + 1, 5);
+		blob->compressed[packet_length_length] = 0;
+		memcpy(blob->compressed + packet_length_length + 1, packet->bytes, length);
+		blob->compressed_length = packet_length_length + 1 + length;
+	}
+
+	return blob;
+
+}
+
+void ltg_send_blob(ltg_client_t* client, const ltg_blob_t* blob) {
+
+	with_lock (&client->lock) {
+
+		const byte_t* bytes = client->compression_enabled ? blob->compressed : blob->uncompressed;
+		const size_t length = client->compression_enabled ? blob->compressed_length : blob->uncompressed_length;
+
+		if (client->outbound.first == NULL) {
+			memcpy(ltg_reserve(client, length), bytes, length);
+			client->send_buffer.length += length;
+		} else {
+			ltg_queue_framed(client, cmp_bulk, bytes, length);
+			ltg_collect_frames(client);
 		}
 
-		ltg_send_e(client, bytes, length);
+		ltg_flush(client);
 
 	}
 
@@ -343,20 +926,24 @@ void ltg_disconnect(ltg_client_t* client) {
 
 	if (pthread_self() != client->thread) {
 		sck_shutdown(client->socket);
+		// the client's thread might be waiting for the session server
+		ath_cancel(client);
 		return;
 	}
 		
 	sck_shutdown(client->socket);
 
+	// make sure a late session server answer doesn't log the client in
+	ath_cancel(client);
+
 	switch (client->state) {
 		case ltg_play: {
-			// cancel keep alive
-			sch_cancel(client->keep_alive);
+			// stop keeping the client alive
+			kal_remove(client);
 
-			// remove from online player list
-			with_lock (&client->listener->online.lock) {
-				utl_id_vector_remove(&client->listener->online.vector, client->online_node);
-			}
+			// remove from online player list, once this returns no broadcast or keep alive can still reach the client
+			reg_remove(&client->listener->online.registry, client);
+			ltg_invalidate_status();
 
 			// create player leave job
 			job_payload_t payload = {
@@ -379,17 +966,35 @@ void ltg_disconnect(ltg_client_t* client) {
 		} break;
 	}
 
-	pthread_mutex_lock(&client->lock);
+	// wait for the compression pool to be done with the client, nobody is left to send what it finished
+	with_lock (&client->lock) {
+		while (client->outbound.pending != 0) {
+			pthread_cond_wait(&client->outbound.done, &client->lock);
+		}
+		while (client->outbound.first != NULL) {
+			ltg_frame_t* frame = client->outbound.first;
+			client->outbound.first = frame->next;
+			free(frame);
+		}
+		client->outbound.last = NULL;
+	}
+	pthread_cond_destroy(&client->outbound.done);
 	pthread_mutex_destroy(&client->lock);
 	sck_close(client->socket);
+	if (client->wake[0] != SCK_FAILED) {
+		sck_close(client->wake[0]);
+		sck_close(client->wake[1]);
+	}
 
 	// remove from client list
 	with_lock (&client->listener->clients.lock) {
 		utl_id_vector_remove(&client->listener->clients.vector, client->id);
 	}
 
-	// free compressors
-	libdeflate_free_compressor(client->compression.compressor);
+	// free compressors and the send buffer
+	free(client->handshake.bytes);
+	cmp_free_compressors(&client->compression.compressors);
+	free(client->send_buffer.bytes);
 	libdeflate_free_decompressor(client->compression.decompressor);
 
 	// free username
@@ -410,9 +1015,11 @@ void ltg_disconnect(ltg_client_t* client) {
 
 void ltg_term(ltg_listener_t* listener) {
 
-	// cancel main thread
-	sck_close(listener->address.socket);
-	pthread_cancel(listener->thread);
+	// stop the main thread
+	ltg_stop_listening(listener);
+
+	// nobody gets timed out while shutting down
+	kal_term();
 
 	// disconnect message
 	cht_translation_t disconnect_message = cht_translation_new;
@@ -437,6 +1044,16 @@ void ltg_term(ltg_listener_t* listener) {
 		}
 	}
 
+	ath_term();
+	ltg_stop_compression_pool();
+	phd_term_blobs();
+	phd_term_status();
+	reg_term(&listener->online.registry);
+
+	with_lock (&ltg_blob_compressors.lock) {
+		cmp_free_compressors(&ltg_blob_compressors.compressors);
+	}
+
 	sck_term();
 
 }
\ No newline at end of file
@@ -126,10 +126,23 @@ typedef enum {
 
 #define LTG_MAX_RECEIVE 3276 // max amount of bytes client can send
 #define LTG_AES_KEY_LENGTH 16 // length of AES key
+#define LTG_POOL_LENGTH 4096 // packets this large get compressed by the compression pool
+#define LTG_COMPRESSION_THREADS 2 // threads in the compression pool
+#define LTG_FRAME_HEADER 10 // room for the packet and data length in front of a frame
+#define LTG_SEND_BUFFER_KEEP 65536 // send buffers are shrunk back to this after a flush
+#define LTG_MAX_HANDSHAKE 1024 // longest handshake frame we wait for, forwarding proxies make them long
+#define LTG_MAX_PENDING 16384 // connections waiting for their handshake at once
+#define LTG_HANDSHAKE_TIMEOUT 5000000000 // nanoseconds a connection has to send its handshake
+#define LTG_POLL_INTERVAL 100 // milliseconds between handshake deadline checks
+#define LTG_MAX_ACCEPTS 256 // connections taken off the backlog per wakeup, before looking at the pending ones
+#define LTG_ACCEPT_BACKOFF 100000000 // nanoseconds the backlog is left alone when out of file descriptors
+#define LTG_CONNECTION_RATE 8 // connections an address can open per second
+#define LTG_CONNECTION_BURST 32 // and at once
 
 typedef byte_t ltg_uuid_t[16];
 
 typedef struct ltg_listener ltg_listener_t;
+typedef struct ltg_pending ltg_pending_t;
 
 typedef enum {
 
@@ -140,4 +153,8 @@ typedef enum {
 
 } ltg_client_state_t;
 
-typedef struct ltg_client ltg_client_t;
\ No newline at end of file
+typedef struct ltg_client ltg_client_t;
+
+typedef struct ltg_frame ltg_frame_t;
+
+typedef struct ltg_blob ltg_blob_t;
\ No newline at end of file
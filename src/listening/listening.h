@@ -13,6 +13,9 @@
 #include "../crypt/rsa.h"
 #include "../crypt/cfb8.h"
 #include "socket/socket.h"
+#include "compression/compression.h"
+#include "limiter/limiter.h"
+#include "registry/registry.h"
 
 #define LTG_UUID_UNPACK(uuid) (ltg_uuid_t) { uuid[0], uuid[1], uuid[2], uuid[3], uuid[4], uuid[5], uuid[6], uuid[7], uuid[8], uuid[9], uuid[10], uuid[11], uuid[12], uuid[13], uuid[14], uuid[15] }
 
@@ -33,13 +36,76 @@ struct ltg_listener {
 	} clients;
 	
 	struct {
-		pthread_mutex_t lock;
-		utl_id_vector_t vector;
+		reg_registry_t registry;
 		_Atomic uint32_t max;
 	} online;
 
+	// connections that did not send a handshake yet, only touched by the listener thread
+	struct {
+		// the first one is the listening socket, the rest line up with `connections`
+		struct pollfd* fds;
+		ltg_pending_t* connections;
+		_Atomic uint32_t count;
+		uint32_t capacity;
+		uint64_t timeout;
+		// the listening socket is not polled until then, after running out of file descriptors
+		uint64_t resume;
+	} pending;
+
+	// new connections per address
+	lim_limiter_t limiter;
+
 	cry_rsa_keypair_t keypair;
 
+	_Atomic bool running;
+
+};
+
+// a connection before its handshake, a full client only gets set up once it sent a valid one
+struct ltg_pending {
+
+	struct sockaddr_in addr;
+	int32_t socket;
+	int addr_size;
+
+	uint64_t deadline;
+
+	// everything received so far, NULL until something arrives
+	byte_t* bytes;
+	size_t length;
+
+};
+
+// a packet waiting to be sent, queued while earlier packets of the client are still being compressed
+struct ltg_frame {
+
+	ltg_frame_t* next;
+	ltg_client_t* client;
+
+	// framed bytes once ready, the payload before that
+	byte_t* bytes;
+	size_t length;
+
+	cmp_class_t class;
+	bool ready;
+
+	byte_t data[];
+
+};
+
+// a packet framed once for clients with and without compression, shared by reference
+struct ltg_blob {
+
+	_Atomic uint32_t references;
+
+	byte_t* compressed;
+	size_t compressed_length;
+
+	byte_t* uncompressed;
+	size_t uncompressed_length;
+
+	byte_t bytes[];
+
 };
 
 struct ltg_client {
@@ -54,10 +120,35 @@ struct ltg_client {
 
 	// compressors and decompressors
 	struct {
-		struct libdeflate_compressor* compressor;
+		cmp_compressors_t compressors;
 		struct libdeflate_decompressor* decompressor;
 	} compression;
 
+	// packets waiting on the compression pool and the ones queued behind them, guarded by `lock`
+	struct {
+		ltg_frame_t* first;
+		ltg_frame_t* last;
+		uint32_t pending;
+		// signalled whenever the pool is done with a frame
+		pthread_cond_t done;
+	} outbound;
+
+	// the compression pool wakes the client's thread up with this to send the frames it finished
+	int32_t wake[2];
+
+	// framed packets about to be encrypted and sent, guarded by `lock`
+	struct {
+		byte_t* bytes;
+		size_t length;
+		size_t capacity;
+	} send_buffer;
+
+	// bytes received before the client was set up, handled before anything else
+	struct {
+		byte_t* bytes;
+		size_t length;
+	} handshake;
+
 	// textures (only non-null after auth)
 	struct {
 		string_t value;
@@ -66,11 +157,12 @@ struct ltg_client {
 
 	string_t username;
 
-	// last recieved packet
-	_Atomic int64_t last_recv;
-
+	// smoothed keep alive round trip in milliseconds
 	_Atomic int64_t ping;
 
+	// ping everyone's player list shows for this client, only touched by the latency broadcast
+	int64_t listed_ping;
+
 	ltg_uuid_t uuid;
 
 	struct {
@@ -78,8 +170,6 @@ struct ltg_client {
 		int size;
 	} address;
 
-	uint32_t online_node;
-
 	uint32_t id;
 
 	// address
@@ -88,7 +178,17 @@ struct ltg_client {
 
 	ltg_locale_t locale;
 
-	uint32_t keep_alive;
+	// place in the keep alive wheel, the links are guarded by the wheel lock
+	struct {
+		ltg_client_t* previous;
+		ltg_client_t* next;
+		// keep alive id waiting for an answer, the sending time in milliseconds, 0 if there is none
+		_Atomic int64_t outstanding;
+		// wheel tick of the last answer
+		_Atomic uint64_t answered;
+		uint16_t slot;
+		bool linked;
+	} keep_alive;
 
 	struct {
 		EVP_CIPHER_CTX* encrypt;
@@ -117,6 +217,17 @@ extern void* t_ltg_run(void*);
 extern void ltg_accept(ltg_client_t*);
 extern void* t_ltg_client(void*);
 
+// stop accepting connections and drop the ones that did not finish their handshake
+extern void ltg_stop_listening(ltg_listener_t* listener);
+
+static inline uint32_t ltg_get_pending_count(const ltg_listener_t* listener) {
+	return listener->pending.count;
+}
+
+static inline void ltg_set_connection_limit(ltg_listener_t* listener, uint32_t rate, uint32_t burst) {
+	lim_set(&listener->limiter, rate, burst);
+}
+
 static inline ltg_client_t* ltg_get_client_by_id(ltg_listener_t* listener, uint32_t id) {
 	
 	ltg_client_t* client = NULL;
@@ -133,6 +244,32 @@ extern bool ltg_handle_packet(ltg_client_t* client, pck_packet_t* packet);
 
 extern void ltg_send(ltg_client_t*, pck_packet_t*);
 
+/*
+Frame and compress a packet once so it can be sent to any number of clients as is
+The blob starts with one reference
+*/
+extern ltg_blob_t* ltg_create_blob(const pck_packet_t* packet);
+extern void ltg_send_blob(ltg_client_t*, const ltg_blob_t*);
+
+static inline ltg_blob_t* ltg_retain_blob(ltg_blob_t* blob) {
+	blob->references++;
+	return blob;
+}
+
+static inline void ltg_release_blob(ltg_blob_t* blob) {
+	if (--blob->references == 0) {
+		free(blob);
+	}
+}
+
+extern void ltg_start_compression_pool(uint32_t threads);
+extern void ltg_stop_compression_pool();
+
+/*
+Send the frames at the front of the queue the compression pool is done with, the client's thread does this when it is woken up
+*/
+extern void ltg_send_ready(ltg_client_t* client);
+
 extern void ltg_disconnect(ltg_client_t*);
 
 extern void ltg_term(ltg_listener_t* listener);
@@ -237,14 +374,6 @@ static inline ent_player_t* ltg_client_get_entity(const ltg_client_t* client) {
 	return client->entity;
 }
 
-static inline int64_t ltg_client_get_last_receive(const ltg_client_t* client) {
-	return client->last_recv;
-}
-
-static inline void ltg_client_set_last_receive(ltg_client_t* client, int64_t last_receive) {
-	client->last_recv = last_receive;
-}
-
 static inline string_t ltg_client_get_textures(const ltg_client_t* client) {
 	return client->textures.value;
 }
@@ -307,48 +436,24 @@ static inline uint32_t ltg_get_online_max(const ltg_listener_t* listener) {
 	return listener->online.max;
 }
 
-static inline void ltg_add_online(ltg_listener_t* listener, ltg_client_t* client) {
-	
-	with_lock (&listener->online.lock) {
-		client->online_node = utl_id_vector_push(&listener->online.vector, &client);
-	}
-
-}
-
-static inline uint32_t ltg_get_online_count(ltg_listener_t* listener) {
-
-	uint32_t count = 0;
-
-	with_lock (&listener->online.lock) {
-		count = utl_id_vector_count(&listener->online.vector);
-	}
+// bumped whenever something shown in the server list ping changes
+extern _Atomic uint32_t ltg_status_version;
 
-	return count;
-	
+static inline void ltg_invalidate_status() {
+	ltg_status_version++;
 }
 
-static inline uint32_t ltg_get_online_length(ltg_listener_t* listener) {
-
-	uint32_t length = 0;
-
-	with_lock (&listener->online.lock) {
-		length = utl_id_vector_length(&listener->online.vector);
-	}
-
-	return length;
+extern void ltg_add_online(ltg_listener_t* listener, ltg_client_t* client);
 
+static inline uint32_t ltg_get_online_count(ltg_listener_t* listener) {
+	return reg_get_count(&listener->online.registry);
 }
 
-static inline ltg_client_t* ltg_get_online_client(ltg_listener_t* listener, uint32_t idx) {
-	
-	ltg_client_t* client = NULL;
-
-	with_lock (&listener->online.lock) {
-		client = UTL_ID_VECTOR_GET_AS(ltg_client_t*, &listener->online.vector, idx);
-	}
-
-	return client;
-
+/*
+Everyone online, only valid inside a read section (`reg_enter` / `reg_exit`)
+*/
+static inline const reg_snapshot_t* ltg_get_online(ltg_listener_t* listener) {
+	return reg_get_snapshot(&listener->online.registry);
 }
 
 static inline cry_rsa_keypair_t* ltg_get_rsa_keys(ltg_listener_t* listener) {
@@ -1,4 +1,5 @@
 #include "handshake.h"
+#include "status.h"
 #include "../../motor.h"
 #include "../../io/logger/logger.h"
 
@@ -42,7 +43,10 @@ bool phd_handle_handshake(ltg_client_t* client, pck_packet_t* packet) {
 
 bool phd_handle_legacy_slp(ltg_client_t* client, __attribute__((unused)) pck_packet_t* packet) {
 
-	phd_send_legacy_slp(client);
+	if (phd_take_status_token(client)) {
+		phd_send_legacy_slp(client);
+	}
+
 	return false;
 
 }
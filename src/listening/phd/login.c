@@ -1,4 +1,3 @@
-#include <curl/curl.h>
 #include <openssl/evp.h>
 #include "login.h"
 #include "play.h"
@@ -8,29 +7,7 @@
 #include "../../io/chat/chat.h"
 #include "../../io/chat/translation.h"
 #include "../../crypt/random.h"
-
-struct {
-
-	CURL* curl;
-	pthread_mutex_t lock;
-
-} phd_authRequest = {
-	.curl = NULL,
-	.lock = PTHREAD_MUTEX_INITIALIZER
-};
-
-size_t phd_auth_response_write(void* ptr, size_t size, size_t nmemb, string_t* r) {
-	
-	const size_t new_len = r->length + size * nmemb;
-	r->value = realloc(r->value, new_len + 1);
-
-	memcpy(r->value + r->length, ptr, size * nmemb);
-	r->value[new_len] = '\0';
-	r->length = new_len;
-
-	return size*nmemb;
-
-}
+#include "../auth/auth.h"
 
 bool phd_login(ltg_client_t* client, pck_packet_t* packet) {
 
@@ -158,78 +135,45 @@ bool phd_handle_encryption_response(ltg_client_t* client, pck_packet_t* packet)
 
 	}
 
-	// auth with Mojang's servers...
-
-	long http_code = 0;
-	string_t response;
+	// create server_id hash
+	EVP_MD_CTX* hash = EVP_MD_CTX_create();
+	EVP_DigestInit_ex(hash, EVP_sha1(), NULL);
+	EVP_DigestUpdate(hash, (byte_t*) "", 0);
+	EVP_DigestUpdate(hash, secret.bytes, LTG_AES_KEY_LENGTH);
+	EVP_DigestUpdate(hash, cry_get_asn1_bytes(ltg_get_rsa_keys(sky_get_listener())), cry_get_asn1_length(ltg_get_rsa_keys(sky_get_listener())));
+	unsigned int digest_length = 20;
+	byte_t server_id_hash[digest_length];
+	EVP_DigestFinal_ex(hash, server_id_hash, &digest_length);
+	EVP_MD_CTX_destroy(hash);
+
+	// create server_id string
+	char server_id[(digest_length << 1) + 2];
+	utl_to_minecraft_hex(server_id, server_id_hash, digest_length);
+
+	// auth with Mojang's servers
+	if (!ath_has_joined(client, UTL_STRTOCSTR(ltg_client_get_username(client)), server_id)) {
+		return false;
+	}
 
-	with_lock (&phd_authRequest.lock) {
+	// the client sends nothing until it is logged in, so its thread waits for the answer and joins it here
+	return ath_wait(client, phd_handle_auth_response);
 
-		if (phd_authRequest.curl == NULL) {
-			phd_authRequest.curl = curl_easy_init();
-			if (!phd_authRequest.curl) {
-				pthread_mutex_unlock(&phd_authRequest.lock);
-				log_error("Failed to initialize cURL");
-				return false;
-			}
-			curl_easy_setopt(phd_authRequest.curl, CURLOPT_TCP_FASTOPEN, 1);
-			curl_easy_setopt(phd_authRequest.curl, CURLOPT_IPRESOLVE, CURL_IPRESOLVE_V4);
-			curl_easy_setopt(phd_authRequest.curl, CURLOPT_WRITEFUNCTION, phd_auth_response_write);
-		}
-		CURLcode res;
-
-		// create server_id hash
-		EVP_MD_CTX* hash = EVP_MD_CTX_create();
-		EVP_DigestInit_ex(hash, EVP_sha1(), NULL);
-		EVP_DigestUpdate(hash, (byte_t*) "", 0);
-		EVP_DigestUpdate(hash, secret.bytes, LTG_AES_KEY_LENGTH);
-		EVP_DigestUpdate(hash, cry_get_asn1_bytes(ltg_get_rsa_keys(sky_get_listener())), cry_get_asn1_length(ltg_get_rsa_keys(sky_get_listener())));
-		unsigned int digest_length = 20;
-		byte_t server_id_hash[digest_length];
-		EVP_DigestFinal_ex(hash, server_id_hash, &digest_length);
-		EVP_MD_CTX_destroy(hash);
-
-		// create server_id string
-		char server_id[(digest_length << 1) + 2];
-		utl_to_minecraft_hex(server_id, server_id_hash, digest_length);
-
-		char request[98 + (digest_length << 1)];
-		sprintf(request, "https://sessionserver.mojang.com/session/minecraft/hasJoined?username=%s&serverId=%s", UTL_STRTOCSTR(ltg_client_get_username(client)), server_id);
-		curl_easy_setopt(phd_authRequest.curl, CURLOPT_URL, request);
-
-		// prepare response string
-		response.length = 0;
-		response.value = malloc(1);
-		response.value[0] = '\0';
-
-		curl_easy_setopt(phd_authRequest.curl, CURLOPT_WRITEDATA, &response);
-
-		res = curl_easy_perform(phd_authRequest.curl);
-		if (res != CURLE_OK) {
-			
-			pthread_mutex_unlock(&phd_authRequest.lock);
-
-			log_error("Could not authenticate client: %s", curl_easy_strerror(res));
-
-			if (response.value != NULL)
-				free(response.value);
-			
-			return false;
-
-		}
+}
 
-		curl_easy_getinfo(phd_authRequest.curl, CURLINFO_RESPONSE_CODE, &http_code);
+bool phd_handle_auth_response(ltg_client_t* client, const ath_result_t* result) {
 
+	if (result->status == ath_failed) {
+		return false;
 	}
 
-	if (http_code != 200) {
+	if (result->status == ath_invalid) {
 		
-		log_info("User attempted to login with an invalid session! (Server returned %ld)", http_code);
+		log_info("User attempted to login with an invalid session! (Server returned %ld)", result->http_code);
 		return false;
 
 	}
 
-	mjson_doc* auth = mjson_read(response.value, response.length);
+	mjson_doc* auth = mjson_read(result->body.value, result->body.length);
 
 	mjson_val* auth_obj = mjson_get_root(auth);
 	const uint32_t auth_obj_size = mjson_get_size(auth_obj);
@@ -279,7 +223,6 @@ bool phd_handle_encryption_response(ltg_client_t* client, pck_packet_t* packet)
 										log_error("Property type has not been set, is the json response from the auth server curropted?");
 										
 										mjson_free(auth);
-										free(response.value);
 										return false;
 									}
 									case textures: {
@@ -297,7 +240,6 @@ bool phd_handle_encryption_response(ltg_client_t* client, pck_packet_t* packet)
 										log_error("Property type has not been set, is the json response from the auth server curropted?");
 										
 										mjson_free(auth);
-										free(response.value);
 										return false;
 									}
 									case textures: {
@@ -318,9 +260,8 @@ bool phd_handle_encryption_response(ltg_client_t* client, pck_packet_t* packet)
 		}
 	}
 
-	// free auth response and auth json doc
+	// free auth json doc
 	mjson_free(auth);
-	free(response.value);
 
 	phd_update_login_success(client);
 
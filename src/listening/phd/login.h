@@ -2,16 +2,18 @@
 #include "../../main.h"
 #include "../../io/packet/packet.h"
 #include "../listening.h"
+#include "../auth/auth.h"
 
 extern bool phd_login(ltg_client_t*, pck_packet_t*);
 
-extern size_t phd_auth_response_write(void*, size_t, size_t, string_t*);
-
 //inbound
 extern bool phd_handle_login_start(ltg_client_t*, pck_packet_t*);
 extern bool phd_handle_encryption_response(ltg_client_t*, pck_packet_t*);
 extern bool phd_handle_login_plugin_response(ltg_client_t*, pck_packet_t*);
 
+// session server callback
+extern bool phd_handle_auth_response(ltg_client_t*, const ath_result_t*);
+
 //outbound
 extern void phd_send_disconnect_login(ltg_client_t*, const char*, size_t);
 extern void phd_send_encryption_request(ltg_client_t*);
@@ -1,16 +1,17 @@
 #include <openssl/evp.h>
 #include "play.h"
+#include "../keep_alive/keep_alive.h"
 #include "../../io/logger/logger.h"
 #include "../../io/nbt/mnbt.h"
 #include "../../io/commands/graph.h"
 #include "../../motor.h"
 #include "../../world/world.h"
+#include "../../world/palette.h"
 #include "../../world/entity/entity.h"
 #include "../../world/item/recipe/recipe.h"
 #include "../../jobs/board.h"
 #include "../../jobs/scheduler/scheduler.h"
 #include "../../util/util.h"
-#include "../../util/long_encode.h"
 
 bool phd_play(ltg_client_t* client, pck_packet_t* packet) {
 
@@ -161,309 +162,72 @@ bool phd_handle_client_settings(ltg_client_t* client, pck_packet_t* packet) {
 bool phd_handle_click_window(ltg_client_t* client, pck_packet_t* packet) {
 
 	const uint8_t window_id = pck_read_int8(packet);
-	const __attribute__((unused)) int32_t state_id = pck_read_var_int(packet);
+	const int32_t state_id = pck_read_var_int(packet);
 	const int16_t slot = pck_read_int16(packet);
 	const int8_t button = pck_read_int8(packet);
 	const int32_t mode = pck_read_var_int(packet);
 
-	ent_player_t* player = ltg_client_get_entity(client);
+	// the slots as the client thinks the click left them, the carried item last
+	const int32_t predicted_count = pck_read_var_int(packet);
+	if (predicted_count < 0 || predicted_count > INV_MAX_SLOTS) {
+		return false;
+	}
 
-	// TODO use API functions to do this
-	with_lock (&player->living_entity.entity.lock) {
-
-		struct {
-			itm_item_t* slot;
-			itm_item_t* target;
-			uint8_t target_size;
-			bool grabbable : 1;
-			bool droppable : 1;
-		} clicked = {
-			.slot = NULL,
-			.grabbable = false,
-			.droppable = false
-		};
+	inv_change_t predicted[INV_MAX_SLOTS + 1];
+	for (int32_t i = 0; i < predicted_count; ++i) {
+		predicted[i].slot = pck_read_int16(packet);
+		predicted[i].item = itm_new;
+		if (!itm_from_packet(packet, &predicted[i].item)) {
+			return false;
+		}
+	}
+	predicted[predicted_count].slot = INV_SLOT_NONE;
+	predicted[predicted_count].item = itm_new;
+	if (!itm_from_packet(packet, &predicted[predicted_count].item)) {
+		return false;
+	}
 
-		switch (window_id) {
-			case 0: { // player inventory
-				if (slot == -999) { // outside
-					clicked.droppable = true;
-				} else if (slot == -1) {
-					clicked.droppable = false;
-					clicked.grabbable = false;
-				} else if (slot == 0) { // crafting output
-					clicked.grabbable = true;
-				} else if (slot <= 4) { // crafting input
-					clicked.droppable = true;
-					clicked.grabbable = true;
-				} else if (slot <= 8) { // armor
-					// TODO variable droppable and grabbable based on hand item
-					clicked.slot = &player->living_entity.armor[slot - 5];
-				} else if (slot <= 35) { // main inventory
-					clicked.droppable = true;
-					clicked.grabbable = true;
-					clicked.slot = &player->inventory[slot - 9];
-				} else if (slot <= 44) { // hotbar
-					clicked.droppable = true;
-					clicked.grabbable = true;
-					clicked.slot = &player->hotbar[slot - 36];
-				} else if (slot == 45) { // offhand
-					clicked.droppable = true;
-					clicked.grabbable = true;
-					clicked.slot = &player->living_entity.off_hand;
-				}
+	if (mode < inv_click_normal || mode > inv_click_double) {
+		return false;
+	}
 
-				switch (mode) {
-					case 1: { // shift click
-						if (slot >= 9 && slot <= 35) { // inventory
-							// attempt to put it in the hotbar
-							clicked.target = player->hotbar;
-							clicked.target_size = 9;
-						} else { // not inventory
-							// attempt to put it in general inventory
-							clicked.target = player->inventory;
-							clicked.target_size = 27;
-						}
-					} break;
-					case 6: { // double click
+	ent_player_t* player = ltg_client_get_entity(client);
+	inv_window_t* window = ent_player_get_window(player);
+	const bool creative = ent_player_get_gamemode(player) == ent_creative;
 
-					} break;
-					default: {
-						// do absolutely nothing
-					} break;
-				}
-			} break;
-		}
+	bool valid = true;
+	inv_change_t changes[INV_MAX_SLOTS + 1];
+	uint32_t change_count = 0;
+	uint32_t window_state_id = 0;
 
-		switch (mode) {
-			case 0: { // normal clicks
-				player->paint.count = 0;
-				switch (button) {
-					case 0: { // left click
-						if (slot == -999) {
-							// TODO drop stack
-							itm_set_count(&player->carried, 0);
-						} else {
-							if (player->carried.type == mat_item_air) {
-								if (clicked.grabbable) {
-									player->carried = *clicked.slot;
-									itm_set_count(clicked.slot, 0);
-								}
-							} else {
-								if (clicked.slot != NULL) {
-									if (clicked.slot->type == mat_item_air) {
-										if (clicked.droppable) {
-											*clicked.slot = player->carried;
-											itm_set_count(&player->carried, 0);
-										}
-									} else {
-										if (itm_is_similar(clicked.slot, &player->carried)) {
-											if (clicked.droppable) {
-												const uint8_t total = clicked.slot->count + player->carried.count;
-												if (total > 64) {
-													itm_set_count(clicked.slot, 64);
-													itm_set_count(&player->carried, total - 64);
-												} else {
-													itm_set_count(clicked.slot, total);
-													itm_set_count(&player->carried, 0);
-												}
-											}
-										} else { // swap
-											if (clicked.droppable && clicked.grabbable) {
-												itm_item_t temp = player->carried;
-												player->carried = *clicked.slot;
-												*clicked.slot = temp;
-											}
-										}
-									}
-								}
-							}
-						}
-					} break;
-					case 1: { // right click
-						if (slot == -999) {
-							if (player->carried.type != mat_item_air) {
-								// TODO drop one
-								itm_set_count(&player->carried, player->carried.count - 1);
-							}
-						} else {
-							if (player->carried.type == mat_item_air) { // take half
-								if (clicked.grabbable) {
-									player->carried = *clicked.slot;
-									itm_set_count(&player->carried, (clicked.slot->count + 1) >> 1);
-									itm_set_count(clicked.slot, clicked.slot->count >> 1);
-								}
-							} else { // drop one
-								if (clicked.droppable) {
-									if (clicked.slot->type == mat_item_air) {
-										*clicked.slot = player->carried;
-										itm_set_count(clicked.slot, 1);
-										itm_set_count(&player->carried, player->carried.count - 1);
-									} else {
-										if (itm_is_similar(clicked.slot, &player->carried)) {
-											if (clicked.slot->count < 64) {
-												itm_set_count(clicked.slot, clicked.slot->count + 1);
-												itm_set_count(&player->carried, player->carried.count - 1);
-											}
-										}
-									}
-								}
-							}
-						}
-					} break;
-				}
-			} break;
-			case 1: { // shift clicks
-				if (clicked.grabbable) {
-					itm_item_t* empty = NULL;
-
-					for (uint8_t i = 0; i < clicked.target_size; ++i) {
-						if (itm_is_similar(clicked.slot, &clicked.target[i])) {
-							const uint8_t total = clicked.slot->count + clicked.target[i].count;
-							if (total <= 64) {
-								itm_set_count(&clicked.target[i], total);
-								itm_set_count(clicked.slot, 0);
-								break;
-							} else {
-								itm_set_count(&clicked.target[i], 64);
-								itm_set_count(clicked.slot, total - 64);
-							}
-						} else if (empty == NULL && clicked.target[i].type == mat_item_air) {
-							empty = &clicked.target[i];
-						}
-					}
+	with_lock (&window->lock) {
 
-					if (empty != NULL && clicked.slot->count > 0) {
-						*empty = *clicked.slot;
-						itm_set_count(clicked.slot, 0);
-					}
-				}
-			} break;
-			case 2: { // number keys
-				if (clicked.slot != NULL && player->carried.type == mat_item_air) {
-
-					// kick hacked clients trying to wreak havoc					
-					if (button > 8) return false;
-
-					itm_item_t* target = &player->hotbar[button];
-					if (clicked.slot->type == mat_item_air) {
-						if (clicked.droppable) {
-							*clicked.slot = *target;
-							itm_set_count(target, 0);
-						}
-					} else {
-						if (clicked.grabbable) {
-							if (target->type == mat_item_air) {
-								*target = *clicked.slot;
-								itm_set_count(clicked.slot, 0);
-							} else {
-								if (clicked.droppable) {
-									itm_item_t temp = *target;
-									*target = *clicked.slot;
-									*clicked.slot = temp;
-								}
-							}
-						}
-					}
-				}
-			} break;
-			case 3: { // middle click
-				player->paint.count = 0;
-				// TODO only defined by creative players
-			} break;
-			case 4: { // drop key
-				if (clicked.grabbable) {
-					switch (button) {
-						case 0: { // drop single item
-							if (clicked.slot->type != mat_item_air) {
-								// TODO drop item
-								itm_set_count(clicked.slot, clicked.slot->count - 1);
-							}
-						} break;
-						case 1: { // drop item stack
-							// TODO drop item stack
-							itm_set_count(clicked.slot, 0);
-						} break;
-					}
-				}
-			} break;
-			case 5: { // drag
-				switch (button) {
-					case 0:
-					case 4:
-					case 8: { // begin drag
-						player->paint.count = 0;
-					} break;
-					case 1:
-					case 5:
-					case 9: { // add slot to drag
-						if (clicked.droppable) {
-							player->paint.elements[player->paint.count++] = clicked.slot;
-						}
-					} break;
-					case 2: {
-						const uint8_t per_slot = player->carried.count / player->paint.count;
-						for (uint8_t i = 0; i < player->paint.count; ++i) {
-							if (player->paint.elements[i]->type == mat_item_air) {
-								*player->paint.elements[i] = player->carried;
-								itm_set_count(player->paint.elements[i], per_slot);
-								itm_set_count(&player->carried, player->carried.count - per_slot);
-							} else {
-								if (itm_is_similar(player->paint.elements[i], &player->carried)) {
-									const uint8_t total = player->paint.elements[i]->count + per_slot;
-									if (total > 64) {
-										const uint8_t to_add = 64 - player->paint.elements[i]->count;
-										itm_set_count(player->paint.elements[i], 64);
-										itm_set_count(&player->carried, player->carried.count - to_add);
-									} else {
-										itm_set_count(player->paint.elements[i], player->paint.elements[i]->count + per_slot);
-										itm_set_count(&player->carried, player->carried.count - per_slot);
-									}
-								}
-							}
-						}
-					} break;
-					case 6: {
-						for (uint8_t i = 0; i < player->paint.count && player->carried.count > 0; ++i) {
-							if (player->paint.elements[i]->type == mat_item_air) {
-								*player->paint.elements[i] = player->carried;
-								itm_set_count(player->paint.elements[i], 1);
-								itm_set_count(&player->carried, player->carried.count - 1);
-							} else {
-								if (itm_is_similar(player->paint.elements[i], &player->carried)) {
-									if (player->paint.elements[i]->count != 64) {
-										itm_set_count(player->paint.elements[i], player->paint.elements[i]->count + 1);
-										itm_set_count(&player->carried, player->carried.count - 1);
-									}
-								}
-							}
-						}
-					} break;
-					case 10: { // paint clone
-						// TODO only defined for creative players
-					} break;
-				}
-			} break;
-			case 6: { // double click
+		if (window_id == window->id) {
 
-			} break;
-		}
+			// a click on a state the client hadn't caught up with yet isn't run, sending the changes puts it right
+			if ((uint32_t) state_id == window->state_id) {
+				valid = inv_click(window, slot, button, mode, creative);
+				inv_update_crafting(window);
+			} else {
+				window->drag.active = false;
+			}
 
-	}
+			for (int32_t i = 0; i <= predicted_count; ++i) {
+				inv_set_remote(window, predicted[i].slot, predicted[i].item);
+			}
 
-	itm_item_t item;
+		}
+
+		change_count = inv_get_changes(window, changes);
+		window_state_id = window->state_id;
 
-	int32_t len = pck_read_var_int(packet);
-	for (int32_t i = 0; i < len; ++i) {
-		__attribute__((unused)) int16_t item_slot = pck_read_int16(packet);
-		itm_from_packet(packet, &item);
 	}
 
-	itm_from_packet(packet, &item);
-	
-	// TODO remove this
-	phd_send_player_inventory(client);
+	for (uint32_t i = 0; i < change_count; ++i) {
+		phd_send_set_slot(client, changes[i].slot == INV_SLOT_NONE ? -1 : window->id, window_state_id, changes[i].slot, &changes[i].item);
+	}
 
-	return true;
+	return valid;
 
 }
 
@@ -495,15 +259,10 @@ bool phd_handle_plugin_message(__attribute__((unused)) ltg_client_t* client, pck
 
 bool phd_handle_keep_alive(ltg_client_t* client, pck_packet_t* packet) {
 
-	int64_t out_ms = pck_read_int64(packet);
+	const int64_t id = pck_read_int64(packet);
 
-	struct timespec time;
-	clock_gettime(CLOCK_REALTIME, &time);
-	ltg_client_set_last_receive(client, time.tv_sec * 1000 + time.tv_nsec / 0xF4240);
-
-	ltg_client_set_ping(client, ltg_client_get_last_receive(client) - out_ms);
-
-	return true;
+	// an id we never sent means the client is making things up
+	return kal_receive(client, id);
 
 }
 
@@ -604,6 +363,13 @@ bool phd_handle_player_digging(ltg_client_t* client, pck_packet_t* packet) {
 	switch (status) {
 		case 0: { // start digging
 			if (!ent_player_is_digging_block(player)) {
+				const uint16_t ticks = ent_player_get_break_speed(
+					player,
+					wld_get_block_type_at(chunk, position.x, position.y, position.z)
+				);
+				if (ticks == MAT_DIG_UNBREAKABLE) {
+					break;
+				}
 				ent_player_start_digging_block(player,
 					sch_schedule(
 						job_new(
@@ -617,10 +383,7 @@ bool phd_handle_player_digging(ltg_client_t* client, pck_packet_t* packet) {
 									.z = position.z,
 								}
 							}),
-						ent_player_get_break_speed(
-							player,
-							wld_get_block_type_at(chunk, position.x, position.y, position.z)
-						)
+						ticks
 					)
 				);
 			} else {
@@ -771,35 +534,31 @@ bool phd_handle_player_block_placement(ltg_client_t* client, pck_packet_t* packe
 
 	ent_player_t* player = client->entity;
 
-	itm_item_t* slot = NULL;
+	inv_window_t* window = ent_player_get_window(player);
+	const uint8_t index = hand == off_hand ? INV_PLAYER_OFF_HAND : INV_PLAYER_HOTBAR + ent_player_get_held_item(player);
 
-	with_lock (&player->living_entity.entity.lock) {
+	mat_block_type_t block = mat_block_air;
 
-		switch (hand) {
-			case main_hand: {
-				slot = player->hotbar + player->held_item;
-			} break;
-			case off_hand: {
-				slot = &player->living_entity.off_hand;
-			} break;
-		}
+	with_lock (&window->lock) {
 
-		const mat_item_t* item = mat_get_item_by_type(slot->type);
-		
-		if (item->block != mat_block_air) {
+		itm_item_t* slot = &player->slots[index];
 
-			wld_chunk_t* player_chunk = player->living_entity.entity.chunk;
-
-			wld_set_block_type_at(player_chunk, position.x, position.y, position.z, item->block);
+		block = mat_get_item_by_type(slot->type)->block;
 
+		if (block != mat_block_air && ent_player_get_gamemode(player) != ent_creative) {
 			itm_set_count(slot, slot->count - 1);
-
-		} else {
-			// tried to place air, interact with block TODO
+			// the client takes the item out itself
+			player->remote_slots[index] = *slot;
 		}
 
 	}
 
+	if (block != mat_block_air) {
+		wld_set_block_type_at(ent_get_chunk(ent_player_get_entity(player)), position.x, position.y, position.z, block);
+	} else {
+		// tried to place air, interact with block TODO
+	}
+
 	return true;
 
 }
@@ -871,9 +630,67 @@ void phd_send_system_chat_message(ltg_client_t* client, const char* message, siz
 
 }
 
+/*
+	Join packets that are the same for every player, framed and compressed once
+	and rebuilt when the recipes or commands they come from change
+*/
+typedef struct {
+
+	ltg_blob_t* blob;
+	uint32_t version;
+
+} phd_blob_t;
+
+static struct {
+
+	pthread_mutex_t lock;
+
+	phd_blob_t recipes;
+	phd_blob_t tags;
+	phd_blob_t commands;
+
+} phd_blobs = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.recipes = { .blob = NULL },
+	.tags = { .blob = NULL },
+	.commands = { .blob = NULL }
+};
+
+// returns a reference to the blob, built again if `version` moved on
+static ltg_blob_t* phd_get_blob(phd_blob_t* cached, uint32_t version, ltg_blob_t* (*build) ()) {
+
+	ltg_blob_t* blob = NULL;
+
+	with_lock (&phd_blobs.lock) {
+
+		if (cached->blob == NULL || cached->version != version) {
+			if (cached->blob != NULL) {
+				ltg_release_blob(cached->blob);
+			}
+			cached->blob = build();
+			cached->version = version;
+		}
+
+		blob = ltg_retain_blob(cached->blob);
+
+	}
+
+	return blob;
+
+}
+
+static ltg_blob_t* phd_build_declare_commands() {
+
+	return ltg_create_blob(cmd_get_graph());
+
+}
+
 void phd_send_declare_commands(ltg_client_t* client) {
 
-	ltg_send(client, cmd_get_graph());
+	ltg_blob_t* blob = phd_get_blob(&phd_blobs.commands, cmd_graph_version, phd_build_declare_commands);
+
+	ltg_send_blob(client, blob);
+	ltg_release_blob(blob);
 
 }
 
@@ -886,16 +703,27 @@ void phd_send_player_inventory(ltg_client_t* client) {
 	pck_write_var_int(packet, 0x14);
 
 	pck_write_int8(packet, 0); // window id = player inventory
-	pck_write_var_int(packet, 0); // state id
 
-	pck_write_var_int(packet, 46);
-	
 	ent_player_serialize_inventory(player, packet);
 
 	ltg_send(client, packet);
 
 }
 
+void phd_send_set_slot(ltg_client_t* client, int8_t window_id, uint32_t state_id, int16_t slot, const itm_item_t* item) {
+
+	PCK_INLINE(packet, 32, io_big_endian);
+
+	pck_write_var_int(packet, 0x16);
+	pck_write_int8(packet, window_id);
+	pck_write_var_int(packet, state_id);
+	pck_write_int16(packet, slot);
+	itm_serialize(packet, item);
+
+	ltg_send(client, packet);
+
+}
+
 void phd_send_plugin_message(ltg_client_t* client, const char* identifier, size_t identifier_length, const byte_t* data, size_t data_length) {
 
 	PCK_INLINE(packet, 6 + identifier_length + data_length, io_big_endian);
@@ -973,6 +801,17 @@ void phd_send_keep_alive(ltg_client_t* client, uint64_t id) {
 
 }
 
+ltg_blob_t* phd_create_keep_alive(int64_t id) {
+
+	PCK_INLINE(packet, 9, io_big_endian);
+
+	pck_write_var_int(packet, 0x21);
+	pck_write_int64(packet, id);
+
+	return ltg_create_blob(packet);
+
+}
+
 struct {
 	pck_packet_t* packet;
 	pthread_mutex_t lock;
@@ -1026,26 +865,38 @@ void phd_send_chunk_data_and_update_light(ltg_client_t* client, wld_chunk_t* chu
 
 		// HEIGHTMAP
 		
-		const uint16_t chunk_height = mat_get_chunk_height(wld_get_environment(wld_chunk_get_world(chunk)));
+		const mat_dimension_type_t environment = wld_get_environment(wld_chunk_get_world(chunk));
+		const uint16_t chunk_height = mat_get_chunk_height(environment);
+		const int16_t min_y = mat_get_dimension_by_type(environment)->min_y;
 
 		const uint8_t bits_per_heightmap = ceil(log2((chunk_height << 4) + 1));
 		const uint32_t heightmap_size = 1 + (255 / (64 / bits_per_heightmap));
 		int64_t motion_blocking[heightmap_size];
 		int64_t world_surface[heightmap_size];
 
-		utl_encode_shorts_to_longs(wld_chunk_get_highest_motion_blocking(chunk), 256, bits_per_heightmap, motion_blocking);
-		utl_encode_shorts_to_longs(wld_chunk_get_highest_world_surface(chunk), 256, bits_per_heightmap, world_surface);
-
-		// create heightmap
-		mnbt_doc* doc = mnbt_new();
-		mnbt_tag* tag = mnbt_new_tag(doc, UTL_CSTRTOARG(""), MNBT_COMPOUND, mnbt_val_compound());
-		mnbt_push_tag(tag, mnbt_new_tag(doc, UTL_CSTRTOARG("MOTION_BLOCKING"), MNBT_LONG_ARRAY, mnbt_val_long_array(motion_blocking, heightmap_size)));
-		mnbt_push_tag(tag, mnbt_new_tag(doc, UTL_CSTRTOARG("WORLD_SURFACE"), MNBT_LONG_ARRAY, mnbt_val_long_array(world_surface, heightmap_size)));
-		mnbt_set_root(doc, tag);
-
-		pck_write_nbt(packet, doc);
+		// heights are sent from the bottom of the world, packing negative ones would spill into their neighbours
+		const int16_t* highest_motion_blocking = wld_chunk_get_highest_motion_blocking(chunk);
+		const int16_t* highest_world_surface = wld_chunk_get_highest_world_surface(chunk);
+		uint16_t heights[2][256];
+		for (uint32_t i = 0; i < 256; ++i) {
+			heights[0][i] = UTL_MAX(highest_motion_blocking[i] - min_y, 0);
+			heights[1][i] = UTL_MAX(highest_world_surface[i] - min_y, 0);
+		}
 
-		mnbt_free(doc);
+		io_pack_shorts(heights[0], 256, bits_per_heightmap, (byte_t*) motion_blocking);
+		io_pack_shorts(heights[1], 256, bits_per_heightmap, (byte_t*) world_surface);
+
+		// write heightmap, the longs are already big endian
+		mnbt_writer nbt = pck_begin_nbt(packet);
+		mnbt_writer_tag(&nbt, MNBT_COMPOUND, UTL_CSTRTOARG(""));
+		mnbt_writer_tag(&nbt, MNBT_LONG_ARRAY, UTL_CSTRTOARG("MOTION_BLOCKING"));
+		mnbt_writer_long_array_be(&nbt, (uint64_t*) motion_blocking, heightmap_size);
+		mnbt_writer_tag(&nbt, MNBT_LONG_ARRAY, UTL_CSTRTOARG("WORLD_SURFACE"));
+		mnbt_writer_long_array_be(&nbt, (uint64_t*) world_surface, heightmap_size);
+		mnbt_writer_end(&nbt);
+		if (!pck_end_nbt(packet, &nbt)) {
+			log_error("Heightmaps do not fit in the chunk packet");
+		}
 
 		// BIOMES
 
@@ -1078,95 +929,26 @@ void phd_send_chunk_data_and_update_light(ltg_client_t* client, wld_chunk_t* chu
 
 			// block state array
 			if (block_count > 0) {
-				struct {
-					mat_block_protocol_id_t array[256];
-					uint8_t length;
-				} palette = {
-					.length = 1
-				};
-				palette.array[0] = wld_chunk_section_get_blocks(wld_chunk_get_section(chunk, i))[0];
-				
-				int8_t block_array[4096];
+				const mat_block_protocol_id_t* blocks = wld_chunk_section_get_blocks(wld_chunk_get_section(chunk, i));
+				wld_palette_t palette;
 
-				struct {
-					mat_block_protocol_id_t block;
-					uint16_t palette;
-				} previous = {
-					.block = palette.array[0],
-					.palette = 0
-				};
-
-				for (uint16_t j = 0; j < 4096; ++j) {
-
-					const mat_block_protocol_id_t block = wld_chunk_section_get_blocks(wld_chunk_get_section(chunk, i))[j];
-					if (block == previous.block) {
-						block_array[j] = previous.palette;
-					} else {
-						// test if block is in palette
-						for (uint8_t k = 0; k < palette.length; ++k) {
-							if (palette.array[k] == block) {
-								block_array[j] = previous.palette = k;
-								previous.block = block;
-
-								goto end;
-							}
-						}
-
-						// add to palette (it hasn't been found)
-						if (palette.length < 255) {
-							palette.array[palette.length] = block;
-							block_array[j] = previous.palette = palette.length++;
-							previous.block = block;
-						} else {
-							// palette is too big, use direct
-							break;
-						}
-					}
-					end:{}
-				}
-
-				if (palette.length == 1) {
+				if (!wld_palettize(blocks, &palette)) {
+					// direct
+					pck_write_int8(packet, palette.bits);
+					pck_write_var_int(packet, io_packed_longs(4096, palette.bits)); // data array length
+					pck_write_packed_shorts(packet, blocks, 4096, palette.bits);
+				} else if (palette.length == 1) {
 					pck_write_int8(packet, 0);
-					pck_write_var_int(packet, palette.array[0]);
+					pck_write_var_int(packet, palette.entries[0]);
 					pck_write_var_int(packet, 0);
-				} else if (palette.length < 255) {
+				} else {
 					// use palette
-					uint8_t bits_per_block;
-					if (palette.length < 17) {
-						bits_per_block = 4;
-					} else if (palette.length < 33) {
-						bits_per_block = 5;
-					} else if (palette.length < 65) {
-						bits_per_block = 6;
-					} else if (palette.length < 129) {
-						bits_per_block = 7;
-					} else {
-						bits_per_block = 8;
-					}
-					const uint8_t blocks_per_long = 64 / bits_per_block;
-					const int32_t data_array_length = 1 + (4095 / blocks_per_long);
-
-					pck_write_int8(packet, bits_per_block);
+					pck_write_int8(packet, palette.bits);
 					pck_write_var_int(packet, palette.length);
-					for (uint8_t j = 0; j < palette.length; ++j) {
-						pck_write_var_int(packet, palette.array[j]);
-					}
+					pck_write_var_shorts(packet, palette.entries, palette.length);
 
-					pck_write_var_int(packet, data_array_length);
-					
-					utl_encode_bytes_to_longs_r(block_array, 4096, bits_per_block, (int64_t*) pck_cursor(packet));
-					packet->cursor += data_array_length << 3;
-				} else {
-					// direct
-					const uint8_t bits_per_block = 15; // log2(block_state_count)
-					const uint8_t blocks_per_long = 64 / bits_per_block;
-					const int32_t data_array_length = 1 + (4095 / blocks_per_long);
-
-					pck_write_int8(packet, bits_per_block);
-					pck_write_var_int(packet, data_array_length); // data array length
-					
-					utl_encode_shorts_to_longs_r((int16_t*) wld_chunk_section_get_blocks(wld_chunk_get_section(chunk, i)), 4096, bits_per_block, (int64_t*) pck_cursor(packet));
-					packet->cursor += data_array_length << 3;
+					pck_write_var_int(packet, io_packed_longs(4096, palette.bits));
+					pck_write_packed_bytes(packet, palette.indices, 4096, palette.bits);
 				}
 			} else {
 				pck_write_int8(packet, 0);
@@ -1246,9 +1028,7 @@ void phd_send_chunk_data_and_update_light(ltg_client_t* client, wld_chunk_t* chu
 					}
 
 					pck_write_var_int(packet, data_array_length);
-					
-					utl_encode_bytes_to_longs_r(biome_array, 64, bits_per_biome, (int64_t*) pck_cursor(packet));
-					packet->cursor += data_array_length << 3;
+					pck_write_packed_bytes(packet, (uint8_t*) biome_array, 64, bits_per_biome);
 				} else {
 					// direct
 					const uint8_t bits_per_biome = 4; // log2(biome_count)
@@ -1257,9 +1037,7 @@ void phd_send_chunk_data_and_update_light(ltg_client_t* client, wld_chunk_t* chu
 
 					pck_write_int8(packet, bits_per_biome);
 					pck_write_var_int(packet, data_array_length); // data array length
-					
-					utl_encode_bytes_to_longs_r((int8_t*) wld_chunk_section_get_biomes(wld_chunk_get_section(chunk, i)), 64, bits_per_biome, (int64_t*) pck_cursor(packet));
-					packet->cursor += data_array_length << 3;
+					pck_write_packed_bytes(packet, wld_chunk_section_get_biomes(wld_chunk_get_section(chunk, i)), 64, bits_per_biome);
 				}
 			}
 		}
@@ -1333,12 +1111,7 @@ void phd_send_join_game(ltg_client_t* client) {
 	ltg_client_set_entity(client, player);
 	ent_register_entity(ent_player_get_entity(player));
 
-	// set last recieve packet to now
-	struct timespec time;
-	clock_gettime(CLOCK_REALTIME, &time);
-	ltg_client_set_last_receive(client, time.tv_sec * 1000 + time.tv_nsec / 0xF4240);
-
-	client->keep_alive = sch_schedule_repeating(job_new(job_keep_alive, (job_payload_t) { .client = client }), 200, 200);
+	kal_add(client);
 
 	const mat_codec_t* codec = mat_get_codec();
 	const mat_codec_t* dimension_codec = mat_get_dimension_codec(wld_get_environment(player_world));
@@ -1387,8 +1160,8 @@ void phd_send_join_game(ltg_client_t* client) {
 	phd_send_server_difficulty(client);
 	phd_send_player_abilities(client);
 	phd_send_held_item_change(client);
-	phd_send_declare_recipes(client); // TODO should be cached
-	phd_send_tags(client); // TODO should be cached
+	phd_send_declare_recipes(client);
+	phd_send_tags(client);
 	phd_send_entity_status(client, ent_player_get_entity(player), 24); // TODO actual op level
 	phd_send_declare_commands(client);
 	phd_send_unlock_recipes(client);
@@ -1408,10 +1181,10 @@ void phd_send_join_game(ltg_client_t* client) {
 	phd_send_update_health(client);
 
 	// TODO remove this, temporarily add two stacks of stone to inventory
-	itm_set_type(&player->inventory[0], mat_item_stone);
-	itm_set_count(&player->inventory[0], 64);
-	itm_set_type(&player->inventory[1], mat_item_stone);
-	itm_set_count(&player->inventory[1], 64);
+	itm_set_type(&player->slots[INV_PLAYER_MAIN], mat_item_stone);
+	itm_set_count(&player->slots[INV_PLAYER_MAIN], 64);
+	itm_set_type(&player->slots[INV_PLAYER_MAIN + 1], mat_item_stone);
+	itm_set_count(&player->slots[INV_PLAYER_MAIN + 1], 64);
 
 	phd_send_player_inventory(client);
 
@@ -1502,84 +1275,82 @@ void phd_send_death_combat_event(ltg_client_t* client, ent_player_t* player, ent
 
 }
 
+// one player of an add player action
+static void phd_write_player_info_add_player(pck_packet_t* packet, ltg_client_t* player) {
+
+	pck_write_bytes(packet, ltg_client_get_uuid(player), 16);
+	pck_write_string(packet, UTL_STRTOARG(ltg_client_get_username(player)));
+	if (ltg_client_has_textures(player)) {
+		pck_write_var_int(packet, 1);
+		pck_write_string(packet, UTL_CSTRTOARG("textures"));
+		pck_write_string(packet, UTL_STRTOARG(ltg_client_get_textures(player)));
+		if (ltg_client_has_textures_signature(player)) {
+			pck_write_int8(packet, true);
+			pck_write_string(packet, UTL_STRTOARG(ltg_client_get_textures_signature(player)));
+		} else {
+			pck_write_int8(packet, false);
+		}
+	} else {
+		pck_write_var_int(packet, 0);
+	}
+
+	ent_player_t* player_ent = ltg_client_get_entity(player);
+
+	pck_write_var_int(packet, ent_player_get_gamemode(player_ent)); // game mode
+
+	pck_write_var_int(packet, ltg_client_get_ping(player)); // ping
+
+	pck_write_int8(packet, false); // has display name
+
+}
+
 void phd_send_player_info_add_players(ltg_client_t* client) {
 
-	uint32_t online_count = ltg_get_online_count(sky_get_listener());
+	reg_enter();
+
+	const reg_snapshot_t* online = ltg_get_online(sky_get_listener());
 
-	if (online_count == 0) {
+	if (online->count == 0) {
+		reg_exit();
 		return;
 	}
 
-	PCK_INLINE(packet, 3 + (online_count * 2048), io_big_endian);
+	pck_packet_t* packet = pck_create(3 + (online->count * 2048), io_big_endian);
 
 	pck_write_var_int(packet, 0x36);
 	pck_write_var_int(packet, 0);
-	pck_write_var_int(packet, online_count);
+	pck_write_var_int(packet, online->count);
 
-	
-	const uint32_t online_length = ltg_get_online_length(sky_get_listener());
-	for (uint32_t i = 0; i < online_length; ++i) {
-		ltg_client_t* player = ltg_get_online_client(sky_get_listener(), i);
-		if (player != NULL) {
-			pck_write_bytes(packet, ltg_client_get_uuid(player), 16);
-			pck_write_string(packet, UTL_STRTOARG(ltg_client_get_username(player)));
-			if (ltg_client_has_textures(player)) {
-				pck_write_var_int(packet, 1);
-				pck_write_string(packet, UTL_CSTRTOARG("textures"));
-				pck_write_string(packet, UTL_STRTOARG(ltg_client_get_textures(player)));
-				if (ltg_client_has_textures_signature(player)) {
-					pck_write_int8(packet, 1);
-					pck_write_string(packet, UTL_STRTOARG(ltg_client_get_textures_signature(player)));
-				} else {
-					pck_write_int8(packet, 0);
-				}
-			} else {
-				pck_write_var_int(packet, 0);
-			}
-			
-			ent_player_t* player_ent = ltg_client_get_entity(player);
-
-			pck_write_var_int(packet, ent_player_get_gamemode(player_ent)); // game mode
-			
-			pck_write_var_int(packet, ltg_client_get_ping(player)); // ping
-			pck_write_int8(packet, 0); // has display name
-
-			if (--online_count == 0) break;
-		}
+	for (uint32_t i = 0; i < online->count; ++i) {
+		phd_write_player_info_add_player(packet, online->clients[i]);
 	}
 
+	reg_exit();
+
 	ltg_send(client, packet);
+	free(packet);
 
 }
 
-void phd_send_player_info_add_player(ltg_client_t* client, ltg_client_t* player) {
+ltg_blob_t* phd_create_player_info_add_player(ltg_client_t* player) {
 
 	PCK_INLINE(packet, 2048, io_big_endian);
 	pck_write_var_int(packet, 0x36);
 	pck_write_var_int(packet, 0); // action
 	pck_write_var_int(packet, 1); // number of players
-	pck_write_bytes(packet, ltg_client_get_uuid(player), 16);
-	pck_write_string(packet, UTL_STRTOARG(ltg_client_get_username(player)));
-	if (ltg_client_has_textures(player)) {
-		pck_write_var_int(packet, 1);
-		pck_write_string(packet, UTL_CSTRTOARG("textures"));
-		pck_write_string(packet, UTL_STRTOARG(ltg_client_get_textures(player)));
-		if (ltg_client_has_textures_signature(player)) {
-			pck_write_int8(packet, true);
-			pck_write_string(packet, UTL_STRTOARG(ltg_client_get_textures_signature(player)));
-		} else {
-			pck_write_int8(packet, false);
-		}
-	} else {
-		pck_write_var_int(packet, 0);
-	}
-	ent_player_t* player_ent = ltg_client_get_entity(player);
+	phd_write_player_info_add_player(packet, player);
 
-	pck_write_var_int(packet, ent_player_get_gamemode(player_ent)); // game mode
+	return ltg_create_blob(packet);
 
-	pck_write_var_int(packet, ltg_client_get_ping(player)); // ping
+}
 
-	pck_write_int8(packet, false); // has display name
+void phd_send_player_info_add_player(ltg_client_t* client, ltg_client_t* player) {
+
+	PCK_INLINE(packet, 2048, io_big_endian);
+	pck_write_var_int(packet, 0x36);
+	pck_write_var_int(packet, 0); // action
+	pck_write_var_int(packet, 1); // number of players
+	phd_write_player_info_add_player(packet, player);
 
 	ltg_send(client, packet);
 
@@ -1589,28 +1360,37 @@ void phd_send_player_info_update_gamemode(__attribute__((unused)) ltg_client_t*
 
 }
 
-void phd_send_player_info_update_latency(ltg_client_t* client) {
+ltg_blob_t* phd_create_player_info_update_latency(const reg_snapshot_t* online) {
 
-	uint32_t online_count = ltg_get_online_count(sky_get_listener());
+	uint32_t changed = 0;
+	for (uint32_t i = 0; i < online->count; ++i) {
+		changed += ltg_client_get_ping(online->clients[i]) != online->clients[i]->listed_ping;
+	}
 
-	PCK_INLINE(packet, 21 * online_count + 6, io_big_endian);
+	if (changed == 0) {
+		return NULL;
+	}
+
+	pck_packet_t* packet = pck_create(21 * changed + 6, io_big_endian);
 
 	pck_write_var_int(packet, 0x36);
 	pck_write_var_int(packet, 2); // update latency
-	pck_write_var_int(packet, online_count);
+	pck_write_var_int(packet, changed);
 	
-	const uint32_t online_length = ltg_get_online_length(sky_get_listener());
-	for (uint32_t i = 0; i < online_length; ++i) {
-		ltg_client_t* player = ltg_get_online_client(sky_get_listener(), i);
-		if (player != NULL) {
+	for (uint32_t i = 0; i < online->count; ++i) {
+		ltg_client_t* player = online->clients[i];
+		const int64_t ping = ltg_client_get_ping(player);
+		if (ping != player->listed_ping) {
 			pck_write_bytes(packet, ltg_client_get_uuid(player), 16);
-			pck_write_var_int(packet, ltg_client_get_ping(player));
-
-			if (--online_count == 0) break;
+			pck_write_var_int(packet, ping);
+			player->listed_ping = ping;
 		}
 	}
 
-	ltg_send(client, packet);
+	ltg_blob_t* blob = ltg_create_blob(packet);
+	free(packet);
+
+	return blob;
 
 }
 
@@ -1618,6 +1398,18 @@ void phd_send_player_info_update_display_name(__attribute__((unused)) ltg_client
 
 }
 
+ltg_blob_t* phd_create_player_info_remove_player(ltg_uuid_t uuid) {
+
+	PCK_INLINE(packet, 19, io_big_endian);
+	pck_write_var_int(packet, 0x36);
+	pck_write_var_int(packet, 4);
+	pck_write_var_int(packet, 1);
+	pck_write_bytes(packet, uuid, 16);
+
+	return ltg_create_blob(packet);
+
+}
+
 void phd_send_player_info_remove_player(ltg_client_t* client, ltg_uuid_t uuid) {
 
 	PCK_INLINE(packet, 19, io_big_endian);
@@ -1723,6 +1515,42 @@ void phd_send_entity_head_look(ltg_client_t* client, ent_living_entity_t* entity
 
 }
 
+ltg_blob_t* phd_create_block_change(int32_t x, int16_t y, int32_t z, mat_block_protocol_id_t block) {
+
+	PCK_INLINE(packet, 14, io_big_endian);
+
+	pck_write_var_int(packet, 0x0C);
+	pck_write_position(packet, (pck_position_t) {
+		.x = x,
+		.y = y,
+		.z = z
+	});
+	pck_write_var_int(packet, block);
+
+	return ltg_create_blob(packet);
+
+}
+
+ltg_blob_t* phd_create_multi_block_change(int32_t x, int32_t y, int32_t z, const uint16_t* indices, const mat_block_protocol_id_t* blocks, uint16_t count) {
+
+	// every record fits in 4 bytes as protocol ids stay below 2^16
+	PCK_INLINE(packet, 14 + (size_t) count * 4, io_big_endian);
+
+	pck_write_var_int(packet, 0x3F);
+	pck_write_int64(packet, ((uint64_t) (x & 0x3FFFFF) << 42) | ((uint64_t) (z & 0x3FFFFF) << 20) | ((uint64_t) y & 0xFFFFF));
+	pck_write_int8(packet, true); // don't trust edges
+	pck_write_var_int(packet, count);
+
+	for (uint16_t i = 0; i < count; ++i) {
+		// block indices are y z x, records want x z y
+		const uint16_t index = indices[i];
+		pck_write_var_long(packet, ((int64_t) blocks[i] << 12) | ((index & 0xF) << 8) | (((index >> 4) & 0xF) << 4) | (index >> 8));
+	}
+
+	return ltg_create_blob(packet);
+
+}
+
 void phd_send_held_item_change(ltg_client_t* client) {
 	
 	PCK_INLINE(packet, 2, io_big_endian);
@@ -1860,10 +1688,16 @@ void phd_send_living_entity_teleport(ltg_client_t* client, ent_living_entity_t*
 
 }
 
-void phd_send_declare_recipes(ltg_client_t* client) {
+static ltg_blob_t* phd_build_declare_recipes() {
+
+	// tags are spelled out, so recipes can get big
+	size_t size = 10;
+	for (size_t i = 0; i < rec_recipes.size; ++i) {
+		size += rec_get_serialized_size(UTL_VECTOR_GET_AS(rec_recipe_t*, &rec_recipes, i));
+	}
+
+	pck_packet_t* packet = pck_create(size, io_big_endian);
 
-	PCK_INLINE(packet, 6 + rec_recipes.size * 128, io_big_endian);
-	
 	pck_write_var_int(packet, 0x66);
 	pck_write_var_int(packet, rec_recipes.size);
 
@@ -1873,13 +1707,25 @@ void phd_send_declare_recipes(ltg_client_t* client) {
 
 	}
 
-	ltg_send(client, packet);
+	ltg_blob_t* blob = ltg_create_blob(packet);
+	free(packet);
+
+	return blob;
 
 }
 
-void phd_send_tags(ltg_client_t* client) {
+void phd_send_declare_recipes(ltg_client_t* client) {
 
-	PCK_INLINE(packet, 16384, io_big_endian);
+	ltg_blob_t* blob = phd_get_blob(&phd_blobs.recipes, rec_version, phd_build_declare_recipes);
+
+	ltg_send_blob(client, blob);
+	ltg_release_blob(blob);
+
+}
+
+static ltg_blob_t* phd_build_tags() {
+
+	pck_packet_t* packet = pck_create(16384, io_big_endian);
 
 	pck_write_var_int(packet, 0x67);
 	pck_write_var_int(packet, 5);
@@ -1939,7 +1785,42 @@ void phd_send_tags(ltg_client_t* client) {
 		}
 	}
 
-	ltg_send(client, packet);
+	ltg_blob_t* blob = ltg_create_blob(packet);
+	free(packet);
+
+	return blob;
+
+}
+
+void phd_send_tags(ltg_client_t* client) {
+
+	// tags never change while running
+	ltg_blob_t* blob = phd_get_blob(&phd_blobs.tags, 0, phd_build_tags);
+
+	ltg_send_blob(client, blob);
+	ltg_release_blob(blob);
+
+}
+
+void phd_init_blobs() {
+
+	ltg_release_blob(phd_get_blob(&phd_blobs.recipes, rec_version, phd_build_declare_recipes));
+	ltg_release_blob(phd_get_blob(&phd_blobs.tags, 0, phd_build_tags));
+	ltg_release_blob(phd_get_blob(&phd_blobs.commands, cmd_graph_version, phd_build_declare_commands));
+
+}
+
+void phd_term_blobs() {
+
+	with_lock (&phd_blobs.lock) {
+		phd_blob_t* blobs[] = { &phd_blobs.recipes, &phd_blobs.tags, &phd_blobs.commands };
+		for (uint32_t i = 0; i < 3; ++i) {
+			if (blobs[i]->blob != NULL) {
+				ltg_release_blob(blobs[i]->blob);
+				blobs[i]->blob = NULL;
+			}
+		}
+	}
 
 }
 
@@ -69,7 +69,7 @@ extern void phd_send_acknowledge_player_digging(ltg_client_t*);
 extern void phd_send_block_break_animation(ltg_client_t*);
 extern void phd_send_block_entity_data(ltg_client_t*);
 extern void phd_send_block_action(ltg_client_t*);
-extern void phd_send_block_change(ltg_client_t*);
+extern ltg_blob_t* phd_create_block_change(int32_t x, int16_t y, int32_t z, mat_block_protocol_id_t block);
 extern void phd_send_boss_bar(ltg_client_t*);
 extern void phd_send_server_difficulty(ltg_client_t* client);
 
@@ -83,7 +83,7 @@ extern void phd_send_close_window(ltg_client_t*);
 extern void phd_send_window_items(ltg_client_t*);
 extern void phd_send_player_inventory(ltg_client_t* client);
 extern void phd_send_window_property(ltg_client_t*);
-extern void phd_send_set_slot(ltg_client_t*);
+extern void phd_send_set_slot(ltg_client_t* client, int8_t window_id, uint32_t state_id, int16_t slot, const itm_item_t* item);
 extern void phd_send_set_cooldown(ltg_client_t*);
 extern void phd_send_plugin_message(ltg_client_t* client, const char* identifier, size_t identifier_length, const byte_t* data, size_t data_length);
 extern void phd_send_named_sound_effect(ltg_client_t*);
@@ -95,6 +95,7 @@ extern void phd_send_change_game_state(ltg_client_t*);
 extern void phd_send_open_horse_window(ltg_client_t*);
 extern void phd_send_initialize_world_border(ltg_client_t* client, wld_world_t* world);
 extern void phd_send_keep_alive(ltg_client_t* client, uint64_t id);
+extern ltg_blob_t* phd_create_keep_alive(int64_t id);
 extern void phd_send_chunk_data_and_update_light(ltg_client_t* client, wld_chunk_t* chunk);
 extern void phd_send_effect(ltg_client_t*);
 extern void phd_send_particle(ltg_client_t*);
@@ -119,8 +120,16 @@ extern void phd_send_death_combat_event(ltg_client_t* client, ent_player_t* play
 extern void phd_send_player_info_add_players(ltg_client_t* client);
 extern void phd_send_player_info_add_player(ltg_client_t* client, ltg_client_t* player);
 extern void phd_send_player_info_update_gamemode(ltg_client_t* client, ltg_client_t* player);
-// does NOT lock players list, expects it to be locked beforehand
-extern void phd_send_player_info_update_latency(ltg_client_t* client);
+
+// player info deltas built once and sent to everyone
+extern ltg_blob_t* phd_create_player_info_add_player(ltg_client_t* player);
+extern ltg_blob_t* phd_create_player_info_remove_player(ltg_uuid_t uuid);
+
+/*
+Latency of everyone whose ping changed since the last update, NULL if nobody's did
+*/
+extern ltg_blob_t* phd_create_player_info_update_latency(const reg_snapshot_t* online);
+
 extern void phd_send_player_info_update_display_name(ltg_client_t* client, ltg_client_t* player);
 extern void phd_send_player_info_remove_player(ltg_client_t* client, ltg_uuid_t uuid);
 
@@ -133,7 +142,12 @@ extern void phd_send_remove_entity_effect(ltg_client_t*);
 extern void phd_send_resource_pack_send(ltg_client_t*);
 extern void phd_send_respawn(ltg_client_t* client, wld_world_t* world, bool keep_metadata);
 extern void phd_send_entity_head_look(ltg_client_t* client, ent_living_entity_t* entity);
-extern void phd_send_multi_block_change(ltg_client_t*);
+
+/*
+Changes in the section at section coordinates `x`, `y`, `z`, `indices` are block indices in the section
+*/
+extern ltg_blob_t* phd_create_multi_block_change(int32_t x, int32_t y, int32_t z, const uint16_t* indices, const mat_block_protocol_id_t* blocks, uint16_t count);
+
 extern void phd_send_select_advancement_tab(ltg_client_t*);
 extern void phd_send_action_bar(ltg_client_t*);
 extern void phd_send_world_border_center(ltg_client_t*);
@@ -177,6 +191,10 @@ extern void phd_send_entity_effect(ltg_client_t*);
 extern void phd_send_declare_recipes(ltg_client_t* client);
 extern void phd_send_tags(ltg_client_t* client);
 
+// build the shared recipe, tag and command packets ahead of the first join
+extern void phd_init_blobs();
+extern void phd_term_blobs();
+
 static inline void phd_update_send_entity(ltg_client_t* client, ent_entity_t* entity) {
 	if (entity != ent_player_get_entity(ltg_client_get_entity(client))) {
 		switch (ent_get_type(entity)) {
@@ -1,6 +1,29 @@
 #include "status.h"
 #include "../../io/logger/logger.h"
 #include "../../io/chat/chat.h"
+#include "../../util/lock_util.h"
+
+// the response everyone gets, built again once `ltg_status_version` moves on
+static struct {
+
+	pthread_mutex_t lock;
+
+	ltg_blob_t* blob;
+	uint32_t version;
+
+} phd_status_cache = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.blob = NULL,
+	.version = 0
+};
+
+static lim_limiter_t phd_status_limiter = LIM_INITIALIZER(PHD_STATUS_RATE, PHD_STATUS_BURST);
+
+bool phd_take_status_token(ltg_client_t* client) {
+
+	return lim_take(&phd_status_limiter, client->address.addr.sin_addr.s_addr);
+
+}
 
 bool phd_status(ltg_client_t* client, pck_packet_t* packet) {
 
@@ -28,6 +51,11 @@ bool phd_handle_request(ltg_client_t* client, pck_packet_t* packet) {
 		return false;
 	}
 
+	// scanners and bots get dropped instead of answered
+	if (!phd_take_status_token(client)) {
+		return false;
+	}
+
 	phd_send_response(client);
 
 	return true;
@@ -44,9 +72,7 @@ bool phd_handle_ping(ltg_client_t* client, pck_packet_t* packet) {
 
 }
 
-void phd_send_response(ltg_client_t* client) {
-
-	// TODO cache SLP
+static ltg_blob_t* phd_build_response() {
 
 	char slp[2048];
 	int32_t slp_length = cht_server_list_ping(slp);
@@ -56,7 +82,45 @@ void phd_send_response(ltg_client_t* client) {
 	pck_write_var_int(response, 0x00);
 	pck_write_string(response, slp, slp_length);
 
-	ltg_send(client, response);
+	return ltg_create_blob(response);
+
+}
+
+void phd_send_response(ltg_client_t* client) {
+
+	ltg_blob_t* blob = NULL;
+
+	with_lock (&phd_status_cache.lock) {
+
+		const uint32_t version = ltg_status_version;
+
+		if (phd_status_cache.blob == NULL || phd_status_cache.version != version) {
+			if (phd_status_cache.blob != NULL) {
+				ltg_release_blob(phd_status_cache.blob);
+			}
+			phd_status_cache.blob = phd_build_response();
+			phd_status_cache.version = version;
+		}
+
+		blob = ltg_retain_blob(phd_status_cache.blob);
+
+	}
+
+	ltg_send_blob(client, blob);
+	ltg_release_blob(blob);
+
+}
+
+void phd_term_status() {
+
+	with_lock (&phd_status_cache.lock) {
+		if (phd_status_cache.blob != NULL) {
+			ltg_release_blob(phd_status_cache.blob);
+			phd_status_cache.blob = NULL;
+		}
+	}
+
+	lim_clear(&phd_status_limiter);
 
 }
 
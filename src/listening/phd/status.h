@@ -2,9 +2,19 @@
 #include "../../main.h"
 #include "../../io/packet/packet.h"
 #include "../listening.h"
+#include "../limiter/limiter.h"
+
+// status requests an address gets per second, and at once
+#define PHD_STATUS_RATE 4
+#define PHD_STATUS_BURST 16
 
 extern bool phd_status(ltg_client_t*, pck_packet_t*);
 
+// false if the address of the client sent too many status requests lately
+extern bool phd_take_status_token(ltg_client_t*);
+
+extern void phd_term_status();
+
 //inbound
 extern bool phd_handle_request(ltg_client_t*, pck_packet_t*);
 extern bool phd_handle_ping(ltg_client_t*, pck_packet_t*);
@@ -0,0 +1,309 @@
+#include <ctype.h>
+#include <sched.h>
+#include <string.h>
+#include <strings.h>
+#include "registry.h"
+#include "../listening.h"
+
+typedef struct reg_reader reg_reader_t;
+
+// a thread that read the registry at some point, records are reused once their thread exits
+struct reg_reader {
+
+	reg_reader_t* next;
+
+	// epoch the current read section started in, 0 outside of one
+	_Atomic uint64_t epoch;
+
+	_Atomic bool used;
+
+	// only touched by the owning thread
+	uint32_t depth;
+
+};
+
+static _Atomic(reg_reader_t*) reg_readers = NULL;
+static _Atomic uint64_t reg_epoch = 1;
+
+static __thread reg_reader_t* reg_reader = NULL;
+
+static pthread_key_t reg_reader_key;
+static pthread_once_t reg_reader_once = PTHREAD_ONCE_INIT;
+
+static const reg_snapshot_t reg_empty = { .count = 0, .mask = 0 };
+
+static void reg_release_reader(void* reader) {
+
+	((reg_reader_t*) reader)->used = false;
+
+}
+
+static void reg_create_reader_key() {
+
+	pthread_key_create(&reg_reader_key, reg_release_reader);
+
+}
+
+static reg_reader_t* reg_get_reader() {
+
+	if (reg_reader != NULL) {
+		return reg_reader;
+	}
+
+	pthread_once(&reg_reader_once, reg_create_reader_key);
+
+	// take over the record of a thread that is gone
+	for (reg_reader_t* reader = reg_readers; reader != NULL; reader = reader->next) {
+		bool used = false;
+		if (atomic_compare_exchange_strong(&reader->used, &used, true)) {
+			reg_reader = reader;
+			break;
+		}
+	}
+
+	if (reg_reader == NULL) {
+		reg_reader = calloc(1, sizeof(reg_reader_t));
+		reg_reader->used = true;
+		reg_reader->next = reg_readers;
+		while (!atomic_compare_exchange_weak(&reg_readers, &reg_reader->next, reg_reader));
+	}
+
+	pthread_setspecific(reg_reader_key, reg_reader);
+
+	return reg_reader;
+
+}
+
+void reg_enter() {
+
+	reg_reader_t* reader = reg_get_reader();
+
+	if (reader->depth++ == 0) {
+		reader->epoch = reg_epoch;
+	}
+
+}
+
+void reg_exit() {
+
+	reg_reader_t* reader = reg_reader;
+
+	if (--reader->depth == 0) {
+		reader->epoch = 0;
+	}
+
+}
+
+const reg_snapshot_t* reg_get_snapshot(reg_registry_t* registry) {
+
+	const reg_snapshot_t* snapshot = registry->snapshot;
+
+	return snapshot == NULL ? &reg_empty : snapshot;
+
+}
+
+void reg_synchronize() {
+
+	const uint64_t epoch = ++reg_epoch;
+
+	for (reg_reader_t* reader = reg_readers; reader != NULL; reader = reader->next) {
+
+		// a thread can't wait for itself
+		if (reader == reg_reader) {
+			continue;
+		}
+
+		uint64_t started;
+		while ((started = reader->epoch) != 0 && started < epoch) {
+			sched_yield();
+		}
+
+	}
+
+}
+
+static inline uint32_t reg_hash_entity_id(uint32_t entity_id) {
+	return entity_id * 0x9E3779B1u;
+}
+
+static inline uint32_t reg_hash_uuid(const byte_t* uuid) {
+
+	// random enough on its own
+	uint32_t hash;
+	memcpy(&hash, uuid + 12, sizeof(hash));
+
+	return hash;
+
+}
+
+// usernames are looked up ignoring case
+static inline uint32_t reg_hash_username(const char* username, size_t length) {
+
+	uint32_t hash = 0x811C9DC5;
+
+	for (size_t i = 0; i < length; ++i) {
+		hash = (hash ^ (byte_t) tolower(username[i])) * 0x01000193;
+	}
+
+	return hash;
+
+}
+
+static inline void reg_insert(uint32_t* table, uint32_t mask, uint32_t hash, uint32_t index) {
+
+	while (table[hash & mask] != 0) {
+		hash++;
+	}
+
+	table[hash & mask] = index + 1;
+
+}
+
+// copy of `old` with `client` added, or everyone but `removed` if that is set
+static reg_snapshot_t* reg_build(const reg_snapshot_t* old, ltg_client_t* added, uint32_t added_entity_id, const ltg_client_t* removed) {
+
+	bool present = false;
+	for (uint32_t i = 0; i < old->count; ++i) {
+		present |= old->clients[i] == removed;
+	}
+
+	const uint32_t count = old->count + (added != NULL) - present;
+
+	if (count == 0) {
+		return NULL;
+	}
+
+	// keep the tables at most half full
+	uint32_t size = 8;
+	while (size < count * 2) {
+		size <<= 1;
+	}
+
+	reg_snapshot_t* snapshot = calloc(1, sizeof(reg_snapshot_t) + sizeof(ltg_client_t*) * count + sizeof(uint32_t) * (size * 3 + count));
+	snapshot->count = count;
+	snapshot->mask = size - 1;
+	snapshot->by_entity_id = (uint32_t*) (snapshot->clients + count);
+	snapshot->by_uuid = snapshot->by_entity_id + size;
+	snapshot->by_username = snapshot->by_uuid + size;
+	snapshot->entity_ids = snapshot->by_username + size;
+
+	uint32_t index = 0;
+	for (uint32_t i = 0; i < old->count; ++i) {
+		if (old->clients[i] != removed) {
+			snapshot->clients[index] = old->clients[i];
+			snapshot->entity_ids[index] = old->entity_ids[i];
+			index++;
+		}
+	}
+	if (added != NULL) {
+		snapshot->clients[index] = added;
+		snapshot->entity_ids[index] = added_entity_id;
+	}
+
+	for (uint32_t i = 0; i < count; ++i) {
+		const ltg_client_t* client = snapshot->clients[i];
+		reg_insert(snapshot->by_entity_id, snapshot->mask, reg_hash_entity_id(snapshot->entity_ids[i]), i);
+		reg_insert(snapshot->by_uuid, snapshot->mask, reg_hash_uuid(client->uuid), i);
+		reg_insert(snapshot->by_username, snapshot->mask, reg_hash_username(client->username.value, client->username.length), i);
+	}
+
+	return snapshot;
+
+}
+
+static void reg_publish(reg_registry_t* registry, ltg_client_t* added, uint32_t added_entity_id, const ltg_client_t* removed) {
+
+	reg_snapshot_t* old = NULL;
+
+	with_lock (&registry->lock) {
+
+		old = registry->snapshot;
+
+		reg_snapshot_t* snapshot = reg_build(old == NULL ? &reg_empty : old, added, added_entity_id, removed);
+		registry->snapshot = snapshot;
+		registry->count = snapshot == NULL ? 0 : snapshot->count;
+
+	}
+
+	// wait for readers of the old snapshot before freeing it
+	reg_synchronize();
+	free(old);
+
+}
+
+void reg_add(reg_registry_t* registry, ltg_client_t* client, uint32_t entity_id) {
+
+	reg_publish(registry, client, entity_id, NULL);
+
+}
+
+void reg_remove(reg_registry_t* registry, ltg_client_t* client) {
+
+	reg_publish(registry, NULL, 0, client);
+
+}
+
+void reg_term(reg_registry_t* registry) {
+
+	with_lock (&registry->lock) {
+		free(registry->snapshot);
+		registry->snapshot = NULL;
+		registry->count = 0;
+	}
+
+}
+
+ltg_client_t* reg_get_by_entity_id(const reg_snapshot_t* snapshot, uint32_t entity_id) {
+
+	if (snapshot->count == 0) {
+		return NULL;
+	}
+
+	for (uint32_t hash = reg_hash_entity_id(entity_id);; ++hash) {
+		const uint32_t index = snapshot->by_entity_id[hash & snapshot->mask];
+		if (index == 0) {
+			return NULL;
+		}
+		if (snapshot->entity_ids[index - 1] == entity_id) {
+			return snapshot->clients[index - 1];
+		}
+	}
+
+}
+
+ltg_client_t* reg_get_by_uuid(const reg_snapshot_t* snapshot, const ltg_uuid_t uuid) {
+
+	if (snapshot->count == 0) {
+		return NULL;
+	}
+
+	for (uint32_t hash = reg_hash_uuid(uuid);; ++hash) {
+		const uint32_t index = snapshot->by_uuid[hash & snapshot->mask];
+		if (index == 0) {
+			return NULL;
+		}
+		if (memcmp(snapshot->clients[index - 1]->uuid, uuid, sizeof(ltg_uuid_t)) == 0) {
+			return snapshot->clients[index - 1];
+		}
+	}
+
+}
+
+ltg_client_t* reg_get_by_username(const reg_snapshot_t* snapshot, const char* username, size_t length) {
+
+	if (snapshot->count == 0) {
+		return NULL;
+	}
+
+	for (uint32_t hash = reg_hash_username(username, length);; ++hash) {
+		const uint32_t index = snapshot->by_username[hash & snapshot->mask];
+		if (index == 0) {
+			return NULL;
+		}
+		const string_t name = snapshot->clients[index - 1]->username;
+		if (name.length == length && strncasecmp(name.value, username, length) == 0) {
+			return snapshot->clients[index - 1];
+		}
+	}
+
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <pthread.h>
+#include "../../main.h"
+#include "../listening.d.h"
+
+/*
+	Online player registry
+
+	Readers never lock, they enter a read section and get an immutable snapshot of everyone online,
+	which stays valid until they leave it. Joins and leaves copy the snapshot, publish the copy and
+	wait until every reader that could still see the old one has left (epoch based reclamation),
+	so a player that was removed can be freed as soon as `reg_remove` returns
+
+	Don't add or remove players from inside a read section
+*/
+
+#define REG_REGISTRY_INITIALIZER { .lock = PTHREAD_MUTEX_INITIALIZER, .snapshot = NULL, .count = 0 }
+
+typedef struct {
+
+	uint32_t count;
+
+	// the lookup tables hold index + 1 into `clients`, 0 is empty
+	uint32_t mask;
+	uint32_t* by_entity_id;
+	uint32_t* by_uuid;
+	uint32_t* by_username;
+
+	uint32_t* entity_ids;
+
+	// in the order they joined
+	ltg_client_t* clients[];
+
+} reg_snapshot_t;
+
+typedef struct {
+
+	// taken by writers only
+	pthread_mutex_t lock;
+
+	_Atomic(reg_snapshot_t*) snapshot;
+
+	_Atomic uint32_t count;
+
+} reg_registry_t;
+
+/*
+Read sections nest, snapshots and the clients in them are only valid inside one
+*/
+extern void reg_enter();
+extern void reg_exit();
+
+extern const reg_snapshot_t* reg_get_snapshot(reg_registry_t* registry);
+
+extern void reg_add(reg_registry_t* registry, ltg_client_t* client, uint32_t entity_id);
+
+/*
+Once this returns no reader can still see the client
+*/
+extern void reg_remove(reg_registry_t* registry, ltg_client_t* client);
+
+/*
+Wait until every read section that started before this call has ended
+*/
+extern void reg_synchronize();
+
+extern void reg_term(reg_registry_t* registry);
+
+extern ltg_client_t* reg_get_by_entity_id(const reg_snapshot_t* snapshot, uint32_t entity_id);
+extern ltg_client_t* reg_get_by_uuid(const reg_snapshot_t* snapshot, const ltg_uuid_t uuid);
+extern ltg_client_t* reg_get_by_username(const reg_snapshot_t* snapshot, const char* username, size_t length);
+
+static inline uint32_t reg_get_count(reg_registry_t* registry) {
+	return registry->count;
+}
@@ -1,4 +1,8 @@
 #include "socket.h"
+#ifndef __WINDOWS__
+#include <netinet/tcp.h>
+#include <fcntl.h>
+#endif
 #include "../../io/logger/logger.h"
 
 // everything is different between *nix and windows again, so much preprocessor, good luck (shouldn't need to be changed though, it's pretty bare-bones)
@@ -50,7 +54,13 @@ int32_t sck_bind(int32_t s, struct sockaddr* addr, int32_t addrSize) {
 
 int32_t sck_listen(int32_t s) {
 
-	int32_t l = listen(s, 3);
+#ifdef TCP_DEFER_ACCEPT
+	// the client always talks first, connections that never do stay with the kernel
+	int32_t defer = SCK_DEFER_ACCEPT;
+	setsockopt(s, IPPROTO_TCP, TCP_DEFER_ACCEPT, &defer, sizeof(defer));
+#endif
+
+	int32_t l = listen(s, SCK_BACKLOG);
 
 	if (l != 0) {
 		log_error("Failed to listen on socket!");
@@ -63,13 +73,40 @@ int32_t sck_listen(int32_t s) {
 int32_t sck_accept(int32_t l, struct sockaddr* addr, int* addrSize) {
 
 #ifdef __WINDOWS__
-	return accept(l, addr, addrSize);
+	// accepted sockets inherit non blocking mode from the listening one here
+	const int32_t s = accept(l, addr, addrSize);
+	if (s != SCK_FAILED) {
+		sck_set_blocking(s, true);
+	}
+	return s;
 #else
 	return accept(l, addr, (unsigned int*) addrSize);
 #endif
 
 }
 
+int32_t sck_set_blocking(int32_t s, bool blocking) {
+
+#ifdef __WINDOWS__
+	u_long mode = !blocking;
+	return ioctlsocket(s, FIONBIO, &mode) == 0 ? SCK_OK : SCK_FAILED;
+#else
+	const int flags = fcntl(s, F_GETFL, 0);
+	return fcntl(s, F_SETFL, blocking ? flags & ~O_NONBLOCK : flags | O_NONBLOCK) == 0 ? SCK_OK : SCK_FAILED;
+#endif
+
+}
+
+int32_t sck_poll(struct pollfd* fds, uint32_t count, int32_t timeout) {
+
+#ifdef __WINDOWS__
+	return WSAPoll(fds, count, timeout);
+#else
+	return poll(fds, count, timeout);
+#endif
+
+}
+
 int32_t sck_send(int32_t s, char* message, int32_t len) {
 
 	return send(s, message, len, 0);
@@ -104,6 +141,47 @@ int32_t sck_close(int32_t s) {
 
 }
 
+int32_t sck_create_wake(int32_t* wake) {
+
+#ifdef __WINDOWS__
+	// WSAPoll only takes sockets
+	wake[0] = wake[1] = SCK_FAILED;
+	return SCK_FAILED;
+#else
+	if (pipe(wake) != 0) {
+		wake[0] = wake[1] = SCK_FAILED;
+		return SCK_FAILED;
+	}
+
+	// waking up never blocks, a full pipe wakes up just as well
+	fcntl(wake[0], F_SETFL, O_NONBLOCK);
+	fcntl(wake[1], F_SETFL, O_NONBLOCK);
+
+	return SCK_OK;
+#endif
+
+}
+
+void sck_wake(int32_t wake) {
+
+#ifndef __WINDOWS__
+	const byte_t signal = 1;
+	if (write(wake, &signal, 1) < 0) {
+		// already awake
+	}
+#endif
+
+}
+
+void sck_clear_wake(int32_t wake) {
+
+#ifndef __WINDOWS__
+	byte_t signals[64];
+	while (read(wake, signals, sizeof(signals)) > 0);
+#endif
+
+}
+
 void sck_term() {
 #ifdef __WINDOWS__
 	WSACleanup();
@@ -8,18 +8,32 @@
 #include <winsock2.h>
 #else
 #include <unistd.h>
+#include <poll.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #endif
 
+// half open connections the kernel queues for us
+#define SCK_BACKLOG SOMAXCONN
+
+// seconds the kernel holds on to a connection that has not sent anything before handing it over
+#define SCK_DEFER_ACCEPT 5
+
 extern int32_t sck_init();
 extern int32_t sck_create();
 extern int32_t sck_bind(int32_t, struct sockaddr*, int32_t);
 extern int32_t sck_listen(int32_t);
 extern int32_t sck_accept(int32_t, struct sockaddr*, int*);
+extern int32_t sck_set_blocking(int32_t, bool);
+extern int32_t sck_poll(struct pollfd*, uint32_t, int32_t);
 extern int32_t sck_send(int32_t, char*, int32_t);
 extern int32_t sck_recv(int32_t, char*, int32_t);
 extern int32_t sck_shutdown(int32_t);
 extern int32_t sck_close(int32_t);
 
+// a pipe a thread can poll on to be woken up, poll on [0] and wake with [1]
+extern int32_t sck_create_wake(int32_t* wake);
+extern void sck_wake(int32_t);
+extern void sck_clear_wake(int32_t);
+
 extern void sck_term();
@@ -15,7 +15,10 @@
 #include "io/json/mjson.h"
 #include "world/world.h"
 #include "world/material/material.h"
+#include "world/item/recipe/recipe.h"
+#include "world/fluids/fluids.h"
 #include "test/tests.h"
+#include "listening/auth/auth.h"
 
 sky_main_t sky_main = {
 	.protocol = __MC_PRO__,
@@ -58,9 +61,16 @@ sky_main_t sky_main = {
 			.vector = UTL_ID_VECTOR_INITIALIZER(ltg_client_t*)
 		},
 		.online = {
-			.lock = PTHREAD_MUTEX_INITIALIZER,
-			.vector = UTL_ID_VECTOR_INITIALIZER(ltg_client_t*),
+			.registry = REG_REGISTRY_INITIALIZER,
 			.max = 20
+		},
+		.pending = {
+			.timeout = LTG_HANDSHAKE_TIMEOUT
+		},
+		.limiter = {
+			.lock = PTHREAD_MUTEX_INITIALIZER,
+			.rate = LTG_CONNECTION_RATE,
+			.burst = LTG_CONNECTION_BURST
 		}
 	}
 
@@ -168,6 +178,11 @@ int main(int argc, char* argv[]) {
 	// encryption / login setup
 	curl_global_init(CURL_GLOBAL_DEFAULT);
 
+	// lookup tables for block states, tags and dig times, tests need them too
+	mat_init_block_states();
+	mat_init_tags();
+	mat_init_tools();
+
 	// run tests if args includes "test"
 	for (int i = 1; i < argc; ++i) {
 		switch (utl_hash(argv[i])) {
@@ -205,6 +220,9 @@ int main(int argc, char* argv[]) {
 
 	}
 
+	// water and lava flow, before plugins so they can change that
+	fld_init();
+
 	// load startup plugins
 	plg_on_startup();
 
@@ -220,6 +238,9 @@ int main(int argc, char* argv[]) {
 	// load postworld plugins
 	plg_on_postworld();
 
+	// index crafting recipes, plugins have added theirs by now
+	rec_build_index();
+
 	// initiate socket
 	ltg_init(sky_get_listener());
 
@@ -270,6 +291,9 @@ void* t_sky_main(__attribute__((unused)) void* input) {
 
 		clock_gettime(CLOCK_MONOTONIC, &currentTime);
 
+		// let the compression policy know how the last tick went
+		cmp_tick(sky_to_nanos(currentTime) > sky_to_nanos(nextTick) + SKY_NANOS_PER_TICK ? sky_to_nanos(currentTime) - sky_to_nanos(nextTick) : 0);
+
 		// sleep for correct time to next tick
 		if (sky_to_nanos(currentTime) < sky_to_nanos(nextTick)) {
 			sleepTime.tv_sec = nextTick.tv_sec - currentTime.tv_sec;
@@ -466,6 +490,9 @@ void sky_load_server_json() {
 				case 0x1b84769c: { // "server"
 					// TODO
 				} break;
+				case 0x2aed1a2d: { // "session-server"
+					ath_set_base_url(mjson_get_string(key_val.value));
+				} break;
 				case 0x4e682648: { // "prevent-proxy-connections"
 					sky_main.prevent_proxy_connections = mjson_get_boolean(key_val.value);
 				} break;
@@ -625,6 +652,8 @@ void sky_term() {
 
 	wld_unload_all();
 
+	rec_term_index();
+
 	// disable plugins
 	plg_on_disable();
 
@@ -107,6 +107,7 @@ static inline void sky_set_motd(cht_component_t* component) {
 		cht_free(sky_main.motd);
 	}
 	sky_main.motd = component;
+	ltg_invalidate_status();
 }
 
 static inline cmd_sender_t sky_get_console() {
@@ -193,6 +193,28 @@ typedef void* player_t;
 
 typedef void* entity_t;
 
+// WORLDS
+
+typedef void* world_t;
+
+// a block state, as its protocol id
+typedef uint16_t block_t;
+
+// both corners are included
+typedef struct {
+
+	int32_t min_x;
+	int32_t min_y;
+	int32_t min_z;
+
+	int32_t max_x;
+	int32_t max_y;
+	int32_t max_z;
+
+} box_t;
+
+typedef void* clipboard_t;
+
 // CHAT
 
 typedef enum {
@@ -388,6 +410,33 @@ typedef struct {
 
 	} chat;
 
+	// All world related functions
+	struct {
+
+		// Get the default world
+		world_t (*const get_default) ();
+
+		// Set every block in a box
+		// Returns the number of blocks that changed
+		uint64_t (*const fill) (world_t world, box_t box, block_t block);
+
+		// Set the blocks in a box the predicate is true for
+		// Returns the number of blocks that changed
+		uint64_t (*const replace) (world_t world, box_t box, bool (*predicate) (block_t block, void* data), void* data, block_t block);
+
+		// Copy the blocks in a box
+		// NOTE: You MUST free all clipboards you copy
+		clipboard_t (*const copy) (world_t world, box_t box);
+
+		// Paste a clipboard with its lowest corner at x, y, z
+		// Returns the number of blocks that changed
+		uint64_t (*const paste) (world_t world, const clipboard_t clipboard, int32_t x, int32_t y, int32_t z);
+
+		// Free a clipboard
+		void (*const free_clipboard) (clipboard_t clipboard);
+
+	} world;
+
 } motor_api_t;
 
 static motor_api_t const* motor;
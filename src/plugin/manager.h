@@ -8,6 +8,8 @@
 #include "../io/logger/logger.h"
 #include "../io/commands/commands.h"
 #include "../util/vector.h"
+#include "../world/world.h"
+#include "../world/edit/edit.h"
 
 #ifdef __WINDOWS__
 #include <windows.h>
@@ -104,6 +106,18 @@ struct plg_interface {
 
 	} chat;
 
+	struct {
+
+		wld_world_t* (*const get_default) ();
+
+		uint64_t (*const fill) (wld_world_t*, edt_box_t, mat_block_protocol_id_t);
+		uint64_t (*const replace) (wld_world_t*, edt_box_t, edt_predicate_t, void*, mat_block_protocol_id_t);
+		edt_clipboard_t* (*const copy) (wld_world_t*, edt_box_t);
+		uint64_t (*const paste) (wld_world_t*, const edt_clipboard_t*, int32_t, int32_t, int32_t);
+		void (*const free_clipboard) (edt_clipboard_t*);
+
+	} world;
+
 };
 
 static const plg_interface_t plg_interface = {
@@ -159,6 +173,15 @@ static const plg_interface_t plg_interface = {
 		.get_color = cht_get_color,
 		.add_extra = cht_add_extra,
 		.free = cht_free
+	},
+
+	.world = {
+		.get_default = wld_get_default,
+		.fill = edt_fill,
+		.replace = edt_replace,
+		.copy = edt_copy,
+		.paste = edt_paste,
+		.free_clipboard = edt_free_clipboard
 	}
 
 };
@@ -1,12 +1,47 @@
 #include "tests.h"
 #include <stdlib.h>
 #include <inttypes.h>
+#include <time.h>
+#include <libdeflate.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/resource.h>
+#include <sched.h>
 #include "../io/logger/logger.h"
 #include "../io/packet/packet.h"
+#include "../io/nbt/mnbt.h"
+#include "../io/batch/batch.h"
+#include "../listening/listening.h"
+#include "../listening/auth/auth.h"
+#include "../listening/compression/compression.h"
+#include "../listening/limiter/limiter.h"
+#include "../listening/keep_alive/keep_alive.h"
+#include "../listening/phd/status.h"
+#include "../listening/phd/play.h"
+#include "../motor.h"
 #include "../util/util.h"
+#include "../util/bit_vector.h"
 #include "../util/str_util.h"
 #include "../world/material/material.h"
 #include "../world/world.h"
+#include "../world/palette.h"
+#include "../world/item/recipe/recipe.h"
+#include "../world/fluids/fluids.h"
+#include "../world/edit/edit.h"
+#include "../world/entity/living/player/player.h"
+
+static uint64_t test_nanos() {
+
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return (uint64_t) time.tv_sec * 1000000000 + time.tv_nsec;
+
+}
 
 bool test_materials() {
 
@@ -175,21 +210,3509 @@ bool test_worlds() {
 
 }
 
-typedef struct {
-	bool (*func)();
-	string_t label;
-} test_t;
+static void test_nbt_stream(mnbt_writer* writer, const int32_t* ints, const int64_t* longs) {
 
-int test_run_all() {
+	mnbt_writer_tag(writer, MNBT_COMPOUND, UTL_CSTRTOARG(""));
+	mnbt_writer_tag(writer, MNBT_BYTE, UTL_CSTRTOARG("byte"));
+	mnbt_writer_byte(writer, -5);
+	mnbt_writer_tag(writer, MNBT_SHORT, UTL_CSTRTOARG("short"));
+	mnbt_writer_short(writer, 0x1234);
+	mnbt_writer_tag(writer, MNBT_LONG, UTL_CSTRTOARG("long"));
+	mnbt_writer_long(writer, 0x0102030405060708L);
+	mnbt_writer_tag(writer, MNBT_DOUBLE, UTL_CSTRTOARG("double"));
+	mnbt_writer_double(writer, 5.6789);
+	mnbt_writer_tag(writer, MNBT_STRING, UTL_CSTRTOARG("string"));
+	mnbt_writer_string(writer, UTL_CSTRTOARG("motor"));
+	mnbt_writer_tag(writer, MNBT_INT_ARRAY, UTL_CSTRTOARG("ints"));
+	mnbt_writer_int_array(writer, ints, 3);
+	mnbt_writer_tag(writer, MNBT_LONG_ARRAY, UTL_CSTRTOARG("longs"));
+	mnbt_writer_long_array(writer, longs, 2);
+	mnbt_writer_tag(writer, MNBT_LIST, UTL_CSTRTOARG("list"));
+	mnbt_writer_list(writer, MNBT_FLOAT, 3);
+	mnbt_writer_float(writer, 0.5);
+	mnbt_writer_float(writer, -1.25);
+	mnbt_writer_float(writer, 3);
+	mnbt_writer_end(writer);
 
-	const test_t tests[] = {
-		(test_t) {
-			.func = test_materials,
-			.label = UTL_CSTRTOSTR("materials")
-		},
-		(test_t) {
-			.func = test_packets,
-			.label = UTL_CSTRTOSTR("packets")
+}
+
+bool test_nbt() {
+
+	int32_t ints[] = { 1, -2, 0x12345678 };
+	int64_t longs[] = { 0x0102030405060708L, -3 };
+
+	// build with a document
+	mnbt_doc* doc = mnbt_new();
+	mnbt_tag* root = mnbt_new_tag(doc, UTL_CSTRTOARG(""), MNBT_COMPOUND, mnbt_val_compound());
+	mnbt_push_tag(root, mnbt_new_tag(doc, UTL_CSTRTOARG("byte"), MNBT_BYTE, mnbt_val_byte(-5)));
+	mnbt_push_tag(root, mnbt_new_tag(doc, UTL_CSTRTOARG("short"), MNBT_SHORT, mnbt_val_short(0x1234)));
+	mnbt_push_tag(root, mnbt_new_tag(doc, UTL_CSTRTOARG("long"), MNBT_LONG, mnbt_val_long(0x0102030405060708L)));
+	mnbt_push_tag(root, mnbt_new_tag(doc, UTL_CSTRTOARG("double"), MNBT_DOUBLE, mnbt_val_double(5.6789)));
+	mnbt_push_tag(root, mnbt_new_tag(doc, UTL_CSTRTOARG("string"), MNBT_STRING, mnbt_val_string(UTL_CSTRTOARG("motor"))));
+	mnbt_push_tag(root, mnbt_new_tag(doc, UTL_CSTRTOARG("ints"), MNBT_INT_ARRAY, mnbt_val_int_array(ints, 3)));
+	mnbt_push_tag(root, mnbt_new_tag(doc, UTL_CSTRTOARG("longs"), MNBT_LONG_ARRAY, mnbt_val_long_array(longs, 2)));
+	mnbt_tag* list = mnbt_new_tag(doc, UTL_CSTRTOARG("list"), MNBT_LIST, mnbt_val_list(MNBT_FLOAT));
+	mnbt_list_push(list, mnbt_val_float(0.5));
+	mnbt_list_push(list, mnbt_val_float(-1.25));
+	mnbt_list_push(list, mnbt_val_float(3));
+	mnbt_push_tag(root, list);
+	mnbt_set_root(doc, root);
+
+	uint8_t doc_bytes[512];
+	const size_t doc_length = mnbt_write(doc, doc_bytes, MNBT_NONE);
+	mnbt_free(doc);
+
+	// stream the same thing
+	uint8_t stream_bytes[512];
+	mnbt_writer nbt = mnbt_new_writer(stream_bytes, sizeof(stream_bytes));
+	test_nbt_stream(&nbt, ints, longs);
+
+	if (nbt.length != doc_length || memcmp(doc_bytes, stream_bytes, doc_length) != 0 || nbt.overflow) {
+		log_error("FAIL ON STREAMED NBT (%zu vs %zu bytes)", nbt.length, doc_length);
+		return false;
+	}
+
+	// without enough room nothing is written past the end and the packet cursor stays put
+	for (size_t room = 0; room < doc_length; room += room < 8 ? 1 : 7) {
+		pck_packet_t* small = pck_create(room + 1, io_big_endian);
+		pck_write_int8(small, 1);
+		mnbt_writer short_nbt = pck_begin_nbt(small);
+		test_nbt_stream(&short_nbt, ints, longs);
+		const bool ended = pck_end_nbt(small, &short_nbt);
+		free(small);
+		if (!short_nbt.overflow || short_nbt.length > room || ended) {
+			log_error("FAIL ON STREAMED NBT OVERFLOW (%zu bytes of room)", room);
+			return false;
+		}
+	}
+
+	// read back into a stack arena, small enough to need extra blocks
+	_Alignas(16) uint8_t arena[256];
+	mnbt_doc* read = mnbt_read_arena(stream_bytes, nbt.length, NULL, MNBT_NONE, arena, sizeof(arena));
+	mnbt_tag* read_root = mnbt_get_root(read);
+
+	if (mnbt_get_type(read_root) != MNBT_COMPOUND || mnbt_get_size(read_root) != 8) {
+		log_error("FAIL ON ARENA READ");
+		return false;
+	}
+
+	if (mnbt_get_long(mnbt_get_tag(read_root, 2)) != 0x0102030405060708L || mnbt_get_long_array(mnbt_get_tag(read_root, 6))[0] != 0x0102030405060708L || mnbt_get_long_array(mnbt_get_tag(read_root, 6))[1] != -3) {
+		log_error("FAIL ON NBT LONG");
+		return false;
+	}
+
+	if (utl_dabs(mnbt_get_double(mnbt_get_tag(read_root, 3)) - 5.6789) > 0.0001 || strcmp(mnbt_get_string(mnbt_get_tag(read_root, 4)), "motor") != 0 || mnbt_get_int_array(mnbt_get_tag(read_root, 5))[2] != 0x12345678) {
+		log_error("FAIL ON NBT VALUES");
+		return false;
+	}
+
+	if (mnbt_get_size(mnbt_get_tag(read_root, 7)) != 3 || mnbt_val_get_float(mnbt_get_list(mnbt_get_tag(read_root, 7), 1)) != -1.25) {
+		log_error("FAIL ON NBT LIST");
+		return false;
+	}
+
+	// writing the arena document gives the same bytes back
+	if (mnbt_write(read, doc_bytes, MNBT_NONE) != nbt.length || memcmp(doc_bytes, stream_bytes, nbt.length) != 0) {
+		log_error("FAIL ON ARENA WRITE");
+		return false;
+	}
+
+	mnbt_free(read);
+
+	return true;
+
+}
+
+static bool test_nbt_cursor_matches(mnbt_type type, mnbt_val val, const mnbt_cursor* cursor) {
+
+	if (cursor->type != type) {
+		return false;
+	}
+
+	switch (type) {
+		case MNBT_BYTE:
+			return mnbt_cursor_get_byte(cursor) == val.Byte;
+		case MNBT_SHORT:
+			return mnbt_cursor_get_short(cursor) == val.Short;
+		case MNBT_INT:
+			return mnbt_cursor_get_int(cursor) == val.Int;
+		case MNBT_LONG:
+			return mnbt_cursor_get_long(cursor) == val.Long;
+		case MNBT_FLOAT:
+			return mnbt_cursor_get_float(cursor) == val.Float;
+		case MNBT_DOUBLE:
+			return mnbt_cursor_get_double(cursor) == val.Double;
+		case MNBT_STRING:
+			return mnbt_cursor_get_size(cursor) == val.String.length && memcmp(mnbt_cursor_get_string(cursor), val.String.string, val.String.length) == 0;
+		case MNBT_BYTE_ARRAY:
+			return mnbt_cursor_get_size(cursor) == val.Byte_Array.size && memcmp(mnbt_cursor_get_array(cursor), val.Byte_Array.bytes, val.Byte_Array.size) == 0;
+		case MNBT_INT_ARRAY: {
+			if (mnbt_cursor_get_size(cursor) != val.Int_Array.size) return false;
+			for (uint32_t i = 0; i < val.Int_Array.size; ++i) {
+				if (mnbt_cursor_get_int_at(cursor, i) != val.Int_Array.ints[i]) return false;
+			}
+			return true;
+		}
+		case MNBT_LONG_ARRAY: {
+			if (mnbt_cursor_get_size(cursor) != val.Long_Array.size) return false;
+			int64_t longs[val.Long_Array.size + 1];
+			mnbt_cursor_read_longs(cursor, longs);
+			return memcmp(longs, val.Long_Array.longs, val.Long_Array.size * sizeof(int64_t)) == 0;
+		}
+		case MNBT_LIST: {
+			mnbt_cursor elements[val.List.size + 1];
+			if (mnbt_cursor_index(cursor, elements, val.List.size + 1) != val.List.size) return false;
+			for (uint32_t i = 0; i < val.List.size; ++i) {
+				if (!test_nbt_cursor_matches(val.List.type, val.List.list[i], &elements[i])) return false;
+			}
+			return true;
+		}
+		case MNBT_COMPOUND: {
+			mnbt_cursor children[val.Compound.size + 1];
+			if (mnbt_cursor_index(cursor, children, val.Compound.size + 1) != val.Compound.size) return false;
+			for (uint32_t i = 0; i < val.Compound.size; ++i) {
+				mnbt_tag* tag = val.Compound.tags[i];
+				const mnbt_cursor* child = mnbt_index_find(children, val.Compound.size, tag->label, tag->label_length);
+				if (child == NULL || !test_nbt_cursor_matches(tag->type, tag->value, child)) return false;
+			}
+			return true;
+		}
+		default:
+			return false;
+	}
+
+}
+
+bool test_nbt_cursor() {
+
+	// chunk shaped document
+	mnbt_doc* doc = mnbt_new();
+	mnbt_tag* root = mnbt_new_tag(doc, UTL_CSTRTOARG(""), MNBT_COMPOUND, mnbt_val_compound());
+	mnbt_tag* level = mnbt_new_tag(doc, UTL_CSTRTOARG("Level"), MNBT_COMPOUND, mnbt_val_compound());
+	mnbt_push_tag(level, mnbt_new_tag(doc, UTL_CSTRTOARG("xPos"), MNBT_INT, mnbt_val_int(-12)));
+	mnbt_push_tag(level, mnbt_new_tag(doc, UTL_CSTRTOARG("Status"), MNBT_STRING, mnbt_val_string(UTL_CSTRTOARG("full"))));
+	mnbt_tag* sections = mnbt_new_tag(doc, UTL_CSTRTOARG("sections"), MNBT_LIST, mnbt_val_list(MNBT_COMPOUND));
+	for (int8_t y = -4; y < 4; ++y) {
+		int64_t states[64];
+		for (uint32_t i = 0; i < 64; ++i) {
+			states[i] = ((int64_t) y << 40) * (i + 1);
+		}
+		mnbt_val section = mnbt_val_compound();
+		mnbt_val_push_tag(&section, mnbt_new_tag(doc, UTL_CSTRTOARG("Y"), MNBT_BYTE, mnbt_val_byte(y)));
+		mnbt_val_push_tag(&section, mnbt_new_tag(doc, UTL_CSTRTOARG("block_states"), MNBT_LONG_ARRAY, mnbt_val_long_array(states, 64)));
+		mnbt_list_push(sections, section);
+	}
+	mnbt_push_tag(level, sections);
+	mnbt_tag* position = mnbt_new_tag(doc, UTL_CSTRTOARG("Pos"), MNBT_LIST, mnbt_val_list(MNBT_DOUBLE));
+	mnbt_list_push(position, mnbt_val_double(1.5));
+	mnbt_list_push(position, mnbt_val_double(64));
+	mnbt_list_push(position, mnbt_val_double(-7.25));
+	mnbt_push_tag(root, level);
+	mnbt_push_tag(root, position);
+	mnbt_set_root(doc, root);
+
+	uint8_t bytes[8192];
+	const size_t length = mnbt_write(doc, bytes, MNBT_NONE);
+	mnbt_free(doc);
+
+	mnbt_cursor cursor;
+	if (!mnbt_cursor_open(&cursor, bytes, length) || mnbt_cursor_length(&cursor) != length - 3) {
+		log_error("FAIL ON CURSOR OPEN");
+		return false;
+	}
+
+	// every value matches what mnbt_read parses
+	mnbt_doc* read = mnbt_read(bytes, length, NULL, MNBT_NONE);
+	if (!test_nbt_cursor_matches(MNBT_COMPOUND, mnbt_get_root(read)->value, &cursor)) {
+		log_error("FAIL ON CURSOR MATCHING READ");
+		return false;
+	}
+
+	mnbt_cursor found;
+	if (!mnbt_cursor_path(&cursor, "Level.sections[5].block_states", &found) || !test_nbt_cursor_matches(MNBT_LONG_ARRAY, mnbt_val_get_tag(mnbt_get_list(mnbt_get_tag(mnbt_get_tag(mnbt_get_root(read), 0), 2), 5), 1)->value, &found)) {
+		log_error("FAIL ON CURSOR PATH");
+		return false;
+	}
+	if (mnbt_cursor_get_long_at(&found, 3) != ((int64_t) 1 << 40) * 4) {
+		log_error("FAIL ON CURSOR LONG ARRAY");
+		return false;
+	}
+
+	mnbt_free(read);
+
+	if (!mnbt_cursor_path(&cursor, "Pos[2]", &found) || mnbt_cursor_get_double(&found) != -7.25) {
+		log_error("FAIL ON CURSOR LIST PATH");
+		return false;
+	}
+
+	if (mnbt_cursor_path(&cursor, "Level.sections[8]", &found) || mnbt_cursor_path(&cursor, "Level.missing", &found) || mnbt_cursor_path(&cursor, "Level.xPos[0]", &found)) {
+		log_error("FAIL ON CURSOR MISSING PATH");
+		return false;
+	}
+
+	// truncated input is rejected instead of read past
+	mnbt_cursor truncated;
+	if (!mnbt_cursor_open(&truncated, bytes, length - 100) || mnbt_cursor_length(&truncated) != 0 || mnbt_cursor_path(&truncated, "Pos[0]", &found)) {
+		log_error("FAIL ON TRUNCATED CURSOR");
+		return false;
+	}
+
+	// cut off anywhere, whatever is found can be read without going past the end
+	for (size_t cut = 1; cut < length; ++cut) {
+
+		uint8_t* cut_bytes = malloc(cut);
+		memcpy(cut_bytes, bytes, cut);
+
+		if (mnbt_cursor_open(&truncated, cut_bytes, cut)) {
+
+			int64_t sink = 0;
+			int64_t states[64];
+
+			for (uint32_t y = 0; y < 8; ++y) {
+				char path[48];
+				sprintf(path, "Level.sections[%u]", y);
+				mnbt_cursor section, value;
+				if (!mnbt_cursor_path(&truncated, path, &section)) {
+					continue;
+				}
+				if (mnbt_cursor_child(&section, UTL_CSTRTOARG("Y"), &value)) {
+					sink += mnbt_cursor_get_byte(&value);
+				}
+				if (mnbt_cursor_child(&section, UTL_CSTRTOARG("block_states"), &value)) {
+					const uint32_t size = mnbt_cursor_get_size(&value);
+					if (size > 64 || (size == 0) != (mnbt_cursor_get_array(&value) == NULL)) {
+						log_error("FAIL ON TRUNCATED ARRAY SIZE (%zu)", cut);
+						return false;
+					}
+					mnbt_cursor_read_longs(&value, states);
+					sink += mnbt_cursor_get_long_at(&value, 3) + mnbt_cursor_get_long_at(&value, 63) + mnbt_cursor_get_long(&value);
+				}
+			}
+			if (mnbt_cursor_path(&truncated, "Level.Status", &found)) {
+				const char* status = mnbt_cursor_get_string(&found);
+				sink += status != NULL ? status[mnbt_cursor_get_size(&found) - 1] : 0;
+			}
+			if (mnbt_cursor_path(&truncated, "Level.xPos", &found)) {
+				sink += mnbt_cursor_get_int(&found) + mnbt_cursor_get_long(&found);
+			}
+			for (uint32_t i = 0; i < 3; ++i) {
+				char path[8];
+				sprintf(path, "Pos[%u]", i);
+				if (mnbt_cursor_path(&truncated, path, &found)) {
+					sink += mnbt_cursor_get_double(&found);
+				}
+			}
+
+			(void) sink;
+
+		}
+
+		free(cut_bytes);
+
+	}
+
+	// the header of the last array is there, its values are not
+	if (!mnbt_cursor_open(&truncated, bytes, length - 100) || !mnbt_cursor_path(&truncated, "Level.sections[7].block_states", &found) || mnbt_cursor_get_size(&found) != 0 || mnbt_cursor_get_array(&found) != NULL || mnbt_cursor_get_long_at(&found, 3) != 0) {
+		log_error("FAIL ON TRUNCATED CURSOR GETTERS");
+		return false;
+	}
+
+	// a list of end tags takes no bytes, only an empty one is allowed
+	byte_t end_list[] = { MNBT_COMPOUND, 0, 0, MNBT_LIST, 0, 1, 'l', MNBT_END, 0xff, 0xff, 0xff, 0xff, MNBT_END };
+	mnbt_cursor end_cursor, end_element;
+	if (!mnbt_cursor_open(&end_cursor, end_list, sizeof(end_list)) || mnbt_cursor_length(&end_cursor) != 0 || !mnbt_cursor_child(&end_cursor, UTL_CSTRTOARG("l"), &found) || mnbt_cursor_element(&found, 1000000, &end_element) || mnbt_cursor_index(&found, &end_element, 1) != 0) {
+		log_error("FAIL ON END LIST");
+		return false;
+	}
+	memset(end_list + 8, 0, 4);
+	if (!mnbt_cursor_open(&end_cursor, end_list, sizeof(end_list)) || mnbt_cursor_length(&end_cursor) != sizeof(end_list) - 3) {
+		log_error("FAIL ON EMPTY END LIST");
+		return false;
+	}
+
+	return true;
+
+}
+
+bool test_batch() {
+
+	srand(1);
+
+	uint8_t bytes[4096];
+	uint16_t shorts[4096];
+	byte_t scalar[4096 * 5];
+	byte_t fast[4096 * 5];
+
+	// packing matches the scalar path for every width and for partial longs
+	for (uint8_t bits = 1; bits <= 8; ++bits) {
+		for (uint32_t i = 0; i < 4096; ++i) {
+			bytes[i] = rand() & ((1 << bits) - 1);
+		}
+		for (uint32_t count = 4032; count <= 4096; count += 63) {
+			const size_t longs = io_pack_bytes_scalar(bytes, count, bits, scalar);
+			if (longs != io_packed_longs(count, bits) || io_pack_bytes(bytes, count, bits, fast) != longs || memcmp(scalar, fast, longs << 3) != 0) {
+				log_error("FAIL ON PACK BYTES (%u bits, %u values)", bits, count);
+				return false;
+			}
+		}
+		// check the layout, value j sits in long j / values per long
+		const uint8_t values_per_long = io_values_per_long[bits];
+		for (uint32_t j = 0; j < 4096; j += 97) {
+			const uint64_t packed = io_read_int64(fast + ((j / values_per_long) << 3), io_big_endian);
+			if (((packed >> ((j % values_per_long) * bits)) & ((1 << bits) - 1)) != bytes[j]) {
+				log_error("FAIL ON PACK LAYOUT (%u bits, value %u)", bits, j);
+				return false;
+			}
+		}
+	}
+	for (uint32_t i = 0; i < 4096; ++i) {
+		shorts[i] = rand() & 0x7FFF;
+	}
+	if (io_pack_shorts(shorts, 4096, 15, fast) != 1024 || io_read_int64(fast + 8, io_big_endian) != (int64_t) (shorts[4] | ((uint64_t) shorts[5] << 15) | ((uint64_t) shorts[6] << 30) | ((uint64_t) shorts[7] << 45))) {
+		log_error("FAIL ON PACK SHORTS");
+		return false;
+	}
+
+	// var ints, mostly single byte with some longer ones mixed in
+	uint32_t ints[4096];
+	uint32_t read[4096];
+	for (uint32_t i = 0; i < 4096; ++i) {
+		ints[i] = (rand() % 10 == 0) ? (uint32_t) rand() << (rand() % 8) : (uint32_t) rand() & 0x7F;
+		shorts[i] = ints[i];
+	}
+	const size_t var_length = io_write_var_ints_scalar(scalar, ints, 4096);
+	if (io_write_var_ints(fast, ints, 4096) != var_length || memcmp(scalar, fast, var_length) != 0) {
+		log_error("FAIL ON WRITE VAR INTS");
+		return false;
+	}
+	if (io_read_var_ints(fast, var_length, read, 4096) != var_length || memcmp(read, ints, sizeof(ints)) != 0) {
+		log_error("FAIL ON READ VAR INTS");
+		return false;
+	}
+	if (io_read_var_ints(fast, var_length - 1, read, 4096) != 0) {
+		log_error("FAIL ON TRUNCATED VAR INTS");
+		return false;
+	}
+	const size_t short_length = io_write_var_shorts_scalar(scalar, shorts, 4096);
+	if (io_write_var_shorts(fast, shorts, 4096) != short_length || memcmp(scalar, fast, short_length) != 0) {
+		log_error("FAIL ON WRITE VAR SHORTS");
+		return false;
+	}
+
+	// benchmark one chunk section worth of values
+	const uint32_t rounds = 2000;
+	volatile byte_t sink = 0;
+	for (uint8_t bits = 4; bits <= 8; bits += 4) {
+		uint64_t start = test_nanos();
+		for (uint32_t r = 0; r < rounds; ++r) {
+			io_pack_bytes_scalar(bytes, 4096, bits, scalar);
+			sink ^= scalar[r & 0xFF];
+		}
+		const uint64_t scalar_time = test_nanos() - start;
+		start = test_nanos();
+		for (uint32_t r = 0; r < rounds; ++r) {
+			io_pack_bytes(bytes, 4096, bits, fast);
+			sink ^= fast[r & 0xFF];
+		}
+		const uint64_t fast_time = test_nanos() - start;
+		log_info("Pack 4096 x %u bits: %" PRIu64 "ns scalar, %" PRIu64 "ns batched", bits, scalar_time / rounds, fast_time / rounds);
+	}
+	for (uint32_t i = 0; i < 4096; ++i) {
+		ints[i] &= 0x7F;
+	}
+	uint64_t start = test_nanos();
+	for (uint32_t r = 0; r < rounds; ++r) {
+		io_write_var_ints_scalar(scalar, ints, 4096);
+		sink ^= scalar[r & 0xFF];
+	}
+	uint64_t scalar_time = test_nanos() - start;
+	start = test_nanos();
+	for (uint32_t r = 0; r < rounds; ++r) {
+		io_write_var_ints(fast, ints, 4096);
+		sink ^= fast[r & 0xFF];
+	}
+	uint64_t fast_time = test_nanos() - start;
+	log_info("Write 4096 var ints: %" PRIu64 "ns scalar, %" PRIu64 "ns batched", scalar_time / rounds, fast_time / rounds);
+	start = test_nanos();
+	for (uint32_t r = 0; r < rounds; ++r) {
+		io_read_var_ints_scalar(fast, 4096, read, 4096);
+		sink ^= read[r & 0xFF];
+	}
+	scalar_time = test_nanos() - start;
+	start = test_nanos();
+	for (uint32_t r = 0; r < rounds; ++r) {
+		io_read_var_ints(fast, 4096, read, 4096);
+		sink ^= read[r & 0xFF];
+	}
+	fast_time = test_nanos() - start;
+	log_info("Read 4096 var ints: %" PRIu64 "ns scalar, %" PRIu64 "ns batched", scalar_time / rounds, fast_time / rounds);
+
+	return true;
+
+}
+
+// the linear search palette builder chunk encoding used before wld_palettize
+static uint16_t test_palette_linear(const mat_block_protocol_id_t* blocks, mat_block_protocol_id_t* entries, uint8_t* indices) {
+
+	uint16_t length = 0;
+	uint16_t k = 0;
+
+	for (uint16_t j = 0; j < 4096; ++j) {
+		if (j > 0 && blocks[j] == blocks[j - 1]) {
+			indices[j] = k;
+			continue;
+		}
+		k = 0;
+		while (k < length && entries[k] != blocks[j]) {
+			k++;
+		}
+		if (k == length) {
+			if (length == WLD_PALETTE_MAX) {
+				return 0;
+			}
+			entries[length++] = blocks[j];
+		}
+		indices[j] = k;
+	}
+
+	return length;
+
+}
+
+bool test_palette() {
+
+	srand(2);
+
+	struct {
+		const char* name;
+		mat_block_protocol_id_t blocks[4096];
+	} sections[4];
+
+	// realistic terrain: stone with scattered ores, a few dirt layers, a grass layer, then air
+	sections[0].name = "terrain";
+	const mat_block_protocol_id_t ores[] = {
+		mat_get_block_default_protocol_id_by_type(mat_block_coal_ore),
+		mat_get_block_default_protocol_id_by_type(mat_block_iron_ore),
+		mat_get_block_default_protocol_id_by_type(mat_block_gravel),
+		mat_get_block_default_protocol_id_by_type(mat_block_andesite)
+	};
+	for (uint16_t j = 0; j < 4096; ++j) {
+		const uint8_t y = j >> 8;
+		mat_block_protocol_id_t block = mat_get_block_default_protocol_id_by_type(mat_block_air);
+		if (y < 9) {
+			block = rand() % 20 == 0 ? ores[rand() % 4] : mat_get_block_default_protocol_id_by_type(mat_block_stone);
+		} else if (y < 12) {
+			block = mat_get_block_default_protocol_id_by_type(mat_block_dirt);
+		} else if (y == 12) {
+			block = mat_get_block_default_protocol_id_by_type(mat_block_grass_block);
+		}
+		sections[0].blocks[j] = block;
+	}
+
+	// one state
+	sections[1].name = "uniform";
+	for (uint16_t j = 0; j < 4096; ++j) {
+		sections[1].blocks[j] = mat_get_block_default_protocol_id_by_type(mat_block_stone);
+	}
+
+	// worst case for a palette: 256 states in random order
+	sections[2].name = "256 random";
+	for (uint16_t j = 0; j < 4096; ++j) {
+		sections[2].blocks[j] = j < 256 ? j * 3 : (rand() % 256) * 3;
+	}
+
+	// too many states, falls back to direct
+	sections[3].name = "direct";
+	for (uint16_t j = 0; j < 4096; ++j) {
+		sections[3].blocks[j] = j;
+	}
+
+	wld_palette_t palette;
+	mat_block_protocol_id_t entries[WLD_PALETTE_MAX];
+	uint8_t indices[4096];
+
+	for (uint8_t s = 0; s < 4; ++s) {
+
+		const uint16_t length = test_palette_linear(sections[s].blocks, entries, indices);
+		const bool fits = wld_palettize(sections[s].blocks, &palette);
+
+		if (fits != (length != 0) || palette.length != length || palette.bits != wld_palette_bits(length)) {
+			log_error("FAIL ON PALETTE LENGTH (%s, %u vs %u)", sections[s].name, palette.length, length);
+			return false;
+		}
+		if (fits && (memcmp(palette.entries, entries, length * sizeof(mat_block_protocol_id_t)) != 0 || memcmp(palette.indices, indices, 4096) != 0)) {
+			log_error("FAIL ON PALETTE INDICES (%s)", sections[s].name);
+			return false;
+		}
+
+		const uint32_t rounds = 1000;
+		volatile uint8_t sink = 0;
+		uint64_t start = test_nanos();
+		for (uint32_t r = 0; r < rounds; ++r) {
+			test_palette_linear(sections[s].blocks, entries, indices);
+			sink ^= indices[r & 0xFFF];
+		}
+		const uint64_t linear_time = test_nanos() - start;
+		start = test_nanos();
+		for (uint32_t r = 0; r < rounds; ++r) {
+			wld_palettize(sections[s].blocks, &palette);
+			sink ^= palette.indices[r & 0xFFF];
+		}
+		const uint64_t fast_time = test_nanos() - start;
+		log_info("Palettize %s (%u states): %" PRIu64 "ns linear, %" PRIu64 "ns palettizer", sections[s].name, length, linear_time / rounds, fast_time / rounds);
+
+	}
+
+	if (wld_palette_bits(2) != 4 || wld_palette_bits(17) != 5 || wld_palette_bits(256) != 8 || wld_palette_bits(1) != 0) {
+		log_error("FAIL ON PALETTE BITS");
+		return false;
+	}
+
+	return true;
+
+}
+
+bool test_compression() {
+
+	srand(3);
+
+	// chunk like payload: packed palette indices, lots of repeats
+	byte_t chunk[16384];
+	chunk[0] = 0x22;
+	for (size_t i = 1; i < sizeof(chunk); ++i) {
+		chunk[i] = (i & 0x3FF) < 600 ? 0x11 : (rand() % 8 == 0 ? rand() & 0xFF : 0x21);
+	}
+
+	// chat like payload: json text
+	byte_t chat[2048];
+	chat[0] = 0x0f;
+	const char* text = "{\"text\":\"hello there\",\"color\":\"gold\",\"extra\":[{\"text\":\"general kenobi \"}]}";
+	for (size_t i = 1; i < sizeof(chat); ++i) {
+		chat[i] = text[i % strlen(text)];
+	}
+
+	// random bytes, nothing to gain
+	byte_t noise[8192];
+	noise[0] = 0x18;
+	for (size_t i = 1; i < sizeof(noise); ++i) {
+		noise[i] = rand() & 0xFF;
+	}
+
+	if (cmp_classify(ltg_play, chunk, sizeof(chunk)) != cmp_chunk || cmp_classify(ltg_play, chat, sizeof(chat)) != cmp_chat || cmp_classify(ltg_login, chunk, sizeof(chunk)) != cmp_other || cmp_classify(ltg_play, (const byte_t[]) { 0x29 }, 1) != cmp_entity) {
+		log_error("FAIL ON COMPRESSION CLASSIFY");
+		return false;
+	}
+
+	if (!cmp_is_incompressible(noise, sizeof(noise)) || cmp_is_incompressible(chunk, sizeof(chunk)) || cmp_is_incompressible(chat, sizeof(chat))) {
+		log_error("FAIL ON COMPRESSION PROBE");
+		return false;
+	}
+
+	// levels drop and thresholds rise with pressure
+	const uint8_t pressure = cmp_get_pressure();
+	cmp_set_pressure(0);
+	if (cmp_get_level(cmp_chunk, 4096, 256) != cmp_get_policy(cmp_chunk).level || cmp_get_level(cmp_chunk, 100, 256) != 0 || cmp_get_level(cmp_entity, 300, 256) != 0) {
+		log_error("FAIL ON COMPRESSION LEVEL (0)");
+		return false;
+	}
+	cmp_set_pressure(CMP_MAX_PRESSURE);
+	if (cmp_get_level(cmp_chunk, 1 << 20, 256) != cmp_get_policy(cmp_chunk).min_level || cmp_get_level(cmp_entity, 1 << 20, 256) != 0 || cmp_get_level(cmp_chunk, 1024, 256) != 0) {
+		log_error("FAIL ON COMPRESSION LEVEL (1)");
+		return false;
+	}
+	cmp_set_pressure(0);
+	for (uint32_t i = 0; i < 4; ++i) {
+		cmp_tick(100000000);
+	}
+	if (cmp_get_pressure() != 4) {
+		log_error("FAIL ON COMPRESSION PRESSURE");
+		return false;
+	}
+
+	// compressed output has to round trip and noise has to be skipped
+	cmp_compressors_t compressors = CMP_COMPRESSORS_INITIALIZER;
+	struct libdeflate_decompressor* decompressor = libdeflate_alloc_decompressor();
+	byte_t out[sizeof(chunk)];
+	byte_t back[sizeof(chunk)];
+
+	const struct {
+		const char* name;
+		const byte_t* bytes;
+		size_t length;
+		cmp_class_t class;
+	} payloads[] = {
+		{ "chunk", chunk, sizeof(chunk), cmp_chunk },
+		{ "chat", chat, sizeof(chat), cmp_chat },
+		{ "noise", noise, sizeof(noise), cmp_other }
+	};
+
+	for (uint32_t p = 0; p < 3; ++p) {
+		for (uint8_t level = 0; level <= CMP_MAX_PRESSURE; level += CMP_MAX_PRESSURE) {
+
+			cmp_set_pressure(level);
+			cmp_reset_stats();
+
+			const uint32_t rounds = 200;
+			for (uint32_t r = 0; r < rounds; ++r) {
+				const size_t length = cmp_compress(&compressors, payloads[p].class, payloads[p].bytes, payloads[p].length, 256, out);
+				if (length == 0) {
+					// at full pressure small payloads are allowed to go uncompressed
+					if (payloads[p].bytes != noise && level == 0) {
+						log_error("FAIL ON COMPRESSION SKIP (%s)", payloads[p].name);
+						return false;
+					}
+					continue;
+				}
+				size_t actual = 0;
+				if (payloads[p].bytes == noise || libdeflate_zlib_decompress(decompressor, out, length, back, payloads[p].length, &actual) != LIBDEFLATE_SUCCESS || actual != payloads[p].length || memcmp(back, payloads[p].bytes, actual) != 0) {
+					log_error("FAIL ON COMPRESSION ROUND TRIP (%s)", payloads[p].name);
+					return false;
+				}
+			}
+
+			const cmp_stats_t stats = cmp_get_stats(payloads[p].class);
+			if (stats.packets != rounds) {
+				log_error("FAIL ON COMPRESSION STATS (%s)", payloads[p].name);
+				return false;
+			}
+			log_info("Compress %s at pressure %u: ratio %.3f, %" PRIu64 "ns per packet, %" PRIu64 " skipped", payloads[p].name, level, cmp_get_ratio(&stats), stats.nanos / rounds, stats.skipped);
+
+		}
+	}
+
+	// three levels taking turns keep replacing a compressor
+	for (uint32_t r = 0; r < 30; ++r) {
+		cmp_set_pressure((r % 3) * (CMP_MAX_PRESSURE / 2));
+		const size_t length = cmp_compress(&compressors, cmp_chunk, chunk, sizeof(chunk), 256, out);
+		size_t actual = 0;
+		if (length == 0 || libdeflate_zlib_decompress(decompressor, out, length, back, sizeof(chunk), &actual) != LIBDEFLATE_SUCCESS || actual != sizeof(chunk) || memcmp(back, chunk, actual) != 0) {
+			log_error("FAIL ON COMPRESSION LEVEL SWITCH (%u)", r);
+			return false;
+		}
+	}
+
+	libdeflate_free_decompressor(decompressor);
+	cmp_free_compressors(&compressors);
+	cmp_reset_stats();
+	cmp_set_pressure(pressure);
+
+	return true;
+
+}
+
+static void* test_compression_pool_read(void* args) {
+
+	int* sockets = args;
+	byte_t* buffer = malloc(1 << 24);
+	size_t length = 0;
+
+	for (;;) {
+		const ssize_t read = recv(sockets[1], buffer + length, (1 << 24) - length, 0);
+		if (read <= 0) {
+			break;
+		}
+		length += read;
+	}
+
+	memcpy(sockets + 2, &length, sizeof(size_t));
+
+	return buffer;
+
+}
+
+static uint64_t test_compression_pool_send(ltg_client_t* client, pck_packet_t* packet, uint32_t count) {
+
+	uint64_t time = 0;
+
+	for (uint32_t i = 0; i < count; ++i) {
+
+		const bool big = i % 3 == 0;
+
+		packet->cursor = 0;
+		pck_write_var_int(packet, big ? 0x22 : 0x29);
+		pck_write_int32(packet, i);
+		for (uint32_t j = 0; j < (big ? 16384u : 32u); ++j) {
+			pck_write_int8(packet, (j & 0x7F) < 100 ? 0 : j * 7);
+		}
+
+		const uint64_t start = test_nanos();
+		ltg_send(client, packet);
+		time += test_nanos() - start;
+
+	}
+
+	return time;
+
+}
+
+static bool test_compression_pool_check(const byte_t* bytes, size_t length, uint32_t count) {
+
+	struct libdeflate_decompressor* decompressor = libdeflate_alloc_decompressor();
+	byte_t payload[32768];
+	size_t cursor = 0;
+	uint32_t next = 0;
+
+	while (cursor < length) {
+
+		uint32_t values[2];
+		size_t read = io_read_var_ints(bytes + cursor, length - cursor, values, 2);
+		if (read == 0) {
+			break;
+		}
+
+		const byte_t* frame = bytes + cursor + read;
+		const size_t frame_length = values[0] - (read - io_var_int_length(values[0]));
+		size_t payload_length = frame_length;
+
+		if (values[1] != 0) {
+			if (libdeflate_zlib_decompress(decompressor, frame, frame_length, payload, sizeof(payload), &payload_length) != LIBDEFLATE_SUCCESS) {
+				break;
+			}
+		} else {
+			memcpy(payload, frame, frame_length);
+		}
+
+		if (io_read_int32(payload + 1, io_big_endian) != (int32_t) next || payload[0] != (next % 3 == 0 ? 0x22 : 0x29)) {
+			break;
+		}
+
+		next++;
+		cursor += io_var_int_length(values[0]) + values[0];
+
+	}
+
+	libdeflate_free_decompressor(decompressor);
+
+	return next == count;
+
+}
+
+bool test_compression_pool() {
+
+	const uint32_t count = 300;
+	uint64_t times[2] = { 0, 0 };
+
+	PCK_INLINE(packet, 20000, io_big_endian);
+
+	for (uint32_t pooled = 0; pooled < 2; ++pooled) {
+
+		int sockets[4];
+		if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0) {
+			log_error("FAIL ON COMPRESSION POOL SOCKETS");
+			return false;
+		}
+
+		ltg_client_t* client = calloc(1, sizeof(ltg_client_t));
+		pthread_mutex_init(&client->lock, NULL);
+		pthread_cond_init(&client->outbound.done, NULL);
+		sck_create_wake(client->wake);
+		client->socket = sockets[0];
+		client->state = ltg_play;
+		client->compression_enabled = true;
+
+		pthread_t reader;
+		pthread_create(&reader, NULL, test_compression_pool_read, sockets);
+
+		if (pooled) {
+			ltg_start_compression_pool(LTG_COMPRESSION_THREADS);
+		}
+
+		times[pooled] = test_compression_pool_send(client, packet, count);
+
+		// the pool leaves the sending to the client's thread and wakes it up
+		bool woken = !pooled;
+		if (pooled) {
+			ltg_stop_compression_pool();
+			struct pollfd wake = { .fd = client->wake[0], .events = POLLIN, .revents = 0 };
+			woken = poll(&wake, 1, 0) == 1;
+			ltg_send_ready(client);
+		}
+
+		shutdown(sockets[0], SHUT_WR);
+
+		byte_t* received = NULL;
+		pthread_join(reader, (void**) &received);
+		size_t length;
+		memcpy(&length, sockets + 2, sizeof(size_t));
+
+		const bool ordered = client->outbound.first == NULL && client->outbound.pending == 0 && test_compression_pool_check(received, length, count);
+
+		free(received);
+		close(sockets[0]);
+		close(sockets[1]);
+		close(client->wake[0]);
+		close(client->wake[1]);
+		cmp_free_compressors(&client->compression.compressors);
+		free(client->send_buffer.bytes);
+		pthread_cond_destroy(&client->outbound.done);
+		pthread_mutex_destroy(&client->lock);
+		free(client);
+
+		if (!ordered || !woken) {
+			log_error("FAIL ON COMPRESSION POOL ORDER (%u)", pooled);
+			return false;
+		}
+
+	}
+
+	log_info("Send %u packets: %" PRIu64 "ns on the sending thread inline, %" PRIu64 "ns with the pool", count, times[0], times[1]);
+
+	cmp_reset_stats();
+
+	return true;
+
+}
+
+// every frame in `bytes` has to decode to `payload`
+static uint32_t test_blobs_check(const byte_t* bytes, size_t length, bool compression, const byte_t* payload, size_t payload_length) {
+
+	struct libdeflate_decompressor* decompressor = libdeflate_alloc_decompressor();
+	byte_t* decoded = malloc(payload_length);
+	size_t cursor = 0;
+	uint32_t frames = 0;
+
+	while (cursor < length) {
+
+		uint32_t values[2];
+		const size_t read = io_read_var_ints(bytes + cursor, length - cursor, values, compression ? 2 : 1);
+		if (read == 0) {
+			break;
+		}
+
+		const byte_t* frame = bytes + cursor + read;
+		const size_t frame_length = values[0] - (read - io_var_int_length(values[0]));
+		size_t decoded_length = frame_length;
+
+		if (compression && values[1] != 0) {
+			if (libdeflate_zlib_decompress(decompressor, frame, frame_length, decoded, payload_length, &decoded_length) != LIBDEFLATE_SUCCESS) {
+				break;
+			}
+		} else if (frame_length <= payload_length) {
+			memcpy(decoded, frame, frame_length);
+		} else {
+			break;
+		}
+
+		if (decoded_length != payload_length || memcmp(decoded, payload, payload_length) != 0) {
+			break;
+		}
+
+		frames++;
+		cursor += io_var_int_length(values[0]) + values[0];
+
+	}
+
+	free(decoded);
+	libdeflate_free_decompressor(decompressor);
+
+	return frames;
+
+}
+
+bool test_blobs() {
+
+	const uint32_t joins = 200;
+	uint64_t times[2] = { 0, 0 };
+
+	// something tag shaped, long runs of small var ints
+	pck_packet_t* packet = pck_create(16384, io_big_endian);
+	pck_write_var_int(packet, 0x67);
+	for (uint32_t i = 0; i < 4000; ++i) {
+		pck_write_var_int(packet, (i * 7) % 900);
+	}
+
+	ltg_blob_t* blob = ltg_create_blob(packet);
+
+	for (uint32_t compression = 0; compression < 2; ++compression) {
+		for (uint32_t shared = 0; shared < 2; ++shared) {
+
+			int sockets[4];
+			if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0) {
+				log_error("FAIL ON BLOB SOCKETS");
+				return false;
+			}
+
+			ltg_client_t* client = calloc(1, sizeof(ltg_client_t));
+			pthread_mutex_init(&client->lock, NULL);
+			client->socket = sockets[0];
+			client->state = ltg_play;
+			client->compression_enabled = compression;
+
+			pthread_t reader;
+			pthread_create(&reader, NULL, test_compression_pool_read, sockets);
+
+			const uint64_t start = test_nanos();
+			for (uint32_t i = 0; i < joins; ++i) {
+				if (shared) {
+					ltg_send_blob(client, blob);
+				} else {
+					ltg_send(client, packet);
+				}
+			}
+			if (compression) {
+				times[shared] = test_nanos() - start;
+			}
+
+			shutdown(sockets[0], SHUT_WR);
+
+			byte_t* received = NULL;
+			pthread_join(reader, (void**) &received);
+			size_t length;
+			memcpy(&length, sockets + 2, sizeof(size_t));
+
+			const uint32_t frames = test_blobs_check(received, length, compression, packet->bytes, packet->cursor);
+
+			free(received);
+			close(sockets[0]);
+			close(sockets[1]);
+			cmp_free_compressors(&client->compression.compressors);
+			free(client->send_buffer.bytes);
+			pthread_mutex_destroy(&client->lock);
+			free(client);
+
+			if (frames != joins) {
+				log_error("FAIL ON BLOB FRAMES (%u, %u): %u", compression, shared, frames);
+				return false;
+			}
+
+		}
+	}
+
+	// a second reference keeps it alive
+	ltg_retain_blob(blob);
+	ltg_release_blob(blob);
+	if (blob->references != 1) {
+		log_error("FAIL ON BLOB REFERENCES");
+		return false;
+	}
+
+	log_info("Send a %zu byte join packet %u times: %" PRIu64 "ns serialized per join, %" PRIu64 "ns shared", packet->cursor, joins, times[0], times[1]);
+
+	ltg_release_blob(blob);
+	free(packet);
+
+	cmp_reset_stats();
+
+	return true;
+
+}
+
+// last status response in `bytes`, NULL if a frame does not parse
+static const byte_t* test_status_last(const byte_t* bytes, size_t length, uint32_t* frames, size_t* slp_length) {
+
+	const byte_t* last = NULL;
+	size_t cursor = 0;
+	*frames = 0;
+
+	while (cursor < length) {
+
+		uint32_t values[3];
+		const size_t read = io_read_var_ints(bytes + cursor, length - cursor, values, 3);
+		if (read == 0 || values[1] != 0x00) {
+			return NULL;
+		}
+
+		last = bytes + cursor + read;
+		*slp_length = values[2];
+
+		*frames += 1;
+		cursor += io_var_int_length(values[0]) + values[0];
+
+	}
+
+	return last;
+
+}
+
+bool test_status() {
+
+	const uint32_t pings = 5000;
+	uint64_t times[2] = { 0, 0 };
+
+	cht_component_t* motd = cht_alloc();
+	motd->text = UTL_CSTRTOSTR("A status test");
+	sky_set_motd(motd);
+
+	for (uint32_t cached = 0; cached < 2; ++cached) {
+
+		int sockets[4];
+		if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0) {
+			log_error("FAIL ON STATUS SOCKETS");
+			return false;
+		}
+
+		ltg_client_t* client = calloc(1, sizeof(ltg_client_t));
+		pthread_mutex_init(&client->lock, NULL);
+		client->socket = sockets[0];
+		client->state = ltg_status;
+
+		pthread_t reader;
+		pthread_create(&reader, NULL, test_compression_pool_read, sockets);
+
+		const uint64_t start = test_nanos();
+		for (uint32_t i = 0; i < pings; ++i) {
+			if (cached) {
+				phd_send_response(client);
+			} else {
+				// what every request used to do
+				char slp[2048];
+				const int32_t slp_length = cht_server_list_ping(slp);
+				PCK_INLINE(response, 2048, io_big_endian);
+				pck_write_var_int(response, 0x00);
+				pck_write_string(response, slp, slp_length);
+				ltg_send(client, response);
+			}
+		}
+		times[cached] = test_nanos() - start;
+
+		// the next response has to pick up the new motd
+		if (cached) {
+			motd = cht_alloc();
+			motd->text = UTL_CSTRTOSTR("A changed status test");
+			sky_set_motd(motd);
+			phd_send_response(client);
+		}
+
+		shutdown(sockets[0], SHUT_WR);
+
+		byte_t* received = NULL;
+		pthread_join(reader, (void**) &received);
+		size_t length;
+		memcpy(&length, sockets + 2, sizeof(size_t));
+
+		char expected[2048];
+		const size_t expected_length = cht_server_list_ping(expected);
+
+		uint32_t frames = 0;
+		size_t slp_length = 0;
+		const byte_t* slp = test_status_last(received, length, &frames, &slp_length);
+		const bool valid = slp != NULL && frames == pings + cached && slp_length == expected_length && memcmp(slp, expected, expected_length) == 0;
+
+		free(received);
+		close(sockets[0]);
+		close(sockets[1]);
+		free(client->send_buffer.bytes);
+		pthread_mutex_destroy(&client->lock);
+		free(client);
+
+		if (!valid) {
+			log_error("FAIL ON STATUS RESPONSE (%u)", cached);
+			return false;
+		}
+
+	}
+
+	sky_set_motd(NULL);
+	phd_term_status();
+
+	log_info("Status: %" PRIu64 " pings/s serialized per request, %" PRIu64 " pings/s cached", (uint64_t) pings * 1000000000 / times[0], (uint64_t) pings * 1000000000 / times[1]);
+
+	// 3 at once, then one a second
+	lim_limiter_t* limiter = malloc(sizeof(lim_limiter_t));
+	*limiter = LIM_INITIALIZER(1, 3);
+	lim_clear(limiter);
+
+	const uint32_t address = inet_addr("10.0.0.1");
+	bool limited = lim_take(limiter, address) && lim_take(limiter, address) && lim_take(limiter, address) && !lim_take(limiter, address) && lim_take(limiter, inet_addr("10.0.0.2"));
+
+	// no rate at all still hands out the burst
+	lim_set(limiter, 0, 2);
+	lim_clear(limiter);
+	limited = limited && limiter->rate == 1 && lim_take(limiter, address) && lim_take(limiter, address) && !lim_take(limiter, address);
+
+	free(limiter);
+
+	if (!limited) {
+		log_error("FAIL ON STATUS LIMITER");
+		return false;
+	}
+
+	return true;
+
+}
+
+// connect from `from` (any loopback address works), or wherever the system likes if it's 0
+static int32_t test_flood_connect(uint16_t port, uint32_t from) {
+
+	const int32_t socket_fd = socket(AF_INET, SOCK_STREAM, 0);
+
+	if (from != 0) {
+		const struct sockaddr_in source = { .sin_family = AF_INET, .sin_port = 0, .sin_addr.s_addr = from };
+		if (bind(socket_fd, (const struct sockaddr*) &source, sizeof(source)) != 0) {
+			close(socket_fd);
+			return -1;
+		}
+	}
+
+	// reset on close, 50k closes would run the loopback out of ports in TIME_WAIT
+	const struct linger linger = { .l_onoff = 1, .l_linger = 0 };
+	setsockopt(socket_fd, SOL_SOCKET, SO_LINGER, &linger, sizeof(linger));
+	const struct timeval timeout = { .tv_sec = 2, .tv_usec = 0 };
+	setsockopt(socket_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+	struct sockaddr_in address = {
+		.sin_family = AF_INET,
+		.sin_port = htons(port),
+		.sin_addr.s_addr = htonl(INADDR_LOOPBACK)
+	};
+
+	if (connect(socket_fd, (struct sockaddr*) &address, sizeof(address)) != 0) {
+		close(socket_fd);
+		return -1;
+	}
+
+	return socket_fd;
+
+}
+
+// handshake into status and a ping right behind it
+static void test_flood_handshake(int32_t socket_fd, int64_t random) {
+
+	PCK_INLINE(handshake, 64, io_big_endian);
+	pck_write_var_int(handshake, 0x00);
+	pck_write_var_int(handshake, 758);
+	pck_write_string(handshake, UTL_CSTRTOARG("localhost"));
+	pck_write_int16(handshake, 25565);
+	pck_write_var_int(handshake, ltg_status);
+
+	byte_t bytes[128];
+	size_t length = io_write_var_int(bytes, handshake->cursor, 5);
+	memcpy(bytes + length, handshake->bytes, handshake->cursor);
+	length += handshake->cursor;
+	bytes[length++] = 0x09;
+	bytes[length++] = 0x01;
+	io_write_int64(bytes + length, random, io_big_endian);
+	length += 8;
+
+	send(socket_fd, bytes, length, MSG_NOSIGNAL);
+
+}
+
+static bool test_flood_pong(int32_t socket_fd, int64_t random) {
+
+	byte_t pong[10];
+	size_t length = 0;
+
+	while (length < sizeof(pong)) {
+		const ssize_t received = recv(socket_fd, pong + length, sizeof(pong) - length, 0);
+		if (received <= 0) {
+			return false;
+		}
+		length += received;
+	}
+
+	return pong[0] == 0x09 && pong[1] == 0x01 && io_read_int64(pong + 2, io_big_endian) == random;
+
+}
+
+// true once the server closed the connection
+static bool test_flood_closed(int32_t socket_fd) {
+
+	byte_t byte;
+	const ssize_t received = recv(socket_fd, &byte, 1, 0);
+
+	return received == 0 || (received < 0 && errno == ECONNRESET);
+
+}
+
+bool test_flood() {
+
+	const uint32_t connections = 50000;
+	const uint32_t wave = 1000;
+
+	ltg_listener_t* listener = calloc(1, sizeof(ltg_listener_t));
+	pthread_mutex_init(&listener->clients.lock, NULL);
+	utl_init_id_vector(&listener->clients.vector, sizeof(ltg_client_t*));
+	listener->limiter = LIM_INITIALIZER(1000000, 1000000);
+	listener->pending.timeout = 300000000;
+	listener->running = true;
+	pthread_create(&listener->thread, NULL, t_ltg_run, listener);
+
+	for (uint32_t i = 0; i < 200 && listener->address.port == 0; ++i) {
+		usleep(10000);
+	}
+	const uint16_t port = listener->address.port;
+
+	int32_t* sockets = malloc(sizeof(int32_t) * wave);
+	int32_t* partial = malloc(sizeof(int32_t) * connections);
+	uint32_t partial_count = 0, handshakes = 0, pongs = 0, garbage = 0, closed = 0, failed = 0, peak = 0;
+
+	const uint64_t start = test_nanos();
+
+	for (uint32_t first = 0; first < connections; first += wave) {
+
+		for (uint32_t i = 0; i < wave; ++i) {
+
+			const int32_t socket_fd = sockets[i] = test_flood_connect(port, 0);
+			if (socket_fd < 0) {
+				failed++;
+				continue;
+			}
+
+			switch ((first + i) % 100) {
+				case 0: {
+					test_flood_handshake(socket_fd, first + i);
+					handshakes++;
+				} break;
+				case 1: {
+					send(socket_fd, "GET / HTTP/1.1\r\n\r\n", 18, MSG_NOSIGNAL);
+					garbage++;
+				} break;
+				case 2: {
+					// half a handshake, has to hit the deadline
+					send(socket_fd, "\x10\x00", 2, MSG_NOSIGNAL);
+					partial[partial_count++] = socket_fd;
+					sockets[i] = -1;
+				} break;
+				default: {
+					// connect and drop
+				} break;
+			}
+
+		}
+
+		const uint32_t pending = ltg_get_pending_count(listener);
+		peak = pending > peak ? pending : peak;
+
+		for (uint32_t i = 0; i < wave; ++i) {
+			if (sockets[i] < 0) {
+				continue;
+			}
+			switch ((first + i) % 100) {
+				case 0: {
+					pongs += test_flood_pong(sockets[i], first + i);
+				} break;
+				case 1: {
+					closed += test_flood_closed(sockets[i]);
+				} break;
+			}
+			close(sockets[i]);
+		}
+
+	}
+
+	for (uint32_t i = 0; i < partial_count; ++i) {
+		closed += test_flood_closed(partial[i]);
+		close(partial[i]);
+	}
+
+	const uint64_t time = test_nanos() - start;
+
+	// the client threads of the pings go away once they notice the close
+	for (uint32_t i = 0; i < 200 && (ltg_get_pending_count(listener) != 0 || ltg_get_client_count(listener) != 0); ++i) {
+		usleep(10000);
+	}
+	const bool clean = ltg_get_pending_count(listener) == 0 && ltg_get_client_count(listener) == 0;
+
+	// a single address only gets its burst
+	ltg_set_connection_limit(listener, 1, 5);
+	lim_clear(&listener->limiter);
+	uint32_t limited = 0;
+	for (uint32_t i = 0; i < 20; ++i) {
+		sockets[i] = test_flood_connect(port, 0);
+		if (sockets[i] >= 0) {
+			test_flood_handshake(sockets[i], i);
+		}
+	}
+	for (uint32_t i = 0; i < 20; ++i) {
+		if (sockets[i] >= 0) {
+			limited += test_flood_pong(sockets[i], i);
+			close(sockets[i]);
+		}
+	}
+
+	// the real limits, every address of a small network opens more than its burst at once
+	const uint32_t addresses = 32, per_address = LTG_CONNECTION_BURST + 8;
+	ltg_set_connection_limit(listener, LTG_CONNECTION_RATE, LTG_CONNECTION_BURST);
+	lim_clear(&listener->limiter);
+	uint32_t real_answered = 0, real_refused = 0;
+	const uint64_t real_start = test_nanos();
+	for (uint32_t a = 0; a < addresses; ++a) {
+		for (uint32_t i = 0; i < per_address; ++i) {
+			sockets[i] = test_flood_connect(port, htonl(0x7F000101 + a));
+			if (sockets[i] >= 0) {
+				test_flood_handshake(sockets[i], i);
+			}
+		}
+		for (uint32_t i = 0; i < per_address; ++i) {
+			if (sockets[i] < 0) {
+				continue;
+			}
+			if (test_flood_pong(sockets[i], i)) {
+				real_answered++;
+			} else {
+				real_refused++;
+			}
+			close(sockets[i]);
+		}
+	}
+	const uint64_t real_time = test_nanos() - real_start;
+	// tokens that came back while an address was still connecting
+	const uint32_t refilled = addresses * (1 + LTG_CONNECTION_RATE * real_time / 1000000000);
+
+	// out of file descriptors the listener waits instead of spinning on the backlog, then picks the connection up
+	struct rlimit limit;
+	getrlimit(RLIMIT_NOFILE, &limit);
+	const int32_t starved = socket(AF_INET, SOCK_STREAM, 0);
+	const int32_t lowest_free = dup(0);
+	close(lowest_free);
+	clockid_t listener_clock;
+	pthread_getcpuclockid(listener->thread, &listener_clock);
+	struct timespec cpu_start, cpu_end;
+	const struct sockaddr_in listen_address = { .sin_family = AF_INET, .sin_port = htons(port), .sin_addr.s_addr = htonl(INADDR_LOOPBACK) };
+	setrlimit(RLIMIT_NOFILE, &(struct rlimit) { .rlim_cur = lowest_free, .rlim_max = limit.rlim_max });
+	// accepts are deferred until there is something to read
+	const bool starved_connected = connect(starved, (struct sockaddr*) &listen_address, sizeof(listen_address)) == 0;
+	if (starved_connected) {
+		test_flood_handshake(starved, 0);
+	}
+	clock_gettime(listener_clock, &cpu_start);
+	usleep(300000);
+	clock_gettime(listener_clock, &cpu_end);
+	setrlimit(RLIMIT_NOFILE, &limit);
+	const uint64_t starved_cpu = sky_to_nanos(cpu_end) - sky_to_nanos(cpu_start);
+	bool starved_answered = false;
+	if (starved_connected) {
+		starved_answered = test_flood_pong(starved, 0);
+	}
+	close(starved);
+
+	ltg_stop_listening(listener);
+	for (uint32_t i = 0; i < 200 && ltg_get_client_count(listener) != 0; ++i) {
+		usleep(10000);
+	}
+	utl_term_id_vector(&listener->clients.vector);
+	pthread_mutex_destroy(&listener->clients.lock);
+	free(listener);
+	free(sockets);
+	free(partial);
+
+	log_info("Flood: %u connections in %" PRIu64 "ms, %u of %u pings answered, %u of %u bad handshakes closed, %u pending at most (%zu bytes each)", connections - failed, time / 1000000, pongs, handshakes, closed, garbage + partial_count, peak, sizeof(struct pollfd) + sizeof(ltg_pending_t));
+	log_info("Flood with the real limits: %u of %u connections from %u addresses answered", real_answered, addresses * per_address, addresses);
+	log_info("Flood out of file descriptors: %" PRIu64 "us of listener cpu in 300ms", starved_cpu / 1000);
+
+	if (!starved_connected || !starved_answered || starved_cpu > 30000000) {
+		log_error("FAIL ON FLOOD WITHOUT FILE DESCRIPTORS (%" PRIu64 "us cpu, %s)", starved_cpu / 1000, starved_answered ? "answered" : "not answered");
+		return false;
+	}
+
+	if (failed != 0 || pongs != handshakes || closed != garbage + partial_count || !clean) {
+		log_error("FAIL ON FLOOD (%u failed, %u pongs, %u closed, %s)", failed, pongs, closed, clean ? "clean" : "not clean");
+		return false;
+	}
+
+	if (limited < 5 || limited > 6) {
+		log_error("FAIL ON FLOOD LIMIT (%u answered)", limited);
+		return false;
+	}
+
+	if (real_answered + real_refused != addresses * per_address || real_answered < addresses * LTG_CONNECTION_BURST || real_answered > addresses * LTG_CONNECTION_BURST + refilled) {
+		log_error("FAIL ON FLOOD REAL LIMIT (%u answered, %u refused)", real_answered, real_refused);
+		return false;
+	}
+
+	return true;
+
+}
+
+#define TEST_REGISTRY_CLIENTS 1000
+#define TEST_REGISTRY_REMOVED UINT32_MAX
+
+static struct {
+
+	reg_registry_t registry;
+
+	_Atomic bool running;
+	_Atomic uint64_t reads;
+	_Atomic uint32_t stale;
+
+} test_registry_state = {
+	.registry = REG_REGISTRY_INITIALIZER
+};
+
+static void* test_registry_read(__attribute__((unused)) void* args) {
+
+	while (test_registry_state.running) {
+
+		reg_enter();
+		const reg_snapshot_t* snapshot = reg_get_snapshot(&test_registry_state.registry);
+		for (uint32_t i = 0; i < snapshot->count; ++i) {
+			// removed clients are marked right after `reg_remove` returns, nobody may still see them
+			if (snapshot->clients[i]->id == TEST_REGISTRY_REMOVED) {
+				test_registry_state.stale++;
+			}
+		}
+		reg_exit();
+
+		test_registry_state.reads++;
+
+		// broadcasts come in bursts, not back to back
+		sched_yield();
+
+	}
+
+	return NULL;
+
+}
+
+bool test_registry() {
+
+	reg_registry_t* registry = &test_registry_state.registry;
+
+	ltg_client_t* clients = calloc(TEST_REGISTRY_CLIENTS, sizeof(ltg_client_t));
+	for (uint32_t i = 0; i < TEST_REGISTRY_CLIENTS; ++i) {
+		clients[i].id = i;
+		clients[i].username.value = malloc(16);
+		clients[i].username.length = sprintf(clients[i].username.value, "Player%u", i);
+		for (uint32_t j = 0; j < 16; ++j) {
+			clients[i].uuid[j] = (i * 2654435761u) >> (j & 3) * 8 ^ j * 31;
+		}
+		reg_add(registry, &clients[i], i * 3 + 7);
+	}
+
+	// lookups by every key, usernames ignoring case
+	reg_enter();
+	const reg_snapshot_t* snapshot = reg_get_snapshot(registry);
+	uint32_t found = 0;
+	const uint64_t start = test_nanos();
+	for (uint32_t i = 0; i < TEST_REGISTRY_CLIENTS; ++i) {
+		char name[16];
+		const size_t length = sprintf(name, "PLAYER%u", i);
+		found += reg_get_by_entity_id(snapshot, i * 3 + 7) == &clients[i];
+		found += reg_get_by_uuid(snapshot, clients[i].uuid) == &clients[i];
+		found += reg_get_by_username(snapshot, name, length) == &clients[i];
+	}
+	const uint64_t lookup_time = test_nanos() - start;
+	const bool missing = reg_get_by_entity_id(snapshot, 1) == NULL && reg_get_by_username(snapshot, UTL_CSTRTOARG("Nobody")) == NULL;
+	reg_exit();
+
+	if (found != TEST_REGISTRY_CLIENTS * 3 || !missing || reg_get_count(registry) != TEST_REGISTRY_CLIENTS) {
+		log_error("FAIL ON REGISTRY LOOKUP (%u)", found);
+		return false;
+	}
+
+	// readers keep broadcasting while players leave and join again
+	test_registry_state.running = true;
+	pthread_t readers[4];
+	for (uint32_t i = 0; i < 4; ++i) {
+		pthread_create(&readers[i], NULL, test_registry_read, NULL);
+	}
+
+	const uint64_t churn_start = test_nanos();
+	for (uint32_t round = 0; round < 2; ++round) {
+		for (uint32_t i = 0; i < TEST_REGISTRY_CLIENTS; i += 2) {
+			reg_remove(registry, &clients[i]);
+			clients[i].id = TEST_REGISTRY_REMOVED;
+		}
+		for (uint32_t i = 0; i < TEST_REGISTRY_CLIENTS; i += 2) {
+			clients[i].id = i;
+			reg_add(registry, &clients[i], i * 3 + 7);
+		}
+	}
+	const uint64_t churn_time = test_nanos() - churn_start;
+
+	test_registry_state.running = false;
+	for (uint32_t i = 0; i < 4; ++i) {
+		pthread_join(readers[i], NULL);
+	}
+
+	for (uint32_t i = 1; i < TEST_REGISTRY_CLIENTS; i += 2) {
+		reg_remove(registry, &clients[i]);
+	}
+
+	reg_enter();
+	snapshot = reg_get_snapshot(registry);
+	const bool removed = snapshot->count == TEST_REGISTRY_CLIENTS / 2 && reg_get_by_entity_id(snapshot, 1 * 3 + 7) == NULL && reg_get_by_entity_id(snapshot, 2 * 3 + 7) == &clients[2];
+	reg_exit();
+
+	log_info("Registry: %" PRIu64 "ns per lookup, %u joins and leaves in %" PRIu64 "ms while 4 readers took %" PRIu64 " snapshots", lookup_time / (TEST_REGISTRY_CLIENTS * 3), TEST_REGISTRY_CLIENTS * 2, churn_time / 1000000, (uint64_t) test_registry_state.reads);
+
+	reg_term(registry);
+	for (uint32_t i = 0; i < TEST_REGISTRY_CLIENTS; ++i) {
+		free(clients[i].username.value);
+	}
+	free(clients);
+
+	if (test_registry_state.stale != 0 || !removed) {
+		log_error("FAIL ON REGISTRY SNAPSHOTS (%u stale)", (uint32_t) test_registry_state.stale);
+		return false;
+	}
+
+	return true;
+
+}
+
+// number of players in an update latency blob
+static uint32_t test_player_list_count(const ltg_blob_t* blob) {
+
+	uint32_t values[4];
+	if (io_read_var_ints(blob->uncompressed, blob->uncompressed_length, values, 4) == 0 || values[1] != 0x36 || values[2] != 2) {
+		return 0;
+	}
+
+	return values[3];
+
+}
+
+bool test_player_list() {
+
+	const uint32_t players = 500;
+
+	reg_registry_t registry = REG_REGISTRY_INITIALIZER;
+	ltg_client_t* clients = calloc(players, sizeof(ltg_client_t));
+	int* sockets = malloc(sizeof(int) * players * 2);
+
+	for (uint32_t i = 0; i < players; ++i) {
+		if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets + i * 2) != 0) {
+			log_error("FAIL ON PLAYER LIST SOCKETS");
+			return false;
+		}
+		pthread_mutex_init(&clients[i].lock, NULL);
+		clients[i].socket = sockets[i * 2];
+		clients[i].state = ltg_play;
+		clients[i].ping = 20 + i % 100;
+		clients[i].username.value = malloc(16);
+		clients[i].username.length = sprintf(clients[i].username.value, "Player%u", i);
+		memcpy(clients[i].uuid, &i, sizeof(i));
+		reg_add(&registry, &clients[i], i);
+	}
+
+	reg_enter();
+	const reg_snapshot_t* online = reg_get_snapshot(&registry);
+
+	// what every ping cycle used to serialize, a packet listing everyone for every player
+	uint64_t start = test_nanos();
+	size_t serialized = 0;
+	for (uint32_t i = 0; i < online->count; ++i) {
+		PCK_INLINE(packet, 21 * online->count + 6, io_big_endian);
+		pck_write_var_int(packet, 0x36);
+		pck_write_var_int(packet, 2);
+		pck_write_var_int(packet, online->count);
+		for (uint32_t j = 0; j < online->count; ++j) {
+			pck_write_bytes(packet, ltg_client_get_uuid(online->clients[j]), 16);
+			pck_write_var_int(packet, ltg_client_get_ping(online->clients[j]));
+		}
+		serialized += packet->cursor;
+	}
+	const uint64_t per_player = test_nanos() - start;
+
+	// the shared packet is built once, sending it is the same work either way
+	uint64_t build_time = 0;
+	uint64_t times[3];
+	uint32_t counts[3];
+
+	for (uint32_t cycle = 0; cycle < 3; ++cycle) {
+
+		// a few pings move between cycles
+		if (cycle == 1) {
+			for (uint32_t i = 0; i < 5; ++i) {
+				online->clients[i * 97]->ping += 1;
+			}
+		}
+
+		start = test_nanos();
+		ltg_blob_t* latency = phd_create_player_info_update_latency(online);
+		if (cycle == 0) {
+			build_time = test_nanos() - start;
+		}
+		if (latency != NULL) {
+			for (uint32_t i = 0; i < online->count; ++i) {
+				ltg_send_blob(online->clients[i], latency);
+			}
+		}
+		times[cycle] = test_nanos() - start;
+
+		counts[cycle] = latency == NULL ? 0 : test_player_list_count(latency);
+		if (latency != NULL) {
+			ltg_release_blob(latency);
+		}
+
+	}
+
+	reg_exit();
+
+	log_info("Player list of %u: %" PRIu64 "us serializing per player (%zu bytes), %" PRIu64 "us once", players, per_player / 1000, serialized, build_time / 1000);
+	log_info("Player list of %u sent: %" PRIu64 "us for %u listed, %" PRIu64 "us for %u changed, %" PRIu64 "us for none", players, times[0] / 1000, counts[0], times[1] / 1000, counts[1], times[2] / 1000);
+
+	reg_term(&registry);
+	for (uint32_t i = 0; i < players; ++i) {
+		close(sockets[i * 2]);
+		close(sockets[i * 2 + 1]);
+		free(clients[i].send_buffer.bytes);
+		free(clients[i].username.value);
+		pthread_mutex_destroy(&clients[i].lock);
+	}
+	free(clients);
+	free(sockets);
+
+	if (counts[0] != players || counts[1] != 5 || counts[2] != 0) {
+		log_error("FAIL ON PLAYER LIST DELTAS (%u, %u, %u)", counts[0], counts[1], counts[2]);
+		return false;
+	}
+
+	return true;
+
+}
+
+bool test_keep_alive() {
+
+	const uint32_t players = 2000;
+	const uint32_t per_tick = players / KAL_SLOTS;
+
+	ltg_client_t* clients = calloc(players, sizeof(ltg_client_t));
+	int* sockets = malloc(sizeof(int) * players * 2);
+
+	// joins spread over a whole interval
+	for (uint32_t i = 0; i < players; ++i) {
+		if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets + i * 2) != 0) {
+			log_error("FAIL ON KEEP ALIVE SOCKETS");
+			return false;
+		}
+		pthread_mutex_init(&clients[i].lock, NULL);
+		clients[i].socket = sockets[i * 2];
+		clients[i].state = ltg_play;
+		if (i % per_tick == 0) {
+			kal_tick();
+		}
+		kal_add(&clients[i]);
+	}
+
+	if (kal_get_count() != players) {
+		log_error("FAIL ON KEEP ALIVE COUNT %u", kal_get_count());
+		return false;
+	}
+
+	// one interval, everyone gets exactly one keep alive
+	uint64_t total = 0, slowest = 0;
+	for (uint32_t i = 0; i < KAL_SLOTS; ++i) {
+		const uint64_t start = test_nanos();
+		kal_tick();
+		const uint64_t time = test_nanos() - start;
+		total += time;
+		slowest = time > slowest ? time : slowest;
+	}
+
+	for (uint32_t i = 0; i < players; ++i) {
+
+		byte_t bytes[32];
+		const ssize_t length = recv(sockets[i * 2 + 1], bytes, sizeof(bytes), MSG_DONTWAIT);
+
+		// frame length, packet id and the id
+		if (length != 10 || bytes[0] != 9 || bytes[1] != 0x21) {
+			log_error("FAIL ON KEEP ALIVE SENT %u (%zd bytes)", i, length);
+			return false;
+		}
+
+		int64_t id = 0;
+		for (uint32_t j = 0; j < 8; ++j) {
+			id = (id << 8) | bytes[2 + j];
+		}
+
+		if (kal_receive(&clients[i], id + 1000000)) {
+			log_error("FAIL ON KEEP ALIVE FORGED ID");
+			return false;
+		}
+
+		// every odd player goes quiet
+		if (i % 2 == 0 && (!kal_receive(&clients[i], id) || ltg_client_get_ping(&clients[i]) < 0)) {
+			log_error("FAIL ON KEEP ALIVE ANSWER %u", i);
+			return false;
+		}
+
+		// the same answer again or one for an older keep alive
+		if (i % 2 == 0 && (kal_receive(&clients[i], id) || kal_receive(&clients[i], id - 1))) {
+			log_error("FAIL ON KEEP ALIVE REPLAY %u", i);
+			return false;
+		}
+
+	}
+
+	// two more intervals, the quiet ones run out of time
+	for (uint32_t i = 0; i < KAL_SLOTS * 2; ++i) {
+		kal_tick();
+	}
+
+	if (kal_get_count() != players / 2) {
+		log_error("FAIL ON KEEP ALIVE TIMEOUT COUNT %u", kal_get_count());
+		return false;
+	}
+
+	for (uint32_t i = 0; i < players; ++i) {
+
+		byte_t bytes[32];
+		const ssize_t length = recv(sockets[i * 2 + 1], bytes, sizeof(bytes), MSG_DONTWAIT);
+
+		// the quiet ones get one more and are shut down when the next one is due
+		if (length != (i % 2 == 0 ? 20 : 10)) {
+			log_error("FAIL ON KEEP ALIVE RESENT %u (%zd bytes)", i, length);
+			return false;
+		}
+
+		const ssize_t end = recv(sockets[i * 2 + 1], bytes, sizeof(bytes), MSG_DONTWAIT);
+		if ((i % 2 == 1) != (end == 0)) {
+			log_error("FAIL ON KEEP ALIVE DISCONNECT %u", i);
+			return false;
+		}
+
+	}
+
+	log_info("Keep alive of %u: %" PRIu64 "ns per tick, %" PRIu64 "us at most", players, total / KAL_SLOTS, slowest / 1000);
+
+	for (uint32_t i = 0; i < players; ++i) {
+		kal_remove(&clients[i]);
+		close(sockets[i * 2]);
+		close(sockets[i * 2 + 1]);
+		free(clients[i].send_buffer.bytes);
+		pthread_mutex_destroy(&clients[i].lock);
+	}
+	free(clients);
+	free(sockets);
+
+	return kal_get_count() == 0;
+
+}
+
+static rec_recipe_t* test_shaped(uint8_t width, uint8_t height, const char* pattern, const rec_ingredient_t* keys, mat_item_type_t result) {
+
+	const rec_recipe_t recipe = {
+		.type = rec_crafting_shaped,
+		.recipe_id = UTL_CSTRTOSTR("test"),
+		.data.crafting_shaped = {
+			.group = UTL_CSTRTOSTR(""),
+			.result = { .type = result, .count = 1 },
+			.width = width,
+			.height = height
+		}
+	};
+
+	rec_recipe_t* shaped = calloc(1, sizeof(rec_recipe_t) + sizeof(rec_ingredient_t) * width * height);
+	memcpy(shaped, &recipe, sizeof(rec_recipe_t));
+
+	// row by row, a space is an empty slot and letters pick from `keys`
+	for (uint8_t i = 0; i < width * height; ++i) {
+		if (pattern[i] != ' ') {
+			shaped->data.crafting_shaped.ingredients[i] = keys[pattern[i] - 'a'];
+		}
+	}
+
+	rec_add_recipe(shaped);
+
+	return shaped;
+
+}
+
+static rec_recipe_t* test_shapeless(uint8_t count, const rec_ingredient_t* ingredients, mat_item_type_t result) {
+
+	const rec_recipe_t recipe = {
+		.type = rec_crafting_shapeless,
+		.recipe_id = UTL_CSTRTOSTR("test"),
+		.data.crafting_shapeless = {
+			.group = UTL_CSTRTOSTR(""),
+			.result = { .type = result, .count = 1 },
+			.ingredient_count = count
+		}
+	};
+
+	rec_recipe_t* shapeless = calloc(1, sizeof(rec_recipe_t) + sizeof(rec_ingredient_t) * count);
+	memcpy(shapeless, &recipe, sizeof(rec_recipe_t));
+	memcpy(shapeless->data.crafting_shapeless.ingredients, ingredients, sizeof(rec_ingredient_t) * count);
+
+	rec_add_recipe(shapeless);
+
+	return shapeless;
+
+}
+
+// a 3 by 3 grid from a pattern, letters are items
+static mat_item_type_t test_recipe_match(const char* pattern, const mat_item_type_t* items) {
+
+	itm_item_t grid[9];
+	for (uint8_t i = 0; i < 9; ++i) {
+		grid[i] = pattern[i] == ' ' ? itm_new : (itm_item_t) { .type = items[pattern[i] - 'a'], .count = 1 };
+	}
+
+	const rec_recipe_t* recipe = rec_match_crafting(grid, 3);
+
+	return recipe == NULL ? mat_item_air : rec_get_crafting_result(recipe).type;
+
+}
+
+#define TEST_ITEM(t) (rec_ingredient_t) { .count = 1, .ingredient = { .type = t, .count = 1 } }
+#define TEST_TAG(t) (rec_ingredient_t) { .count = 1, .tag = mat_item_tags[t] }
+
+bool test_recipes() {
+
+	const rec_ingredient_t planks = TEST_TAG(mat_item_tag_planks);
+	const rec_ingredient_t stick = TEST_ITEM(mat_item_stick);
+
+	// a slice of the vanilla recipes with tags, mirrored shapes and shapeless alternatives
+	test_shaped(1, 2, "aa", &planks, mat_item_stick);
+	test_shaped(2, 2, "aaaa", &planks, mat_item_crafting_table);
+	test_shaped(3, 3, "aaaa aaaa", &planks, mat_item_chest);
+	test_shaped(1, 2, "ab", (rec_ingredient_t[]) { TEST_TAG(mat_item_tag_coals), stick }, mat_item_torch);
+	test_shaped(3, 3, "aaa b  b ", (rec_ingredient_t[]) { planks, stick }, mat_item_wooden_pickaxe);
+	test_shaped(2, 3, "aaab b", (rec_ingredient_t[]) { TEST_ITEM(mat_item_iron_ingot), stick }, mat_item_iron_axe);
+	test_shaped(3, 3, "aaabbbaaa", (rec_ingredient_t[]) { planks, TEST_ITEM(mat_item_book) }, mat_item_bookshelf);
+	test_shaped(3, 1, "aaa", (rec_ingredient_t[]) { TEST_ITEM(mat_item_wheat) }, mat_item_bread);
+	test_shaped(3, 1, "aaa", (rec_ingredient_t[]) { TEST_ITEM(mat_item_sugar_cane) }, mat_item_paper);
+	test_shaped(3, 3, "aaaaaaaaa", (rec_ingredient_t[]) { TEST_ITEM(mat_item_iron_ingot) }, mat_item_iron_block);
+	test_shaped(3, 3, "aaaabaaaa", (rec_ingredient_t[]) { TEST_ITEM(mat_item_glass), TEST_ITEM(mat_item_white_dye) }, mat_item_white_stained_glass);
+	test_shapeless(4, (rec_ingredient_t[]) { TEST_ITEM(mat_item_paper), TEST_ITEM(mat_item_paper), TEST_ITEM(mat_item_paper), TEST_ITEM(mat_item_leather) }, mat_item_book);
+	test_shapeless(3, (rec_ingredient_t[]) { TEST_ITEM(mat_item_gunpowder), TEST_ITEM(mat_item_blaze_powder), TEST_TAG(mat_item_tag_coals) }, mat_item_fire_charge);
+	test_shapeless(1, (rec_ingredient_t[]) { TEST_ITEM(mat_item_bone_meal) }, mat_item_white_dye);
+	test_shapeless(2, (rec_ingredient_t[]) { TEST_ITEM(mat_item_iron_ingot), TEST_ITEM(mat_item_flint) }, mat_item_flint_and_steel);
+
+	// and enough made up ones to get to the size of the vanilla set
+	const char* patterns[] = { "a a a a a", "aaaa aa a", " a aaa a ", "a  aa aaa" };
+	for (uint32_t i = 0; i < 400; ++i) {
+		test_shaped(3, 3, patterns[i & 3], (rec_ingredient_t[]) { TEST_ITEM(400 + (i >> 2)) }, 400 + (i >> 2));
+	}
+	for (uint32_t i = 0; i < 100; ++i) {
+		test_shapeless(2, (rec_ingredient_t[]) { TEST_ITEM(600 + i), TEST_ITEM(601 + i) }, 600 + i);
+	}
+
+	uint64_t start = test_nanos();
+	rec_build_index();
+	const uint64_t build_time = test_nanos() - start;
+
+	const struct {
+		const char* pattern;
+		mat_item_type_t items[3];
+		mat_item_type_t result;
+	} cases[] = {
+		{ " a  a    ", { mat_item_oak_planks }, mat_item_stick },
+		{ "      a  ", { mat_item_oak_planks }, mat_item_air },
+		{ "a  b     ", { mat_item_spruce_planks, mat_item_birch_planks }, mat_item_stick },
+		{ "ab ab    ", { mat_item_oak_planks, mat_item_warped_planks }, mat_item_crafting_table },
+		{ "aaaa aaaa", { mat_item_oak_planks }, mat_item_chest },
+		{ "aaaaaaaaa", { mat_item_oak_planks }, mat_item_air },
+		{ "  a  b   ", { mat_item_charcoal, mat_item_stick }, mat_item_torch },
+		{ "aba c  c ", { mat_item_oak_planks, mat_item_jungle_planks, mat_item_stick }, mat_item_wooden_pickaxe },
+		{ "aa ab  b ", { mat_item_iron_ingot, mat_item_stick }, mat_item_iron_axe },
+		{ " aa ba b ", { mat_item_iron_ingot, mat_item_stick }, mat_item_iron_axe },
+		{ "aa ba b  ", { mat_item_iron_ingot, mat_item_stick }, mat_item_iron_axe },
+		{ "      aaa", { mat_item_wheat }, mat_item_bread },
+		{ "a b  c  a", { mat_item_paper, mat_item_leather, mat_item_paper }, mat_item_book },
+		{ "a b  a  a", { mat_item_paper, mat_item_leather }, mat_item_book },
+		{ " c  a b  ", { mat_item_gunpowder, mat_item_blaze_powder, mat_item_charcoal }, mat_item_fire_charge },
+		{ " c  a b  ", { mat_item_gunpowder, mat_item_blaze_powder, mat_item_stick }, mat_item_air },
+		{ "   a     ", { mat_item_iron_ingot }, mat_item_air },
+		{ "         ", { mat_item_air }, mat_item_air }
+	};
+
+	for (uint32_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+		const mat_item_type_t result = test_recipe_match(cases[i].pattern, cases[i].items);
+		if (result != cases[i].result) {
+			log_error("FAIL ON RECIPE %u, got %u instead of %u", i, result, cases[i].result);
+			return false;
+		}
+	}
+
+	// 2 by 2 grids are matched the same way
+	const itm_item_t small[4] = { itm_new, { .type = mat_item_oak_planks, .count = 1 }, itm_new, { .type = mat_item_oak_planks, .count = 1 } };
+	const rec_recipe_t* small_recipe = rec_match_crafting(small, 2);
+	if (small_recipe == NULL || rec_get_crafting_result(small_recipe).type != mat_item_stick) {
+		log_error("FAIL ON RECIPE 2 BY 2");
+		return false;
+	}
+
+	// the grid of every recipe, tags filled in with their first item
+	const uint32_t recipes = rec_recipes.size;
+	itm_item_t* grids = calloc(recipes * 9, sizeof(itm_item_t));
+	for (uint32_t i = 0; i < recipes; ++i) {
+		const rec_recipe_t* recipe = UTL_VECTOR_GET_AS(rec_recipe_t*, &rec_recipes, i);
+		const bool shaped = recipe->type == rec_crafting_shaped;
+		const uint32_t count = shaped ? recipe->data.crafting_shaped.width * recipe->data.crafting_shaped.height : recipe->data.crafting_shapeless.ingredient_count;
+		for (uint32_t j = 0; j < count; ++j) {
+			const rec_ingredient_t* ingredient = shaped ? &recipe->data.crafting_shaped.ingredients[j] : &recipe->data.crafting_shapeless.ingredients[j];
+			const uint32_t slot = shaped ? (j / recipe->data.crafting_shaped.width) * 3 + j % recipe->data.crafting_shaped.width : j;
+			if (ingredient->count != 0) {
+				grids[i * 9 + slot] = (itm_item_t) { .type = ingredient->tag == NULL ? ingredient->ingredient.type : (mat_item_type_t) ingredient->tag->entries[0], .count = 1 };
+			}
+		}
+	}
+
+	const uint32_t rounds = 200;
+	uint32_t matched = 0;
+
+	start = test_nanos();
+	for (uint32_t round = 0; round < rounds; ++round) {
+		for (uint32_t i = 0; i < recipes; ++i) {
+			const rec_recipe_t* recipe = rec_match_crafting(grids + i * 9, 3);
+			matched += recipe != NULL && rec_get_crafting_result(recipe).type == rec_get_crafting_result(UTL_VECTOR_GET_AS(rec_recipe_t*, &rec_recipes, i)).type;
+		}
+	}
+	const uint64_t time = test_nanos() - start;
+
+	log_info("Recipes: %u indexed in %" PRIu64 "us, %" PRIu64 " matches/s", recipes, build_time / 1000, (uint64_t) rounds * recipes * 1000000000 / time);
+
+	// serialized recipes stay within the size the recipe packet is made for
+	for (uint32_t i = 0; i < recipes; ++i) {
+		const rec_recipe_t* recipe = UTL_VECTOR_GET_AS(rec_recipe_t*, &rec_recipes, i);
+		const size_t size = rec_get_serialized_size(recipe);
+		pck_packet_t* packet = pck_create(size, io_big_endian);
+		rec_serialize(packet, recipe);
+		const bool fits = packet->cursor <= size;
+		free(packet);
+		if (!fits) {
+			log_error("FAIL ON RECIPE SIZE %u", i);
+			free(grids);
+			return false;
+		}
+	}
+
+	free(grids);
+	rec_term_index();
+	for (uint32_t i = 0; i < recipes; ++i) {
+		free(UTL_VECTOR_GET_AS(rec_recipe_t*, &rec_recipes, i));
+	}
+	rec_recipes.size = 0;
+	rec_version++;
+
+	if (matched != rounds * recipes) {
+		log_error("FAIL ON RECIPE MATCHES %u of %u", matched, rounds * recipes);
+		return false;
+	}
+
+	return true;
+
+}
+
+static void test_upd_spread(wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z, __attribute__((unused)) mat_block_type_t source) {
+	wld_set_block_type_at(chunk, x, y, z, mat_block_black_wool);
+}
+
+static void test_upd_flip(wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z, __attribute__((unused)) mat_block_type_t source) {
+	wld_set_block_type_at(chunk, x, y, z, wld_get_block_type_at(chunk, x, y, z) == mat_block_red_wool ? mat_block_blue_wool : mat_block_red_wool);
+}
+
+static int32_t test_upd_ticked[8];
+static uint32_t test_upd_ticked_count = 0;
+
+static void test_upd_tick(__attribute__((unused)) wld_chunk_t* chunk, int32_t x, __attribute__((unused)) int16_t y, __attribute__((unused)) int32_t z) {
+	if (test_upd_ticked_count < 8) {
+		test_upd_ticked[test_upd_ticked_count] = x;
+	}
+	test_upd_ticked_count += 1;
+}
+
+bool test_block_updates() {
+
+	const upd_behavior_t spread = { .neighbor_update = test_upd_spread };
+	const upd_behavior_t flip = { .neighbor_update = test_upd_flip };
+	const upd_behavior_t tick = { .scheduled_tick = test_upd_tick };
+
+	wld_world_t* world = wld_new(UTL_CSTRTOSTR("updates"), 0, mat_dimension_overworld);
+
+	// 16 by 16 chunks around spawn, all of them ticking
+	const int32_t min_x = ((wld_get_spawn_x(world) >> 4) - 8) << 4;
+	const int32_t min_z = ((wld_get_spawn_z(world) >> 4) - 8) << 4;
+	const int16_t y = 200;
+	wld_chunk_t* chunk = wld_get_chunk_at(world, min_x, min_z);
+
+	wld_region_t* regions[4];
+	uint32_t region_count = 0;
+	for (int32_t x = min_x; x < min_x + 256; x += 255) {
+		for (int32_t z = min_z; z < min_z + 256; z += 255) {
+			wld_region_t* region = wld_get_region_at(world, x, z);
+			bool found = false;
+			for (uint32_t i = 0; i < region_count; ++i) {
+				found |= regions[i] == region;
+			}
+			if (!found) {
+				regions[region_count++] = region;
+			}
+		}
+	}
+
+	for (int32_t x = min_x; x < min_x + 256; ++x) {
+		for (int32_t z = min_z; z < min_z + 256; ++z) {
+			wld_set_block_type_at(chunk, x, y, z, mat_block_white_wool);
+		}
+	}
+
+	// one change spreads over the whole plane, one level per update
+	upd_set_behavior(mat_block_white_wool, &spread);
+	wld_set_block_type_at(chunk, min_x, y + 1, min_z, mat_block_stone);
+
+	uint32_t updates = 0;
+	uint32_t ticks = 0;
+	uint64_t start = test_nanos();
+	for (bool queued = true; queued; ++ticks) {
+		queued = false;
+		for (uint32_t i = 0; i < region_count; ++i) {
+			updates += upd_tick_region(regions[i]);
+		}
+		for (uint32_t i = 0; i < region_count; ++i) {
+			queued |= upd_get_queued_count(regions[i]) != 0;
+		}
+	}
+	const uint64_t time = test_nanos() - start;
+
+	upd_set_behavior(mat_block_white_wool, NULL);
+
+	uint32_t black = 0;
+	for (int32_t x = min_x; x < min_x + 256; ++x) {
+		for (int32_t z = min_z; z < min_z + 256; ++z) {
+			black += wld_get_block_type_at(chunk, x, y, z) == mat_block_black_wool;
+		}
+	}
+
+	log_info("Block updates: %u in %u ticks, %" PRIu64 " updates/s", updates, ticks, (uint64_t) updates * 1000000000 / time);
+
+	if (black != 256 * 256 || updates < 100000) {
+		log_error("FAIL ON BLOCK UPDATE SPREAD %u blocks, %u updates", black, updates);
+		return false;
+	}
+
+	// two blocks flipping each other forever, the depth limit ends it
+	const int32_t flip_x = min_x + 16;
+	const int32_t flip_z = min_z + 16;
+	wld_set_block_type_at(chunk, flip_x, y + 10, flip_z, mat_block_red_wool);
+	wld_set_block_type_at(chunk, flip_x + 1, y + 10, flip_z, mat_block_blue_wool);
+	upd_set_behavior(mat_block_red_wool, &flip);
+	upd_set_behavior(mat_block_blue_wool, &flip);
+	wld_set_block_type_at(chunk, flip_x - 1, y + 10, flip_z, mat_block_stone);
+
+	wld_region_t* region = wld_chunk_get_region(wld_relative_chunk(chunk, (flip_x >> 4) - wld_get_chunk_x(chunk), (flip_z >> 4) - wld_get_chunk_z(chunk)));
+	updates = 0;
+	ticks = 0;
+	while (upd_get_queued_count(region) != 0 && ticks < 100) {
+		updates += upd_tick_region(region);
+		ticks += 1;
+	}
+
+	upd_set_behavior(mat_block_red_wool, NULL);
+	upd_set_behavior(mat_block_blue_wool, NULL);
+
+	if (upd_get_queued_count(region) != 0 || updates != UPD_MAX_DEPTH) {
+		log_error("FAIL ON BLOCK UPDATE DEPTH %u updates in %u ticks", updates, ticks);
+		return false;
+	}
+
+	// scheduled ticks come up by due tick, then priority, then in order
+	const int32_t tick_x = min_x + 32;
+	for (int32_t x = tick_x; x < tick_x + 5; ++x) {
+		wld_set_block_type_at(chunk, x, y + 20, min_z, mat_block_white_wool);
+	}
+	upd_set_behavior(mat_block_white_wool, &tick);
+
+	wld_chunk_t* tick_chunk = wld_relative_chunk(chunk, (tick_x >> 4) - wld_get_chunk_x(chunk), 0);
+	region = wld_chunk_get_region(tick_chunk);
+
+	upd_schedule_tick(tick_chunk, tick_x, y + 20, min_z, mat_block_white_wool, 2, upd_priority_normal);
+	upd_schedule_tick(tick_chunk, tick_x + 1, y + 20, min_z, mat_block_white_wool, 1, upd_priority_normal);
+	upd_schedule_tick(tick_chunk, tick_x + 2, y + 20, min_z, mat_block_white_wool, 1, upd_priority_high);
+	upd_schedule_tick(tick_chunk, tick_x + 3, y + 20, min_z, mat_block_white_wool, 1, upd_priority_normal);
+	upd_schedule_tick(tick_chunk, tick_x + 4, y + 20, min_z, mat_block_white_wool, 1, upd_priority_normal);
+	// already scheduled
+	upd_schedule_tick(tick_chunk, tick_x + 1, y + 20, min_z, mat_block_white_wool, 1, upd_priority_extremely_high);
+	// not there anymore by the time it comes up
+	wld_set_block_type_at(chunk, tick_x + 4, y + 20, min_z, mat_block_stone);
+
+	const uint32_t scheduled = upd_get_scheduled_count(region);
+
+	upd_tick_region(region);
+	const uint32_t early = test_upd_ticked_count;
+	world->age += 1;
+	upd_tick_region(region);
+	world->age += 1;
+	upd_tick_region(region);
+
+	upd_set_behavior(mat_block_white_wool, NULL);
+
+	wld_unload_all();
+
+	if (scheduled != 5 || early != 0 || test_upd_ticked_count != 4 || test_upd_ticked[0] != tick_x + 2 || test_upd_ticked[1] != tick_x + 1 || test_upd_ticked[2] != tick_x + 3 || test_upd_ticked[3] != tick_x) {
+		log_error("FAIL ON SCHEDULED TICKS %u scheduled, %u ticked", scheduled, test_upd_ticked_count);
+		return false;
+	}
+
+	return true;
+
+}
+
+static uint32_t test_random_ticked = 0;
+static bool test_random_outside = false;
+static int16_t test_random_min_y = 0;
+
+static void test_random_tick(__attribute__((unused)) wld_chunk_t* chunk, __attribute__((unused)) int32_t x, int16_t y, __attribute__((unused)) int32_t z) {
+	test_random_ticked += 1;
+	test_random_outside |= y < test_random_min_y || y >= test_random_min_y + 16;
+}
+
+bool test_random_ticks() {
+
+	const upd_behavior_t wheat = { .random_tick = test_random_tick };
+	const uint32_t rounds = 1000;
+
+	wld_world_t* world = wld_new(UTL_CSTRTOSTR("random"), 0, mat_dimension_overworld);
+	wld_chunk_t* chunk = wld_get_chunk_at(world, wld_get_spawn_x(world), wld_get_spawn_z(world));
+	wld_region_t* region = wld_chunk_get_region(chunk);
+	const uint8_t speed = wld_get_random_tick_speed(world);
+
+	// nothing in the generated terrain gets random ticks
+	uint32_t chunks = 0;
+	uint32_t ticked = 0;
+	uint64_t start = test_nanos();
+	for (uint32_t i = 0; i < rounds; ++i) {
+		for (uint32_t j = 0; j < 32 * 32; ++j) {
+			wld_chunk_t* region_chunk = wld_region_get_chunk_by_idx(region, j);
+			if (region_chunk != NULL) {
+				ticked += upd_random_tick_chunk(region_chunk, speed);
+				chunks += 1;
+			}
+		}
+	}
+	const uint64_t empty_time = test_nanos() - start;
+
+	if (ticked != 0) {
+		log_error("FAIL ON RANDOM TICKS IN EMPTY TERRAIN %u", ticked);
+		return false;
+	}
+
+	// a section full of wheat gets exactly `speed` ticks every time
+	const int16_t min_y = mat_get_dimension_by_type(mat_dimension_overworld)->min_y + 160;
+	const int32_t min_x = wld_get_chunk_x(chunk) << 4;
+	const int32_t min_z = wld_get_chunk_z(chunk) << 4;
+	wld_chunk_section_t* section = wld_chunk_get_section(chunk, 10);
+
+	for (int16_t y = min_y; y < min_y + 16; ++y) {
+		for (int32_t x = min_x; x < min_x + 16; ++x) {
+			for (int32_t z = min_z; z < min_z + 16; ++z) {
+				wld_set_block_type_at(chunk, x, y, z, mat_block_wheat);
+			}
+		}
+	}
+	const uint32_t full_count = wld_chunk_section_get_random_tick_count(section);
+
+	upd_set_behavior(mat_block_wheat, &wheat);
+	test_random_min_y = min_y;
+
+	start = test_nanos();
+	for (uint32_t i = 0; i < rounds; ++i) {
+		upd_random_tick_chunk(chunk, speed);
+	}
+	const uint64_t full_time = test_nanos() - start;
+	const uint32_t full_ticked = test_random_ticked;
+
+	// half of it, about half the ticks
+	for (int16_t y = min_y; y < min_y + 8; ++y) {
+		for (int32_t x = min_x; x < min_x + 16; ++x) {
+			for (int32_t z = min_z; z < min_z + 16; ++z) {
+				wld_set_block_type_at(chunk, x, y, z, mat_block_stone);
+			}
+		}
+	}
+	const uint32_t half_count = wld_chunk_section_get_random_tick_count(section);
+
+	test_random_ticked = 0;
+	for (uint32_t i = 0; i < rounds; ++i) {
+		upd_random_tick_chunk(chunk, speed);
+	}
+	const uint32_t half_ticked = test_random_ticked;
+
+	upd_set_behavior(mat_block_wheat, NULL);
+
+	for (int16_t y = min_y + 8; y < min_y + 16; ++y) {
+		for (int32_t x = min_x; x < min_x + 16; ++x) {
+			for (int32_t z = min_z; z < min_z + 16; ++z) {
+				wld_set_block_type_at(chunk, x, y, z, mat_block_air);
+			}
+		}
+	}
+	const uint32_t cleared_count = wld_chunk_section_get_random_tick_count(section) + wld_chunk_get_random_tick_count(chunk);
+
+	wld_unload_all();
+
+	log_info("Random ticks: %" PRIu64 "ns per chunk of empty terrain, %" PRIu64 "ns per chunk with a tickable section", empty_time / chunks, full_time / rounds);
+
+	if (full_count != 4096 || half_count != 2048 || cleared_count != 0) {
+		log_error("FAIL ON RANDOM TICK COUNTS %u, %u, %u", full_count, half_count, cleared_count);
+		return false;
+	}
+
+	if (full_ticked != rounds * speed || half_ticked < rounds * speed * 4 / 10 || half_ticked > rounds * speed * 6 / 10 || test_random_outside) {
+		log_error("FAIL ON RANDOM TICKS %u, %u", full_ticked, half_ticked);
+		return false;
+	}
+
+	return true;
+
+}
+
+static uint32_t test_fluids_settle(wld_world_t* world, wld_region_t** regions, uint32_t region_count, uint32_t* sections) {
+
+	uint32_t ticks = 0;
+
+	for (bool active = true; active && ticks < 1000; ++ticks) {
+
+		world->age += 1;
+
+		for (uint32_t i = 0; i < region_count; ++i) {
+			upd_tick_region(regions[i]);
+		}
+		for (uint32_t i = 0; i < region_count; ++i) {
+			const wld_sent_changes_t sent = wld_send_region_changes(regions[i]);
+			*sections += sent.blocks + sent.sections + sent.chunks;
+		}
+
+		active = false;
+		for (uint32_t i = 0; i < region_count; ++i) {
+			active |= upd_get_scheduled_count(regions[i]) != 0 || upd_get_queued_count(regions[i]) != 0;
+		}
+
+	}
+
+	return ticks;
+
+}
+
+bool test_fluids() {
+
+	fld_init();
+
+	wld_world_t* world = wld_new(UTL_CSTRTOSTR("fluids"), 0, mat_dimension_overworld);
+
+	// a reservoir of 47 by 62 held back by a dam, with room to flow on the other side
+	const int32_t min_x = ((wld_get_spawn_x(world) >> 4) - 6) << 4;
+	const int32_t min_z = ((wld_get_spawn_z(world) >> 4) - 4) << 4;
+	const int32_t dam_x = min_x + 48;
+	const int16_t y = 100;
+	wld_chunk_t* chunk = wld_get_chunk_at(world, min_x, min_z);
+
+	wld_region_t* regions[4];
+	uint32_t region_count = 0;
+	for (int32_t x = min_x; x < min_x + 96; x += 95) {
+		for (int32_t z = min_z; z < min_z + 64; z += 63) {
+			wld_region_t* region = wld_get_region_at(world, x, z);
+			bool found = false;
+			for (uint32_t i = 0; i < region_count; ++i) {
+				found |= regions[i] == region;
+			}
+			if (!found) {
+				regions[region_count++] = region;
+			}
+		}
+	}
+
+	for (int32_t x = min_x; x < min_x + 96; ++x) {
+		for (int32_t z = min_z; z < min_z + 64; ++z) {
+			wld_set_block_type_at(chunk, x, y - 1, z, mat_block_stone);
+			if (x == min_x || x == min_x + 95 || z == min_z || z == min_z + 63 || x == dam_x) {
+				wld_set_block_type_at(chunk, x, y, z, mat_block_stone);
+			} else if (x < dam_x) {
+				wld_set_block_type_at(chunk, x, y, z, mat_block_water);
+			}
+		}
+	}
+
+	uint32_t sections = 0;
+	test_fluids_settle(world, regions, region_count, &sections);
+
+	// still water does nothing
+	world->age += 100;
+	uint32_t idle = 0;
+	for (uint32_t i = 0; i < region_count; ++i) {
+		idle += upd_tick_region(regions[i]);
+	}
+
+	// break the dam
+	for (int32_t z = min_z + 1; z < min_z + 63; ++z) {
+		wld_set_block_type_at(chunk, dam_x, y, z, mat_block_air);
+	}
+
+	sections = 0;
+	const uint64_t start = test_nanos();
+	const uint32_t ticks = test_fluids_settle(world, regions, region_count, &sections);
+	const uint64_t time = test_nanos() - start;
+
+	uint32_t flowing = 0;
+	bool levels = true;
+	for (int32_t x = dam_x; x < min_x + 95; ++x) {
+		for (int32_t z = min_z + 1; z < min_z + 63; ++z) {
+			const fld_fluid_t fluid = fld_get_fluid(wld_get_block_at(chunk, x, y, z));
+			flowing += fluid.block == mat_block_water;
+			// one level less every block away from the sources
+			if (z == min_z + 32) {
+				levels &= x - dam_x < 7 ? fluid.block == mat_block_water && fluid.level == x - dam_x + 1 : fluid.block == mat_block_air;
+			}
+		}
+	}
+
+	bool reservoir = true;
+	for (int32_t x = min_x + 1; x < dam_x; ++x) {
+		for (int32_t z = min_z + 1; z < min_z + 63; ++z) {
+			reservoir &= fld_is_source(fld_get_fluid(wld_get_block_at(chunk, x, y, z)));
+		}
+	}
+
+	log_info("Fluids: dam broke in %u ticks, %" PRIu64 "us, %u blocks flowing sent in %u section updates", ticks, time / 1000, flowing, sections);
+
+	// lava next to water
+	wld_set_block_type_at(chunk, min_x + 60, y + 1, min_z + 10, mat_block_water);
+	wld_set_block_type_at(chunk, min_x + 61, y + 1, min_z + 10, mat_block_lava);
+	test_fluids_settle(world, regions, region_count, &sections);
+	const mat_block_type_t hardened = wld_get_block_type_at(chunk, min_x + 61, y + 1, min_z + 10);
+
+	wld_unload_all();
+
+	if (idle != 0 || ticks >= 1000 || !levels || !reservoir || flowing < 7 * 62 || sections * 4 > flowing) {
+		log_error("FAIL ON DAM %u idle updates, %u ticks, %u flowing in %u sections", idle, ticks, flowing, sections);
+		return false;
+	}
+
+	if (hardened != mat_block_obsidian) {
+		log_error("FAIL ON LAVA MEETING WATER %u", hardened);
+		return false;
+	}
+
+	return true;
+
+}
+
+bool test_block_changes() {
+
+	wld_world_t* world = wld_new(UTL_CSTRTOSTR("block_changes"), 0, mat_dimension_overworld);
+
+	const int32_t x = (wld_get_spawn_x(world) >> 4) << 4;
+	const int32_t z = (wld_get_spawn_z(world) >> 4) << 4;
+	wld_chunk_t* chunk = wld_get_chunk_at(world, x, z);
+	wld_region_t* region = wld_get_region_at(world, x, z);
+
+	// whatever generating the chunk changed is not this test's business
+	wld_send_region_changes(region);
+
+	// a single block and a few blocks in another section
+	wld_set_block_type_at(chunk, x + 1, 200, z + 2, mat_block_stone);
+	for (int32_t i = 0; i < 5; ++i) {
+		wld_set_block_type_at(chunk, x + i, 250, z + 3, mat_block_glass);
+	}
+	// changing twice still sends the block once
+	wld_set_block_type_at(chunk, x, 250, z + 3, mat_block_dirt);
+	const wld_sent_changes_t mixed = wld_send_changes(chunk);
+
+	// nothing changes when a block stays the same
+	wld_set_block_type_at(chunk, x + 1, 200, z + 2, mat_block_stone);
+	const wld_sent_changes_t same = wld_send_changes(chunk);
+
+	// a section full of changes sends the chunk again
+	for (int32_t i = 0; i < 16 * 16 * 8; ++i) {
+		wld_set_block_type_at(chunk, x + (i & 0xF), 208 + (i >> 8), z + ((i >> 4) & 0xF), mat_block_glass);
+	}
+	const wld_sent_changes_t full = wld_send_changes(chunk);
+
+	wld_unload_all();
+
+	if (mixed.blocks != 1 || mixed.sections != 1 || mixed.chunks != 0) {
+		log_error("FAIL ON MIXED CHANGES %u blocks, %u sections, %u chunks", mixed.blocks, mixed.sections, mixed.chunks);
+		return false;
+	}
+
+	if (same.blocks != 0 || same.sections != 0 || same.chunks != 0) {
+		log_error("FAIL ON SAME BLOCK %u blocks, %u sections, %u chunks", same.blocks, same.sections, same.chunks);
+		return false;
+	}
+
+	if (full.blocks != 0 || full.sections != 0 || full.chunks != 1) {
+		log_error("FAIL ON FULL SECTION %u blocks, %u sections, %u chunks", full.blocks, full.sections, full.chunks);
+		return false;
+	}
+
+	// records are x z y after the block
+	const uint16_t indices[2] = { (1 << 8) | (2 << 4) | 3, (15 << 8) | (14 << 4) | 13 };
+	const mat_block_protocol_id_t blocks[2] = { 1, mat_get_block_default_protocol_id_by_type(mat_block_glass) };
+	ltg_blob_t* blob = phd_create_multi_block_change(-2, -4, 7, indices, blocks, 2);
+
+	pck_packet_t* packet = pck_from_bytes(blob->uncompressed, blob->uncompressed_length, io_big_endian);
+	const int32_t length = pck_read_var_int(packet);
+	const int32_t id = pck_read_var_int(packet);
+	const int64_t position = pck_read_int64(packet);
+	const int8_t trust_edges = pck_read_int8(packet);
+	const int32_t count = pck_read_var_int(packet);
+	const int64_t first = pck_read_var_long(packet);
+	const int64_t second = pck_read_var_long(packet);
+	const bool read_all = packet->cursor == blob->uncompressed_length && (size_t) length + 1 == blob->uncompressed_length;
+	free(packet);
+	ltg_release_blob(blob);
+
+	const int64_t s_x = position >> 42;
+	const int64_t s_y = (position << 44) >> 44;
+	const int64_t s_z = (position << 22) >> 42;
+
+	if (!read_all || id != 0x3F || s_x != -2 || s_y != -4 || s_z != 7 || trust_edges != 1 || count != 2 || first != ((1 << 12) | (3 << 8) | (2 << 4) | 1) || second != (((int64_t) blocks[1] << 12) | (13 << 8) | (14 << 4) | 15)) {
+		log_error("FAIL ON MULTI BLOCK CHANGE length %d, id %d, section %ld %ld %ld, count %d", length, id, s_x, s_y, s_z, count);
+		return false;
+	}
+
+	log_info("Block changes: %u blocks, %u sections, %u chunks sent", mixed.blocks + full.blocks, mixed.sections + full.sections, mixed.chunks + full.chunks);
+
+	return true;
+
+}
+
+static bool test_world_edit_matches(mat_block_protocol_id_t block, void* data) {
+	return mat_get_block_type_by_protocol_id(block) == *(mat_block_type_t*) data;
+}
+
+// counters and heightmaps of the chunks in a box have to match their blocks
+static bool test_world_edit_check(wld_world_t* world, edt_box_t box) {
+
+	const mat_dimension_t* dimension = mat_get_dimension_by_type(wld_get_environment(world));
+
+	for (int32_t c_x = box.min_x >> 4; c_x <= box.max_x >> 4; ++c_x) {
+		for (int32_t c_z = box.min_z >> 4; c_z <= box.max_z >> 4; ++c_z) {
+
+			wld_chunk_t* chunk = wld_get_chunk(world, c_x, c_z);
+
+			uint32_t chunk_random_ticks = 0;
+			int16_t highest[16 * 16];
+			for (uint32_t i = 0; i < 16 * 16; ++i) {
+				highest[i] = dimension->min_y;
+			}
+
+			for (uint32_t s = 0; s < (uint32_t) dimension->height >> 4; ++s) {
+
+				wld_chunk_section_t* section = wld_chunk_get_section(chunk, s);
+				uint32_t blocks = 0;
+				uint32_t random_ticks = 0;
+
+				for (uint32_t i = 0; i < 16 * 16 * 16; ++i) {
+					const mat_block_t* block = mat_get_block_by_type(mat_get_block_type_by_protocol_id(section->blocks[i]));
+					blocks += !block->air;
+					random_ticks += block->random_ticks;
+					if (!block->air) {
+						highest[i & 0xFF] = dimension->min_y + (s << 4) + (i >> 8);
+					}
+				}
+
+				if (blocks != section->block_count || random_ticks != section->random_tick_count) {
+					log_error("FAIL ON SECTION %d %u %d, %u blocks counted %u, %u random ticks counted %u", c_x, s, c_z, blocks, (uint32_t) section->block_count, random_ticks, (uint32_t) section->random_tick_count);
+					return false;
+				}
+
+				chunk_random_ticks += random_ticks;
+
+			}
+
+			if (chunk_random_ticks != chunk->random_tick_count) {
+				log_error("FAIL ON CHUNK %d %d, %u random ticks counted %u", c_x, c_z, chunk_random_ticks, (uint32_t) chunk->random_tick_count);
+				return false;
+			}
+
+			// only columns in the box got their heightmaps recalculated
+			for (int32_t x = UTL_MAX(box.min_x, c_x << 4); x <= UTL_MIN(box.max_x, (c_x << 4) + 15); ++x) {
+				for (int32_t z = UTL_MAX(box.min_z, c_z << 4); z <= UTL_MIN(box.max_z, (c_z << 4) + 15); ++z) {
+					const uint16_t column = ((z & 0xF) << 4) | (x & 0xF);
+					if (chunk->highest.motion_blocking[column] != highest[column] || chunk->highest.world_surface[column] != highest[column]) {
+						log_error("FAIL ON HEIGHTMAP %d %d, %d should be %d", x, z, chunk->highest.motion_blocking[column], highest[column]);
+						return false;
+					}
+				}
+			}
+
+		}
+	}
+
+	return true;
+
+}
+
+bool test_world_edit() {
+
+	wld_world_t* world = wld_new(UTL_CSTRTOSTR("world_edit"), 0, mat_dimension_overworld);
+
+	// not lined up with chunks
+	const int32_t x = ((wld_get_spawn_x(world) >> 4) << 4) - 40;
+	const int32_t z = ((wld_get_spawn_z(world) >> 4) << 4) - 24;
+	const edt_box_t box = {
+		.min_x = x,
+		.min_y = 4,
+		.min_z = z,
+		.max_x = x + 63,
+		.max_y = 67,
+		.max_z = z + 63
+	};
+
+	uint64_t start = test_nanos();
+	const uint64_t filled = edt_fill(world, box, mat_get_block_default_protocol_id_by_type(mat_block_stone));
+	const uint64_t fill_time = test_nanos() - start;
+
+	// the lower half of the stone becomes grass, which gets random ticks
+	mat_block_type_t stone = mat_block_stone;
+	edt_box_t lower = box;
+	lower.max_y = 35;
+	const uint64_t replaced = edt_replace(world, lower, test_world_edit_matches, &stone, mat_get_block_default_protocol_id_by_type(mat_block_grass_block));
+
+	bool checked = test_world_edit_check(world, box);
+
+	start = test_nanos();
+	edt_clipboard_t* clipboard = edt_copy(world, box);
+	const uint64_t copy_time = test_nanos() - start;
+
+	// upside down box order doesn't matter and above the world is cut off
+	const edt_box_t pasted_box = {
+		.min_x = x + 100,
+		.min_y = 300,
+		.min_z = z,
+		.max_x = x + 163,
+		.max_y = 363,
+		.max_z = z + 63
+	};
+	const uint64_t pasted = edt_paste(world, clipboard, pasted_box.min_x, pasted_box.min_y, pasted_box.min_z);
+	checked &= test_world_edit_check(world, pasted_box);
+
+	bool same = true;
+	wld_chunk_t* chunk = wld_get_chunk_at(world, x, z);
+	for (int32_t y = 0; y < 20; ++y) {
+		for (int32_t d_z = 0; d_z < 64; ++d_z) {
+			for (int32_t d_x = 0; d_x < 64; ++d_x) {
+				same &= wld_get_block_at(chunk, x + 100 + d_x, 300 + y, z + d_z) == clipboard->blocks[((y * 64) + d_z) * 64 + d_x];
+			}
+		}
+	}
+	same &= wld_get_block_at(chunk, x + 100, 300, z) == mat_get_block_default_protocol_id_by_type(mat_block_grass_block);
+	same &= wld_get_block_at(chunk, x + 100, 319, z) == mat_get_block_default_protocol_id_by_type(mat_block_grass_block);
+
+	edt_free_clipboard(clipboard);
+
+	// what it costs one block at a time
+	const edt_box_t single_box = {
+		.min_x = x,
+		.min_y = 100,
+		.min_z = z,
+		.max_x = x + 31,
+		.max_y = 115,
+		.max_z = z + 31
+	};
+	start = test_nanos();
+	for (int32_t y = single_box.min_y; y <= single_box.max_y; ++y) {
+		for (int32_t b_z = single_box.min_z; b_z <= single_box.max_z; ++b_z) {
+			for (int32_t b_x = single_box.min_x; b_x <= single_box.max_x; ++b_x) {
+				wld_set_block_type_at(chunk, b_x, y, b_z, mat_block_stone);
+			}
+		}
+	}
+	const uint64_t single_time = test_nanos() - start;
+
+	// nothing to change the second time
+	const uint64_t refilled = edt_fill(world, single_box, mat_get_block_default_protocol_id_by_type(mat_block_stone));
+
+	wld_unload_all();
+
+	if (filled != edt_get_volume(box) || replaced != edt_get_volume(lower) || pasted != 64 * 20 * 64 || refilled != 0) {
+		log_error("FAIL ON CHANGED BLOCKS %" PRIu64 " filled, %" PRIu64 " replaced, %" PRIu64 " pasted, %" PRIu64 " refilled", filled, replaced, pasted, refilled);
+		return false;
+	}
+
+	if (!checked || !same) {
+		log_error("FAIL ON BLOCKS");
+		return false;
+	}
+
+	log_info("World edit: fill %" PRIu64 " blocks/s, copy %" PRIu64 " blocks/s, one at a time %" PRIu64 " blocks/s", filled * 1000000000 / UTL_MAX(fill_time, 1), edt_get_volume(box) * 1000000000 / UTL_MAX(copy_time, 1), edt_get_volume(single_box) * 1000000000 / UTL_MAX(single_time, 1));
+
+	return true;
+
+}
+
+// the division based lookups the tables replaced
+static uint8_t test_block_states_get(mat_block_protocol_id_t protocol, mat_state_modifier_type_t field) {
+
+	const mat_block_type_t type = mat_get_block_type_by_protocol_id(protocol);
+	const mat_block_t* block = mat_get_block_by_type(type);
+	uint32_t state = protocol - mat_get_block_base_protocol_id_by_type(type);
+
+	for (int32_t i = block->modifiers_count - 1; i >= 0; --i) {
+		if (block->modifiers[i] != field) {
+			state /= mat_get_state_modifier_by_type(block->modifiers[i])->count;
+		} else {
+			return state % mat_get_state_modifier_by_type(field)->count;
+		}
+	}
+
+	return 0;
+
+}
+
+bool test_block_states() {
+
+	const uint32_t count = mat_get_block_state_count();
+
+	// every value of every state modifier of every state
+	for (uint32_t protocol = 0; protocol < count; ++protocol) {
+
+		const mat_block_type_t type = mat_get_block_type_by_protocol_id(protocol);
+		const mat_block_t* block = mat_get_block_by_type(type);
+
+		if (mat_is_block_air(protocol) != block->air || mat_block_gets_random_ticks(protocol) != block->random_ticks || mat_get_block_luminance(protocol) != block->luminance) {
+			log_error("FAIL ON FLAGS OF %u", protocol);
+			return false;
+		}
+
+		for (uint32_t i = 0; i < block->modifiers_count; ++i) {
+
+			const mat_state_modifier_type_t field = block->modifiers[i];
+
+			if (mat_get_block_state_value(protocol, field) != test_block_states_get(protocol, field)) {
+				log_error("FAIL ON GET %u, modifier %u is %u and should be %u", protocol, field, mat_get_block_state_value(protocol, field), test_block_states_get(protocol, field));
+				return false;
+			}
+
+			for (uint8_t value = 0; value < mat_get_state_modifier_by_type(field)->count; ++value) {
+				const mat_block_protocol_id_t set = mat_set_block_state_value(protocol, field, value);
+				bool others = mat_get_block_type_by_protocol_id(set) == type && test_block_states_get(set, field) == value;
+				for (uint32_t j = 0; j < block->modifiers_count; ++j) {
+					others &= j == i || test_block_states_get(set, block->modifiers[j]) == test_block_states_get(protocol, block->modifiers[j]);
+				}
+				if (!others) {
+					log_error("FAIL ON SET %u, modifier %u to %u gave %u", protocol, field, value, set);
+					return false;
+				}
+			}
+
+		}
+
+		// fields the block doesn't have
+		if (mat_get_block_state_value(protocol, mat_state_modifier_dripleaf_tilt) != test_block_states_get(protocol, mat_state_modifier_dripleaf_tilt) || (type != mat_block_big_dripleaf && type != mat_block_big_dripleaf_stem && mat_set_block_state_value(protocol, mat_state_modifier_dripleaf_tilt, 1) != protocol)) {
+			log_error("FAIL ON MISSING MODIFIER %u", protocol);
+			return false;
+		}
+
+	}
+
+	const mat_block_protocol_id_t chest = mat_get_block_default_protocol_id_by_type(mat_block_chest);
+	uint32_t sum = 0;
+
+	uint64_t start = test_nanos();
+	for (uint32_t i = 0; i < 1000000; ++i) {
+		sum += test_block_states_get(chest + (i & 0x7), mat_state_modifier_facing_cardinal);
+	}
+	const uint64_t divisions = test_nanos() - start;
+
+	start = test_nanos();
+	for (uint32_t i = 0; i < 1000000; ++i) {
+		sum += mat_get_block_state_value(chest + (i & 0x7), mat_state_modifier_facing_cardinal);
+	}
+	const uint64_t tables = test_nanos() - start;
+
+	log_info("Block states: %u states, reading a value %" PRIu64 "ps with tables, %" PRIu64 "ps dividing (%u)", count, tables / 1000, divisions / 1000, sum);
+
+	return true;
+
+}
+
+static bool test_tags_contains(const mat_tag_t* tag, int32_t entry) {
+
+	for (int32_t i = 0; i < tag->count; ++i) {
+		if (tag->entries[i] == entry) {
+			return true;
+		}
+	}
+
+	return false;
+
+}
+
+bool test_tags() {
+
+	for (uint32_t tag = 0; tag < mat_block_tag_count; ++tag) {
+		for (uint32_t block = 0; block < mat_block_count; ++block) {
+			if (mat_block_has_tag(block, tag) != test_tags_contains(mat_block_tags[tag], block)) {
+				log_error("FAIL ON BLOCK %u IN %s", block, UTL_STRTOCSTR(mat_block_tags[tag]->identifier));
+				return false;
+			}
+		}
+	}
+
+	for (uint32_t tag = 0; tag < mat_item_tag_count; ++tag) {
+		for (uint32_t item = 0; item < mat_item_count; ++item) {
+			if (mat_item_has_tag(item, tag) != test_tags_contains(mat_item_tags[tag], item)) {
+				log_error("FAIL ON ITEM %u IN %s", item, UTL_STRTOCSTR(mat_item_tags[tag]->identifier));
+				return false;
+			}
+		}
+	}
+
+	// the tags agree with the flags of the blocks
+	for (uint32_t block = 0; block < mat_block_count; ++block) {
+		const mat_block_t* data = mat_get_block_by_type(block);
+		if (mat_block_has_tag(block, mat_block_tag_needs_iron_tool) != data->needs_iron_tool || mat_block_has_tag(block, mat_block_tag_air) != data->air) {
+			log_error("FAIL ON FLAGS OF BLOCK %u", block);
+			return false;
+		}
+	}
+
+	if (
+		!ent_player_is_best_tool(mat_block_stone, mat_item_wooden_pickaxe) ||
+		ent_player_is_best_tool(mat_block_stone, mat_item_diamond_shovel) ||
+		ent_player_is_best_tool(mat_block_dirt, mat_item_stick) ||
+		!ent_player_is_best_tool(mat_block_dirt, mat_item_golden_shovel) ||
+		!ent_player_is_best_tool(mat_block_oak_planks, mat_item_netherite_axe) ||
+		!ent_player_is_best_tool(mat_block_torch, mat_item_air)
+	) {
+		log_error("FAIL ON BEST TOOL");
+		return false;
+	}
+
+	if (
+		!ent_player_can_harvest(mat_block_stone, mat_item_wooden_pickaxe) ||
+		ent_player_can_harvest(mat_block_stone, mat_item_air) ||
+		ent_player_can_harvest(mat_block_iron_ore, mat_item_golden_pickaxe) ||
+		!ent_player_can_harvest(mat_block_iron_ore, mat_item_stone_pickaxe) ||
+		ent_player_can_harvest(mat_block_obsidian, mat_item_iron_pickaxe) ||
+		!ent_player_can_harvest(mat_block_obsidian, mat_item_netherite_pickaxe) ||
+		!ent_player_can_harvest(mat_block_dirt, mat_item_air)
+	) {
+		log_error("FAIL ON HARVEST");
+		return false;
+	}
+
+	uint32_t harvestable = 0;
+	const uint64_t start = test_nanos();
+	for (uint32_t item = 0; item < mat_item_count; ++item) {
+		for (uint32_t block = 0; block < mat_block_count; ++block) {
+			harvestable += ent_player_is_best_tool(block, item) && ent_player_can_harvest(block, item);
+		}
+	}
+	const uint64_t time = test_nanos() - start;
+
+	log_info("Tags: %u of %u block and item pairs harvested with the best tool, %" PRIu64 "ps per pair", harvestable, mat_item_count * mat_block_count, time * 1000 / (mat_item_count * mat_block_count));
+
+	return true;
+
+}
+
+bool test_dig_times() {
+
+	// ticks from the vanilla client
+	const struct {
+		mat_block_type_t block;
+		mat_item_type_t item;
+		float32_t multiplier;
+		uint16_t ticks;
+	} digs[] = {
+		{ mat_block_stone, mat_item_air, 1, 150 },
+		{ mat_block_stone, mat_item_wooden_pickaxe, 1, 23 },
+		{ mat_block_stone, mat_item_stone_pickaxe, 1, 12 },
+		{ mat_block_stone, mat_item_iron_pickaxe, 1, 8 },
+		{ mat_block_stone, mat_item_diamond_pickaxe, 1, 6 },
+		{ mat_block_stone, mat_item_netherite_pickaxe, 1, 5 },
+		{ mat_block_stone, mat_item_golden_pickaxe, 1, 4 },
+		{ mat_block_stone, mat_item_diamond_shovel, 1, 150 },
+		{ mat_block_stone, mat_item_diamond_pickaxe, 0.2, 29 },
+		{ mat_block_obsidian, mat_item_air, 1, 5000 },
+		{ mat_block_obsidian, mat_item_wooden_pickaxe, 1, 2500 },
+		{ mat_block_obsidian, mat_item_stone_pickaxe, 1, 1250 },
+		{ mat_block_obsidian, mat_item_diamond_pickaxe, 1, 188 },
+		{ mat_block_obsidian, mat_item_netherite_pickaxe, 1, 167 },
+		{ mat_block_dirt, mat_item_air, 1, 15 },
+		{ mat_block_dirt, mat_item_wooden_shovel, 1, 8 },
+		{ mat_block_dirt, mat_item_golden_shovel, 1, 2 },
+		{ mat_block_oak_planks, mat_item_air, 1, 60 },
+		{ mat_block_oak_planks, mat_item_wooden_axe, 1, 30 },
+		{ mat_block_oak_planks, mat_item_golden_axe, 1, 5 },
+		{ mat_block_iron_ore, mat_item_air, 1, 300 },
+		{ mat_block_iron_ore, mat_item_wooden_pickaxe, 1, 150 },
+		{ mat_block_iron_ore, mat_item_stone_pickaxe, 1, 23 },
+		{ mat_block_torch, mat_item_air, 1, 0 },
+		{ mat_block_bedrock, mat_item_netherite_pickaxe, 1, MAT_DIG_UNBREAKABLE }
+	};
+
+	for (uint32_t i = 0; i < sizeof(digs) / sizeof(digs[0]); ++i) {
+		const uint16_t ticks = mat_get_dig_ticks(digs[i].block, mat_get_item_tool(digs[i].item), digs[i].multiplier);
+		if (ticks != digs[i].ticks) {
+			log_error("FAIL ON DIG %u: %u TICKS, EXPECTED %u", i, ticks, digs[i].ticks);
+			return false;
+		}
+	}
+
+	uint64_t total = 0;
+	const uint64_t start = test_nanos();
+	for (uint32_t item = 0; item < mat_item_count; ++item) {
+		const mat_tool_t tool = mat_get_item_tool(item);
+		for (uint32_t block = 0; block < mat_block_count; ++block) {
+			total += mat_get_dig_ticks(block, tool, 1);
+		}
+	}
+	const uint64_t time = test_nanos() - start;
+
+	log_info("Dig times: %" PRIu64 " ticks over %u block and item pairs, %" PRIu64 "ps per pair", total, mat_item_count * mat_block_count, time * 1000 / (mat_item_count * mat_block_count));
+
+	return true;
+
+}
+
+static bool test_inventory_is(const inv_window_t* window, int16_t slot, mat_item_type_t type, uint8_t count) {
+
+	const itm_item_t* item = slot == INV_SLOT_NONE ? &window->carried : &window->slots[slot];
+
+	return (count == 0 && item->type == mat_item_air) || (item->type == type && item->count == count);
+
+}
+
+bool test_inventory() {
+
+	itm_item_t slots[INV_PLAYER_SLOTS];
+	itm_item_t remote[INV_PLAYER_SLOTS];
+	for (uint8_t i = 0; i < INV_PLAYER_SLOTS; ++i) {
+		slots[i] = itm_new;
+	}
+
+	inv_window_t window = { .carried = itm_new };
+	inv_init_window(&window, inv_window_player, 0, slots, remote);
+
+	slots[INV_PLAYER_MAIN] = (itm_item_t) { .type = mat_item_stone, .count = 64 };
+	slots[INV_PLAYER_MAIN + 1] = (itm_item_t) { .type = mat_item_dirt, .count = 10 };
+	slots[INV_PLAYER_ARMOR] = (itm_item_t) { .type = mat_item_iron_helmet, .count = 1 };
+	inv_set_sent(&window);
+
+	inv_change_t changes[INV_MAX_SLOTS + 1];
+	if (inv_get_changes(&window, changes) != 0 || window.state_id != 0) {
+		log_error("FAIL ON SENT WINDOW");
+		return false;
+	}
+
+	// pick up, put one down and put the rest on top of it
+	if (
+		!inv_click(&window, INV_PLAYER_MAIN, 0, inv_click_normal, false) ||
+		!test_inventory_is(&window, INV_SLOT_NONE, mat_item_stone, 64) ||
+		!inv_click(&window, INV_PLAYER_HOTBAR, 1, inv_click_normal, false) ||
+		!test_inventory_is(&window, INV_PLAYER_HOTBAR, mat_item_stone, 1) ||
+		!inv_click(&window, INV_PLAYER_HOTBAR, 0, inv_click_normal, false) ||
+		!test_inventory_is(&window, INV_PLAYER_HOTBAR, mat_item_stone, 64) ||
+		!test_inventory_is(&window, INV_SLOT_NONE, mat_item_air, 0) ||
+		!test_inventory_is(&window, INV_PLAYER_MAIN, mat_item_air, 0)
+	) {
+		log_error("FAIL ON CLICKS");
+		return false;
+	}
+
+	// the client guessed right, so nothing is sent
+	inv_set_remote(&window, INV_PLAYER_MAIN, itm_new);
+	inv_set_remote(&window, INV_PLAYER_HOTBAR, slots[INV_PLAYER_HOTBAR]);
+	if (inv_get_changes(&window, changes) != 0 || window.state_id != 0) {
+		log_error("FAIL ON MATCHING GUESS");
+		return false;
+	}
+
+	// dirt from the hotbar joins the dirt in the main inventory, stone from there goes to the hotbar
+	slots[INV_PLAYER_HOTBAR + 1] = (itm_item_t) { .type = mat_item_dirt, .count = 60 };
+	slots[INV_PLAYER_MAIN + 5] = (itm_item_t) { .type = mat_item_stone, .count = 10 };
+	if (
+		!inv_click(&window, INV_PLAYER_HOTBAR + 1, 0, inv_click_shift, false) ||
+		!test_inventory_is(&window, INV_PLAYER_MAIN + 1, mat_item_dirt, 64) ||
+		!test_inventory_is(&window, INV_PLAYER_MAIN, mat_item_dirt, 6) ||
+		!test_inventory_is(&window, INV_PLAYER_HOTBAR + 1, mat_item_air, 0) ||
+		!inv_click(&window, INV_PLAYER_MAIN + 5, 0, inv_click_shift, false) ||
+		!test_inventory_is(&window, INV_PLAYER_HOTBAR, mat_item_stone, 64) ||
+		!test_inventory_is(&window, INV_PLAYER_HOTBAR + 1, mat_item_stone, 10) ||
+		!inv_click(&window, INV_PLAYER_ARMOR, 0, inv_click_shift, false) ||
+		!test_inventory_is(&window, INV_PLAYER_MAIN + 2, mat_item_iron_helmet, 1)
+	) {
+		log_error("FAIL ON SHIFT CLICKS");
+		return false;
+	}
+
+	// only the slots the client doesn't know about are sent, under a new state id
+	const uint32_t change_count = inv_get_changes(&window, changes);
+	if (change_count != 5 || window.state_id != 1 || changes[0].slot != INV_PLAYER_ARMOR) {
+		log_error("FAIL ON CHANGES %u", change_count);
+		return false;
+	}
+
+	// swap with the hotbar, and spread stone over three slots
+	if (
+		!inv_click(&window, INV_PLAYER_MAIN + 2, 8, inv_click_number, false) ||
+		!test_inventory_is(&window, INV_PLAYER_HOTBAR + 8, mat_item_iron_helmet, 1) ||
+		inv_click(&window, INV_PLAYER_MAIN, 9, inv_click_number, false) ||
+		!inv_click(&window, INV_PLAYER_HOTBAR, 0, inv_click_normal, false) ||
+		!inv_click(&window, INV_SLOT_OUTSIDE, 0, inv_click_drag, false) ||
+		!inv_click(&window, INV_PLAYER_MAIN + 10, 1, inv_click_drag, false) ||
+		!inv_click(&window, INV_PLAYER_MAIN + 11, 1, inv_click_drag, false) ||
+		!inv_click(&window, INV_PLAYER_MAIN + 11, 1, inv_click_drag, false) ||
+		!inv_click(&window, INV_PLAYER_MAIN + 12, 1, inv_click_drag, false) ||
+		!inv_click(&window, INV_SLOT_OUTSIDE, 2, inv_click_drag, false) ||
+		!test_inventory_is(&window, INV_PLAYER_MAIN + 10, mat_item_stone, 21) ||
+		!test_inventory_is(&window, INV_PLAYER_MAIN + 12, mat_item_stone, 21) ||
+		!test_inventory_is(&window, INV_SLOT_NONE, mat_item_stone, 1) ||
+		!inv_click(&window, INV_PLAYER_MAIN + 10, 0, inv_click_double, false) ||
+		!test_inventory_is(&window, INV_SLOT_NONE, mat_item_stone, 64) ||
+		inv_click(&window, INV_PLAYER_SLOTS, 0, inv_click_normal, false)
+	) {
+		log_error("FAIL ON SWAPS AND DRAGS");
+		return false;
+	}
+	inv_click(&window, INV_SLOT_OUTSIDE, 0, inv_click_normal, false);
+
+	// two planks over each other in the grid make sticks, shift clicking makes all of them
+	test_shaped(1, 2, "aa", (rec_ingredient_t[]) { TEST_ITEM(mat_item_oak_planks) }, mat_item_stick);
+	slots[INV_PLAYER_GRID] = (itm_item_t) { .type = mat_item_oak_planks, .count = 2 };
+	inv_update_crafting(&window);
+	const bool single = test_inventory_is(&window, INV_PLAYER_RESULT, mat_item_air, 0);
+	slots[INV_PLAYER_GRID + 2] = (itm_item_t) { .type = mat_item_oak_planks, .count = 3 };
+	inv_update_crafting(&window);
+	const bool crafting = single &&
+		test_inventory_is(&window, INV_PLAYER_RESULT, mat_item_stick, 1) &&
+		inv_click(&window, INV_PLAYER_RESULT, 0, inv_click_normal, false) &&
+		test_inventory_is(&window, INV_SLOT_NONE, mat_item_stick, 1) &&
+		test_inventory_is(&window, INV_PLAYER_GRID + 2, mat_item_oak_planks, 2) &&
+		inv_click(&window, INV_PLAYER_RESULT, 0, inv_click_shift, false) &&
+		test_inventory_is(&window, INV_PLAYER_RESULT, mat_item_air, 0) &&
+		test_inventory_is(&window, INV_PLAYER_GRID + 2, mat_item_oak_planks, 1) &&
+		test_inventory_is(&window, INV_PLAYER_HOTBAR, mat_item_stick, 1);
+
+	for (uint32_t i = 0; i < rec_recipes.size; ++i) {
+		free(UTL_VECTOR_GET_AS(rec_recipe_t*, &rec_recipes, i));
+	}
+	rec_term_index();
+	rec_recipes.size = 0;
+	rec_version++;
+
+	if (!crafting) {
+		log_error("FAIL ON CRAFTING");
+		return false;
+	}
+
+	// moving a stack back and forth, and what a full resend would have been
+	for (uint8_t i = 0; i < INV_PLAYER_SLOTS; ++i) {
+		slots[i] = itm_new;
+	}
+	window.carried = itm_new;
+	slots[INV_PLAYER_MAIN] = (itm_item_t) { .type = mat_item_dirt, .count = 64 };
+	inv_set_sent(&window);
+	const uint32_t rounds = 100000;
+	uint64_t sent = 0;
+	const uint64_t start = test_nanos();
+	for (uint32_t i = 0; i < rounds; ++i) {
+		inv_click(&window, INV_PLAYER_MAIN, 0, inv_click_shift, false);
+		sent += inv_get_changes(&window, changes);
+		inv_click(&window, INV_PLAYER_HOTBAR, 0, inv_click_shift, false);
+		sent += inv_get_changes(&window, changes);
+	}
+	const uint64_t time = test_nanos() - start;
+
+	log_info("Inventory: %" PRIu64 "ns per click, %" PRIu64 " slots sent for %u clicks instead of %u", time / (rounds * 2), sent, rounds * 2, rounds * 2 * INV_PLAYER_SLOTS);
+
+	inv_term_window(&window);
+
+	// slots from the client, without nbt, with nbt and with nbt that claims more than was sent
+	const byte_t slot_bytes[] = {
+		1, 0x01, 5, MNBT_END,
+		1, 0x02, 1, MNBT_COMPOUND, 0, 0, MNBT_INT, 0, 1, 'a', 0, 0, 0, 7, MNBT_END,
+		1, 0x03, 1, MNBT_COMPOUND, 0, 0, MNBT_STRING, 0, 1, 'a', 0x7f, 0xff, 'b'
+	};
+	PCK_INLINE(slot_packet, sizeof(slot_bytes), io_big_endian);
+	memcpy(slot_packet->bytes, slot_bytes, sizeof(slot_bytes));
+
+	itm_item_t read[3] = { itm_new, itm_new, itm_new };
+	if (!itm_from_packet(slot_packet, &read[0]) || read[0].type != 1 || read[0].count != 5 || slot_packet->cursor != 4) {
+		log_error("FAIL ON SLOT WITHOUT NBT");
+		return false;
+	}
+	if (!itm_from_packet(slot_packet, &read[1]) || read[1].type != 2 || slot_packet->cursor != 19) {
+		log_error("FAIL ON SLOT WITH NBT");
+		return false;
+	}
+	if (itm_from_packet(slot_packet, &read[2]) || slot_packet->cursor > slot_packet->length) {
+		log_error("FAIL ON SLOT WITH TRUNCATED NBT");
+		return false;
+	}
+
+	return true;
+
+}
+
+bool test_cfb8() {
+
+	byte_t key[LTG_AES_KEY_LENGTH];
+	for (uint32_t i = 0; i < LTG_AES_KEY_LENGTH; ++i) {
+		key[i] = i * 37 + 1;
+	}
+
+	const size_t length = 1 << 20;
+	byte_t* plain = malloc(length);
+	byte_t* separate = malloc(length);
+	byte_t* batched = malloc(length);
+	for (size_t i = 0; i < length; ++i) {
+		plain[i] = i * 13;
+	}
+
+	// 64 byte packets one at a time into a separate buffer versus one in place call
+	EVP_CIPHER_CTX* e1;
+	EVP_CIPHER_CTX* d1;
+	EVP_CIPHER_CTX* e2;
+	EVP_CIPHER_CTX* d2;
+	cfb8_init(key, &e1, &d1);
+	cfb8_init(key, &e2, &d2);
+
+	uint64_t start = test_nanos();
+	for (size_t i = 0; i < length; i += 64) {
+		cfb8_encrypt(e1, plain + i, 64, separate + i);
+	}
+	const uint64_t separate_time = test_nanos() - start;
+
+	memcpy(batched, plain, length);
+	start = test_nanos();
+	cfb8_encrypt_in_place(e2, batched, length);
+	const uint64_t batched_time = test_nanos() - start;
+
+	if (memcmp(separate, batched, length) != 0) {
+		log_error("FAIL ON CFB8 ENCRYPT IN PLACE");
+		return false;
+	}
+
+	// decrypting in uneven pieces has to give the plain text back
+	for (size_t i = 0; i < length; i += 1000) {
+		cfb8_decrypt_in_place(d2, batched + i, UTL_MIN(1000, (int64_t) (length - i)));
+	}
+	if (memcmp(plain, batched, length) != 0) {
+		log_error("FAIL ON CFB8 DECRYPT IN PLACE");
+		return false;
+	}
+
+	cfb8_done(e1, d1);
+	cfb8_done(e2, d2);
+	free(plain);
+	free(separate);
+	free(batched);
+
+	log_info("CFB8 1MiB: %" PRIu64 "MB/s per packet, %" PRIu64 "MB/s batched in place", (uint64_t) length * 1000 / UTL_MAX(separate_time, 1), (uint64_t) length * 1000 / UTL_MAX(batched_time, 1));
+
+	return true;
+
+}
+
+typedef struct {
+
+	_Atomic bool done;
+	ath_status_t status;
+
+	// what ath_wait returned
+	bool waited;
+
+} test_auth_t;
+
+static bool test_auth_callback(ltg_client_t* client, const ath_result_t* result) {
+
+	test_auth_t* auth = (test_auth_t*) client;
+
+	auth->status = result->status;
+	auth->done = true;
+
+	return true;
+
+}
+
+// minimal session server: "slow" never answers, "bad" gets a 204 and everyone else a profile after 100ms
+static void* test_auth_stub_connection(void* args) {
+
+	const int connection = (int) (intptr_t) args;
+
+	char request[1024];
+	size_t length = 0;
+	while (length < sizeof(request) - 1) {
+		const ssize_t read = recv(connection, request + length, sizeof(request) - 1 - length, 0);
+		if (read <= 0) {
+			break;
+		}
+		length += read;
+		request[length] = 0;
+		if (strstr(request, "\r\n\r\n") != NULL) {
+			break;
+		}
+	}
+	request[length] = 0;
+
+	char response[512];
+	if (strstr(request, "username=slow") != NULL) {
+		// hold the connection until the client gives up
+		while (recv(connection, request, sizeof(request), 0) > 0);
+	} else if (strstr(request, "username=bad") != NULL) {
+		const int response_length = sprintf(response, "HTTP/1.1 204 No Content\r\nContent-Length: 0\r\n\r\n");
+		send(connection, response, response_length, 0);
+	} else {
+		nanosleep(&(struct timespec) { .tv_sec = 0, .tv_nsec = 100000000 }, NULL);
+		const char* body = "{\"id\":\"0123456789abcdef0123456789abcdef\",\"name\":\"player\",\"properties\":[]}";
+		const int response_length = sprintf(response, "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: %zu\r\n\r\n%s", strlen(body), body);
+		send(connection, response, response_length, 0);
+	}
+
+	close(connection);
+
+	return NULL;
+
+}
+
+static void* test_auth_stub(void* args) {
+
+	const int server = (int) (intptr_t) args;
+
+	for (;;) {
+		const int connection = accept(server, NULL, NULL);
+		if (connection < 0) {
+			break;
+		}
+		pthread_t thread;
+		pthread_create(&thread, NULL, test_auth_stub_connection, (void*) (intptr_t) connection);
+		pthread_detach(thread);
+	}
+
+	return NULL;
+
+}
+
+// wait for the results like the clients' threads do
+static bool test_auth_wait(test_auth_t* auths, uint32_t count) {
+
+	for (uint32_t i = 0; i < count; ++i) {
+		auths[i].waited = ath_wait((ltg_client_t*) &auths[i], test_auth_callback);
+		if (!auths[i].waited) {
+			return false;
+		}
+	}
+
+	return true;
+
+}
+
+static void* test_auth_waiter(void* args) {
+
+	test_auth_t* auth = args;
+	auth->waited = ath_wait((ltg_client_t*) auth, test_auth_callback);
+
+	return NULL;
+
+}
+
+bool test_auth() {
+
+	// start the stub server on a free port
+	const int server = socket(AF_INET, SOCK_STREAM, 0);
+	struct sockaddr_in address = { .sin_family = AF_INET, .sin_port = 0, .sin_addr.s_addr = htonl(INADDR_LOOPBACK) };
+	socklen_t address_length = sizeof(address);
+	if (bind(server, (struct sockaddr*) &address, sizeof(address)) != 0 || listen(server, 64) != 0 || getsockname(server, (struct sockaddr*) &address, &address_length) != 0) {
+		log_error("FAIL ON AUTH STUB");
+		return false;
+	}
+	pthread_t stub;
+	pthread_create(&stub, NULL, test_auth_stub, (void*) (intptr_t) server);
+
+	char url[64];
+	sprintf(url, "http://127.0.0.1:%u", ntohs(address.sin_port));
+
+	ath_init();
+	ath_set_base_url(url);
+	ath_set_timeout(500);
+
+	bool passed = false;
+	test_auth_t auths[8] = { 0 };
+	test_auth_t again = { 0 }, escaped = { 0 }, bad = { 0 }, slow = { 0 }, canceled = { 0 };
+
+	// requests run side by side, 8 of them take about as long as one
+	uint64_t start = test_nanos();
+	for (uint32_t i = 0; i < 8; ++i) {
+		char username[16];
+		sprintf(username, "player%u", i);
+		ath_has_joined((ltg_client_t*) &auths[i], username, "-1a2b3c");
+	}
+	if (!test_auth_wait(auths, 8)) {
+		log_error("FAIL ON AUTH CONCURRENT");
+		goto done;
+	}
+	const uint64_t concurrent_time = test_nanos() - start;
+	for (uint32_t i = 0; i < 8; ++i) {
+		if (auths[i].status != ath_ok) {
+			log_error("FAIL ON AUTH STATUS (%u)", i);
+			goto done;
+		}
+	}
+	if (concurrent_time > 700000000) {
+		log_error("FAIL ON AUTH CONCURRENT TIME (%" PRIu64 "ns)", concurrent_time);
+		goto done;
+	}
+
+	// logging in again asks the session server again
+	start = test_nanos();
+	ath_has_joined((ltg_client_t*) &again, "player3", "-4d5e6f");
+	if (!test_auth_wait(&again, 1) || again.status != ath_ok || test_nanos() - start < 100000000) {
+		log_error("FAIL ON AUTH AGAIN");
+		goto done;
+	}
+
+	// the arguments can't add to the query, unescaped this would be a request for "bad"
+	ath_has_joined((ltg_client_t*) &escaped, "player&username=bad", "-1a2b3c&x=y");
+	if (!test_auth_wait(&escaped, 1) || escaped.status != ath_ok) {
+		log_error("FAIL ON AUTH ESCAPE");
+		goto done;
+	}
+
+	// invalid sessions and timeouts
+	ath_has_joined((ltg_client_t*) &bad, "bad", "-1a2b3c");
+	ath_has_joined((ltg_client_t*) &slow, "slow", "-1a2b3c");
+	if (!test_auth_wait(&bad, 1) || bad.status != ath_invalid) {
+		log_error("FAIL ON AUTH INVALID");
+		goto done;
+	}
+	if (!test_auth_wait(&slow, 1) || slow.status != ath_failed) {
+		log_error("FAIL ON AUTH TIMEOUT");
+		goto done;
+	}
+
+	// cancelling wakes up the client's thread without running the callback
+	pthread_t waiter;
+	ath_has_joined((ltg_client_t*) &canceled, "slow", "-1a2b3c");
+	pthread_create(&waiter, NULL, test_auth_waiter, &canceled);
+	nanosleep(&(struct timespec) { .tv_sec = 0, .tv_nsec = 10000000 }, NULL);
+	start = test_nanos();
+	ath_cancel((ltg_client_t*) &canceled);
+	pthread_join(waiter, NULL);
+	const uint64_t cancel_time = test_nanos() - start;
+	if (canceled.done || canceled.waited || cancel_time > 100000000) {
+		log_error("FAIL ON AUTH CANCEL");
+		goto done;
+	}
+
+	log_info("Auth: 8 concurrent logins in %" PRIu64 "ms", concurrent_time / 1000000);
+
+	passed = true;
+
+done:
+	ath_term();
+	ath_set_base_url(ATH_DEFAULT_BASE_URL);
+	ath_set_timeout(ATH_DEFAULT_TIMEOUT);
+
+	shutdown(server, SHUT_RDWR);
+	close(server);
+	pthread_join(stub, NULL);
+
+	return passed;
+
+}
+
+static void test_bit_vector_count(uint32_t bit, void* arg) {
+
+	uint32_t* counter = arg;
+
+	counter[0] += 1;
+	counter[1] += bit;
+
+}
+
+bool test_bit_vector() {
+
+	utl_bit_vector_t a = UTL_BIT_VECTOR_INITIALIZER;
+	utl_bit_vector_t b = UTL_BIT_VECTOR_INITIALIZER;
+
+	// inline words
+	utl_bit_vector_set_bit(&a, 3);
+	if (!utl_bit_vector_test_bit(&a, 3) || utl_bit_vector_test_bit(&a, 4) || utl_bit_vector_test_bit(&a, 67) || a.heap != NULL) {
+		log_error("FAIL ON INLINE TEST BIT");
+		return false;
+	}
+
+	// spill to heap, even bits in a and every third bit in b
+	for (uint32_t i = 0; i < 1000; ++i) {
+		if (i % 2 == 0) utl_bit_vector_set_bit(&a, i);
+		if (i % 3 == 0) utl_bit_vector_set_bit(&b, i);
+	}
+	utl_bit_vector_reset_bit(&a, 3);
+	utl_bit_vector_reset_bit(&a, 100000);
+
+	for (uint32_t i = 0; i < 1000; ++i) {
+		if (utl_bit_vector_test_bit(&a, i) != (i % 2 == 0)) {
+			log_error("FAIL ON TEST BIT %u", i);
+			return false;
+		}
+	}
+
+	uint32_t counter[2] = { 0, 0 };
+	utl_bit_vector_foreach(&a, test_bit_vector_count, counter);
+	if (counter[0] != 500 || counter[1] != 249500 || utl_bit_vector_popcount(&a) != 500) {
+		log_error("FAIL ON FOREACH (%u bits)", counter[0]);
+		return false;
+	}
+
+	// multiples of 2 or 3 below 1000
+	counter[0] = counter[1] = 0;
+	utl_bit_vector_or_foreach(&a, &b, test_bit_vector_count, counter);
+	if (counter[0] != 667) {
+		log_error("FAIL ON OR FOREACH (%u bits)", counter[0]);
+		return false;
+	}
+
+	// multiples of 2 or 3 but not 6
+	pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+	counter[0] = counter[1] = 0;
+	utl_bit_vector_xor_foreach(&a, &b, &lock, &lock, test_bit_vector_count, counter);
+	if (counter[0] != 500) {
+		log_error("FAIL ON XOR FOREACH (%u bits)", counter[0]);
+		return false;
+	}
+
+	utl_bit_vector_t c = UTL_BIT_VECTOR_INITIALIZER;
+	utl_bit_vector_or(&c, &a);
+	utl_bit_vector_and(&c, &b);
+	if (utl_bit_vector_popcount(&c) != 167 || !utl_bit_vector_test_bit(&c, 996) || utl_bit_vector_test_bit(&c, 994)) {
+		log_error("FAIL ON AND (%u bits)", utl_bit_vector_popcount(&c));
+		return false;
+	}
+	utl_bit_vector_xor(&c, &b);
+	if (utl_bit_vector_popcount(&c) != 167 || !utl_bit_vector_test_bit(&c, 3) || utl_bit_vector_test_bit(&c, 6)) {
+		log_error("FAIL ON XOR (%u bits)", utl_bit_vector_popcount(&c));
+		return false;
+	}
+
+	utl_term_bit_vector(&a);
+	utl_term_bit_vector(&b);
+	utl_term_bit_vector(&c);
+
+	// word kernels on both sides of the wide cutoff and with every tail length
+	for (uint32_t count = 0; count < 20; ++count) {
+
+		uint64_t dst[3][20], src[20], expected[3][20];
+		for (uint32_t i = 0; i < count; ++i) {
+			src[i] = 0x9e3779b97f4a7c15ull * (i + 1);
+			for (uint32_t k = 0; k < 3; ++k) {
+				dst[k][i] = 0xc2b2ae3d27d4eb4full * (i + 7);
+			}
+			expected[0][i] = dst[0][i] | src[i];
+			expected[1][i] = dst[1][i] & src[i];
+			expected[2][i] = dst[2][i] ^ src[i];
+		}
+
+		utl_bit_words_or(dst[0], src, count);
+		utl_bit_words_and(dst[1], src, count);
+		utl_bit_words_xor(dst[2], src, count);
+
+		for (uint32_t k = 0; k < 3; ++k) {
+			if (memcmp(dst[k], expected[k], sizeof(uint64_t) * count) != 0) {
+				log_error("FAIL ON WORD KERNEL %u (%u words)", k, count);
+				return false;
+			}
+		}
+
+	}
+
+	return true;
+
+}
+
+typedef struct {
+	bool (*func)();
+	string_t label;
+} test_t;
+
+int test_run_all() {
+
+	const test_t tests[] = {
+		(test_t) {
+			.func = test_materials,
+			.label = UTL_CSTRTOSTR("materials")
+		},
+		(test_t) {
+			.func = test_packets,
+			.label = UTL_CSTRTOSTR("packets")
+		},
+		(test_t) {
+			.func = test_nbt,
+			.label = UTL_CSTRTOSTR("nbt")
+		},
+		(test_t) {
+			.func = test_nbt_cursor,
+			.label = UTL_CSTRTOSTR("nbt_cursor")
+		},
+		(test_t) {
+			.func = test_batch,
+			.label = UTL_CSTRTOSTR("batch")
+		},
+		(test_t) {
+			.func = test_palette,
+			.label = UTL_CSTRTOSTR("palette")
+		},
+		(test_t) {
+			.func = test_compression,
+			.label = UTL_CSTRTOSTR("compression")
+		},
+		(test_t) {
+			.func = test_compression_pool,
+			.label = UTL_CSTRTOSTR("compression_pool")
+		},
+		(test_t) {
+			.func = test_blobs,
+			.label = UTL_CSTRTOSTR("blobs")
+		},
+		(test_t) {
+			.func = test_status,
+			.label = UTL_CSTRTOSTR("status")
+		},
+		(test_t) {
+			.func = test_flood,
+			.label = UTL_CSTRTOSTR("flood")
+		},
+		(test_t) {
+			.func = test_registry,
+			.label = UTL_CSTRTOSTR("registry")
+		},
+		(test_t) {
+			.func = test_player_list,
+			.label = UTL_CSTRTOSTR("player_list")
+		},
+		(test_t) {
+			.func = test_keep_alive,
+			.label = UTL_CSTRTOSTR("keep_alive")
+		},
+		(test_t) {
+			.func = test_recipes,
+			.label = UTL_CSTRTOSTR("recipes")
+		},
+		(test_t) {
+			.func = test_block_updates,
+			.label = UTL_CSTRTOSTR("block_updates")
+		},
+		(test_t) {
+			.func = test_random_ticks,
+			.label = UTL_CSTRTOSTR("random_ticks")
+		},
+		(test_t) {
+			.func = test_fluids,
+			.label = UTL_CSTRTOSTR("fluids")
+		},
+		(test_t) {
+			.func = test_block_changes,
+			.label = UTL_CSTRTOSTR("block_changes")
+		},
+		(test_t) {
+			.func = test_world_edit,
+			.label = UTL_CSTRTOSTR("world_edit")
+		},
+		(test_t) {
+			.func = test_block_states,
+			.label = UTL_CSTRTOSTR("block_states")
+		},
+		(test_t) {
+			.func = test_tags,
+			.label = UTL_CSTRTOSTR("tags")
+		},
+		(test_t) {
+			.func = test_dig_times,
+			.label = UTL_CSTRTOSTR("dig_times")
+		},
+		(test_t) {
+			.func = test_inventory,
+			.label = UTL_CSTRTOSTR("inventory")
+		},
+		(test_t) {
+			.func = test_cfb8,
+			.label = UTL_CSTRTOSTR("cfb8")
+		},
+		(test_t) {
+			.func = test_auth,
+			.label = UTL_CSTRTOSTR("auth")
+		},
+		(test_t) {
+			.func = test_bit_vector,
+			.label = UTL_CSTRTOSTR("bit_vector")
 		},
 		(test_t) {
 			.func = test_worlds,
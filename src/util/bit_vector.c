@@ -0,0 +1,102 @@
+#include "bit_vector.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define UTL_BIT_VECTOR_X86 1
+#include <immintrin.h>
+#endif
+
+#ifdef UTL_BIT_VECTOR_X86
+
+// the vector paths only handle whole groups of 4 words, the scalar loop picks up the rest
+
+__attribute__((target("avx2")))
+static uint32_t utl_bit_words_or_avx2(uint64_t* restrict dst, const uint64_t* restrict src, uint32_t count) {
+
+	uint32_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const __m256i a = _mm256_loadu_si256((const __m256i*) (dst + i));
+		const __m256i b = _mm256_loadu_si256((const __m256i*) (src + i));
+		_mm256_storeu_si256((__m256i*) (dst + i), _mm256_or_si256(a, b));
+	}
+
+	return i;
+
+}
+
+__attribute__((target("avx2")))
+static uint32_t utl_bit_words_and_avx2(uint64_t* restrict dst, const uint64_t* restrict src, uint32_t count) {
+
+	uint32_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const __m256i a = _mm256_loadu_si256((const __m256i*) (dst + i));
+		const __m256i b = _mm256_loadu_si256((const __m256i*) (src + i));
+		_mm256_storeu_si256((__m256i*) (dst + i), _mm256_and_si256(a, b));
+	}
+
+	return i;
+
+}
+
+__attribute__((target("avx2")))
+static uint32_t utl_bit_words_xor_avx2(uint64_t* restrict dst, const uint64_t* restrict src, uint32_t count) {
+
+	uint32_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const __m256i a = _mm256_loadu_si256((const __m256i*) (dst + i));
+		const __m256i b = _mm256_loadu_si256((const __m256i*) (src + i));
+		_mm256_storeu_si256((__m256i*) (dst + i), _mm256_xor_si256(a, b));
+	}
+
+	return i;
+
+}
+
+#endif
+
+void utl_bit_words_or_wide(uint64_t* restrict dst, const uint64_t* restrict src, uint32_t count) {
+
+	uint32_t i = 0;
+
+#ifdef UTL_BIT_VECTOR_X86
+	if (__builtin_cpu_supports("avx2")) {
+		i = utl_bit_words_or_avx2(dst, src, count);
+	}
+#endif
+
+	for (; i < count; ++i) {
+		dst[i] |= src[i];
+	}
+
+}
+
+void utl_bit_words_and_wide(uint64_t* restrict dst, const uint64_t* restrict src, uint32_t count) {
+
+	uint32_t i = 0;
+
+#ifdef UTL_BIT_VECTOR_X86
+	if (__builtin_cpu_supports("avx2")) {
+		i = utl_bit_words_and_avx2(dst, src, count);
+	}
+#endif
+
+	for (; i < count; ++i) {
+		dst[i] &= src[i];
+	}
+
+}
+
+void utl_bit_words_xor_wide(uint64_t* restrict dst, const uint64_t* restrict src, uint32_t count) {
+
+	uint32_t i = 0;
+
+#ifdef UTL_BIT_VECTOR_X86
+	if (__builtin_cpu_supports("avx2")) {
+		i = utl_bit_words_xor_avx2(dst, src, count);
+	}
+#endif
+
+	for (; i < count; ++i) {
+		dst[i] ^= src[i];
+	}
+
+}
@@ -1,40 +1,67 @@
 #pragma once
 #include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
 #include "../main.h"
 #include "util.h"
-#include "vector.h"
 #include "lock_util.h"
 
+// words stored inside the bit vector itself before spilling to the heap
+// 2 words cover client ids 0-127 which keeps chunk subscriber sets allocation free on most servers
+#define UTL_BIT_VECTOR_INLINE_WORDS 2
+
+// sets this long go through the vector kernels in bit_vector.c, shorter ones aren't worth the call
+#define UTL_BIT_VECTOR_WIDE_WORDS 8
+
 typedef struct {
 
-	utl_vector_t vector;
+	// NULL while the bits fit in the inline words
+	uint64_t* heap;
+
+	// words in use
+	uint32_t size;
+
+	// words available in `heap`, 0 when using the inline words
+	uint32_t capacity;
+
+	uint64_t inline_words[UTL_BIT_VECTOR_INLINE_WORDS];
 
 } utl_bit_vector_t;
 
-#define UTL_BIT_VECTOR_INITIALIZER { .vector = UTL_VECTOR_INITIALIZER(byte_t) }
+#define UTL_BIT_VECTOR_INITIALIZER { .heap = NULL, .size = 0, .capacity = 0, .inline_words = { 0 } }
+
+static inline void utl_init_bit_vector(utl_bit_vector_t* vector) {
+
+	*vector = (utl_bit_vector_t) UTL_BIT_VECTOR_INITIALIZER;
+
+}
 
 static inline utl_bit_vector_t* utl_create_bit_vector() {
 
 	utl_bit_vector_t* vector = malloc(sizeof(utl_bit_vector_t));
-	utl_init_vector(&vector->vector, sizeof(byte_t));
+	utl_init_bit_vector(vector);
 
 	return vector;
 
 }
 
-static inline void utl_init_bit_vector(utl_bit_vector_t* vector) {
+static inline uint64_t* utl_bit_vector_words(utl_bit_vector_t* vector) {
+	return vector->heap != NULL ? vector->heap : vector->inline_words;
+}
 
-	utl_init_vector(&vector->vector, sizeof(byte_t));
+static inline const uint64_t* utl_bit_vector_words_c(const utl_bit_vector_t* vector) {
+	return vector->heap != NULL ? vector->heap : vector->inline_words;
+}
 
+static inline uint32_t utl_bit_vector_size(const utl_bit_vector_t* vector) {
+	return vector->size;
 }
 
-static inline bool utl_bit_vector_test_bit(utl_bit_vector_t* vector, uint32_t bit) {
+static inline bool utl_bit_vector_test_bit(const utl_bit_vector_t* vector, uint32_t bit) {
 
-	if (vector->vector.size > (bit >> 3)) {
+	if (vector->size > (bit >> 6)) {
 
-		const byte_t byte = UTL_VECTOR_GET_AS(byte_t, &vector->vector, bit >> 3);
-		
-		return ((byte & 0x7) | (1 << bit)) ? true : false;
+		return (utl_bit_vector_words_c(vector)[bit >> 6] >> (bit & 0x3F)) & 1;
 
 	}
 
@@ -42,98 +69,193 @@ static inline bool utl_bit_vector_test_bit(utl_bit_vector_t* vector, uint32_t bi
 
 }
 
+/*
+Make sure word `to` exists, new words are zeroed
+*/
 static inline void utl_bit_vector_expand(utl_bit_vector_t* vector, uint32_t to) {
 
-	if (vector->vector.capacity <= to) {
+	if (vector->size > to) {
+		return;
+	}
 
-		utl_vector_resize(&vector->vector, (to + 1) * 2);
+	if (to >= UTL_BIT_VECTOR_INLINE_WORDS && to >= vector->capacity) {
 
-	}
+		const uint32_t new_capacity = (to + 1) * 2;
+
+		if (vector->heap == NULL) {
+			vector->heap = malloc(sizeof(uint64_t) * new_capacity);
+			memcpy(vector->heap, vector->inline_words, sizeof(uint64_t) * vector->size);
+		} else {
+			vector->heap = realloc(vector->heap, sizeof(uint64_t) * new_capacity);
+		}
 
-	if (vector->vector.size <= to) {
-		
-		memset(vector->vector.array + vector->vector.size, 0, to + 1);
-		vector->vector.size = to + 1;
+		vector->capacity = new_capacity;
 
 	}
 
+	memset(utl_bit_vector_words(vector) + vector->size, 0, sizeof(uint64_t) * (to + 1 - vector->size));
+	vector->size = to + 1;
+
 }
 
 static inline void utl_bit_vector_set_bit(utl_bit_vector_t* vector, uint32_t bit) {
-	
-	utl_bit_vector_expand(vector, bit >> 3);
 
-	byte_t* byte = utl_vector_get(&vector->vector, bit >> 3);
+	utl_bit_vector_expand(vector, bit >> 6);
 
-	*byte |= (1 << (bit & 0x7));
+	utl_bit_vector_words(vector)[bit >> 6] |= (uint64_t) 1 << (bit & 0x3F);
 
 }
 
 static inline void utl_bit_vector_reset_bit(utl_bit_vector_t* vector, uint32_t bit) {
-	
-	utl_bit_vector_expand(vector, bit >> 3);
-
-	byte_t* byte = utl_vector_get(&vector->vector, bit >> 3);
-
-	*byte &= ~(1 << (bit & 0x7));
-
-}
-
-static const byte_t utl_ffs[] = {
-	0, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2,
-	0, 1, 0, 4, 0, 1, 0, 2, 0, 1, 0, 3, 0,
-	1, 0, 2, 0, 1, 0, 5, 0, 1, 0, 2, 0, 1,
-	0, 3, 0, 1, 0, 2, 0, 1, 0, 4, 0, 1, 0,
-	2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0, 6,
-	0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0,
-	1, 0, 4, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1,
-	0, 2, 0, 1, 0, 5, 0, 1, 0, 2, 0, 1, 0,
-	3, 0, 1, 0, 2, 0, 1, 0, 4, 0, 1, 0, 2,
-	0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0, 7, 0,
-	1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1,
-	0, 4, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0,
-	2, 0, 1, 0, 5, 0, 1, 0, 2, 0, 1, 0, 3,
-	0, 1, 0, 2, 0, 1, 0, 4, 0, 1, 0, 2, 0,
-	1, 0, 3, 0, 1, 0, 2, 0, 1, 0, 6, 0, 1,
-	0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
-	4, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2,
-	0, 1, 0, 5, 0, 1, 0, 2, 0, 1, 0, 3, 0,
-	1, 0, 2, 0, 1, 0, 4, 0, 1, 0, 2, 0, 1,
-	0, 3, 0, 1, 0, 2, 0, 1, 0
-};
 
-static inline void utl_bit_vector_foreach(utl_bit_vector_t* vector, void (*const function) (uint32_t, void*), void* input) {
+	if (vector->size > (bit >> 6)) {
+
+		utl_bit_vector_words(vector)[bit >> 6] &= ~((uint64_t) 1 << (bit & 0x3F));
+
+	}
+
+}
+
+static inline void utl_bit_vector_clear(utl_bit_vector_t* vector) {
+
+	memset(utl_bit_vector_words(vector), 0, sizeof(uint64_t) * vector->size);
+
+}
+
+/*
+Word kernels, `dst` and `src` must have at least `count` words
+The wide ones pick AVX2 at runtime when the cpu has it
+*/
+extern void utl_bit_words_or_wide(uint64_t* restrict dst, const uint64_t* restrict src, uint32_t count);
+extern void utl_bit_words_and_wide(uint64_t* restrict dst, const uint64_t* restrict src, uint32_t count);
+extern void utl_bit_words_xor_wide(uint64_t* restrict dst, const uint64_t* restrict src, uint32_t count);
+
+static inline void utl_bit_words_or(uint64_t* restrict dst, const uint64_t* restrict src, uint32_t count) {
+
+	if (count >= UTL_BIT_VECTOR_WIDE_WORDS) {
+		utl_bit_words_or_wide(dst, src, count);
+		return;
+	}
+
+	for (uint32_t i = 0; i < count; ++i) {
+		dst[i] |= src[i];
+	}
+
+}
+
+static inline void utl_bit_words_and(uint64_t* restrict dst, const uint64_t* restrict src, uint32_t count) {
+
+	if (count >= UTL_BIT_VECTOR_WIDE_WORDS) {
+		utl_bit_words_and_wide(dst, src, count);
+		return;
+	}
+
+	for (uint32_t i = 0; i < count; ++i) {
+		dst[i] &= src[i];
+	}
+
+}
+
+static inline void utl_bit_words_xor(uint64_t* restrict dst, const uint64_t* restrict src, uint32_t count) {
+
+	if (count >= UTL_BIT_VECTOR_WIDE_WORDS) {
+		utl_bit_words_xor_wide(dst, src, count);
+		return;
+	}
+
+	for (uint32_t i = 0; i < count; ++i) {
+		dst[i] ^= src[i];
+	}
+
+}
 
-	const uint32_t size = vector->vector.size;
+static inline uint32_t utl_bit_words_popcount(const uint64_t* words, uint32_t count) {
 
-	for (uint32_t i = 0; i < size; ++i) {
-		
-		byte_t byte = UTL_VECTOR_GET_AS(byte_t, &vector->vector, i);
+	uint32_t bits = 0;
 
-		while (byte) {
-			function((i << 3) + utl_ffs[byte], input);
-			byte &= byte - 1;
+	for (uint32_t i = 0; i < count; ++i) {
+		bits += __builtin_popcountll(words[i]);
+	}
+
+	return bits;
+
+}
+
+static inline void utl_bit_words_foreach(const uint64_t* words, uint32_t count, void (*const function) (uint32_t, void*), void* input) {
+
+	for (uint32_t i = 0; i < count; ++i) {
+
+		uint64_t word = words[i];
+
+		while (word) {
+			function((i << 6) + __builtin_ctzll(word), input);
+			word &= word - 1;
 		}
 
 	}
 
 }
 
+/*
+Whole set operations, `dst` grows to fit `src` where needed
+*/
+static inline void utl_bit_vector_or(utl_bit_vector_t* dst, const utl_bit_vector_t* src) {
+
+	if (src->size == 0) {
+		return;
+	}
+
+	utl_bit_vector_expand(dst, src->size - 1);
+	utl_bit_words_or(utl_bit_vector_words(dst), utl_bit_vector_words_c(src), src->size);
+
+}
+
+static inline void utl_bit_vector_and(utl_bit_vector_t* dst, const utl_bit_vector_t* src) {
+
+	const uint32_t common = UTL_MIN(dst->size, src->size);
+	uint64_t* words = utl_bit_vector_words(dst);
+
+	utl_bit_words_and(words, utl_bit_vector_words_c(src), common);
+	memset(words + common, 0, sizeof(uint64_t) * (dst->size - common));
+
+}
+
+static inline void utl_bit_vector_xor(utl_bit_vector_t* dst, const utl_bit_vector_t* src) {
+
+	if (src->size == 0) {
+		return;
+	}
+
+	utl_bit_vector_expand(dst, src->size - 1);
+	utl_bit_words_xor(utl_bit_vector_words(dst), utl_bit_vector_words_c(src), src->size);
+
+}
+
+static inline uint32_t utl_bit_vector_popcount(const utl_bit_vector_t* vector) {
+
+	return utl_bit_words_popcount(utl_bit_vector_words_c(vector), vector->size);
+
+}
+
+static inline void utl_bit_vector_foreach(utl_bit_vector_t* vector, void (*const function) (uint32_t, void*), void* input) {
+
+	utl_bit_words_foreach(utl_bit_vector_words(vector), vector->size, function, input);
+
+}
+
 static inline void utl_bit_vector_lock_foreach(utl_bit_vector_t* vector, pthread_mutex_t* mutex, void (*const function) (uint32_t, void*), void* input) {
 
 	pthread_mutex_lock(mutex);
-	
-	const uint32_t size = vector->vector.size;
 
-	for (uint32_t i = 0; i < size; ++i) {
-			
-		byte_t byte = UTL_VECTOR_GET_AS(byte_t, &vector->vector, i);
+	for (uint32_t i = 0; i < vector->size; ++i) {
+
+		uint64_t word = utl_bit_vector_words(vector)[i];
 
 		pthread_mutex_unlock(mutex);
 
-		while (byte) {
-			function((i << 3) + utl_ffs[byte], input);
-			byte &= byte - 1;
+		while (word) {
+			function((i << 6) + __builtin_ctzll(word), input);
+			word &= word - 1;
 		}
 
 		pthread_mutex_lock(mutex);
@@ -145,60 +267,52 @@ static inline void utl_bit_vector_lock_foreach(utl_bit_vector_t* vector, pthread
 }
 
 static inline void utl_bit_vector_or_foreach(utl_bit_vector_t* v1, utl_bit_vector_t* v2, void (*const function) (uint32_t, void*), void* input) {
-	
-	const uint32_t size = UTL_MAX(v1->vector.size, v2->vector.size);
 
-	for (uint32_t i = 0; i < size; ++i) {
-		
-		byte_t byte = 0;
+	const uint32_t size = UTL_MAX(v1->size, v2->size);
+	uint64_t words[size + 1];
 
-		if (i < v1->vector.size) {
-			byte |= UTL_VECTOR_GET_AS(byte_t, &v1->vector, i);
-		}
-		if (i < v2->vector.size) {
-			byte |= UTL_VECTOR_GET_AS(byte_t, &v2->vector, i);
-		}
+	memset(words, 0, sizeof(uint64_t) * size);
+	utl_bit_words_or(words, utl_bit_vector_words(v1), v1->size);
+	utl_bit_words_or(words, utl_bit_vector_words(v2), v2->size);
 
-		while (byte) {
-			function((i << 3) + utl_ffs[byte], input);
-			byte &= byte - 1;
-		}
-
-	}
+	utl_bit_words_foreach(words, size, function, input);
 
 }
 
 static inline void utl_bit_vector_xor_foreach(utl_bit_vector_t* v1, utl_bit_vector_t* v2, pthread_mutex_t* m1, pthread_mutex_t* m2, void (*const function) (uint32_t, void*), void* input) {
-	
-	const uint32_t size = UTL_MAX(v1->vector.size, v2->vector.size);
 
-	for (uint32_t i = 0; i < size; ++i) {
-		
-		byte_t byte = 0;
+	uint32_t s1 = 0, s2 = 0;
 
-		if (i < v1->vector.size) {
-			with_lock (m1) {
-				byte ^= UTL_VECTOR_GET_AS(byte_t, &v1->vector, i);
-			}
-		}
-		if (i < v2->vector.size) {
-			with_lock (m2) {
-				byte ^= UTL_VECTOR_GET_AS(byte_t, &v2->vector, i);
-			}
-		}
+	with_lock (m1) {
+		s1 = v1->size;
+	}
+	with_lock (m2) {
+		s2 = v2->size;
+	}
 
-		while (byte) {
-			function((i << 3) + utl_ffs[byte], input);
-			byte &= byte - 1;
-		}
+	// snapshot both sets so the callback runs without either lock held
+	const uint32_t size = UTL_MAX(s1, s2);
+	uint64_t words[size + 1];
 
+	memset(words, 0, sizeof(uint64_t) * size);
+	with_lock (m1) {
+		utl_bit_words_xor(words, utl_bit_vector_words(v1), UTL_MIN(v1->size, size));
+	}
+	with_lock (m2) {
+		utl_bit_words_xor(words, utl_bit_vector_words(v2), UTL_MIN(v2->size, size));
 	}
 
+	utl_bit_words_foreach(words, size, function, input);
+
 }
 
 static inline void utl_term_bit_vector(utl_bit_vector_t* vector) {
 
-	utl_term_vector(&vector->vector);
+	if (vector->heap != NULL) {
+		free(vector->heap);
+	}
+
+	utl_init_bit_vector(vector);
 
 }
 
@@ -207,4 +321,4 @@ static inline void utl_destroy_bit_vector(utl_bit_vector_t* vector) {
 	utl_term_bit_vector(vector);
 	free(vector);
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,360 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include "edit.h"
+#include "../world.h"
+
+typedef enum {
+
+	edt_fill_blocks,
+	edt_replace_blocks,
+	edt_copy_blocks,
+	edt_paste_blocks
+
+} edt_operation_t;
+
+typedef struct {
+
+	edt_operation_t operation;
+
+	// already clamped to the world
+	edt_box_t box;
+	int16_t min_y;
+
+	mat_block_protocol_id_t block;
+
+	edt_predicate_t predicate;
+	void* data;
+
+	// copied to or pasted from, its lowest corner is at origin
+	edt_clipboard_t* clipboard;
+	struct {
+		int32_t x;
+		int32_t y;
+		int32_t z;
+	} origin;
+
+	wld_chunk_t** chunks;
+	uint32_t chunk_count;
+
+	_Atomic uint32_t next;
+	_Atomic uint64_t changed;
+
+} edt_edit_t;
+
+static inline const mat_block_protocol_id_t* edt_get_clipboard_row(const edt_edit_t* edit, int32_t x, int32_t y, int32_t z) {
+
+	const edt_clipboard_t* clipboard = edit->clipboard;
+
+	return &clipboard->blocks[((size_t) (y - edit->origin.y) * clipboard->size_z + (size_t) (z - edit->origin.z)) * clipboard->size_x + (size_t) (x - edit->origin.x)];
+
+}
+
+// the highest block of every changed column, starting where nothing above can be a block
+static void edt_update_heightmaps(const edt_edit_t* edit, wld_chunk_t* chunk, const uint64_t columns[4]) {
+
+	const int16_t min_y = edit->min_y;
+
+	for (uint32_t i = 0; i < 4; ++i) {
+		for (uint64_t bits = columns[i]; bits != 0; bits &= bits - 1) {
+
+			const uint16_t column = (i << 6) | __builtin_ctzll(bits);
+
+			int32_t y = UTL_MAX(chunk->highest.world_surface[column], chunk->highest.motion_blocking[column]);
+			y = UTL_MAX(y, edit->box.max_y);
+
+			for (; y > min_y; --y) {
+				const mat_block_protocol_id_t block = chunk->sections[(y - min_y) >> 4].blocks[((y & 0xF) << 8) | column];
+				if (!mat_is_block_air(block)) {
+					break;
+				}
+			}
+
+			chunk->highest.motion_blocking[column] = y;
+			chunk->highest.world_surface[column] = y;
+
+		}
+	}
+
+}
+
+static uint64_t edt_edit_chunk(const edt_edit_t* edit, wld_chunk_t* chunk) {
+
+	const int32_t c_x = wld_get_chunk_x(chunk) << 4;
+	const int32_t c_z = wld_get_chunk_z(chunk) << 4;
+
+	// part of the box in this chunk
+	const uint8_t min_x = UTL_MAX(edit->box.min_x, c_x) - c_x;
+	const uint8_t max_x = UTL_MIN(edit->box.max_x, c_x + 15) - c_x;
+	const uint8_t min_z = UTL_MAX(edit->box.min_z, c_z) - c_z;
+	const uint8_t max_z = UTL_MIN(edit->box.max_z, c_z + 15) - c_z;
+
+	const mat_block_state_t state = mat_get_block_state(edit->block);
+
+	uint64_t changed = 0;
+	uint64_t columns[4] = { 0, 0, 0, 0 };
+
+	for (int32_t s = (edit->box.min_y - edit->min_y) >> 4; s <= (edit->box.max_y - edit->min_y) >> 4; ++s) {
+
+		wld_chunk_section_t* section = wld_chunk_get_section(chunk, s);
+
+		const int32_t s_y = edit->min_y + (s << 4);
+		const uint8_t min_y = UTL_MAX(edit->box.min_y, s_y) - s_y;
+		const uint8_t max_y = UTL_MIN(edit->box.max_y, s_y + 15) - s_y;
+
+		if (edit->operation == edt_copy_blocks) {
+			for (uint8_t y = min_y; y <= max_y; ++y) {
+				for (uint8_t z = min_z; z <= max_z; ++z) {
+					mat_block_protocol_id_t* row = (mat_block_protocol_id_t*) edt_get_clipboard_row(edit, c_x + min_x, s_y + y, c_z + z);
+					for (uint8_t x = min_x; x <= max_x; ++x) {
+						row[x - min_x] = atomic_load_explicit(&section->blocks[(y << 8) | (z << 4) | x], memory_order_relaxed);
+					}
+				}
+			}
+			continue;
+		}
+
+		uint64_t section_changed[16 * 16 * 16 / 64] = { 0 };
+		uint32_t section_count = 0;
+		int32_t block_count = 0;
+		int32_t random_tick_count = 0;
+
+		// neighboring blocks are mostly the same, so remember what the last one matched
+		mat_block_protocol_id_t last = edit->block;
+		bool last_matches = false;
+		if (edit->operation == edt_replace_blocks) {
+			last_matches = edit->predicate(last, edit->data);
+		}
+
+		for (uint8_t y = min_y; y <= max_y; ++y) {
+			for (uint8_t z = min_z; z <= max_z; ++z) {
+
+				const mat_block_protocol_id_t* source = NULL;
+				if (edit->operation == edt_paste_blocks) {
+					source = edt_get_clipboard_row(edit, c_x + min_x, s_y + y, c_z + z);
+				}
+
+				for (uint8_t x = min_x; x <= max_x; ++x) {
+
+					const uint16_t index = (y << 8) | (z << 4) | x;
+					const mat_block_protocol_id_t old = atomic_load_explicit(&section->blocks[index], memory_order_relaxed);
+
+					if (edit->operation == edt_replace_blocks && old != last) {
+						last = old;
+						last_matches = edit->predicate(old, edit->data);
+					}
+
+					mat_block_protocol_id_t new = edit->block;
+					mat_block_state_t new_state = state;
+					if (edit->operation == edt_replace_blocks && !last_matches) {
+						continue;
+					} else if (edit->operation == edt_paste_blocks) {
+						new = source[x - min_x];
+						new_state = mat_get_block_state(new);
+					}
+
+					if (new == old) {
+						continue;
+					}
+
+					atomic_store_explicit(&section->blocks[index], new, memory_order_relaxed);
+
+					const mat_block_state_t old_state = mat_get_block_state(old);
+					block_count += (bool) (old_state & MAT_STATE_AIR) - (bool) (new_state & MAT_STATE_AIR);
+					random_tick_count += (bool) (new_state & MAT_STATE_RANDOM_TICKS) - (bool) (old_state & MAT_STATE_RANDOM_TICKS);
+					section_changed[index >> 6] |= (uint64_t) 1 << (index & 0x3F);
+					section_count += 1;
+
+				}
+
+			}
+		}
+
+		if (section_count == 0) {
+			continue;
+		}
+
+		section->block_count += block_count;
+		section->random_tick_count += random_tick_count;
+		chunk->random_tick_count += random_tick_count;
+
+		for (uint32_t i = 0; i < 16 * 16 * 16 / 64; ++i) {
+			if (section_changed[i] != 0) {
+				section->changed[i] |= section_changed[i];
+				// the same 64 columns every 4 words
+				columns[i & 0x3] |= section_changed[i];
+			}
+		}
+		chunk->changed_sections |= (uint64_t) 1 << s;
+
+		changed += section_count;
+
+	}
+
+	if (changed != 0) {
+		edt_update_heightmaps(edit, chunk, columns);
+	}
+
+	return changed;
+
+}
+
+static void* t_edt_run(void* args) {
+
+	edt_edit_t* edit = args;
+
+	uint64_t changed = 0;
+	for (uint32_t i = edit->next++; i < edit->chunk_count; i = edit->next++) {
+		changed += edt_edit_chunk(edit, edit->chunks[i]);
+	}
+
+	edit->changed += changed;
+
+	return NULL;
+
+}
+
+// clamps the box to the world, false if nothing is left of it
+static bool edt_clamp(wld_world_t* world, edt_box_t* box, int16_t* min_y) {
+
+	const mat_dimension_t* dimension = mat_get_dimension_by_type(wld_get_environment(world));
+	*min_y = dimension->min_y;
+
+	edt_box_t clamped = {
+		.min_x = UTL_MIN(box->min_x, box->max_x),
+		.min_y = UTL_MAX(UTL_MIN(box->min_y, box->max_y), dimension->min_y),
+		.min_z = UTL_MIN(box->min_z, box->max_z),
+		.max_x = UTL_MAX(box->min_x, box->max_x),
+		.max_y = UTL_MIN(UTL_MAX(box->min_y, box->max_y), dimension->min_y + dimension->height - 1),
+		.max_z = UTL_MAX(box->min_z, box->max_z)
+	};
+	*box = clamped;
+
+	return box->min_y <= box->max_y;
+
+}
+
+static uint64_t edt_run(wld_world_t* world, edt_edit_t* edit) {
+
+	// chunks are found or generated up front, the threads only change blocks
+	const int32_t min_c_x = edit->box.min_x >> 4;
+	const int32_t min_c_z = edit->box.min_z >> 4;
+	const uint32_t chunks_x = (edit->box.max_x >> 4) - min_c_x + 1;
+	const uint32_t chunks_z = (edit->box.max_z >> 4) - min_c_z + 1;
+
+	edit->chunk_count = chunks_x * chunks_z;
+	edit->chunks = malloc(sizeof(wld_chunk_t*) * edit->chunk_count);
+	for (uint32_t x = 0; x < chunks_x; ++x) {
+		for (uint32_t z = 0; z < chunks_z; ++z) {
+			edit->chunks[x * chunks_z + z] = wld_get_chunk(world, min_c_x + x, min_c_z + z);
+		}
+	}
+
+	uint32_t threads = 1;
+	if (edt_get_volume(edit->box) >= EDT_THREAD_BLOCKS) {
+		threads = UTL_MIN(EDT_THREADS, edit->chunk_count);
+	}
+
+	pthread_t helpers[EDT_THREADS];
+	for (uint32_t i = 1; i < threads; ++i) {
+		pthread_create(&helpers[i], NULL, t_edt_run, edit);
+	}
+
+	t_edt_run(edit);
+
+	for (uint32_t i = 1; i < threads; ++i) {
+		pthread_join(helpers[i], NULL);
+	}
+
+	free(edit->chunks);
+
+	return edit->changed;
+
+}
+
+uint64_t edt_fill(wld_world_t* world, edt_box_t box, mat_block_protocol_id_t block) {
+
+	edt_edit_t edit = {
+		.operation = edt_fill_blocks,
+		.box = box,
+		.block = block
+	};
+
+	if (!edt_clamp(world, &edit.box, &edit.min_y)) {
+		return 0;
+	}
+
+	return edt_run(world, &edit);
+
+}
+
+uint64_t edt_replace(wld_world_t* world, edt_box_t box, edt_predicate_t predicate, void* data, mat_block_protocol_id_t block) {
+
+	edt_edit_t edit = {
+		.operation = edt_replace_blocks,
+		.box = box,
+		.block = block,
+		.predicate = predicate,
+		.data = data
+	};
+
+	if (!edt_clamp(world, &edit.box, &edit.min_y)) {
+		return 0;
+	}
+
+	return edt_run(world, &edit);
+
+}
+
+edt_clipboard_t* edt_copy(wld_world_t* world, edt_box_t box) {
+
+	edt_edit_t edit = {
+		.operation = edt_copy_blocks,
+		.box = box
+	};
+
+	if (!edt_clamp(world, &edit.box, &edit.min_y)) {
+		return NULL;
+	}
+
+	edit.clipboard = malloc(sizeof(edt_clipboard_t) + sizeof(mat_block_protocol_id_t) * edt_get_volume(edit.box));
+	edit.clipboard->size_x = edit.box.max_x - edit.box.min_x + 1;
+	edit.clipboard->size_y = edit.box.max_y - edit.box.min_y + 1;
+	edit.clipboard->size_z = edit.box.max_z - edit.box.min_z + 1;
+	edit.origin.x = edit.box.min_x;
+	edit.origin.y = edit.box.min_y;
+	edit.origin.z = edit.box.min_z;
+
+	edt_run(world, &edit);
+
+	return edit.clipboard;
+
+}
+
+uint64_t edt_paste(wld_world_t* world, const edt_clipboard_t* clipboard, int32_t x, int32_t y, int32_t z) {
+
+	edt_edit_t edit = {
+		.operation = edt_paste_blocks,
+		.box = {
+			.min_x = x,
+			.min_y = y,
+			.min_z = z,
+			.max_x = x + clipboard->size_x - 1,
+			.max_y = y + clipboard->size_y - 1,
+			.max_z = z + clipboard->size_z - 1
+		},
+		// only read from
+		.clipboard = (edt_clipboard_t*) clipboard,
+		.origin = { x, y, z }
+	};
+
+	if (!edt_clamp(world, &edit.box, &edit.min_y)) {
+		return 0;
+	}
+
+	return edt_run(world, &edit);
+
+}
+
+void edt_free_clipboard(edt_clipboard_t* clipboard) {
+	free(clipboard);
+}
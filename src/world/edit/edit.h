@@ -0,0 +1,76 @@
+#pragma once
+#include "../world.d.h"
+#include "../../main.h"
+#include "../material/material.h"
+
+/*
+	Bulk edits
+
+	Fill, replace and paste change whole boxes of blocks a section row at a time instead of going
+	through wld_set_block_at block by block. Counters are adjusted once per section and heightmaps
+	once per column, changes get sent with the rest at the end of the tick. Big edits are split by
+	chunk over a few threads.
+
+	Like setting blocks with physics off, edits don't cause block updates
+*/
+
+// threads a big edit runs on, the calling one included
+#define EDT_THREADS 4
+
+// edits smaller than this stay on the calling thread
+#define EDT_THREAD_BLOCKS 65536
+
+// both corners are included
+typedef struct {
+
+	int32_t min_x;
+	int32_t min_y;
+	int32_t min_z;
+
+	int32_t max_x;
+	int32_t max_y;
+	int32_t max_z;
+
+} edt_box_t;
+
+typedef bool (*edt_predicate_t) (mat_block_protocol_id_t block, void* data);
+
+typedef struct {
+
+	uint32_t size_x;
+	uint32_t size_y;
+	uint32_t size_z;
+
+	// y, z then x like sections
+	mat_block_protocol_id_t blocks[];
+
+} edt_clipboard_t;
+
+/*
+Set every block in the box
+Returns the number of blocks that changed
+*/
+extern uint64_t edt_fill(wld_world_t* world, edt_box_t box, mat_block_protocol_id_t block);
+
+/*
+Set the blocks in the box the predicate is true for
+Returns the number of blocks that changed
+*/
+extern uint64_t edt_replace(wld_world_t* world, edt_box_t box, edt_predicate_t predicate, void* data, mat_block_protocol_id_t block);
+
+/*
+Copy the blocks in the box, the clipboard has to be freed with edt_free_clipboard
+*/
+extern edt_clipboard_t* edt_copy(wld_world_t* world, edt_box_t box);
+
+/*
+Paste a clipboard with its lowest corner at x, y, z
+Returns the number of blocks that changed
+*/
+extern uint64_t edt_paste(wld_world_t* world, const edt_clipboard_t* clipboard, int32_t x, int32_t y, int32_t z);
+
+extern void edt_free_clipboard(edt_clipboard_t* clipboard);
+
+static inline uint64_t edt_get_volume(edt_box_t box) {
+	return (uint64_t) (box.max_x - box.min_x + 1) * (uint64_t) (box.max_y - box.min_y + 1) * (uint64_t) (box.max_z - box.min_z + 1);
+}
@@ -1,40 +1,50 @@
 #include "player.h"
 #include "../../../../jobs/scheduler/scheduler.h"
+#include "../../../fluids/fluids.h"
+#include "../../../world.h"
 
-uint16_t ent_player_get_break_speed(ent_player_t* player, mat_block_type_t block) {
+mat_tool_t ent_player_get_tool(ent_player_t* player) {
 
-	float32_t speed_multiplier = 1;
+	const mat_item_type_t item = ent_player_get_hotbar_slot(player, player->held_item)->type;
 
-	const mat_block_t* block_data = mat_get_block_by_type(block);
+	// slots can change under the same held item
+	if (!player->held_tool.valid || player->held_tool.item != item) {
+		player->held_tool.tool = mat_get_item_tool(item);
+		player->held_tool.item = item;
+		player->held_tool.valid = true;
+	}
 
-	itm_item_t* held = &player->hotbar[player->held_item];
-	const mat_item_t* held_data = mat_get_item_by_type(held->type);
+	return player->held_tool.tool;
 
-	const bool is_best_tool = ent_player_is_best_tool(block_data, held_data);
-	const bool can_harvest = ent_player_can_harvest(block_data, held_data);
-	
-	if (is_best_tool) {
-		// TODO speed_multiplier = tool_power;
-		if (!can_harvest) {
-			speed_multiplier = 1;
-		}
-		// TODO efficiency
-	}
+}
+
+float32_t ent_player_get_dig_multiplier(ent_player_t* player) {
 
-	float32_t damage = speed_multiplier / block_data->hardness;
+	ent_entity_t* entity = (ent_entity_t*) player;
 
-	if (can_harvest) {
-		damage /= 30;
-	} else {
-		damage /= 100;
+	float32_t multiplier = 1;
+
+	if (!ent_is_on_ground(entity)) {
+		multiplier *= 0.2;
 	}
 
-	// instant break
-	if (damage > 1) {
-		return 0;
+	const mat_dimension_t* dimension = mat_get_dimension_by_type(wld_get_environment(ent_get_world(entity)));
+	const int32_t eye_y = utl_int_floor(ent_get_y(entity) + (entity->crouching ? 1.27 : 1.62));
+
+	if (eye_y >= dimension->min_y && eye_y < dimension->min_y + dimension->height) {
+		const fld_fluid_t fluid = fld_get_fluid(wld_get_block_at(ent_get_chunk(entity), ent_get_block_x(entity), eye_y, ent_get_block_z(entity)));
+		if (fluid.block == mat_block_water) {
+			multiplier *= 0.2;
+		}
 	}
 
-	return utl_int_ceil(1 / damage);
+	return multiplier;
+
+}
+
+uint16_t ent_player_get_break_speed(ent_player_t* player, mat_block_type_t block) {
+
+	return mat_get_dig_ticks(block, ent_player_get_tool(player), ent_player_get_dig_multiplier(player));
 
 }
 
@@ -44,6 +54,8 @@ void ent_free_player(ent_player_t* entity) {
 		sch_cancel(entity->digging);
 	}
 
+	inv_term_window(&entity->window);
+
 	ent_free_entity((ent_entity_t*) entity);
 
 }
\ No newline at end of file
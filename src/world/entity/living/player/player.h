@@ -5,6 +5,7 @@
 #include "../../../../main.h"
 #include "../../../../jobs/scheduler/scheduler.h"
 #include "../living.h"
+#include "../../../item/inventory/inventory.h"
 
 struct ent_player {
 
@@ -30,14 +31,17 @@ struct ent_player {
 
 	bool digging_block : 1;
 
-	itm_item_t inventory[27];
-	itm_item_t hotbar[9];
-	itm_item_t carried;
-
+	// tool in the main hand, worked out again when the held item changes
 	struct {
-		itm_item_t* elements[90];
-		uint8_t count;
-	} paint;
+		mat_tool_t tool;
+		mat_item_type_t item : 11;
+		bool valid : 1;
+	} held_tool;
+
+	// crafting, armor, main inventory, hotbar and off hand in the order of the player window
+	itm_item_t slots[INV_PLAYER_SLOTS];
+	itm_item_t remote_slots[INV_PLAYER_SLOTS];
+	inv_window_t window;
 
 	// for parrots
 	ent_living_entity_t* left_shoulder;
@@ -58,6 +62,7 @@ static inline ent_player_t* ent_alloc_player(const byte_t* uuid, wld_world_t* wo
 	player->living_entity.entity.position.x = x;
 	player->living_entity.entity.position.y = y;
 	player->living_entity.entity.position.z = z;
+	inv_init_window(&player->window, inv_window_player, 0, player->slots, player->remote_slots);
 
 	return player;
 
@@ -71,60 +76,40 @@ static inline ent_entity_t* ent_player_get_entity(ent_player_t* player) {
 	return &player->living_entity.entity;
 }
 
+static inline inv_window_t* ent_player_get_window(ent_player_t* player) {
+	return &player->window;
+}
+
+static inline itm_item_t* ent_player_get_hotbar_slot(ent_player_t* player, uint8_t idx) {
+	return &player->slots[INV_PLAYER_HOTBAR + idx];
+}
+
 static inline ent_gamemode_t ent_player_get_gamemode(const ent_player_t* player) {
 	return player->gamemode;
 }
 
 // player specific functions
-static inline bool ent_player_is_best_tool(const mat_block_t* block, const mat_item_t* item) {
-
-	if (block->mineable) {
-
-		if (item->tool) {
-
-			if (
-				(block->mineable_axe && item->tool_axe) ||
-				(block->mineable_hoe && item->tool_hoe) ||
-				(block->mineable_pickaxe && item->tool_pickaxe) ||
-				(block->mineable_shovel && item->tool_shovel)
-			) {
-				return true;
-			}
-
-		}
-
-		return false;
-	}
-
-	return true;
-
+static inline bool ent_player_is_best_tool(mat_block_type_t block, mat_item_type_t item) {
+	return !mat_block_has_tag(block, mat_block_tag_mineable) || mat_is_best_tool(block, mat_get_item_tool(item));
 }
 
-static inline bool ent_player_can_harvest(const mat_block_t* block, const mat_item_t* item) {
-
-	if (block->needs) {
-
-		if (item->tool) {
-
-			if (
-				(block->needs_wooden_tool && item->least_wooden_tool) ||
-				(block->needs_stone_tool && item->least_stone_tool) ||
-				(block->needs_iron_tool && item->least_iron_tool) ||
-				(block->needs_diamond_tool && item->least_diamond_tool)
-			) {
-				return true;
-			}
-
-		}
-
-		return false;
+static inline bool ent_player_can_harvest(mat_block_type_t block, mat_item_type_t item) {
+	return mat_can_harvest(block, mat_get_item_tool(item));
+}
 
-	}
+/*
+Tool the player is holding, cached until the held item changes
+*/
+extern mat_tool_t ent_player_get_tool(ent_player_t* player);
 
-	return true;
-
-}
+/*
+Dig speed multiplier of what isn't the tool, in the air or with the eyes underwater
+*/
+extern float32_t ent_player_get_dig_multiplier(ent_player_t* player);
 
+/*
+Ticks it takes the player to break a block
+*/
 extern uint16_t ent_player_get_break_speed(ent_player_t* player, mat_block_type_t block);
 
 static inline bool ent_player_is_digging_block(ent_player_t* player) {
@@ -182,6 +167,7 @@ static inline void ent_player_set_main_hand(ent_player_t* player, byte_t main_ha
 static inline void ent_player_set_held_item(ent_player_t* player, uint16_t held_item) {
 
 	player->held_item = held_item;
+	player->held_tool.valid = false;
 
 }
 
@@ -201,36 +187,26 @@ static inline uint8_t ent_player_get_food(ent_player_t* player) {
 	return player->food;
 }
 
+/*
+Write the state id and every slot of the player window, counting them as sent
+*/
 static inline void ent_player_serialize_inventory(ent_player_t* player, pck_packet_t* packet) {
-	
-	with_lock (&player->living_entity.entity.lock) {
-		// crafting slots
-		pck_write_int8(packet, false);
-		pck_write_int8(packet, false);
-		pck_write_int8(packet, false);
-		pck_write_int8(packet, false);
-		pck_write_int8(packet, false);
-
-		// armor
-		for (uint8_t i = 0; i < 4; ++i) {
-			itm_serialize(packet, &player->living_entity.armor[i]);
-		}
 
-		// inventory
-		for (uint8_t i = 0; i < 27; ++i) {
-			itm_serialize(packet, &player->inventory[i]);
-		}
+	inv_window_t* window = &player->window;
 
-		// hotbar
-		for (uint8_t i = 0; i < 9; ++i) {
-			itm_serialize(packet, &player->hotbar[i]);
+	with_lock (&window->lock) {
+
+		pck_write_var_int(packet, window->state_id);
+
+		pck_write_var_int(packet, INV_PLAYER_SLOTS);
+		for (uint8_t i = 0; i < INV_PLAYER_SLOTS; ++i) {
+			itm_serialize(packet, &player->slots[i]);
 		}
 
-		// offhand
-		itm_serialize(packet, &player->living_entity.off_hand);
+		itm_serialize(packet, &window->carried);
+
+		inv_set_sent(window);
 
-		// carried
-		itm_serialize(packet, &player->carried);
 	}
 
 }
@@ -0,0 +1,417 @@
+#include <stdlib.h>
+#include "fluids.h"
+#include "../world.h"
+#include "../updates/updates.h"
+
+// how a fluid flows in a world
+typedef struct {
+
+	mat_block_type_t block : 16;
+
+	uint8_t drop_off;
+	uint8_t slope_distance;
+
+	uint16_t delay;
+
+} fld_flow_t;
+
+// no shape can be further away
+#define FLD_NO_SLOPE 1000
+
+static const struct {
+
+	int8_t x;
+	int8_t z;
+
+} fld_directions[4] = {
+	{ 0, -1 }, // north
+	{ 0, 1 }, // south
+	{ -1, 0 }, // west
+	{ 1, 0 } // east
+};
+
+static inline uint8_t fld_opposite(uint8_t direction) {
+	return direction ^ 1;
+}
+
+static inline fld_flow_t fld_get_flow(wld_chunk_t* chunk, mat_block_type_t block) {
+
+	if (block == mat_block_lava) {
+
+		if (mat_get_dimension_by_type(wld_get_environment(wld_chunk_get_world(chunk)))->ultrawarm) {
+			return (fld_flow_t) { .block = mat_block_lava, .drop_off = 1, .slope_distance = 4, .delay = FLD_LAVA_ULTRAWARM_DELAY };
+		}
+
+		return (fld_flow_t) { .block = mat_block_lava, .drop_off = 2, .slope_distance = 2, .delay = FLD_LAVA_DELAY };
+
+	}
+
+	return (fld_flow_t) { .block = mat_block_water, .drop_off = 1, .slope_distance = 4, .delay = FLD_WATER_DELAY };
+
+}
+
+static inline bool fld_has_waterlogged(mat_block_type_t block) {
+
+	const mat_block_t* data = mat_get_block_by_type(block);
+
+	for (uint8_t i = 0; i < data->modifiers_count; ++i) {
+		if (data->modifiers[i] == mat_state_modifier_waterlogged) {
+			return true;
+		}
+	}
+
+	return false;
+
+}
+
+fld_fluid_t fld_get_fluid(mat_block_protocol_id_t block) {
+
+	const mat_block_type_t type = mat_get_block_type_by_protocol_id(block);
+
+	if (type == mat_block_water || type == mat_block_lava) {
+		return (fld_fluid_t) { .block = type, .level = block - mat_get_block_base_protocol_id_by_type(type) };
+	}
+
+	// vanilla lists true before false
+	if (fld_has_waterlogged(type) && mat_get_block_state_value(block, mat_state_modifier_waterlogged) == 0) {
+		return (fld_fluid_t) { .block = mat_block_water, .level = 0 };
+	}
+
+	return (fld_fluid_t) { .block = mat_block_air, .level = 0 };
+
+}
+
+// read a block, false if it isn't loaded or out of the world
+static inline bool fld_get_block(wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z, mat_block_protocol_id_t* block) {
+
+	const mat_dimension_type_t environment = wld_get_environment(wld_chunk_get_world(chunk));
+	const int16_t min_y = mat_get_dimension_by_type(environment)->min_y;
+
+	if (y < min_y || ((y - min_y) >> 4) >= mat_get_chunk_height(environment)) {
+		return false;
+	}
+
+	wld_chunk_t* block_chunk = wld_find_relative_chunk(chunk, (x >> 4) - wld_get_chunk_x(chunk), (z >> 4) - wld_get_chunk_z(chunk));
+	if (block_chunk == NULL) {
+		return false;
+	}
+
+	*block = wld_chunk_get_section(block_chunk, (y - min_y) >> 4)->blocks[((y & 0xF) << 8) | ((z & 0xF) << 4) | (x & 0xF)];
+
+	return true;
+
+}
+
+// fluid can be in the block, air, fluids and plants that get washed away
+static inline bool fld_can_hold(mat_block_protocol_id_t block) {
+
+	const mat_block_type_t type = mat_get_block_type_by_protocol_id(block);
+	const mat_block_t* data = mat_get_block_by_type(type);
+
+	return data->air || type == mat_block_water || type == mat_block_lava || data->replaceable_plants;
+
+}
+
+static inline bool fld_can_spread_to(mat_block_protocol_id_t block, bool down, const fld_flow_t* flow) {
+
+	const fld_fluid_t fluid = fld_get_fluid(block);
+
+	switch (fluid.block) {
+		case mat_block_air:
+			return fld_can_hold(block);
+		case mat_block_water:
+			// only lava falling into it
+			return down && flow->block != mat_block_water;
+		default:
+			// water takes over lava that is high enough
+			return flow->block == mat_block_water && fld_get_amount(fluid) >= 4;
+	}
+
+}
+
+// the fluid can flow down at a block below
+static inline bool fld_is_hole(wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z, const fld_flow_t* flow) {
+
+	mat_block_protocol_id_t block;
+	if (!fld_get_block(chunk, x, y, z, &block)) {
+		return false;
+	}
+
+	return fld_get_fluid(block).block == flow->block || fld_can_hold(block);
+
+}
+
+// fluid can flow through a block while looking for holes
+static inline bool fld_can_pass(mat_block_protocol_id_t block, const fld_flow_t* flow) {
+
+	const fld_fluid_t fluid = fld_get_fluid(block);
+
+	return !(fluid.block == flow->block && fld_is_source(fluid)) && fld_can_hold(block);
+
+}
+
+// the fluid schedules its own tick once it's placed
+static inline void fld_set_fluid(wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z, fld_fluid_t fluid) {
+	wld_set_block_at(chunk, x, y, z, mat_get_block_base_protocol_id_by_type(fluid.block) + fluid.level);
+}
+
+// lava next to water hardens, true if it did
+static bool fld_harden_lava(wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z, fld_fluid_t lava) {
+
+	mat_block_protocol_id_t block;
+	bool water = fld_get_block(chunk, x, y + 1, z, &block) && fld_get_fluid(block).block == mat_block_water;
+
+	for (uint8_t i = 0; i < 4 && !water; ++i) {
+		water = fld_get_block(chunk, x + fld_directions[i].x, y, z + fld_directions[i].z, &block) && fld_get_fluid(block).block == mat_block_water;
+	}
+
+	if (!water) {
+		return false;
+	}
+
+	wld_set_block_at(chunk, x, y, z, mat_get_block_default_protocol_id_by_type(fld_is_source(lava) ? mat_block_obsidian : mat_block_cobblestone));
+
+	return true;
+
+}
+
+static uint8_t fld_count_sources(wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z, const fld_flow_t* flow) {
+
+	uint8_t sources = 0;
+
+	for (uint8_t i = 0; i < 4; ++i) {
+		mat_block_protocol_id_t block;
+		if (fld_get_block(chunk, x + fld_directions[i].x, y, z + fld_directions[i].z, &block)) {
+			const fld_fluid_t fluid = fld_get_fluid(block);
+			sources += fluid.block == flow->block && fld_is_source(fluid);
+		}
+	}
+
+	return sources;
+
+}
+
+// what the fluid at a block should be given its neighbors
+static fld_fluid_t fld_get_new_fluid(wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z, const fld_flow_t* flow) {
+
+	uint8_t max_amount = 0;
+	uint8_t sources = 0;
+
+	for (uint8_t i = 0; i < 4; ++i) {
+		mat_block_protocol_id_t block;
+		if (fld_get_block(chunk, x + fld_directions[i].x, y, z + fld_directions[i].z, &block)) {
+			const fld_fluid_t fluid = fld_get_fluid(block);
+			if (fluid.block == flow->block) {
+				sources += fld_is_source(fluid);
+				max_amount = UTL_MAX(max_amount, fld_get_amount(fluid));
+			}
+		}
+	}
+
+	mat_block_protocol_id_t block;
+
+	// water between two sources becomes one if it has something to stand on
+	if (flow->block == mat_block_water && sources >= 2 && fld_get_block(chunk, x, y - 1, z, &block)) {
+		const fld_fluid_t below = fld_get_fluid(block);
+		if (!fld_can_hold(block) || (below.block == mat_block_water && fld_is_source(below))) {
+			return (fld_fluid_t) { .block = flow->block, .level = 0 };
+		}
+	}
+
+	if (fld_get_block(chunk, x, y + 1, z, &block) && fld_get_fluid(block).block == flow->block) {
+		return (fld_fluid_t) { .block = flow->block, .level = 8 };
+	}
+
+	if (max_amount <= flow->drop_off) {
+		return (fld_fluid_t) { .block = mat_block_air, .level = 0 };
+	}
+
+	return (fld_fluid_t) { .block = flow->block, .level = 8 - (max_amount - flow->drop_off) };
+
+}
+
+// distance to the closest hole, not going back the way it came
+static uint16_t fld_get_slope_distance(wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z, uint8_t depth, uint8_t from, const fld_flow_t* flow) {
+
+	uint16_t distance = FLD_NO_SLOPE;
+
+	for (uint8_t i = 0; i < 4; ++i) {
+
+		if (i == from) {
+			continue;
+		}
+
+		const int32_t n_x = x + fld_directions[i].x;
+		const int32_t n_z = z + fld_directions[i].z;
+
+		mat_block_protocol_id_t block;
+		if (!fld_get_block(chunk, n_x, y, n_z, &block) || !fld_can_pass(block, flow)) {
+			continue;
+		}
+
+		if (fld_is_hole(chunk, n_x, y - 1, n_z, flow)) {
+			return depth;
+		}
+
+		if (depth < flow->slope_distance) {
+			distance = UTL_MIN(distance, fld_get_slope_distance(chunk, n_x, y, n_z, depth + 1, fld_opposite(i), flow));
+		}
+
+	}
+
+	return distance;
+
+}
+
+static void fld_spread_to(wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z, mat_block_protocol_id_t block, bool down, fld_fluid_t fluid, const fld_flow_t* flow) {
+
+	// lava falling into water
+	if (down && flow->block == mat_block_lava && fld_get_fluid(block).block == mat_block_water) {
+		wld_set_block_at(chunk, x, y, z, mat_get_block_default_protocol_id_by_type(mat_block_stone));
+		return;
+	}
+
+	fld_set_fluid(chunk, x, y, z, fluid);
+
+}
+
+static void fld_spread_to_sides(wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z, fld_fluid_t fluid, const fld_flow_t* flow) {
+
+	if (!fld_is_falling(fluid) && fld_get_amount(fluid) <= flow->drop_off) {
+		return;
+	}
+
+	// only flow towards the closest holes
+	uint16_t min_distance = FLD_NO_SLOPE;
+	mat_block_protocol_id_t blocks[4];
+	fld_fluid_t spreads[4];
+	bool spread[4] = { false, false, false, false };
+
+	for (uint8_t i = 0; i < 4; ++i) {
+
+		const int32_t n_x = x + fld_directions[i].x;
+		const int32_t n_z = z + fld_directions[i].z;
+
+		if (!fld_get_block(chunk, n_x, y, n_z, &blocks[i]) || !fld_can_pass(blocks[i], flow)) {
+			continue;
+		}
+
+		const uint16_t distance = fld_is_hole(chunk, n_x, y - 1, n_z, flow) ? 0 : fld_get_slope_distance(chunk, n_x, y, n_z, 1, fld_opposite(i), flow);
+
+		if (distance < min_distance) {
+			min_distance = distance;
+			for (uint8_t j = 0; j < i; ++j) {
+				spread[j] = false;
+			}
+		}
+
+		if (distance <= min_distance && fld_can_spread_to(blocks[i], false, flow)) {
+			spreads[i] = fld_get_new_fluid(chunk, n_x, y, n_z, flow);
+			spread[i] = spreads[i].block != mat_block_air;
+		}
+
+	}
+
+	for (uint8_t i = 0; i < 4; ++i) {
+		if (spread[i]) {
+			fld_spread_to(chunk, x + fld_directions[i].x, y, z + fld_directions[i].z, blocks[i], false, spreads[i], flow);
+		}
+	}
+
+}
+
+static void fld_spread(wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z, fld_fluid_t fluid, const fld_flow_t* flow) {
+
+	mat_block_protocol_id_t below;
+	if (fld_get_block(chunk, x, y - 1, z, &below) && fld_can_spread_to(below, true, flow)) {
+
+		fld_spread_to(chunk, x, y - 1, z, below, true, fld_get_new_fluid(chunk, x, y - 1, z, flow), flow);
+
+		// sources keep spreading around while falling
+		if (fld_count_sources(chunk, x, y, z, flow) >= 3) {
+			fld_spread_to_sides(chunk, x, y, z, fluid, flow);
+		}
+
+		return;
+
+	}
+
+	if (fld_is_source(fluid) || !fld_is_hole(chunk, x, y - 1, z, flow)) {
+		fld_spread_to_sides(chunk, x, y, z, fluid, flow);
+	}
+
+}
+
+// harden lava touching water, or have the fluid flow in a bit
+static void fld_placed(wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z) {
+
+	mat_block_protocol_id_t block;
+	if (!fld_get_block(chunk, x, y, z, &block)) {
+		return;
+	}
+
+	const fld_fluid_t fluid = fld_get_fluid(block);
+
+	if (fluid.block == mat_block_air || (fluid.block == mat_block_lava && fld_harden_lava(chunk, x, y, z, fluid))) {
+		return;
+	}
+
+	upd_schedule_tick(chunk, x, y, z, mat_get_block_type_by_protocol_id(block), fld_get_flow(chunk, fluid.block).delay, upd_priority_normal);
+
+}
+
+static void fld_neighbor_update(wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z, __attribute__((unused)) mat_block_type_t source) {
+	fld_placed(chunk, x, y, z);
+}
+
+static void fld_scheduled_tick(wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z) {
+
+	mat_block_protocol_id_t block;
+	if (!fld_get_block(chunk, x, y, z, &block)) {
+		return;
+	}
+
+	fld_fluid_t fluid = fld_get_fluid(block);
+
+	if (fluid.block == mat_block_air || (fluid.block == mat_block_lava && fld_harden_lava(chunk, x, y, z, fluid))) {
+		return;
+	}
+
+	const fld_flow_t flow = fld_get_flow(chunk, fluid.block);
+
+	if (!fld_is_source(fluid)) {
+
+		const fld_fluid_t new_fluid = fld_get_new_fluid(chunk, x, y, z, &flow);
+
+		if (new_fluid.block == mat_block_air) {
+			wld_set_block_at(chunk, x, y, z, mat_get_block_default_protocol_id_by_type(mat_block_air));
+			return;
+		}
+
+		// all falling levels are the same
+		if (UTL_MIN(new_fluid.level, 8) != UTL_MIN(fluid.level, 8)) {
+			fld_set_fluid(chunk, x, y, z, new_fluid);
+			fluid = new_fluid;
+		}
+
+	}
+
+	fld_spread(chunk, x, y, z, fluid, &flow);
+
+}
+
+static const upd_behavior_t fld_behavior = {
+	.placed = fld_placed,
+	.neighbor_update = fld_neighbor_update,
+	.scheduled_tick = fld_scheduled_tick
+};
+
+void fld_init() {
+
+	for (uint32_t block = 0; block < mat_block_count; ++block) {
+		if (block == mat_block_water || block == mat_block_lava || fld_has_waterlogged(block)) {
+			upd_set_behavior(block, &fld_behavior);
+		}
+	}
+
+}
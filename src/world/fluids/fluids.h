@@ -0,0 +1,57 @@
+#pragma once
+#include "../world.d.h"
+#include "../../main.h"
+#include "../material/material.h"
+
+/*
+	Fluids
+
+	Water and lava flow through the block update scheduler. A fluid block only gets a tick when
+	one of its neighbors changes, so still fluid costs nothing and the scheduled ticks of a region
+	are exactly the fluid that is still moving. Flowing follows vanilla, including the search for
+	the closest hole within a few blocks.
+*/
+
+// ticks between flow steps
+#define FLD_WATER_DELAY 5
+#define FLD_LAVA_DELAY 30
+#define FLD_LAVA_ULTRAWARM_DELAY 10
+
+typedef struct {
+
+	// mat_block_water, mat_block_lava or mat_block_air for no fluid
+	mat_block_type_t block : 16;
+
+	// 0 for sources, 1 to 7 for flowing fluid and 8 or more for falling fluid
+	uint8_t level;
+
+} fld_fluid_t;
+
+/*
+Make water and lava flow, plugins can override the behaviors afterwards
+*/
+extern void fld_init();
+
+/*
+Fluid in a block, waterlogged blocks hold a water source
+*/
+extern fld_fluid_t fld_get_fluid(mat_block_protocol_id_t block);
+
+static inline bool fld_is_source(fld_fluid_t fluid) {
+	return fluid.block != mat_block_air && fluid.level == 0;
+}
+
+static inline bool fld_is_falling(fld_fluid_t fluid) {
+	return fluid.level >= 8;
+}
+
+// 8 for sources and falling fluid, less the further fluid flowed
+static inline uint8_t fld_get_amount(fld_fluid_t fluid) {
+
+	if (fluid.block == mat_block_air) {
+		return 0;
+	}
+
+	return fluid.level == 0 || fluid.level >= 8 ? 8 : 8 - fluid.level;
+
+}
@@ -0,0 +1,513 @@
+#include "inventory.h"
+#include "../../../util/str_util.h"
+#include "../recipe/recipe.h"
+#include "../../../util/util.h"
+
+_Static_assert(INV_MAX_SLOTS <= 64, "dragged over slots are kept in one word");
+
+enum {
+
+	inv_player_result,
+	inv_player_grid,
+	inv_player_armor,
+	inv_player_main,
+	inv_player_hotbar,
+	inv_player_off_hand
+
+};
+
+const inv_layout_t inv_layouts[inv_window_count] = {
+	[inv_window_player] = {
+		.size = INV_PLAYER_SLOTS,
+		.hotbar = INV_PLAYER_HOTBAR,
+		.off_hand = INV_PLAYER_OFF_HAND,
+		.grid = INV_PLAYER_GRID,
+		.grid_size = 2,
+		.result = INV_PLAYER_RESULT,
+		.range_count = 6,
+		.ranges = {
+			[inv_player_result] = { INV_PLAYER_RESULT, INV_PLAYER_GRID, INV_TAKE | INV_RESULT, 64, 2, { inv_player_hotbar, inv_player_main } },
+			[inv_player_grid] = { INV_PLAYER_GRID, INV_PLAYER_ARMOR, INV_TAKE | INV_PLACE, 64, 2, { inv_player_main, inv_player_hotbar } },
+			// items don't say which armor slot they go in, so they can only be taken out
+			[inv_player_armor] = { INV_PLAYER_ARMOR, INV_PLAYER_MAIN, INV_TAKE, 1, 2, { inv_player_main, inv_player_hotbar } },
+			[inv_player_main] = { INV_PLAYER_MAIN, INV_PLAYER_HOTBAR, INV_TAKE | INV_PLACE, 64, 1, { inv_player_hotbar } },
+			[inv_player_hotbar] = { INV_PLAYER_HOTBAR, INV_PLAYER_OFF_HAND, INV_TAKE | INV_PLACE, 64, 1, { inv_player_main } },
+			[inv_player_off_hand] = { INV_PLAYER_OFF_HAND, INV_PLAYER_SLOTS, INV_TAKE | INV_PLACE, 64, 2, { inv_player_main, inv_player_hotbar } }
+		},
+		.slot_ranges = {
+			[INV_PLAYER_RESULT] = inv_player_result,
+			[INV_PLAYER_GRID ... INV_PLAYER_ARMOR - 1] = inv_player_grid,
+			[INV_PLAYER_ARMOR ... INV_PLAYER_MAIN - 1] = inv_player_armor,
+			[INV_PLAYER_MAIN ... INV_PLAYER_HOTBAR - 1] = inv_player_main,
+			[INV_PLAYER_HOTBAR ... INV_PLAYER_OFF_HAND - 1] = inv_player_hotbar,
+			[INV_PLAYER_OFF_HAND] = inv_player_off_hand
+		}
+	}
+};
+
+static inline bool inv_is_empty(const itm_item_t* item) {
+	return item->type == mat_item_air || item->count == 0;
+}
+
+static inline bool inv_is_same(const itm_item_t* a, const itm_item_t* b) {
+
+	if (inv_is_empty(a) || inv_is_empty(b)) {
+		return inv_is_empty(a) && inv_is_empty(b);
+	}
+
+	return a->type == b->type && a->count == b->count;
+
+}
+
+// room for the item in the range, in similar stacks and empty slots
+static inline uint32_t inv_get_room(const inv_window_t* window, const itm_item_t* item, const inv_range_t* range) {
+
+	if (!(range->flags & INV_PLACE)) {
+		return 0;
+	}
+
+	uint32_t room = 0;
+	for (uint8_t i = range->begin; i < range->end; ++i) {
+		itm_item_t* slot = &window->slots[i];
+		if (inv_is_empty(slot)) {
+			room += range->max_count;
+		} else if (itm_is_similar(slot, (itm_item_t*) item) && slot->count < range->max_count) {
+			room += range->max_count - slot->count;
+		}
+	}
+
+	return room;
+
+}
+
+// as much of the item as fits goes into similar stacks first, then into empty slots
+static void inv_move_to_range(inv_window_t* window, itm_item_t* item, const inv_range_t* range) {
+
+	if (!(range->flags & INV_PLACE)) {
+		return;
+	}
+
+	for (uint8_t i = range->begin; i < range->end && !inv_is_empty(item); ++i) {
+		itm_item_t* slot = &window->slots[i];
+		if (!inv_is_empty(slot) && itm_is_similar(slot, item) && slot->count < range->max_count) {
+			const uint8_t moved = UTL_MIN(item->count, range->max_count - slot->count);
+			itm_set_count(slot, slot->count + moved);
+			itm_set_count(item, item->count - moved);
+		}
+	}
+
+	for (uint8_t i = range->begin; i < range->end && !inv_is_empty(item); ++i) {
+		itm_item_t* slot = &window->slots[i];
+		if (inv_is_empty(slot)) {
+			const uint8_t moved = UTL_MIN(item->count, range->max_count);
+			*slot = *item;
+			itm_set_count(slot, moved);
+			itm_set_count(item, item->count - moved);
+		}
+	}
+
+}
+
+void inv_update_crafting(inv_window_t* window) {
+
+	const inv_layout_t* layout = window->layout;
+
+	if (layout->grid_size == 0) {
+		return;
+	}
+
+	const rec_recipe_t* recipe = rec_match_crafting(&window->slots[layout->grid], layout->grid_size);
+
+	window->slots[layout->result] = recipe == NULL ? itm_new : rec_get_crafting_result(recipe);
+
+}
+
+// takes the whole result into `into` and uses up the grid, false if it doesn't fit
+static bool inv_craft(inv_window_t* window, itm_item_t* into) {
+
+	const inv_layout_t* layout = window->layout;
+	const itm_item_t result = window->slots[layout->result];
+
+	if (inv_is_empty(&result)) {
+		return false;
+	}
+
+	if (inv_is_empty(into)) {
+		*into = result;
+	} else if (itm_is_similar(into, (itm_item_t*) &result) && into->count + result.count <= 64) {
+		itm_set_count(into, into->count + result.count);
+	} else {
+		return false;
+	}
+
+	for (uint8_t i = 0; i < layout->grid_size * layout->grid_size; ++i) {
+		itm_item_t* ingredient = &window->slots[layout->grid + i];
+		if (!inv_is_empty(ingredient)) {
+			itm_set_count(ingredient, ingredient->count - 1);
+		}
+	}
+
+	inv_update_crafting(window);
+
+	return true;
+
+}
+
+static void inv_click_slot(inv_window_t* window, uint8_t slot, bool right) {
+
+	const inv_range_t* range = inv_get_range(window, slot);
+	itm_item_t* item = &window->slots[slot];
+	itm_item_t* carried = &window->carried;
+
+	if (range->flags & INV_RESULT) {
+		inv_craft(window, carried);
+		return;
+	}
+
+	if (inv_is_empty(carried)) {
+		if (!inv_is_empty(item) && (range->flags & INV_TAKE)) {
+			// right clicks take the bigger half
+			const uint8_t taken = right ? (item->count + 1) >> 1 : item->count;
+			*carried = *item;
+			itm_set_count(carried, taken);
+			itm_set_count(item, item->count - taken);
+		}
+		return;
+	}
+
+	if (!(range->flags & INV_PLACE)) {
+		return;
+	}
+
+	if (inv_is_empty(item)) {
+		const uint8_t placed = right ? 1 : UTL_MIN(carried->count, range->max_count);
+		*item = *carried;
+		itm_set_count(item, placed);
+		itm_set_count(carried, carried->count - placed);
+	} else if (itm_is_similar(item, carried)) {
+		if (item->count < range->max_count) {
+			const uint8_t placed = UTL_MIN(right ? 1 : carried->count, range->max_count - item->count);
+			itm_set_count(item, item->count + placed);
+			itm_set_count(carried, carried->count - placed);
+		}
+	} else if ((range->flags & INV_TAKE) && carried->count <= range->max_count) {
+		const itm_item_t swapped = *item;
+		*item = *carried;
+		*carried = swapped;
+	}
+
+}
+
+static void inv_shift_click_slot(inv_window_t* window, uint8_t slot) {
+
+	const inv_layout_t* layout = window->layout;
+	const inv_range_t* range = inv_get_range(window, slot);
+
+	if (!(range->flags & INV_TAKE) || inv_is_empty(&window->slots[slot])) {
+		return;
+	}
+
+	if (range->flags & INV_RESULT) {
+		// craft for as long as the whole result fits
+		for (uint32_t i = 0; i < 64 && !inv_is_empty(&window->slots[slot]); ++i) {
+
+			itm_item_t result = window->slots[slot];
+
+			uint32_t room = 0;
+			for (uint8_t j = 0; j < range->target_count; ++j) {
+				room += inv_get_room(window, &result, &layout->ranges[range->targets[j]]);
+			}
+			if (room < result.count) {
+				break;
+			}
+
+			itm_item_t crafted = itm_new;
+			inv_craft(window, &crafted);
+			for (uint8_t j = 0; j < range->target_count; ++j) {
+				inv_move_to_range(window, &crafted, &layout->ranges[range->targets[j]]);
+			}
+
+		}
+		return;
+	}
+
+	itm_item_t item = window->slots[slot];
+	for (uint8_t i = 0; i < range->target_count; ++i) {
+		inv_move_to_range(window, &item, &layout->ranges[range->targets[i]]);
+	}
+	window->slots[slot] = item;
+
+}
+
+static bool inv_swap_slot(inv_window_t* window, uint8_t slot, int8_t button) {
+
+	const inv_layout_t* layout = window->layout;
+
+	uint8_t target;
+	if (button >= 0 && button < 9) {
+		target = layout->hotbar + button;
+	} else if (button == 40 && layout->off_hand != UINT8_MAX) {
+		target = layout->off_hand;
+	} else {
+		return false;
+	}
+
+	if (slot == target) {
+		return true;
+	}
+
+	const inv_range_t* range = inv_get_range(window, slot);
+	itm_item_t* item = &window->slots[slot];
+	itm_item_t* swapped = &window->slots[target];
+
+	if (range->flags & INV_RESULT) {
+		inv_craft(window, swapped);
+		return true;
+	}
+
+	if (!inv_is_empty(item) && !(range->flags & INV_TAKE)) {
+		return true;
+	}
+	if (!inv_is_empty(swapped) && (!(range->flags & INV_PLACE) || swapped->count > range->max_count)) {
+		return true;
+	}
+
+	const itm_item_t temp = *item;
+	*item = *swapped;
+	*swapped = temp;
+
+	return true;
+
+}
+
+static bool inv_drop_slot(inv_window_t* window, uint8_t slot, int8_t button) {
+
+	const inv_range_t* range = inv_get_range(window, slot);
+	itm_item_t* item = &window->slots[slot];
+
+	if (button != 0 && button != 1) {
+		return false;
+	}
+
+	// TODO spawn the dropped items once there are item entities
+	if (range->flags & INV_RESULT) {
+		for (uint32_t i = 0; i < (button == 1 ? 64 : 1); ++i) {
+			itm_item_t dropped = itm_new;
+			if (!inv_craft(window, &dropped)) {
+				break;
+			}
+		}
+	} else if ((range->flags & INV_TAKE) && !inv_is_empty(item)) {
+		itm_set_count(item, button == 1 ? 0 : item->count - 1);
+	}
+
+	return true;
+
+}
+
+static bool inv_drag(inv_window_t* window, int16_t slot, int8_t button, bool creative) {
+
+	const uint8_t stage = button & 0x3;
+	const uint8_t kind = button >> 2;
+
+	if (button < 0 || kind > 2 || stage == 3) {
+		return false;
+	}
+
+	itm_item_t* carried = &window->carried;
+
+	switch (stage) {
+		case 0: { // start
+			window->drag.active = !inv_is_empty(carried) && (kind != 2 || creative);
+			window->drag.kind = kind;
+			window->drag.count = 0;
+			window->drag.added = 0;
+		} break;
+		case 1: { // add a slot
+			if (!window->drag.active || window->drag.kind != kind) {
+				window->drag.active = false;
+				break;
+			}
+			if (slot < 0 || (window->drag.added >> slot) & 1) {
+				break;
+			}
+
+			const inv_range_t* range = inv_get_range(window, slot);
+			const itm_item_t* item = &window->slots[slot];
+
+			if ((range->flags & (INV_PLACE | INV_RESULT)) != INV_PLACE) {
+				break;
+			}
+			if (!inv_is_empty(item) && !itm_is_similar((itm_item_t*) item, carried)) {
+				break;
+			}
+			if (kind != 2 && window->drag.count >= carried->count) {
+				break;
+			}
+
+			window->drag.added |= (uint64_t) 1 << slot;
+			window->drag.slots[window->drag.count++] = slot;
+		} break;
+		case 2: { // end
+			if (!window->drag.active || window->drag.kind != kind || window->drag.count == 0) {
+				window->drag.active = false;
+				break;
+			}
+
+			const itm_item_t stack = *carried;
+			const uint8_t per_slot = kind == 0 ? stack.count / window->drag.count : 1;
+
+			for (uint8_t i = 0; i < window->drag.count; ++i) {
+
+				const inv_range_t* range = inv_get_range(window, window->drag.slots[i]);
+				itm_item_t* item = &window->slots[window->drag.slots[i]];
+
+				const uint8_t count = inv_is_empty(item) ? 0 : item->count;
+				const uint8_t room = range->max_count > count ? range->max_count - count : 0;
+				const uint8_t placed = kind == 2 ? room : UTL_MIN(per_slot, room);
+
+				if (placed == 0) {
+					continue;
+				}
+
+				*item = stack;
+				itm_set_count(item, count + placed);
+
+				// full stacks are copies
+				if (kind != 2) {
+					itm_set_count(carried, carried->count - placed);
+				}
+
+			}
+
+			window->drag.active = false;
+		} break;
+	}
+
+	return true;
+
+}
+
+static void inv_gather(inv_window_t* window) {
+
+	const inv_layout_t* layout = window->layout;
+	itm_item_t* carried = &window->carried;
+
+	// partial stacks go first, full ones only if that wasn't enough
+	for (uint8_t pass = 0; pass < 2; ++pass) {
+		for (uint8_t i = 0; i < layout->size && carried->count < 64; ++i) {
+
+			const inv_range_t* range = inv_get_range(window, i);
+			itm_item_t* item = &window->slots[i];
+
+			if ((range->flags & (INV_TAKE | INV_RESULT)) != INV_TAKE || inv_is_empty(item) || !itm_is_similar(item, carried)) {
+				continue;
+			}
+			if (pass == 0 && item->count == range->max_count) {
+				continue;
+			}
+
+			const uint8_t taken = UTL_MIN(item->count, 64 - carried->count);
+			itm_set_count(carried, carried->count + taken);
+			itm_set_count(item, item->count - taken);
+
+		}
+	}
+
+}
+
+bool inv_click(inv_window_t* window, int16_t slot, int8_t button, inv_click_mode_t mode, bool creative) {
+
+	if (slot != INV_SLOT_OUTSIDE && slot != INV_SLOT_NONE && (slot < 0 || slot >= window->layout->size)) {
+		return false;
+	}
+
+	if (mode != inv_click_drag) {
+		window->drag.active = false;
+	}
+
+	switch (mode) {
+		case inv_click_normal: {
+			if (button != 0 && button != 1) {
+				return false;
+			}
+			if (slot == INV_SLOT_OUTSIDE) {
+				// TODO spawn the dropped items once there are item entities
+				if (!inv_is_empty(&window->carried)) {
+					itm_set_count(&window->carried, button == 0 ? 0 : window->carried.count - 1);
+				}
+			} else if (slot >= 0) {
+				inv_click_slot(window, slot, button == 1);
+			}
+		} break;
+		case inv_click_shift: {
+			if (button != 0 && button != 1) {
+				return false;
+			}
+			if (slot >= 0) {
+				inv_shift_click_slot(window, slot);
+			}
+		} break;
+		case inv_click_number: {
+			if (slot >= 0) {
+				return inv_swap_slot(window, slot, button);
+			}
+		} break;
+		case inv_click_middle: {
+			if (slot >= 0 && creative && inv_is_empty(&window->carried) && !inv_is_empty(&window->slots[slot])) {
+				window->carried = window->slots[slot];
+				itm_set_count(&window->carried, 64);
+			}
+		} break;
+		case inv_click_drop: {
+			if (slot >= 0) {
+				return inv_drop_slot(window, slot, button);
+			}
+		} break;
+		case inv_click_drag: {
+			return inv_drag(window, slot, button, creative);
+		}
+		case inv_click_double: {
+			if (slot >= 0 && !inv_is_empty(&window->carried)) {
+				inv_gather(window);
+			}
+		} break;
+		default: {
+			return false;
+		}
+	}
+
+	return true;
+
+}
+
+uint32_t inv_get_changes(inv_window_t* window, inv_change_t* changes) {
+
+	uint32_t count = 0;
+
+	for (uint8_t i = 0; i < window->layout->size; ++i) {
+		if (!inv_is_same(&window->slots[i], &window->remote[i])) {
+			changes[count++] = (inv_change_t) {
+				.slot = i,
+				.item = window->slots[i]
+			};
+			window->remote[i] = window->slots[i];
+		}
+	}
+
+	if (!inv_is_same(&window->carried, &window->remote_carried)) {
+		changes[count++] = (inv_change_t) {
+			.slot = INV_SLOT_NONE,
+			.item = window->carried
+		};
+		window->remote_carried = window->carried;
+	}
+
+	// clients hold on to the state id of the last update they got
+	if (count != 0) {
+		window->state_id = (window->state_id + 1) & 0x7FFF;
+	}
+
+	return count;
+
+}
@@ -0,0 +1,189 @@
+#pragma once
+#include <pthread.h>
+#include <string.h>
+#include "../../../main.h"
+#include "../item.h"
+
+/*
+	Inventories
+
+	A window is one array of slots in the order the protocol numbers them, next to a copy of what the
+	client was last told. Clicks run on the slots, the client's own guess at the outcome goes in the
+	copy, and only the slots where the two differ are sent back. A click on an outdated state id is
+	not run at all, sending the differences is enough to put the client right again.
+
+	Every slot belongs to a range of its layout, like the hotbar, which says what can be done with
+	it and where shift clicks move it to.
+*/
+
+// slots of the biggest window
+#define INV_MAX_SLOTS 46
+
+#define INV_MAX_RANGES 6
+
+// slot numbers outside of the window
+#define INV_SLOT_NONE -1
+#define INV_SLOT_OUTSIDE -999
+
+// range flags
+#define INV_TAKE 0x1
+#define INV_PLACE 0x2
+#define INV_RESULT 0x4
+
+// player window
+#define INV_PLAYER_SLOTS 46
+#define INV_PLAYER_RESULT 0
+#define INV_PLAYER_GRID 1
+#define INV_PLAYER_ARMOR 5
+#define INV_PLAYER_MAIN 9
+#define INV_PLAYER_HOTBAR 36
+#define INV_PLAYER_OFF_HAND 45
+
+typedef enum {
+
+	inv_window_player,
+
+	inv_window_count
+
+} inv_window_type_t;
+
+typedef enum {
+
+	inv_click_normal = 0,
+	inv_click_shift = 1,
+	inv_click_number = 2,
+	inv_click_middle = 3,
+	inv_click_drop = 4,
+	inv_click_drag = 5,
+	inv_click_double = 6
+
+} inv_click_mode_t;
+
+typedef struct {
+
+	uint8_t begin;
+	uint8_t end;
+
+	uint8_t flags;
+	uint8_t max_count;
+
+	// ranges shift clicks move to, in order
+	uint8_t target_count;
+	uint8_t targets[2];
+
+} inv_range_t;
+
+typedef struct {
+
+	uint8_t size;
+	uint8_t hotbar;
+
+	// UINT8_MAX if there is none
+	uint8_t off_hand;
+
+	// crafting grid and its result, a grid size of 0 if there is none
+	uint8_t grid;
+	uint8_t grid_size;
+	uint8_t result;
+
+	uint8_t range_count;
+	inv_range_t ranges[INV_MAX_RANGES];
+
+	// range of every slot
+	uint8_t slot_ranges[INV_MAX_SLOTS];
+
+} inv_layout_t;
+
+typedef struct {
+
+	pthread_mutex_t lock;
+
+	const inv_layout_t* layout;
+	uint8_t id;
+	uint32_t state_id;
+
+	itm_item_t* slots;
+	itm_item_t carried;
+
+	// what the client thinks is in the window
+	itm_item_t* remote;
+	itm_item_t remote_carried;
+
+	struct {
+		uint64_t added;
+		uint8_t slots[INV_MAX_SLOTS];
+		uint8_t count;
+		// 0 to spread, 1 for one each and 2 for full stacks
+		uint8_t kind;
+		bool active : 1;
+	} drag;
+
+} inv_window_t;
+
+typedef struct {
+
+	// INV_SLOT_NONE for the carried item
+	int16_t slot;
+	itm_item_t item;
+
+} inv_change_t;
+
+extern const inv_layout_t inv_layouts[inv_window_count];
+
+static inline void inv_init_window(inv_window_t* window, inv_window_type_t type, uint8_t id, itm_item_t* slots, itm_item_t* remote) {
+
+	pthread_mutex_init(&window->lock, NULL);
+
+	window->layout = &inv_layouts[type];
+	window->id = id;
+	window->slots = slots;
+	window->remote = remote;
+
+}
+
+static inline void inv_term_window(inv_window_t* window) {
+	pthread_mutex_destroy(&window->lock);
+}
+
+static inline const inv_range_t* inv_get_range(const inv_window_t* window, uint8_t slot) {
+	return &window->layout->ranges[window->layout->slot_ranges[slot]];
+}
+
+/*
+Run a click, false if the client sent one no client could
+*/
+extern bool inv_click(inv_window_t* window, int16_t slot, int8_t button, inv_click_mode_t mode, bool creative);
+
+/*
+The client's guess at a slot after its click, INV_SLOT_NONE for the carried item
+*/
+static inline void inv_set_remote(inv_window_t* window, int16_t slot, itm_item_t item) {
+
+	if (slot == INV_SLOT_NONE) {
+		window->remote_carried = item;
+	} else if (slot >= 0 && slot < window->layout->size) {
+		window->remote[slot] = item;
+	}
+
+}
+
+/*
+Put the crafting result of the grid in its slot
+*/
+extern void inv_update_crafting(inv_window_t* window);
+
+/*
+Slots the client has wrong, counted as sent from here on
+Changes needs room for INV_MAX_SLOTS + 1, returns how many there are
+*/
+extern uint32_t inv_get_changes(inv_window_t* window, inv_change_t* changes);
+
+/*
+Count the whole window as sent, after sending all of it
+*/
+static inline void inv_set_sent(inv_window_t* window) {
+
+	memcpy(window->remote, window->slots, sizeof(itm_item_t) * window->layout->size);
+	window->remote_carried = window->carried;
+
+}
@@ -61,26 +61,45 @@ static inline bool itm_is_similar(itm_item_t* a, itm_item_t* b) {
 
 }
 
-static inline void itm_from_packet(pck_packet_t* packet, itm_item_t* item) {
+/*
+Read a slot from a packet, the nbt is only skipped over
+Returns false if the nbt is malformed or runs past the end of the packet
+*/
+static inline bool itm_from_packet(pck_packet_t* packet, itm_item_t* item) {
 
 	bool present = pck_read_int8(packet);
 
 	if (present) {
 		mat_item_type_t type = pck_read_var_int(packet);
 		int8_t count = pck_read_int8(packet);
-		size_t len = 0;
-		mnbt_doc* doc = mnbt_read(pck_cursor(packet), 1, &len, MNBT_NONE);
 
-		packet->cursor += len;
+		if (packet->cursor >= packet->length) {
+			return false;
+		}
+
+		// a single end tag if there is no nbt
+		if (*pck_cursor(packet) == MNBT_END) {
+			packet->cursor += 1;
+		} else {
+			mnbt_cursor nbt;
+			if (!mnbt_cursor_open(&nbt, pck_cursor(packet), packet->length - packet->cursor)) {
+				return false;
+			}
+			const size_t length = mnbt_cursor_length(&nbt);
+			if (length == 0) {
+				return false;
+			}
+			packet->cursor = (nbt.value + length) - packet->bytes;
+		}
 
 		itm_set_type(item, type);
 		itm_set_count(item, count);
-
-		mnbt_free(doc);
 	} else {
 		itm_set_type(item, mat_item_air);
 	}
 
+	return true;
+
 }
 
 /*
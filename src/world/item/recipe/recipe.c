@@ -1,4 +1,513 @@
+#include <pthread.h>
 #include "../../../util/str_util.h"
+#include "../../../util/lock_util.h"
 #include "recipe.h"
 
-utl_vector_t rec_recipes = UTL_VECTOR_INITIALIZER(rec_recipe_t*);
\ No newline at end of file
+utl_vector_t rec_recipes = UTL_VECTOR_INITIALIZER(rec_recipe_t*);
+_Atomic uint32_t rec_version = 0;
+
+// (width - 1) | (height - 1) << 2 | slots << 4, the slots of the trimmed shape in a 3 wide grid
+#define REC_SHAPES (1 << (4 + REC_GRID_SLOTS))
+
+#define REC_ROW_EMPTY UINT32_MAX
+
+typedef struct {
+
+	uint32_t first;
+	uint16_t count;
+
+	// 64 recipes per word
+	uint16_t words;
+
+} rec_bucket_t;
+
+typedef struct {
+
+	// bucket << 16 | slot << 12 | item
+	uint32_t key;
+
+	// into the masks
+	uint32_t offset;
+
+} rec_row_t;
+
+typedef struct {
+
+	_Atomic uint32_t references;
+	uint32_t version;
+
+	// bucket of every shape and of every shapeless ingredient count, -1 if there is none
+	int16_t shaped[REC_SHAPES];
+	int16_t shapeless[REC_GRID_SLOTS + 1];
+
+	rec_bucket_t* buckets;
+	const rec_recipe_t** recipes;
+
+	rec_row_t* rows;
+	uint32_t row_mask;
+
+	uint64_t* masks;
+	uint32_t mask_count;
+	uint32_t mask_capacity;
+
+} rec_index_t;
+
+static struct {
+
+	pthread_mutex_t lock;
+	rec_index_t* index;
+
+} rec_index = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.index = NULL
+};
+
+void rec_add_recipe(rec_recipe_t* recipe) {
+
+	utl_vector_push(&rec_recipes, &recipe);
+	rec_version++;
+
+}
+
+/*
+Trim the occupied slots of a 3 wide grid down to the box around them
+Returns the shape and sets `offset` to the slot the box starts at, or -1 if nothing is occupied
+*/
+static int32_t rec_trim(uint16_t occupied, uint8_t* offset) {
+
+	if (occupied == 0) {
+		return -1;
+	}
+
+	uint8_t min_x = 2, min_y = 2, max_x = 0, max_y = 0;
+
+	for (uint8_t i = 0; i < REC_GRID_SLOTS; ++i) {
+		if (occupied & (1 << i)) {
+			const uint8_t x = i % 3, y = i / 3;
+			min_x = x < min_x ? x : min_x;
+			min_y = y < min_y ? y : min_y;
+			max_x = x > max_x ? x : max_x;
+			max_y = y > max_y ? y : max_y;
+		}
+	}
+
+	// nothing is left of min_x, so shifting keeps every row in place
+	*offset = min_y * 3 + min_x;
+
+	return (max_x - min_x) | (max_y - min_y) << 2 | (occupied >> *offset) << 4;
+
+}
+
+static inline uint32_t rec_row_key(uint32_t bucket, uint8_t slot, mat_item_type_t item) {
+	return bucket << 16 | (uint32_t) slot << 12 | item;
+}
+
+static inline const rec_row_t* rec_find_row(const rec_index_t* index, uint32_t key) {
+
+	for (uint32_t i = (key * 0x9E3779B1) & index->row_mask;; i = (i + 1) & index->row_mask) {
+		if (index->rows[i].key == key) {
+			return &index->rows[i];
+		}
+		if (index->rows[i].key == REC_ROW_EMPTY) {
+			return NULL;
+		}
+	}
+
+}
+
+static void rec_set_bit(rec_index_t* index, uint32_t bucket, uint8_t slot, mat_item_type_t item, uint32_t bit) {
+
+	const uint32_t key = rec_row_key(bucket, slot, item);
+	const uint16_t words = index->buckets[bucket].words;
+
+	uint32_t i = (key * 0x9E3779B1) & index->row_mask;
+	while (index->rows[i].key != key && index->rows[i].key != REC_ROW_EMPTY) {
+		i = (i + 1) & index->row_mask;
+	}
+
+	if (index->rows[i].key == REC_ROW_EMPTY) {
+
+		if (index->mask_count + words > index->mask_capacity) {
+			index->mask_capacity = (index->mask_count + words) * 2;
+			index->masks = realloc(index->masks, sizeof(uint64_t) * index->mask_capacity);
+		}
+
+		index->rows[i].key = key;
+		index->rows[i].offset = index->mask_count;
+		memset(index->masks + index->mask_count, 0, sizeof(uint64_t) * words);
+		index->mask_count += words;
+
+	}
+
+	index->masks[index->rows[i].offset + (bit >> 6)] |= (uint64_t) 1 << (bit & 63);
+
+}
+
+static void rec_set_ingredient(rec_index_t* index, uint32_t bucket, uint8_t slot, const rec_ingredient_t* ingredient, uint32_t bit) {
+
+	if (ingredient->tag == NULL) {
+		rec_set_bit(index, bucket, slot, ingredient->ingredient.type, bit);
+		return;
+	}
+
+	for (int32_t i = 0; i < ingredient->tag->count; ++i) {
+		rec_set_bit(index, bucket, slot, ingredient->tag->entries[i], bit);
+	}
+
+}
+
+static inline bool rec_is_empty(const rec_ingredient_t* ingredient) {
+	return ingredient->tag == NULL && (ingredient->count == 0 || ingredient->ingredient.type == mat_item_air);
+}
+
+typedef struct {
+
+	const rec_recipe_t* recipe;
+	uint32_t order;
+
+	// shape for shaped recipes, REC_SHAPES + ingredient count for shapeless ones
+	int32_t key;
+
+	const rec_ingredient_t* slots[REC_GRID_SLOTS];
+
+} rec_entry_t;
+
+static int rec_compare_entries(const void* a, const void* b) {
+
+	const rec_entry_t* entry_a = a;
+	const rec_entry_t* entry_b = b;
+
+	if (entry_a->key != entry_b->key) {
+		return entry_a->key < entry_b->key ? -1 : 1;
+	}
+
+	// keep the order recipes were added in, earlier ones win
+	return entry_a->order < entry_b->order ? -1 : (entry_a->order > entry_b->order);
+
+}
+
+static rec_index_t* rec_create_index() {
+
+	rec_index_t* index = calloc(1, sizeof(rec_index_t));
+	index->references = 1;
+	index->version = rec_version;
+
+	memset(index->shaped, -1, sizeof(index->shaped));
+	memset(index->shapeless, -1, sizeof(index->shapeless));
+
+	// every shaped recipe can need a mirrored entry as well
+	rec_entry_t* entries = malloc(sizeof(rec_entry_t) * (rec_recipes.size * 2 + 1));
+	uint32_t entry_count = 0;
+	uint32_t item_count = 0;
+
+	for (uint32_t i = 0; i < rec_recipes.size; ++i) {
+
+		const rec_recipe_t* recipe = UTL_VECTOR_GET_AS(rec_recipe_t*, &rec_recipes, i);
+
+		switch (recipe->type) {
+			case rec_crafting_shaped: {
+
+				const uint8_t width = recipe->data.crafting_shaped.width;
+				const uint8_t height = recipe->data.crafting_shaped.height;
+
+				uint16_t occupied = 0, mirrored_occupied = 0;
+				uint32_t items = 0;
+
+				for (uint8_t y = 0; y < height; ++y) {
+					for (uint8_t x = 0; x < width; ++x) {
+						if (!rec_is_empty(&recipe->data.crafting_shaped.ingredients[y * width + x])) {
+							occupied |= 1 << (y * 3 + x);
+							mirrored_occupied |= 1 << (y * 3 + (width - 1 - x));
+						}
+					}
+				}
+
+				uint8_t offset = 0, mirrored_offset = 0;
+				rec_entry_t entry = { .recipe = recipe, .order = entry_count, .key = rec_trim(occupied, &offset) };
+				rec_entry_t mirrored = { .recipe = recipe, .order = entry_count + 1, .key = rec_trim(mirrored_occupied, &mirrored_offset) };
+
+				if (entry.key < 0) {
+					break;
+				}
+
+				for (uint8_t y = 0; y < height; ++y) {
+					for (uint8_t x = 0; x < width; ++x) {
+						const rec_ingredient_t* ingredient = &recipe->data.crafting_shaped.ingredients[y * width + x];
+						if (!rec_is_empty(ingredient)) {
+							entry.slots[y * 3 + x - offset] = ingredient;
+							mirrored.slots[y * 3 + (width - 1 - x) - mirrored_offset] = ingredient;
+							items += ingredient->tag == NULL ? 1 : ingredient->tag->count;
+						}
+					}
+				}
+
+				entries[entry_count++] = entry;
+				item_count += items;
+
+				// symmetric recipes only need to be in once
+				bool symmetric = mirrored.key == entry.key;
+				for (uint8_t j = 0; j < REC_GRID_SLOTS && symmetric; ++j) {
+					symmetric = mirrored.slots[j] == entry.slots[j] || (mirrored.slots[j] != NULL && entry.slots[j] != NULL && mirrored.slots[j]->tag == entry.slots[j]->tag && mirrored.slots[j]->ingredient.type == entry.slots[j]->ingredient.type);
+				}
+				if (!symmetric) {
+					entries[entry_count++] = mirrored;
+					item_count += items;
+				}
+
+			} break;
+			case rec_crafting_shapeless: {
+
+				const size_t count = recipe->data.crafting_shapeless.ingredient_count;
+				if (count == 0 || count > REC_GRID_SLOTS) {
+					break;
+				}
+
+				rec_entry_t entry = { .recipe = recipe, .order = entry_count, .key = REC_SHAPES + count };
+				for (size_t j = 0; j < count; ++j) {
+					const rec_ingredient_t* ingredient = &recipe->data.crafting_shapeless.ingredients[j];
+					entry.slots[j] = ingredient;
+					item_count += ingredient->tag == NULL ? 1 : ingredient->tag->count;
+				}
+
+				entries[entry_count++] = entry;
+
+			} break;
+			default:
+				break;
+		}
+
+	}
+
+	qsort(entries, entry_count, sizeof(rec_entry_t), rec_compare_entries);
+
+	index->buckets = malloc(sizeof(rec_bucket_t) * (entry_count + 1));
+	index->recipes = malloc(sizeof(rec_recipe_t*) * (entry_count + 1));
+
+	// at most one row per ingredient item, kept under half full
+	uint32_t capacity = 16;
+	while (capacity < item_count * 2) {
+		capacity <<= 1;
+	}
+	index->row_mask = capacity - 1;
+	index->rows = malloc(sizeof(rec_row_t) * capacity);
+	for (uint32_t i = 0; i < capacity; ++i) {
+		index->rows[i].key = REC_ROW_EMPTY;
+	}
+
+	uint32_t bucket_count = 0;
+
+	for (uint32_t i = 0; i < entry_count;) {
+
+		uint32_t end = i;
+		while (end < entry_count && entries[end].key == entries[i].key) {
+			index->recipes[end] = entries[end].recipe;
+			end += 1;
+		}
+
+		const uint32_t bucket = bucket_count++;
+		index->buckets[bucket] = (rec_bucket_t) {
+			.first = i,
+			.count = end - i,
+			.words = (end - i + 63) >> 6
+		};
+
+		if (entries[i].key < REC_SHAPES) {
+			index->shaped[entries[i].key] = bucket;
+		} else {
+			index->shapeless[entries[i].key - REC_SHAPES] = bucket;
+		}
+
+		for (uint32_t j = i; j < end; ++j) {
+			const bool shapeless = entries[j].key >= REC_SHAPES;
+			for (uint8_t slot = 0; slot < REC_GRID_SLOTS; ++slot) {
+				if (entries[j].slots[slot] != NULL) {
+					// shapeless ingredients can go anywhere
+					rec_set_ingredient(index, bucket, shapeless ? 0 : slot, entries[j].slots[slot], j - i);
+				}
+			}
+		}
+
+		i = end;
+
+	}
+
+	free(entries);
+
+	return index;
+
+}
+
+static inline void rec_release_index(rec_index_t* index) {
+
+	if (--index->references == 0) {
+		free(index->buckets);
+		free(index->recipes);
+		free(index->rows);
+		free(index->masks);
+		free(index);
+	}
+
+}
+
+static rec_index_t* rec_get_index() {
+
+	rec_index_t* index = NULL;
+
+	with_lock (&rec_index.lock) {
+
+		if (rec_index.index == NULL || rec_index.index->version != rec_version) {
+			if (rec_index.index != NULL) {
+				rec_release_index(rec_index.index);
+			}
+			rec_index.index = rec_create_index();
+		}
+
+		index = rec_index.index;
+		index->references++;
+
+	}
+
+	return index;
+
+}
+
+void rec_build_index() {
+
+	rec_release_index(rec_get_index());
+
+}
+
+void rec_term_index() {
+
+	with_lock (&rec_index.lock) {
+		if (rec_index.index != NULL) {
+			rec_release_index(rec_index.index);
+			rec_index.index = NULL;
+		}
+	}
+
+}
+
+// and the masks of the bucket for every item, false if one of them fits nowhere
+static bool rec_intersect(const rec_index_t* index, uint32_t bucket, const mat_item_type_t* items, const uint8_t* slots, uint8_t count, uint64_t* candidates) {
+
+	const uint16_t words = index->buckets[bucket].words;
+
+	for (uint16_t i = 0; i < words; ++i) {
+		candidates[i] = UINT64_MAX;
+	}
+
+	for (uint8_t i = 0; i < count; ++i) {
+
+		const rec_row_t* row = rec_find_row(index, rec_row_key(bucket, slots[i], items[i]));
+		if (row == NULL) {
+			return false;
+		}
+
+		uint64_t any = 0;
+		for (uint16_t j = 0; j < words; ++j) {
+			candidates[j] &= index->masks[row->offset + j];
+			any |= candidates[j];
+		}
+		if (any == 0) {
+			return false;
+		}
+
+	}
+
+	return true;
+
+}
+
+// give every item its own ingredient, ingredients that fit several items make this a search
+static bool rec_assign(const rec_ingredient_t* ingredients, const mat_item_type_t* items, uint8_t count, uint8_t item, uint16_t used) {
+
+	if (item == count) {
+		return true;
+	}
+
+	for (uint8_t i = 0; i < count; ++i) {
+		if (!(used & (1 << i)) && rec_ingredient_accepts(&ingredients[i], items[item]) && rec_assign(ingredients, items, count, item + 1, used | (1 << i))) {
+			return true;
+		}
+	}
+
+	return false;
+
+}
+
+const rec_recipe_t* rec_match_crafting(const itm_item_t* grid, uint8_t size) {
+
+	if (size == 0 || size > 3) {
+		return NULL;
+	}
+
+	uint16_t occupied = 0;
+	for (uint8_t y = 0; y < size; ++y) {
+		for (uint8_t x = 0; x < size; ++x) {
+			const itm_item_t* item = &grid[y * size + x];
+			occupied |= (item->type != mat_item_air && item->count != 0) << (y * 3 + x);
+		}
+	}
+
+	uint8_t offset;
+	const int32_t shape = rec_trim(occupied, &offset);
+	if (shape < 0) {
+		return NULL;
+	}
+
+	mat_item_type_t items[REC_GRID_SLOTS];
+	uint8_t slots[REC_GRID_SLOTS];
+	uint8_t count = 0;
+
+	for (uint8_t i = 0; i < REC_GRID_SLOTS; ++i) {
+		if (occupied & (1 << i)) {
+			items[count] = grid[(i / 3) * size + i % 3].type;
+			slots[count] = i - offset;
+			count += 1;
+		}
+	}
+
+	rec_index_t* index = rec_get_index();
+	const rec_recipe_t* recipe = NULL;
+
+	const int16_t shaped = index->shaped[shape];
+	if (shaped >= 0) {
+
+		uint64_t candidates[index->buckets[shaped].words];
+
+		if (rec_intersect(index, shaped, items, slots, count, candidates)) {
+			for (uint16_t i = 0; recipe == NULL; ++i) {
+				if (candidates[i] != 0) {
+					recipe = index->recipes[index->buckets[shaped].first + (i << 6) + __builtin_ctzll(candidates[i])];
+				}
+			}
+		}
+
+	}
+
+	const int16_t shapeless = index->shapeless[count];
+	if (recipe == NULL && shapeless >= 0) {
+
+		uint64_t candidates[index->buckets[shapeless].words];
+		const uint8_t anywhere[REC_GRID_SLOTS] = { 0 };
+
+		// every item fits some ingredient of the candidates, check they fit different ones
+		if (rec_intersect(index, shapeless, items, anywhere, count, candidates)) {
+			for (uint16_t i = 0; i < index->buckets[shapeless].words && recipe == NULL; ++i) {
+				for (uint64_t word = candidates[i]; word != 0 && recipe == NULL; word &= word - 1) {
+					const rec_recipe_t* candidate = index->recipes[index->buckets[shapeless].first + (i << 6) + __builtin_ctzll(word)];
+					if (rec_assign(candidate->data.crafting_shapeless.ingredients, items, count, 0, 0)) {
+						recipe = candidate;
+					}
+				}
+			}
+		}
+
+	}
+
+	rec_release_index(index);
+
+	return recipe;
+
+}
@@ -30,6 +30,16 @@ typedef enum {
 
 } rec_recipe_type_t;
 
+typedef struct {
+
+	size_t count;
+	itm_item_t ingredient;
+
+	// any item of the tag fits instead of `ingredient` when set
+	const mat_tag_t* tag;
+
+} rec_ingredient_t;
+
 typedef struct {
 
 	rec_recipe_type_t type : 5;
@@ -43,10 +53,7 @@ typedef struct {
 			itm_item_t result;
 
 			size_t ingredient_count;
-			struct {
-				size_t count;
-				itm_item_t ingredient;
-			} ingredients[];
+			rec_ingredient_t ingredients[];
 
 		} crafting_shapeless;
 
@@ -58,10 +65,8 @@ typedef struct {
 			uint8_t width : 2;
 			uint8_t height : 2;
 
-			struct {
-				size_t count;
-				itm_item_t ingredient;
-			} ingredients[];
+			// row by row, empty slots have a count of 0
+			rec_ingredient_t ingredients[];
 
 		} crafting_shaped;
 
@@ -105,6 +110,136 @@ typedef struct {
 
 extern utl_vector_t rec_recipes;
 
+// changes every time a recipe is added
+extern _Atomic uint32_t rec_version;
+
+extern void rec_add_recipe(rec_recipe_t* recipe);
+
+/*
+	Crafting recipe index
+
+	Shaped recipes are trimmed to the smallest box around their ingredients and bucketed by that
+	shape, mirrored ones go in a second time. Shapeless recipes are bucketed by their number of
+	ingredients. Every bucket keeps a bit mask of its recipes for each slot and item that fits
+	there, with tags expanded, so a grid is matched by and-ing at most 9 masks
+*/
+
+#define REC_GRID_SLOTS 9
+
+/*
+Index the current crafting recipes, the index is rebuilt on the next match when recipes are added later
+*/
+extern void rec_build_index();
+extern void rec_term_index();
+
+/*
+Find the crafting recipe for a `size` by `size` grid of items given row by row, NULL if there is none
+*/
+extern const rec_recipe_t* rec_match_crafting(const itm_item_t* grid, uint8_t size);
+
+static inline itm_item_t rec_get_crafting_result(const rec_recipe_t* recipe) {
+
+	switch (recipe->type) {
+		case rec_crafting_shapeless:
+			return recipe->data.crafting_shapeless.result;
+		case rec_crafting_shaped:
+			return recipe->data.crafting_shaped.result;
+		default:
+			return itm_new;
+	}
+
+}
+
+static inline bool rec_ingredient_accepts(const rec_ingredient_t* ingredient, mat_item_type_t type) {
+
+	if (ingredient->tag == NULL) {
+		return ingredient->count != 0 && ingredient->ingredient.type == type;
+	}
+
+	for (int32_t i = 0; i < ingredient->tag->count; ++i) {
+		if (ingredient->tag->entries[i] == (int32_t) type) {
+			return true;
+		}
+	}
+
+	return false;
+
+}
+
+static inline void rec_serialize_ingredient(pck_packet_t* packet, const rec_ingredient_t* ingredient) {
+
+	if (ingredient->tag == NULL) {
+		pck_write_var_int(packet, ingredient->count);
+		if (ingredient->count != 0) {
+			itm_serialize(packet, &ingredient->ingredient);
+		}
+		return;
+	}
+
+	// clients get tags spelled out
+	pck_write_var_int(packet, ingredient->tag->count);
+	for (int32_t i = 0; i < ingredient->tag->count; ++i) {
+		const itm_item_t item = { .type = ingredient->tag->entries[i], .count = 1 };
+		itm_serialize(packet, &item);
+	}
+
+}
+
+// items take at most a flag, a var int, a count and an empty nbt tag
+#define REC_ITEM_BYTES 8
+
+// type names are shorter than this
+#define REC_TYPE_BYTES 48
+
+static inline size_t rec_get_ingredient_size(const rec_ingredient_t* ingredient) {
+
+	if (ingredient->tag == NULL) {
+		return 5 + REC_ITEM_BYTES;
+	}
+
+	return 5 + (size_t) ingredient->tag->count * REC_ITEM_BYTES;
+
+}
+
+/*
+Most bytes rec_serialize can write for a recipe
+*/
+static inline size_t rec_get_serialized_size(const rec_recipe_t* recipe) {
+
+	size_t size = 5 + REC_TYPE_BYTES + 5 + recipe->recipe_id.length;
+
+	switch (recipe->type) {
+		case rec_crafting_shapeless: {
+			size += 5 + recipe->data.crafting_shapeless.group.length + 5 + REC_ITEM_BYTES;
+			for (size_t i = 0; i < recipe->data.crafting_shapeless.ingredient_count; ++i) {
+				size += rec_get_ingredient_size(&recipe->data.crafting_shapeless.ingredients[i]);
+			}
+		} break;
+		case rec_crafting_shaped: {
+			size += 5 + 5 + 5 + recipe->data.crafting_shaped.group.length + REC_ITEM_BYTES;
+			for (size_t i = 0; i < recipe->data.crafting_shaped.width * recipe->data.crafting_shaped.height; ++i) {
+				size += rec_get_ingredient_size(&recipe->data.crafting_shaped.ingredients[i]);
+			}
+		} break;
+		case rec_smelting:
+		case rec_blasting:
+		case rec_smoking:
+		case rec_campfire_cooking: {
+			size += 5 + recipe->data.smelting.group.length + 5 + REC_ITEM_BYTES * 2 + 4 + 5;
+		} break;
+		case rec_stonecutting: {
+			size += 5 + recipe->data.stonecutting.group.length + 5 + REC_ITEM_BYTES * 2;
+		} break;
+		case rec_smithing: {
+			size += 5 + REC_ITEM_BYTES + 5 + REC_ITEM_BYTES + REC_ITEM_BYTES;
+		} break;
+		default: break;
+	}
+
+	return size;
+
+}
+
 static inline void rec_serialize(pck_packet_t* packet, const rec_recipe_t* recipe) {
 
 	const string_t types[] = {
@@ -140,8 +275,7 @@ static inline void rec_serialize(pck_packet_t* packet, const rec_recipe_t* recip
 			pck_write_string(packet, UTL_STRTOARG(recipe->data.crafting_shapeless.group));
 			pck_write_var_int(packet, recipe->data.crafting_shapeless.ingredient_count);
 			for (size_t i = 0; i < recipe->data.crafting_shapeless.ingredient_count; ++i) {
-				pck_write_var_int(packet, recipe->data.crafting_shapeless.ingredients[i].count);
-				itm_serialize(packet, &recipe->data.crafting_shapeless.ingredients[i].ingredient);
+				rec_serialize_ingredient(packet, &recipe->data.crafting_shapeless.ingredients[i]);
 			}
 			itm_serialize(packet, &recipe->data.crafting_shapeless.result);
 		} break;
@@ -150,8 +284,7 @@ static inline void rec_serialize(pck_packet_t* packet, const rec_recipe_t* recip
 			pck_write_var_int(packet, recipe->data.crafting_shaped.height);
 			pck_write_string(packet, UTL_STRTOARG(recipe->data.crafting_shaped.group));
 			for (size_t i = 0; i < recipe->data.crafting_shaped.width * recipe->data.crafting_shaped.height; ++i) {
-				pck_write_var_int(packet, recipe->data.crafting_shaped.ingredients[i].count);
-				itm_serialize(packet, &recipe->data.crafting_shaped.ingredients[i].ingredient);
+				rec_serialize_ingredient(packet, &recipe->data.crafting_shaped.ingredients[i]);
 			}
 			itm_serialize(packet, &recipe->data.crafting_shaped.result);
 		} break;
@@ -0,0 +1,85 @@
+#include <stdlib.h>
+#include <assert.h>
+#include "blocks.h"
+
+_Static_assert(mat_block_count <= 0x400, "block types have to fit in 10 bits of a state word");
+_Static_assert(MAT_STATE_TYPE_SHIFT + 10 <= 45, "values and block type have to stay below the flags");
+
+mat_block_state_t* mat_block_states = NULL;
+mat_block_properties_t mat_block_properties[mat_block_count];
+
+static uint32_t mat_block_state_count = 0;
+
+static inline uint32_t mat_get_block_states_by_type(const mat_block_t* block) {
+
+	uint32_t states = 1;
+	for (uint32_t i = 0; i < block->modifiers_count; ++i) {
+		states *= mat_get_state_modifier_by_type(block->modifiers[i])->count;
+	}
+
+	return states;
+
+}
+
+void mat_init_block_states() {
+
+	if (mat_block_states != NULL) {
+		return;
+	}
+
+	mat_block_state_count = mat_get_block_base_protocol_id_by_type(mat_block_count - 1) + mat_get_block_states_by_type(mat_get_block_by_type(mat_block_count - 1));
+	mat_block_states = malloc(sizeof(mat_block_state_t) * mat_block_state_count);
+
+	for (uint32_t type = 0; type < mat_block_count; ++type) {
+
+		const mat_block_t* block = mat_get_block_by_type(type);
+		mat_block_properties_t* properties = &mat_block_properties[type];
+
+		assert(block->modifiers_count <= MAT_STATE_MAX_MODIFIERS);
+
+		for (uint32_t i = 0; i < block->modifiers_count; ++i) {
+			properties->modifiers[block->modifiers[i] >> 6] |= (uint64_t) 1 << (block->modifiers[i] & 0x3F);
+		}
+
+		// the last modifier changes fastest
+		uint32_t strides[MAT_STATE_MAX_MODIFIERS];
+		uint32_t stride = 1;
+		for (int32_t i = block->modifiers_count - 1; i >= 0; --i) {
+			strides[i] = stride;
+			stride *= mat_get_state_modifier_by_type(block->modifiers[i])->count;
+		}
+
+		int32_t slots[MAT_STATE_MAX_MODIFIERS];
+		for (uint32_t i = 0; i < block->modifiers_count; ++i) {
+			slots[i] = mat_get_block_state_slot(type, block->modifiers[i]);
+			properties->strides[slots[i]] = strides[i];
+		}
+
+		mat_block_state_t flags = (mat_block_state_t) type << MAT_STATE_TYPE_SHIFT;
+		flags |= block->air ? MAT_STATE_AIR : 0;
+		flags |= block->transparent ? 0 : MAT_STATE_OPAQUE;
+		flags |= block->random_ticks ? MAT_STATE_RANDOM_TICKS : 0;
+		flags |= block->water ? MAT_STATE_WATER : 0;
+		flags |= block->lava ? MAT_STATE_LAVA : 0;
+		flags |= (mat_block_state_t) block->luminance << MAT_STATE_LUMINANCE_SHIFT;
+
+		const mat_block_protocol_id_t base = mat_get_block_base_protocol_id_by_type(type);
+		for (uint32_t state = 0; state < stride; ++state) {
+
+			mat_block_state_t word = flags;
+			for (uint32_t i = 0; i < block->modifiers_count; ++i) {
+				const uint32_t value = (state / strides[i]) % mat_get_state_modifier_by_type(block->modifiers[i])->count;
+				word |= (mat_block_state_t) value << (slots[i] * MAT_STATE_VALUE_BITS);
+			}
+
+			mat_block_states[base + state] = word;
+
+		}
+
+	}
+
+}
+
+uint32_t mat_get_block_state_count() {
+	return mat_block_state_count;
+}
@@ -79,6 +79,7 @@ const mat_block_t mat_block_acacia_fence_gate_d = {
 const mat_block_t mat_block_acacia_leaves_d = { 
 	.resistance = 0.2,
 	.hardness = 0.2,
+	.random_ticks = true,
 	.encouragement = 30,
 	.flammability = 60,
 	.transparent = true,
@@ -140,6 +141,7 @@ const mat_block_t mat_block_acacia_pressure_plate_d = {
 const mat_block_t mat_block_acacia_sapling_d = { 
 	.resistance = 0,
 	.hardness = 0,
+	.random_ticks = true,
 	.transparent = true,
 	.modifiers_count = 1,
 	.modifiers = {
@@ -370,6 +372,7 @@ const mat_block_t mat_block_azalea_d = {
 const mat_block_t mat_block_azalea_leaves_d = { 
 	.resistance = 0.2,
 	.hardness = 0.2,
+	.random_ticks = true,
 	.encouragement = 30,
 	.flammability = 60,
 	.transparent = true,
@@ -401,6 +404,7 @@ const mat_block_t mat_block_azure_bluet_d = {
 const mat_block_t mat_block_bamboo_d = { 
 	.resistance = 1,
 	.hardness = 1,
+	.random_ticks = true,
 	.encouragement = 60,
 	.flammability = 60,
 	.transparent = true,
@@ -418,6 +422,7 @@ const mat_block_t mat_block_bamboo_d = {
 const mat_block_t mat_block_bamboo_sapling_d = { 
 	.resistance = 1,
 	.hardness = 1,
+	.random_ticks = true,
 	.transparent = true,
 	.catches_fire_from_lava = true,
 	.bamboo_plantable_on = true,
@@ -425,6 +430,7 @@ const mat_block_t mat_block_bamboo_sapling_d = {
 const mat_block_t mat_block_beetroots_d = { 
 	.resistance = 0,
 	.hardness = 0,
+	.random_ticks = true,
 	.transparent = true,
 	.mineable_axe = true,
 	.mineable = true,
@@ -620,6 +626,7 @@ const mat_block_t mat_block_birch_fence_gate_d = {
 const mat_block_t mat_block_birch_leaves_d = { 
 	.resistance = 0.2,
 	.hardness = 0.2,
+	.random_ticks = true,
 	.encouragement = 30,
 	.flammability = 60,
 	.transparent = true,
@@ -681,6 +688,7 @@ const mat_block_t mat_block_birch_pressure_plate_d = {
 const mat_block_t mat_block_birch_sapling_d = { 
 	.resistance = 0,
 	.hardness = 0,
+	.random_ticks = true,
 	.transparent = true,
 	.modifiers_count = 1,
 	.modifiers = {
@@ -998,6 +1006,7 @@ const mat_block_t mat_block_coal_block_d = {
 const mat_block_t mat_block_copper_block_d = {
 	.resistance = 6,
 	.hardness = 3,
+	.random_ticks = true,
 	.needs_stone_tool = true,
 	.needs = true,
 	.mineable_pickaxe = true,
@@ -1450,6 +1459,7 @@ const mat_block_t mat_block_brown_glazed_terracotta_d = {
 const mat_block_t mat_block_brown_mushroom_d = { 
 	.resistance = 0,
 	.hardness = 0,
+	.random_ticks = true,
 	.luminance = 1,
 	.transparent = true,
 	.mineable_axe = true,
@@ -1559,6 +1569,7 @@ const mat_block_t mat_block_bubble_coral_fan_d = {
 const mat_block_t mat_block_budding_amethyst_d = { 
 	.resistance = 1.5,
 	.hardness = 1.5,
+	.random_ticks = true,
 	.crystal_sound_blocks = true,
 	.mineable_pickaxe = true,
 	.mineable = true,
@@ -1566,6 +1577,7 @@ const mat_block_t mat_block_budding_amethyst_d = {
 const mat_block_t mat_block_cactus_d = { 
 	.resistance = 0.4,
 	.hardness = 0.4,
+	.random_ticks = true,
 	.transparent = true,
 	.modifiers_count = 1,
 	.modifiers = {
@@ -1620,6 +1632,7 @@ const mat_block_t mat_block_candle_d = {
 const mat_block_t mat_block_carrots_d = { 
 	.resistance = 0,
 	.hardness = 0,
+	.random_ticks = true,
 	.transparent = true,
 	.mineable_axe = true,
 	.mineable = true,
@@ -1660,6 +1673,7 @@ const mat_block_t mat_block_cauldron_d = {
 const mat_block_t mat_block_cave_vines_d = { 
 	.resistance = 0,
 	.hardness = 0,
+	.random_ticks = true,
 	.transparent = true,
 	.mineable_axe = true,
 	.mineable = true,
@@ -1786,6 +1800,7 @@ const mat_block_t mat_block_chiseled_stone_bricks_d = {
 const mat_block_t mat_block_chorus_flower_d = { 
 	.resistance = 0.4,
 	.hardness = 0.4,
+	.random_ticks = true,
 	.light_filtering = true,
 	.transparent = true,
 	.mineable_axe = true,
@@ -1973,6 +1988,7 @@ const mat_block_t mat_block_cobweb_d = {
 const mat_block_t mat_block_cocoa_d = { 
 	.resistance = 3,
 	.hardness = 0.2,
+	.random_ticks = true,
 	.transparent = true,
 	.mineable_axe = true,
 	.mineable = true,
@@ -2188,6 +2204,7 @@ const mat_block_t mat_block_crimson_hyphae_d = {
 const mat_block_t mat_block_crimson_nylium_d = { 
 	.resistance = 0.4,
 	.hardness = 0.4,
+	.random_ticks = true,
 	.enderman_holdable = true,
 	.mushroom_grow_block = true,
 	.mineable_pickaxe = true,
@@ -2316,6 +2333,7 @@ const mat_block_t mat_block_crying_obsidian_d = {
 const mat_block_t mat_block_cut_copper_d = { 
 	.resistance = 6,
 	.hardness = 3,
+	.random_ticks = true,
 	.needs_stone_tool = true,
 	.needs = true,
 	.mineable_pickaxe = true,
@@ -2324,6 +2342,7 @@ const mat_block_t mat_block_cut_copper_d = {
 const mat_block_t mat_block_cut_copper_slab_d = { 
 	.resistance = 6,
 	.hardness = 3,
+	.random_ticks = true,
 	.transparent = true,
 	.modifiers_count = 2,
 	.modifiers = {
@@ -2339,6 +2358,7 @@ const mat_block_t mat_block_cut_copper_slab_d = {
 const mat_block_t mat_block_cut_copper_stairs_d = { 
 	.resistance = 6,
 	.hardness = 3,
+	.random_ticks = true,
 	.transparent = true,
 	.modifiers_count = 4,
 	.modifiers = {
@@ -2625,6 +2645,7 @@ const mat_block_t mat_block_dark_oak_fence_gate_d = {
 const mat_block_t mat_block_dark_oak_leaves_d = { 
 	.resistance = 0.2,
 	.hardness = 0.2,
+	.random_ticks = true,
 	.encouragement = 30,
 	.flammability = 60,
 	.transparent = true,
@@ -2686,6 +2707,7 @@ const mat_block_t mat_block_dark_oak_pressure_plate_d = {
 const mat_block_t mat_block_dark_oak_sapling_d = { 
 	.resistance = 0,
 	.hardness = 0,
+	.random_ticks = true,
 	.transparent = true,
 	.modifiers_count = 1,
 	.modifiers = {
@@ -3127,6 +3149,7 @@ const mat_block_t mat_block_deepslate_lapis_ore_d = {
 const mat_block_t mat_block_deepslate_redstone_ore_d = { 
 	.resistance = 3,
 	.hardness = 4.5,
+	.random_ticks = true,
 	.modifiers_count = 1,
 	.modifiers = {
 		mat_state_modifier_lit
@@ -3336,6 +3359,7 @@ const mat_block_t mat_block_dragon_head_d = {
 const mat_block_t mat_block_kelp_d = { 
 	.resistance = 0,
 	.hardness = 0,
+	.random_ticks = true,
 	.modifiers_count = 1,
 	.modifiers = {
 		mat_state_modifier_vine_age
@@ -3492,6 +3516,7 @@ const mat_block_t mat_block_ender_chest_d = {
 const mat_block_t mat_block_exposed_copper_d = { 
 	.resistance = 6,
 	.hardness = 3,
+	.random_ticks = true,
 	.needs_stone_tool = true,
 	.needs = true,
 	.mineable_pickaxe = true,
@@ -3500,6 +3525,7 @@ const mat_block_t mat_block_exposed_copper_d = {
 const mat_block_t mat_block_exposed_cut_copper_d = { 
 	.resistance = 6,
 	.hardness = 3,
+	.random_ticks = true,
 	.needs_stone_tool = true,
 	.needs = true,
 	.mineable_pickaxe = true,
@@ -3508,6 +3534,7 @@ const mat_block_t mat_block_exposed_cut_copper_d = {
 const mat_block_t mat_block_exposed_cut_copper_slab_d = { 
 	.resistance = 6,
 	.hardness = 3,
+	.random_ticks = true,
 	.transparent = true,
 	.modifiers_count = 2,
 	.modifiers = {
@@ -3523,6 +3550,7 @@ const mat_block_t mat_block_exposed_cut_copper_slab_d = {
 const mat_block_t mat_block_exposed_cut_copper_stairs_d = { 
 	.resistance = 6,
 	.hardness = 3,
+	.random_ticks = true,
 	.transparent = true,
 	.modifiers_count = 4,
 	.modifiers = {
@@ -3539,6 +3567,7 @@ const mat_block_t mat_block_exposed_cut_copper_stairs_d = {
 const mat_block_t mat_block_farmland_d = { 
 	.resistance = 0.6,
 	.hardness = 0.6,
+	.random_ticks = true,
 	.transparent = true,
 	.modifiers_count = 1,
 	.modifiers = {
@@ -3560,6 +3589,7 @@ const mat_block_t mat_block_fern_d = {
 const mat_block_t mat_block_fire_d = { 
 	.resistance = 0,
 	.hardness = 0,
+	.random_ticks = true,
 	.transparent = true,
 	.modifiers_count = 6,
 	.modifiers = {
@@ -3625,6 +3655,7 @@ const mat_block_t mat_block_flowering_azalea_d = {
 const mat_block_t mat_block_flowering_azalea_leaves_d = { 
 	.resistance = 0.2,
 	.hardness = 0.2,
+	.random_ticks = true,
 	.encouragement = 30,
 	.flammability = 60,
 	.transparent = true,
@@ -3793,6 +3824,7 @@ const mat_block_t mat_block_grass_d = {
 const mat_block_t mat_block_grass_block_d = { 
 	.resistance = 0.6,
 	.hardness = 0.6,
+	.random_ticks = true,
 	.transparent = true,
 	.modifiers_count = 1,
 	.modifiers = {
@@ -4191,6 +4223,7 @@ const mat_block_t mat_block_horn_coral_fan_d = {
 const mat_block_t mat_block_ice_d = { 
 	.resistance = 0.5,
 	.hardness = 0.5,
+	.random_ticks = true,
 	.light_filtering = true,
 	.transparent = true,
 	.geode_invalid_blocks = true,
@@ -4415,6 +4448,7 @@ const mat_block_t mat_block_jungle_fence_gate_d = {
 const mat_block_t mat_block_jungle_leaves_d = { 
 	.resistance = 0.2,
 	.hardness = 0.2,
+	.random_ticks = true,
 	.encouragement = 30,
 	.flammability = 60,
 	.transparent = true,
@@ -4476,6 +4510,7 @@ const mat_block_t mat_block_jungle_pressure_plate_d = {
 const mat_block_t mat_block_jungle_sapling_d = { 
 	.resistance = 0,
 	.hardness = 0,
+	.random_ticks = true,
 	.transparent = true,
 	.modifiers_count = 1,
 	.modifiers = {
@@ -4641,6 +4676,7 @@ const mat_block_t mat_block_large_fern_d = {
 const mat_block_t mat_block_lava_d = { 
 	.resistance = 100,
 	.hardness = 100,
+	.random_ticks = true,
 	.light_filtering = true,
 	.luminance = 15,
 	.modifiers_count = 1,
@@ -5320,6 +5356,7 @@ const mat_block_t mat_block_melon_d = {
 const mat_block_t mat_block_melon_stem_d = { 
 	.resistance = 0,
 	.hardness = 0,
+	.random_ticks = true,
 	.transparent = true,
 	.mineable_axe = true,
 	.mineable = true,
@@ -5486,6 +5523,7 @@ const mat_block_t mat_block_mushroom_stem_d = {
 const mat_block_t mat_block_mycelium_d = { 
 	.resistance = 0.6,
 	.hardness = 0.6,
+	.random_ticks = true,
 	.modifiers_count = 1,
 	.modifiers = {
 		mat_state_modifier_grass_snowy
@@ -5606,6 +5644,7 @@ const mat_block_t mat_block_nether_sprouts_d = {
 const mat_block_t mat_block_nether_wart_d = { 
 	.resistance = 0,
 	.hardness = 0,
+	.random_ticks = true,
 	.transparent = true,
 	.mineable_axe = true,
 	.mineable = true,
@@ -5718,6 +5757,7 @@ const mat_block_t mat_block_oak_fence_gate_d = {
 const mat_block_t mat_block_oak_leaves_d = { 
 	.resistance = 0.2,
 	.hardness = 0.2,
+	.random_ticks = true,
 	.encouragement = 30,
 	.flammability = 60,
 	.transparent = true,
@@ -5779,6 +5819,7 @@ const mat_block_t mat_block_oak_pressure_plate_d = {
 const mat_block_t mat_block_oak_sapling_d = { 
 	.resistance = 0,
 	.hardness = 0,
+	.random_ticks = true,
 	.transparent = true,
 	.modifiers_count = 1,
 	.modifiers = {
@@ -6320,6 +6361,7 @@ const mat_block_t mat_block_podzol_d = {
 const mat_block_t mat_block_pointed_dripstone_d = { 
 	.resistance = 3,
 	.hardness = 1.5,
+	.random_ticks = true,
 	.transparent = true,
 	.modifiers_count = 3,
 	.modifiers = {
@@ -6678,6 +6720,7 @@ const mat_block_t mat_block_poppy_d = {
 const mat_block_t mat_block_potatoes_d = { 
 	.resistance = 0,
 	.hardness = 0,
+	.random_ticks = true,
 	.transparent = true,
 	.mineable_axe = true,
 	.mineable = true,
@@ -6819,6 +6862,7 @@ const mat_block_t mat_block_pumpkin_d = {
 const mat_block_t mat_block_pumpkin_stem_d = { 
 	.resistance = 0,
 	.hardness = 0,
+	.random_ticks = true,
 	.transparent = true,
 	.mineable_axe = true,
 	.mineable = true,
@@ -7150,6 +7194,7 @@ const mat_block_t mat_block_red_glazed_terracotta_d = {
 const mat_block_t mat_block_red_mushroom_d = { 
 	.resistance = 0,
 	.hardness = 0,
+	.random_ticks = true,
 	.transparent = true,
 	.mineable_axe = true,
 	.mineable = true,
@@ -7387,6 +7432,7 @@ const mat_block_t mat_block_redstone_lamp_d = {
 const mat_block_t mat_block_redstone_ore_d = { 
 	.resistance = 3,
 	.hardness = 3,
+	.random_ticks = true,
 	.modifiers_count = 1,
 	.modifiers = {
 		mat_state_modifier_lit
@@ -7846,6 +7892,7 @@ const mat_block_t mat_block_smooth_stone_slab_d = {
 const mat_block_t mat_block_snow_d = { 
 	.resistance = 0.1,
 	.hardness = 0.1,
+	.random_ticks = true,
 	.transparent = true,
 	.modifiers_count = 1,
 	.modifiers = {
@@ -8038,6 +8085,7 @@ const mat_block_t mat_block_spruce_fence_gate_d = {
 const mat_block_t mat_block_spruce_leaves_d = { 
 	.resistance = 0.2,
 	.hardness = 0.2,
+	.random_ticks = true,
 	.encouragement = 30,
 	.flammability = 60,
 	.transparent = true,
@@ -8099,6 +8147,7 @@ const mat_block_t mat_block_spruce_pressure_plate_d = {
 const mat_block_t mat_block_spruce_sapling_d = { 
 	.resistance = 0,
 	.hardness = 0,
+	.random_ticks = true,
 	.transparent = true,
 	.modifiers_count = 1,
 	.modifiers = {
@@ -8646,6 +8695,7 @@ const mat_block_t mat_block_structure_void_d = {
 const mat_block_t mat_block_sugar_cane_d = { 
 	.resistance = 0,
 	.hardness = 0,
+	.random_ticks = true,
 	.transparent = true,
 	.mineable_axe = true,
 	.mineable = true,
@@ -8673,6 +8723,7 @@ const mat_block_t mat_block_sunflower_d = {
 const mat_block_t mat_block_sweet_berry_bush_d = { 
 	.resistance = 0,
 	.hardness = 0,
+	.random_ticks = true,
 	.encouragement = 60,
 	.flammability = 100,
 	.transparent = true,
@@ -8841,6 +8892,7 @@ const mat_block_t mat_block_tuff_d = {
 const mat_block_t mat_block_turtle_egg_d = { 
 	.resistance = 0.5,
 	.hardness = 0.5,
+	.random_ticks = true,
 	.transparent = true,
 	.modifiers_count = 2,
 	.modifiers = {
@@ -8851,6 +8903,7 @@ const mat_block_t mat_block_turtle_egg_d = {
 const mat_block_t mat_block_twisting_vines_d = { 
 	.resistance = 0,
 	.hardness = 0,
+	.random_ticks = true,
 	.transparent = true,
 	.mineable_axe = true,
 	.mineable = true,
@@ -8863,6 +8916,7 @@ const mat_block_t mat_block_twisting_vines_d = {
 const mat_block_t mat_block_vine_d = { 
 	.resistance = 0.2,
 	.hardness = 0.2,
+	.random_ticks = true,
 	.encouragement = 15,
 	.flammability = 100,
 	.transparent = true,
@@ -8974,6 +9028,7 @@ const mat_block_t mat_block_warped_hyphae_d = {
 const mat_block_t mat_block_warped_nylium_d = { 
 	.resistance = 0.4,
 	.hardness = 0.4,
+	.random_ticks = true,
 	.enderman_holdable = true,
 	.mushroom_grow_block = true,
 	.mineable_pickaxe = true,
@@ -9300,6 +9355,7 @@ const mat_block_t mat_block_waxed_weathered_cut_copper_stairs_d = {
 const mat_block_t mat_block_weathered_copper_d = { 
 	.resistance = 6,
 	.hardness = 3,
+	.random_ticks = true,
 	.needs_stone_tool = true,
 	.needs = true,
 	.mineable_pickaxe = true,
@@ -9308,6 +9364,7 @@ const mat_block_t mat_block_weathered_copper_d = {
 const mat_block_t mat_block_weathered_cut_copper_d = { 
 	.resistance = 6,
 	.hardness = 3,
+	.random_ticks = true,
 	.needs_stone_tool = true,
 	.needs = true,
 	.mineable_pickaxe = true,
@@ -9316,6 +9373,7 @@ const mat_block_t mat_block_weathered_cut_copper_d = {
 const mat_block_t mat_block_weathered_cut_copper_slab_d = { 
 	.resistance = 6,
 	.hardness = 3,
+	.random_ticks = true,
 	.transparent = true,
 	.modifiers_count = 2,
 	.modifiers = {
@@ -9331,6 +9389,7 @@ const mat_block_t mat_block_weathered_cut_copper_slab_d = {
 const mat_block_t mat_block_weathered_cut_copper_stairs_d = { 
 	.resistance = 6,
 	.hardness = 3,
+	.random_ticks = true,
 	.transparent = true,
 	.modifiers_count = 4,
 	.modifiers = {
@@ -9347,6 +9406,7 @@ const mat_block_t mat_block_weathered_cut_copper_stairs_d = {
 const mat_block_t mat_block_weeping_vines_d = { 
 	.resistance = 0,
 	.hardness = 0,
+	.random_ticks = true,
 	.transparent = true,
 	.mineable_axe = true,
 	.mineable = true,
@@ -9365,6 +9425,7 @@ const mat_block_t mat_block_wet_sponge_d = {
 const mat_block_t mat_block_wheat_d = { 
 	.resistance = 0,
 	.hardness = 0,
+	.random_ticks = true,
 	.transparent = true,
 	.mineable_axe = true,
 	.mineable = true,
@@ -9688,6 +9749,7 @@ const mat_block_t mat_block_end_portal_d = {
 const mat_block_t mat_block_frosted_ice_d = {
 	.resistance = 0.5,
 	.hardness = 0.5,
+	.random_ticks = true,
 	.light_filtering = true,
 	.transparent = true,
 	.modifiers_count = 1,
@@ -9710,6 +9772,7 @@ const mat_block_t mat_block_piston_head_d = {
 const mat_block_t mat_block_nether_portal_d = {
 	.resistance = 0,
 	.hardness = -1,
+	.random_ticks = true,
 	.luminance = 11,
 	.transparent = true,
 	.modifiers_count = 1,
@@ -950,6 +950,7 @@ typedef struct {
 	bool needs : 1;
 	bool needs_wooden_tool : 1;
 	bool air : 1;
+	bool random_ticks : 1; // some state of the block gets random ticks
 
 	// vanilla tags
 	bool mineable_axe : 1;
@@ -1115,62 +1116,113 @@ static inline mat_block_protocol_id_t mat_get_block_default_protocol_id_by_type(
 }
 
 /*
-Read the value of a state field of a block with certain protocol
+	Every block state has one word with its type, flags and the values of its state modifiers.
+	State modifiers of a block are packed in the order of their types, so a block's set of them
+	and a popcount tell where a value is
 */
-static inline uint8_t mat_get_block_state_value(mat_block_protocol_id_t block_protocol, mat_state_modifier_type_t field) {
 
-	mat_block_type_t block_id = mat_get_block_type_by_protocol_id(block_protocol);
-	mat_block_protocol_id_t block_state = block_protocol - mat_get_block_base_protocol_id_by_type(block_id);
-	const mat_block_t* block_data = mat_get_block_by_type(block_id);
+#define MAT_STATE_VALUE_BITS 5
+#define MAT_STATE_MAX_MODIFIERS 7
 
-	for (int32_t i = block_data->modifiers_count - 1; i >= 0; --i) {
+#define MAT_STATE_TYPE_SHIFT (MAT_STATE_VALUE_BITS * MAT_STATE_MAX_MODIFIERS)
+#define MAT_STATE_AIR ((uint64_t) 1 << 45)
+#define MAT_STATE_OPAQUE ((uint64_t) 1 << 46)
+#define MAT_STATE_RANDOM_TICKS ((uint64_t) 1 << 47)
+#define MAT_STATE_WATER ((uint64_t) 1 << 48)
+#define MAT_STATE_LAVA ((uint64_t) 1 << 49)
+#define MAT_STATE_LUMINANCE_SHIFT 50
 
-		if (block_data->modifiers[i] != field) {
+typedef uint64_t mat_block_state_t;
 
-			block_state /= mat_get_state_modifier_by_type(block_data->modifiers[i])->count;
+typedef struct {
 
-		} else {
+	// state modifiers of the block, a bit per type
+	uint64_t modifiers[(mat_state_modifier_count + 63) / 64];
 
-			return block_state % mat_get_state_modifier_by_type(field)->count;
+	// protocol ids between values of each state modifier
+	uint16_t strides[MAT_STATE_MAX_MODIFIERS];
 
-		}
+} mat_block_properties_t;
 
-	}
+extern mat_block_state_t* mat_block_states;
+extern mat_block_properties_t mat_block_properties[mat_block_count];
+
+/*
+Build the block state tables, before anything looks at block states
+*/
+extern void mat_init_block_states();
 
-	return 0;
+extern uint32_t mat_get_block_state_count();
 
+static inline mat_block_state_t mat_get_block_state(mat_block_protocol_id_t block_protocol) {
+	return mat_block_states[block_protocol];
 }
 
-/*
-Set a state field for a particular block
-*/
-static inline mat_block_protocol_id_t mat_set_block_state_value(mat_block_protocol_id_t block_protocol, mat_state_modifier_type_t field, uint8_t value) {
+static inline bool mat_is_block_air(mat_block_protocol_id_t block_protocol) {
+	return mat_block_states[block_protocol] & MAT_STATE_AIR;
+}
 
-	mat_block_type_t block_id = mat_get_block_type_by_protocol_id(block_protocol);
-	mat_block_protocol_id_t block_state = block_protocol - mat_get_block_base_protocol_id_by_type(block_id);
-	int32_t state_add = 1;
-	const mat_block_t* block_data = mat_get_block_by_type(block_id);
+static inline bool mat_is_block_opaque(mat_block_protocol_id_t block_protocol) {
+	return mat_block_states[block_protocol] & MAT_STATE_OPAQUE;
+}
 
-	for (int32_t i = block_data->modifiers_count - 1; i >= 0; --i) {
+static inline bool mat_block_gets_random_ticks(mat_block_protocol_id_t block_protocol) {
+	return mat_block_states[block_protocol] & MAT_STATE_RANDOM_TICKS;
+}
 
-		const mat_state_modifier_t* modifier = mat_get_state_modifier_by_type(block_data->modifiers[i]);
+static inline uint8_t mat_get_block_luminance(mat_block_protocol_id_t block_protocol) {
+	return (mat_block_states[block_protocol] >> MAT_STATE_LUMINANCE_SHIFT) & 0xF;
+}
 
-		if (block_data->modifiers[i] != field) {
+// position of a state modifier in a state word, -1 if the block doesn't have it
+static inline int32_t mat_get_block_state_slot(mat_block_type_t type, mat_state_modifier_type_t field) {
 
-			block_state /= modifier->count;
-			state_add *= modifier->count;
+	const uint64_t* modifiers = mat_block_properties[type].modifiers;
 
-		} else {
+	if (!(modifiers[field >> 6] & ((uint64_t) 1 << (field & 0x3F)))) {
+		return -1;
+	}
 
-			block_state %= modifier->count;
-			state_add *= (int32_t) value - block_state;
+	int32_t slot = __builtin_popcountll(modifiers[field >> 6] & (((uint64_t) 1 << (field & 0x3F)) - 1));
+	for (uint32_t i = 0; i < (uint32_t) field >> 6; ++i) {
+		slot += __builtin_popcountll(modifiers[i]);
+	}
 
-			return block_protocol + state_add;
+	return slot;
 
-		}
+}
 
+/*
+Read the value of a state field of a block with certain protocol
+*/
+static inline uint8_t mat_get_block_state_value(mat_block_protocol_id_t block_protocol, mat_state_modifier_type_t field) {
+
+	const mat_block_state_t state = mat_block_states[block_protocol];
+	const int32_t slot = mat_get_block_state_slot(state >> MAT_STATE_TYPE_SHIFT & 0x3FF, field);
+
+	if (slot < 0) {
+		return 0;
+	}
+
+	return (state >> (slot * MAT_STATE_VALUE_BITS)) & ((1 << MAT_STATE_VALUE_BITS) - 1);
+
+}
+
+/*
+Set a state field for a particular block
+*/
+static inline mat_block_protocol_id_t mat_set_block_state_value(mat_block_protocol_id_t block_protocol, mat_state_modifier_type_t field, uint8_t value) {
+
+	const mat_block_state_t state = mat_block_states[block_protocol];
+	const mat_block_type_t type = state >> MAT_STATE_TYPE_SHIFT & 0x3FF;
+	const int32_t slot = mat_get_block_state_slot(type, field);
+
+	if (slot < 0) {
+		return block_protocol;
 	}
 
-	return block_protocol;
+	const int32_t old_value = (state >> (slot * MAT_STATE_VALUE_BITS)) & ((1 << MAT_STATE_VALUE_BITS) - 1);
 
-}
\ No newline at end of file
+	return block_protocol + ((int32_t) value - old_value) * mat_block_properties[type].strides[slot];
+
+}
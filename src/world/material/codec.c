@@ -2,6 +2,7 @@
 #include "../../util/str_util.h"
 #include "../../main.h"
 #include "../../io/nbt/mnbt.h"
+#include "../../io/logger/logger.h"
 #include "codec.h"
 #include "biomes.h"
 
@@ -180,32 +181,51 @@ const mat_codec_t* mat_get_dimension_codec(mat_dimension_type_t type) {
 
 	if (mat_dimension_codec[type] == NULL) {
 		const mat_dimension_t* dimension = mat_get_dimension_by_type(type);
-		mnbt_doc* doc = mnbt_new();
-		mnbt_tag* element = mnbt_new_tag(doc, UTL_CSTRTOARG(""), MNBT_COMPOUND, mnbt_val_compound());
-		mnbt_push_tag(element, mnbt_new_tag(doc, UTL_CSTRTOARG("piglin_safe"), MNBT_BYTE, mnbt_val_byte(dimension->piglin_safe)));
-		mnbt_push_tag(element, mnbt_new_tag(doc, UTL_CSTRTOARG("natural"), MNBT_BYTE, mnbt_val_byte(dimension->natural)));
-		mnbt_push_tag(element, mnbt_new_tag(doc, UTL_CSTRTOARG("ambient_light"), MNBT_FLOAT, mnbt_val_float(dimension->ambient_light)));
+		mat_dimension_codec[type] = malloc(sizeof(mat_codec_t) + 1024);
+
+		mnbt_writer nbt = mnbt_new_writer(mat_dimension_codec[type]->bytes, 1024);
+		mnbt_writer_tag(&nbt, MNBT_COMPOUND, UTL_CSTRTOARG(""));
+		mnbt_writer_tag(&nbt, MNBT_BYTE, UTL_CSTRTOARG("piglin_safe"));
+		mnbt_writer_byte(&nbt, dimension->piglin_safe);
+		mnbt_writer_tag(&nbt, MNBT_BYTE, UTL_CSTRTOARG("natural"));
+		mnbt_writer_byte(&nbt, dimension->natural);
+		mnbt_writer_tag(&nbt, MNBT_FLOAT, UTL_CSTRTOARG("ambient_light"));
+		mnbt_writer_float(&nbt, dimension->ambient_light);
 		if (dimension->has_fixed_time) {
-			mnbt_push_tag(element, mnbt_new_tag(doc, UTL_CSTRTOARG("fixed_time"), MNBT_LONG, mnbt_val_long(dimension->fixed_time)));
+			mnbt_writer_tag(&nbt, MNBT_LONG, UTL_CSTRTOARG("fixed_time"));
+			mnbt_writer_long(&nbt, dimension->fixed_time);
+		}
+		mnbt_writer_tag(&nbt, MNBT_STRING, UTL_CSTRTOARG("infiniburn"));
+		mnbt_writer_string(&nbt, "", 0);
+		mnbt_writer_tag(&nbt, MNBT_BYTE, UTL_CSTRTOARG("respawn_anchor_works"));
+		mnbt_writer_byte(&nbt, dimension->respawn_anchor_works);
+		mnbt_writer_tag(&nbt, MNBT_BYTE, UTL_CSTRTOARG("has_skylight"));
+		mnbt_writer_byte(&nbt, dimension->has_skylight);
+		mnbt_writer_tag(&nbt, MNBT_BYTE, UTL_CSTRTOARG("bed_works"));
+		mnbt_writer_byte(&nbt, dimension->bed_works);
+		mnbt_writer_tag(&nbt, MNBT_STRING, UTL_CSTRTOARG("effects"));
+		mnbt_writer_string(&nbt, UTL_STRTOARG(dimension->effects));
+		mnbt_writer_tag(&nbt, MNBT_BYTE, UTL_CSTRTOARG("has_raids"));
+		mnbt_writer_byte(&nbt, dimension->has_raids);
+		mnbt_writer_tag(&nbt, MNBT_INT, UTL_CSTRTOARG("min_y"));
+		mnbt_writer_int(&nbt, dimension->min_y);
+		mnbt_writer_tag(&nbt, MNBT_INT, UTL_CSTRTOARG("height"));
+		mnbt_writer_int(&nbt, dimension->height);
+		mnbt_writer_tag(&nbt, MNBT_INT, UTL_CSTRTOARG("logical_height"));
+		mnbt_writer_int(&nbt, dimension->logical_height);
+		mnbt_writer_tag(&nbt, MNBT_FLOAT, UTL_CSTRTOARG("coordinate_scale"));
+		mnbt_writer_float(&nbt, dimension->coordinate_scale);
+		mnbt_writer_tag(&nbt, MNBT_BYTE, UTL_CSTRTOARG("ultrawarm"));
+		mnbt_writer_byte(&nbt, dimension->ultrawarm);
+		mnbt_writer_tag(&nbt, MNBT_BYTE, UTL_CSTRTOARG("has_ceiling"));
+		mnbt_writer_byte(&nbt, dimension->has_ceiling);
+		mnbt_writer_end(&nbt);
+
+		if (nbt.overflow) {
+			log_error("Dimension codec does not fit in 1024 bytes");
 		}
-		mnbt_push_tag(element, mnbt_new_tag(doc, UTL_CSTRTOARG("infiniburn"), MNBT_STRING, mnbt_val_string("", 0)));
-		mnbt_push_tag(element, mnbt_new_tag(doc, UTL_CSTRTOARG("respawn_anchor_works"), MNBT_BYTE, mnbt_val_byte(dimension->respawn_anchor_works)));
-		mnbt_push_tag(element, mnbt_new_tag(doc, UTL_CSTRTOARG("has_skylight"), MNBT_BYTE, mnbt_val_byte(dimension->has_skylight)));
-		mnbt_push_tag(element, mnbt_new_tag(doc, UTL_CSTRTOARG("bed_works"), MNBT_BYTE, mnbt_val_byte(dimension->bed_works)));
-		mnbt_push_tag(element, mnbt_new_tag(doc, UTL_CSTRTOARG("effects"), MNBT_STRING, mnbt_val_string(UTL_STRTOARG(dimension->effects))));
-		mnbt_push_tag(element, mnbt_new_tag(doc, UTL_CSTRTOARG("has_raids"), MNBT_BYTE, mnbt_val_byte(dimension->has_raids)));
-		mnbt_push_tag(element, mnbt_new_tag(doc, UTL_CSTRTOARG("min_y"), MNBT_INT, mnbt_val_int(dimension->min_y)));
-		mnbt_push_tag(element, mnbt_new_tag(doc, UTL_CSTRTOARG("height"), MNBT_INT, mnbt_val_int(dimension->height)));
-		mnbt_push_tag(element, mnbt_new_tag(doc, UTL_CSTRTOARG("logical_height"), MNBT_INT, mnbt_val_int(dimension->logical_height)));
-		mnbt_push_tag(element, mnbt_new_tag(doc, UTL_CSTRTOARG("coordinate_scale"), MNBT_FLOAT, mnbt_val_float(dimension->coordinate_scale)));
-		mnbt_push_tag(element, mnbt_new_tag(doc, UTL_CSTRTOARG("ultrawarm"), MNBT_BYTE, mnbt_val_byte(dimension->ultrawarm)));
-		mnbt_push_tag(element, mnbt_new_tag(doc, UTL_CSTRTOARG("has_ceiling"), MNBT_BYTE, mnbt_val_byte(dimension->has_ceiling)));
-		mnbt_set_root(doc, element);
-
-		mat_dimension_codec[type] = malloc(sizeof(mat_codec_t) + 1024);
-		mat_dimension_codec[type]->size = mnbt_write(doc, mat_dimension_codec[type]->bytes, MNBT_NONE);
 
-		mnbt_free(doc);
+		mat_dimension_codec[type]->size = nbt.length;
 
 		mat_dimension_codec[type] = realloc(mat_dimension_codec[type], sizeof(mat_codec_t) + mat_dimension_codec[type]->size);
 
@@ -7,4 +7,5 @@
 #include "dimensions.h"
 #include "items.h"
 #include "state_modifiers.h"
+#include "tools.h"
 #include "tags/tags.h"
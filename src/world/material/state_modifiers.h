@@ -466,6 +466,8 @@ typedef enum {
 		// full
 	mat_state_modifier_dripleaf_tilt,
 
+	mat_state_modifier_count
+
 } mat_state_modifier_type_t;
 
 typedef struct {
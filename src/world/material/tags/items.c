@@ -1020,6 +1020,150 @@ const mat_tag_t mat_item_tag_terracotta_d = MAT_TAG_INITIALIZER(
 	MAT_ITEM_TAG_TERRACOTTA
 );
 
+const mat_tag_t mat_item_tag_tool_d = MAT_TAG_INITIALIZER(
+	UTL_CSTRTOSTR("motor:tool"),
+	mat_item_wooden_axe,
+	mat_item_stone_axe,
+	mat_item_golden_axe,
+	mat_item_iron_axe,
+	mat_item_diamond_axe,
+	mat_item_netherite_axe,
+	mat_item_wooden_hoe,
+	mat_item_stone_hoe,
+	mat_item_golden_hoe,
+	mat_item_iron_hoe,
+	mat_item_diamond_hoe,
+	mat_item_netherite_hoe,
+	mat_item_wooden_pickaxe,
+	mat_item_stone_pickaxe,
+	mat_item_golden_pickaxe,
+	mat_item_iron_pickaxe,
+	mat_item_diamond_pickaxe,
+	mat_item_netherite_pickaxe,
+	mat_item_wooden_shovel,
+	mat_item_stone_shovel,
+	mat_item_golden_shovel,
+	mat_item_iron_shovel,
+	mat_item_diamond_shovel,
+	mat_item_netherite_shovel
+);
+
+const mat_tag_t mat_item_tag_tool_axe_d = MAT_TAG_INITIALIZER(
+	UTL_CSTRTOSTR("motor:tool_axe"),
+	mat_item_wooden_axe,
+	mat_item_stone_axe,
+	mat_item_golden_axe,
+	mat_item_iron_axe,
+	mat_item_diamond_axe,
+	mat_item_netherite_axe
+);
+
+const mat_tag_t mat_item_tag_tool_hoe_d = MAT_TAG_INITIALIZER(
+	UTL_CSTRTOSTR("motor:tool_hoe"),
+	mat_item_wooden_hoe,
+	mat_item_stone_hoe,
+	mat_item_golden_hoe,
+	mat_item_iron_hoe,
+	mat_item_diamond_hoe,
+	mat_item_netherite_hoe
+);
+
+const mat_tag_t mat_item_tag_tool_pickaxe_d = MAT_TAG_INITIALIZER(
+	UTL_CSTRTOSTR("motor:tool_pickaxe"),
+	mat_item_wooden_pickaxe,
+	mat_item_stone_pickaxe,
+	mat_item_golden_pickaxe,
+	mat_item_iron_pickaxe,
+	mat_item_diamond_pickaxe,
+	mat_item_netherite_pickaxe
+);
+
+const mat_tag_t mat_item_tag_tool_shovel_d = MAT_TAG_INITIALIZER(
+	UTL_CSTRTOSTR("motor:tool_shovel"),
+	mat_item_wooden_shovel,
+	mat_item_stone_shovel,
+	mat_item_golden_shovel,
+	mat_item_iron_shovel,
+	mat_item_diamond_shovel,
+	mat_item_netherite_shovel
+);
+
+const mat_tag_t mat_item_tag_least_wooden_tool_d = MAT_TAG_INITIALIZER(
+	UTL_CSTRTOSTR("motor:least_wooden_tool"),
+	mat_item_wooden_axe,
+	mat_item_stone_axe,
+	mat_item_golden_axe,
+	mat_item_iron_axe,
+	mat_item_diamond_axe,
+	mat_item_netherite_axe,
+	mat_item_wooden_hoe,
+	mat_item_stone_hoe,
+	mat_item_golden_hoe,
+	mat_item_iron_hoe,
+	mat_item_diamond_hoe,
+	mat_item_netherite_hoe,
+	mat_item_wooden_pickaxe,
+	mat_item_stone_pickaxe,
+	mat_item_golden_pickaxe,
+	mat_item_iron_pickaxe,
+	mat_item_diamond_pickaxe,
+	mat_item_netherite_pickaxe,
+	mat_item_wooden_shovel,
+	mat_item_stone_shovel,
+	mat_item_golden_shovel,
+	mat_item_iron_shovel,
+	mat_item_diamond_shovel,
+	mat_item_netherite_shovel
+);
+
+const mat_tag_t mat_item_tag_least_stone_tool_d = MAT_TAG_INITIALIZER(
+	UTL_CSTRTOSTR("motor:least_stone_tool"),
+	mat_item_stone_axe,
+	mat_item_iron_axe,
+	mat_item_diamond_axe,
+	mat_item_netherite_axe,
+	mat_item_stone_hoe,
+	mat_item_iron_hoe,
+	mat_item_diamond_hoe,
+	mat_item_netherite_hoe,
+	mat_item_stone_pickaxe,
+	mat_item_iron_pickaxe,
+	mat_item_diamond_pickaxe,
+	mat_item_netherite_pickaxe,
+	mat_item_stone_shovel,
+	mat_item_iron_shovel,
+	mat_item_diamond_shovel,
+	mat_item_netherite_shovel
+);
+
+const mat_tag_t mat_item_tag_least_iron_tool_d = MAT_TAG_INITIALIZER(
+	UTL_CSTRTOSTR("motor:least_iron_tool"),
+	mat_item_iron_axe,
+	mat_item_diamond_axe,
+	mat_item_netherite_axe,
+	mat_item_iron_hoe,
+	mat_item_diamond_hoe,
+	mat_item_netherite_hoe,
+	mat_item_iron_pickaxe,
+	mat_item_diamond_pickaxe,
+	mat_item_netherite_pickaxe,
+	mat_item_iron_shovel,
+	mat_item_diamond_shovel,
+	mat_item_netherite_shovel
+);
+
+const mat_tag_t mat_item_tag_least_diamond_tool_d = MAT_TAG_INITIALIZER(
+	UTL_CSTRTOSTR("motor:least_diamond_tool"),
+	mat_item_diamond_axe,
+	mat_item_netherite_axe,
+	mat_item_diamond_hoe,
+	mat_item_netherite_hoe,
+	mat_item_diamond_pickaxe,
+	mat_item_netherite_pickaxe,
+	mat_item_diamond_shovel,
+	mat_item_netherite_shovel
+);
+
 const mat_tag_t* mat_item_tags[] = {
 
 	&mat_item_tag_banners_d,
@@ -1093,4 +1237,13 @@ const mat_tag_t* mat_item_tags[] = {
 	&mat_item_tag_cluster_max_harvestables_d,
 	&mat_item_tag_dirt_d,
 	&mat_item_tag_terracotta_d,
+	&mat_item_tag_tool_d,
+	&mat_item_tag_tool_axe_d,
+	&mat_item_tag_tool_hoe_d,
+	&mat_item_tag_tool_pickaxe_d,
+	&mat_item_tag_tool_shovel_d,
+	&mat_item_tag_least_wooden_tool_d,
+	&mat_item_tag_least_stone_tool_d,
+	&mat_item_tag_least_iron_tool_d,
+	&mat_item_tag_least_diamond_tool_d,
 };
\ No newline at end of file
@@ -0,0 +1,24 @@
+#include "tags.h"
+
+uint64_t mat_block_tag_bits[mat_block_tag_count][MAT_BLOCK_TAG_WORDS];
+uint64_t mat_item_tag_bits[mat_item_tag_count][MAT_ITEM_TAG_WORDS];
+
+static void mat_fill_tag_bits(const mat_tag_t* tag, uint64_t* bits) {
+
+	for (int32_t i = 0; i < tag->count; ++i) {
+		bits[tag->entries[i] >> 6] |= (uint64_t) 1 << (tag->entries[i] & 0x3F);
+	}
+
+}
+
+void mat_init_tags() {
+
+	for (uint32_t i = 0; i < mat_block_tag_count; ++i) {
+		mat_fill_tag_bits(mat_block_tags[i], mat_block_tag_bits[i]);
+	}
+
+	for (uint32_t i = 0; i < mat_item_tag_count; ++i) {
+		mat_fill_tag_bits(mat_item_tags[i], mat_item_tag_bits[i]);
+	}
+
+}
@@ -1,5 +1,7 @@
 #pragma once
 #include "../../../main.h"
+#include "../blocks.h"
+#include "../items.h"
 
 typedef struct {
 
@@ -95,6 +97,15 @@ typedef enum {
 	mat_item_tag_cluster_max_harvestables,
 	mat_item_tag_dirt,
 	mat_item_tag_terracotta,
+	mat_item_tag_tool,
+	mat_item_tag_tool_axe,
+	mat_item_tag_tool_hoe,
+	mat_item_tag_tool_pickaxe,
+	mat_item_tag_tool_shovel,
+	mat_item_tag_least_wooden_tool,
+	mat_item_tag_least_stone_tool,
+	mat_item_tag_least_iron_tool,
+	mat_item_tag_least_diamond_tool,
 	
 	mat_item_tag_count
 
@@ -278,4 +289,28 @@ typedef enum {
 
 } mat_entity_type_tag_t;
 
-extern const mat_tag_t* mat_entity_type_tags[];
\ No newline at end of file
+extern const mat_tag_t* mat_entity_type_tags[];
+
+/*
+	Tags are also kept as bitsets by block or item type, so checking if something is in a tag
+	is a single bit test and whole words of types can be checked at once
+*/
+
+#define MAT_BLOCK_TAG_WORDS ((mat_block_count + 63) / 64)
+#define MAT_ITEM_TAG_WORDS ((mat_item_count + 63) / 64)
+
+extern uint64_t mat_block_tag_bits[mat_block_tag_count][MAT_BLOCK_TAG_WORDS];
+extern uint64_t mat_item_tag_bits[mat_item_tag_count][MAT_ITEM_TAG_WORDS];
+
+/*
+Build the tag bitsets from the tag lists
+*/
+extern void mat_init_tags();
+
+static inline bool mat_block_has_tag(mat_block_type_t block, mat_block_tag_t tag) {
+	return (mat_block_tag_bits[tag][block >> 6] >> (block & 0x3F)) & 1;
+}
+
+static inline bool mat_item_has_tag(mat_item_type_t item, mat_item_tag_t tag) {
+	return (mat_item_tag_bits[tag][item >> 6] >> (item & 0x3F)) & 1;
+}
@@ -0,0 +1,148 @@
+#include <assert.h>
+#include "tools.h"
+#include "tags/tags.h"
+#include "../../util/util.h"
+
+const float32_t mat_tool_speeds[mat_tool_tier_count] = {
+	[mat_tool_tier_none] = 1,
+	[mat_tool_tier_wooden] = 2,
+	[mat_tool_tier_golden] = 12,
+	[mat_tool_tier_stone] = 4,
+	[mat_tool_tier_iron] = 6,
+	[mat_tool_tier_diamond] = 8,
+	[mat_tool_tier_netherite] = 9
+};
+
+const uint8_t mat_tool_levels[mat_tool_tier_count] = {
+	[mat_tool_tier_none] = 0,
+	[mat_tool_tier_wooden] = 0,
+	[mat_tool_tier_golden] = 0,
+	[mat_tool_tier_stone] = 1,
+	[mat_tool_tier_iron] = 2,
+	[mat_tool_tier_diamond] = 3,
+	[mat_tool_tier_netherite] = 4
+};
+
+mat_tool_t mat_item_tools[mat_item_count];
+mat_block_dig_t mat_block_digs[mat_block_count];
+
+// every distinct hardness, blocks share a few dozen
+static float32_t mat_hardnesses[256];
+static uint32_t mat_hardness_count = 0;
+
+// ticks to dig with a multiplier of 1 and no efficiency, by hardness, tier of the tool used and if it drops
+static uint16_t mat_dig_ticks[256][mat_tool_tier_count][2];
+
+static const struct {
+
+	mat_tool_tier_t tier;
+	mat_item_type_t items[4];
+
+} mat_tiers[] = {
+	{ mat_tool_tier_wooden, { mat_item_wooden_axe, mat_item_wooden_hoe, mat_item_wooden_pickaxe, mat_item_wooden_shovel } },
+	{ mat_tool_tier_golden, { mat_item_golden_axe, mat_item_golden_hoe, mat_item_golden_pickaxe, mat_item_golden_shovel } },
+	{ mat_tool_tier_stone, { mat_item_stone_axe, mat_item_stone_hoe, mat_item_stone_pickaxe, mat_item_stone_shovel } },
+	{ mat_tool_tier_iron, { mat_item_iron_axe, mat_item_iron_hoe, mat_item_iron_pickaxe, mat_item_iron_shovel } },
+	{ mat_tool_tier_diamond, { mat_item_diamond_axe, mat_item_diamond_hoe, mat_item_diamond_pickaxe, mat_item_diamond_shovel } },
+	{ mat_tool_tier_netherite, { mat_item_netherite_axe, mat_item_netherite_hoe, mat_item_netherite_pickaxe, mat_item_netherite_shovel } }
+};
+
+static uint16_t mat_compute_dig_ticks(float32_t hardness, float32_t speed, bool harvest) {
+
+	if (hardness < 0) {
+		return MAT_DIG_UNBREAKABLE;
+	}
+
+	// hardnesses like 0.8 aren't exact as floats and would be a tick off
+	const float64_t exact = (int64_t) (hardness * 1000 + 0.5) / 1000.0;
+	const float64_t ticks = exact * (harvest ? 30 : 100) / speed;
+
+	// breaks in the first tick
+	if (ticks <= 1) {
+		return 0;
+	}
+
+	return UTL_MIN(utl_int_ceil(ticks - ticks * 1e-6), MAT_DIG_UNBREAKABLE - 1);
+
+}
+
+static inline uint8_t mat_get_hardness_class(float32_t hardness) {
+
+	for (uint32_t i = 0; i < mat_hardness_count; ++i) {
+		if (mat_hardnesses[i] == hardness) {
+			return i;
+		}
+	}
+
+	assert(mat_hardness_count < 256);
+
+	mat_hardnesses[mat_hardness_count] = hardness;
+	return mat_hardness_count++;
+
+}
+
+void mat_init_tools() {
+
+	for (uint32_t i = 0; i < sizeof(mat_tiers) / sizeof(mat_tiers[0]); ++i) {
+		for (uint32_t j = 0; j < 4; ++j) {
+			const mat_item_type_t item = mat_tiers[i].items[j];
+			mat_item_tools[item] = (mat_tool_t) {
+				.kinds = (mat_item_has_tag(item, mat_item_tag_tool_axe) ? MAT_TOOL_AXE : 0) |
+					(mat_item_has_tag(item, mat_item_tag_tool_hoe) ? MAT_TOOL_HOE : 0) |
+					(mat_item_has_tag(item, mat_item_tag_tool_pickaxe) ? MAT_TOOL_PICKAXE : 0) |
+					(mat_item_has_tag(item, mat_item_tag_tool_shovel) ? MAT_TOOL_SHOVEL : 0),
+				.tier = mat_tiers[i].tier
+			};
+		}
+	}
+
+	for (uint32_t block = 0; block < mat_block_count; ++block) {
+
+		uint8_t level = 0;
+		if (mat_block_has_tag(block, mat_block_tag_needs_diamond_tool)) {
+			level = mat_tool_levels[mat_tool_tier_diamond];
+		} else if (mat_block_has_tag(block, mat_block_tag_needs_iron_tool)) {
+			level = mat_tool_levels[mat_tool_tier_iron];
+		} else if (mat_block_has_tag(block, mat_block_tag_needs_stone_tool)) {
+			level = mat_tool_levels[mat_tool_tier_stone];
+		}
+
+		mat_block_digs[block] = (mat_block_dig_t) {
+			.hardness = mat_get_hardness_class(mat_get_block_by_type(block)->hardness),
+			.kinds = (mat_block_has_tag(block, mat_block_tag_mineable_axe) ? MAT_TOOL_AXE : 0) |
+				(mat_block_has_tag(block, mat_block_tag_mineable_hoe) ? MAT_TOOL_HOE : 0) |
+				(mat_block_has_tag(block, mat_block_tag_mineable_pickaxe) ? MAT_TOOL_PICKAXE : 0) |
+				(mat_block_has_tag(block, mat_block_tag_mineable_shovel) ? MAT_TOOL_SHOVEL : 0),
+			.needs_tool = mat_block_has_tag(block, mat_block_tag_needs),
+			.level = level
+		};
+
+	}
+
+	for (uint32_t i = 0; i < mat_hardness_count; ++i) {
+		for (uint32_t tier = 0; tier < mat_tool_tier_count; ++tier) {
+			mat_dig_ticks[i][tier][false] = mat_compute_dig_ticks(mat_hardnesses[i], mat_tool_speeds[tier], false);
+			mat_dig_ticks[i][tier][true] = mat_compute_dig_ticks(mat_hardnesses[i], mat_tool_speeds[tier], true);
+		}
+	}
+
+}
+
+uint16_t mat_get_dig_ticks(mat_block_type_t block, mat_tool_t tool, float32_t multiplier) {
+
+	const mat_block_dig_t dig = mat_block_digs[block];
+	const bool best = dig.kinds & tool.kinds;
+	const bool harvest = mat_can_harvest(block, tool);
+
+	if (multiplier == 1 && (!best || tool.efficiency == 0)) {
+		return mat_dig_ticks[dig.hardness][best ? tool.tier : mat_tool_tier_none][harvest];
+	}
+
+	float32_t speed = best ? mat_tool_speeds[tool.tier] : 1;
+	if (best && tool.efficiency != 0) {
+		speed += tool.efficiency * tool.efficiency + 1;
+	}
+
+	return mat_compute_dig_ticks(mat_hardnesses[dig.hardness], speed * multiplier, harvest);
+
+}
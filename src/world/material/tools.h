@@ -0,0 +1,89 @@
+#pragma once
+#include "../../main.h"
+#include "blocks.h"
+#include "items.h"
+
+/*
+	TOOLS
+	Dig times by tool, kept in a table by hardness class, tool tier and whether the block drops
+	anything. Only dig speed multipliers that aren't 1, like digging in the air, need the formula
+*/
+
+#define MAT_TOOL_AXE 0x1
+#define MAT_TOOL_HOE 0x2
+#define MAT_TOOL_PICKAXE 0x4
+#define MAT_TOOL_SHOVEL 0x8
+
+// blocks no tool can break
+#define MAT_DIG_UNBREAKABLE UINT16_MAX
+
+typedef enum {
+
+	mat_tool_tier_none,
+	mat_tool_tier_wooden,
+	mat_tool_tier_golden,
+	mat_tool_tier_stone,
+	mat_tool_tier_iron,
+	mat_tool_tier_diamond,
+	mat_tool_tier_netherite,
+
+	mat_tool_tier_count
+
+} mat_tool_tier_t;
+
+typedef struct {
+
+	uint8_t kinds : 4;
+	mat_tool_tier_t tier : 3;
+
+	// efficiency level
+	uint8_t efficiency : 3;
+
+} mat_tool_t;
+
+typedef struct {
+
+	// index into the hardnesses
+	uint8_t hardness;
+
+	// tools that dig it faster
+	uint8_t kinds : 4;
+
+	// needs one of those tools at this harvest level or more to drop anything
+	bool needs_tool : 1;
+	uint8_t level : 3;
+
+} mat_block_dig_t;
+
+extern const float32_t mat_tool_speeds[mat_tool_tier_count];
+extern const uint8_t mat_tool_levels[mat_tool_tier_count];
+
+extern mat_tool_t mat_item_tools[mat_item_count];
+extern mat_block_dig_t mat_block_digs[mat_block_count];
+
+/*
+Build the dig tables, needs the tag bitsets
+*/
+extern void mat_init_tools();
+
+static inline mat_tool_t mat_get_item_tool(mat_item_type_t item) {
+	return mat_item_tools[item];
+}
+
+static inline bool mat_is_best_tool(mat_block_type_t block, mat_tool_t tool) {
+	return mat_block_digs[block].kinds & tool.kinds;
+}
+
+static inline bool mat_can_harvest(mat_block_type_t block, mat_tool_t tool) {
+
+	const mat_block_dig_t dig = mat_block_digs[block];
+
+	return !dig.needs_tool || ((dig.kinds & tool.kinds) && mat_tool_levels[tool.tier] >= dig.level);
+
+}
+
+/*
+Ticks it takes to dig a block, 0 for instantly and MAT_DIG_UNBREAKABLE for never
+The multiplier takes what isn't the tool into account, 1 on the ground and out of water
+*/
+extern uint16_t mat_get_dig_ticks(mat_block_type_t block, mat_tool_t tool, float32_t multiplier);
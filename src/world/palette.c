@@ -0,0 +1,85 @@
+#include "palette.h"
+#include <string.h>
+
+#ifdef __SSE2__
+#include <immintrin.h>
+#endif
+
+// open addressing table from state to palette index, twice the palette size keeps probes short
+#define WLD_PALETTE_SLOTS 512
+#define WLD_PALETTE_EMPTY 0xFFFF
+
+static inline uint16_t wld_palette_hash(mat_block_protocol_id_t block) {
+	return ((uint32_t) block * 2654435761u) >> 23;
+}
+
+/*
+Length of the run of `block` starting at blocks[i], stops at `end`
+*/
+static inline uint16_t wld_palette_run(const mat_block_protocol_id_t* blocks, uint16_t i, uint16_t end, mat_block_protocol_id_t block) {
+
+	uint16_t j = i;
+
+#ifdef __SSE2__
+	const __m128i match = _mm_set1_epi16(block);
+	while (j + 8 <= end) {
+		const uint32_t equal = _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_loadu_si128((const __m128i*) (blocks + j)), match));
+		if (equal != 0xFFFF) {
+			return j - i + (__builtin_ctz(~equal) >> 1);
+		}
+		j += 8;
+	}
+#endif
+
+	while (j < end && blocks[j] == block) {
+		j++;
+	}
+
+	return j - i;
+
+}
+
+bool wld_palettize(const mat_block_protocol_id_t* blocks, wld_palette_t* palette) {
+
+	mat_block_protocol_id_t keys[WLD_PALETTE_SLOTS];
+	uint8_t values[WLD_PALETTE_SLOTS];
+	memset(keys, 0xFF, sizeof(keys));
+
+	palette->length = 0;
+
+	for (uint16_t i = 0; i < 4096;) {
+
+		const mat_block_protocol_id_t block = blocks[i];
+
+		// find or add the state
+		uint16_t slot = wld_palette_hash(block);
+		while (keys[slot] != block && keys[slot] != WLD_PALETTE_EMPTY) {
+			slot = (slot + 1) & (WLD_PALETTE_SLOTS - 1);
+		}
+		if (keys[slot] == WLD_PALETTE_EMPTY) {
+			if (palette->length == WLD_PALETTE_MAX) {
+				palette->length = 0;
+				palette->bits = WLD_PALETTE_DIRECT_BITS;
+				return false;
+			}
+			keys[slot] = block;
+			values[slot] = palette->length;
+			palette->entries[palette->length++] = block;
+		}
+
+		palette->indices[i++] = values[slot];
+
+		// sections are mostly long runs of the same state, translate them in one go
+		if (i < 4096 && blocks[i] == block) {
+			const uint16_t run = wld_palette_run(blocks, i, 4096, block);
+			memset(palette->indices + i, values[slot], run);
+			i += run;
+		}
+
+	}
+
+	palette->bits = wld_palette_bits(palette->length);
+
+	return true;
+
+}
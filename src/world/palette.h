@@ -0,0 +1,49 @@
+#pragma once
+#include "../main.h"
+#include "material/blocks.h"
+
+#define WLD_PALETTE_MAX 256
+#define WLD_PALETTE_DIRECT_BITS 15 // log2(block_state_count)
+
+/*
+The palette of a chunk section, shared by network encoding and saving
+*/
+typedef struct {
+
+	// 0 when the section has too many states and has to use the direct palette
+	uint16_t length;
+
+	// bits per block, 0 for a single state and WLD_PALETTE_DIRECT_BITS for the direct palette
+	uint8_t bits;
+
+	mat_block_protocol_id_t entries[WLD_PALETTE_MAX];
+
+	// index into entries for every block, only valid when length > 0
+	uint8_t indices[16 * 16 * 16];
+
+} wld_palette_t;
+
+/*
+Bits per block the protocol uses for a palette of `length` entries
+*/
+static inline uint8_t wld_palette_bits(uint16_t length) {
+
+	if (length == 0 || length > WLD_PALETTE_MAX) {
+		return WLD_PALETTE_DIRECT_BITS;
+	}
+
+	if (length == 1) {
+		return 0;
+	}
+
+	const uint8_t bits = 32 - __builtin_clz(length - 1);
+
+	return bits < 4 ? 4 : bits;
+
+}
+
+/*
+Build the palette of the 4096 blocks of a section
+Returns false if there are more than WLD_PALETTE_MAX states, palette->length is then 0
+*/
+extern bool wld_palettize(const mat_block_protocol_id_t* blocks, wld_palette_t* palette);
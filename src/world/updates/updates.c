@@ -0,0 +1,457 @@
+#include "updates.h"
+#include "../world.h"
+#include "../../util/lock_util.h"
+
+const upd_behavior_t* upd_behaviors[mat_block_count];
+
+// depth of the neighbor update being handled on this thread, 0 outside of one
+static __thread uint16_t upd_depth = 0;
+
+// random tick positions, same generator as vanilla
+static __thread uint32_t upd_random = 0x5DEECE66;
+
+// handled at a time with the region lock released
+#define UPD_BATCH 256
+
+// ticks that come up in chunks that aren't ticking try again this much later
+#define UPD_RETRY_DELAY 20
+
+static inline uint64_t upd_tick_key(int32_t x, int16_t y, int32_t z, mat_block_type_t block) {
+	// 0 marks an empty slot
+	return ((uint64_t) (x & 0x1FF) | (uint64_t) (z & 0x1FF) << 9 | (uint64_t) (uint16_t) y << 18 | (uint64_t) block << 34) + 1;
+}
+
+static inline uint32_t upd_key_home(const upd_region_t* updates, uint64_t key) {
+	return (uint32_t) ((key * 0x9E3779B97F4A7C15) >> 32) & updates->ticks.key_mask;
+}
+
+static void upd_put_key(upd_region_t* updates, uint64_t key) {
+
+	uint32_t i = upd_key_home(updates, key);
+	while (updates->ticks.keys[i] != 0) {
+		i = (i + 1) & updates->ticks.key_mask;
+	}
+
+	updates->ticks.keys[i] = key;
+
+}
+
+// returns false if the key is there already, the region lock has to be held
+static bool upd_add_key(upd_region_t* updates, uint64_t key) {
+
+	// keep the table at most half full
+	if ((updates->ticks.count + 1) * 2 > updates->ticks.key_mask) {
+
+		const uint64_t* keys = updates->ticks.keys;
+		const uint32_t capacity = updates->ticks.keys == NULL ? 0 : updates->ticks.key_mask + 1;
+
+		updates->ticks.key_mask = (capacity == 0 ? 64 : capacity * 2) - 1;
+		updates->ticks.keys = calloc(updates->ticks.key_mask + 1, sizeof(uint64_t));
+
+		for (uint32_t i = 0; i < capacity; ++i) {
+			if (keys[i] != 0) {
+				upd_put_key(updates, keys[i]);
+			}
+		}
+
+		free((void*) keys);
+
+	}
+
+	for (uint32_t i = upd_key_home(updates, key); updates->ticks.keys[i] != 0; i = (i + 1) & updates->ticks.key_mask) {
+		if (updates->ticks.keys[i] == key) {
+			return false;
+		}
+	}
+
+	upd_put_key(updates, key);
+
+	return true;
+
+}
+
+// the region lock has to be held
+static void upd_remove_key(upd_region_t* updates, uint64_t key) {
+
+	uint32_t i = upd_key_home(updates, key);
+	while (updates->ticks.keys[i] != key) {
+		if (updates->ticks.keys[i] == 0) {
+			return;
+		}
+		i = (i + 1) & updates->ticks.key_mask;
+	}
+
+	updates->ticks.keys[i] = 0;
+
+	// move back whatever probed past the hole
+	for (uint32_t j = (i + 1) & updates->ticks.key_mask; updates->ticks.keys[j] != 0; j = (j + 1) & updates->ticks.key_mask) {
+		const uint32_t home = upd_key_home(updates, updates->ticks.keys[j]);
+		if (i <= j ? (home <= i || home > j) : (home <= i && home > j)) {
+			updates->ticks.keys[i] = updates->ticks.keys[j];
+			updates->ticks.keys[j] = 0;
+			i = j;
+		}
+	}
+
+}
+
+static inline bool upd_before(const upd_tick_t* a, const upd_tick_t* b) {
+
+	if (a->due != b->due) {
+		return a->due < b->due;
+	}
+	if (a->priority != b->priority) {
+		return a->priority < b->priority;
+	}
+
+	return a->order < b->order;
+
+}
+
+// the region lock has to be held
+static void upd_push_tick(upd_region_t* updates, upd_tick_t tick) {
+
+	if (updates->ticks.count == updates->ticks.capacity) {
+		updates->ticks.capacity = updates->ticks.capacity == 0 ? 64 : updates->ticks.capacity * 2;
+		updates->ticks.heap = realloc(updates->ticks.heap, sizeof(upd_tick_t) * updates->ticks.capacity);
+	}
+
+	tick.order = updates->ticks.order++;
+
+	uint32_t i = updates->ticks.count++;
+	while (i > 0 && upd_before(&tick, &updates->ticks.heap[(i - 1) >> 1])) {
+		updates->ticks.heap[i] = updates->ticks.heap[(i - 1) >> 1];
+		i = (i - 1) >> 1;
+	}
+	updates->ticks.heap[i] = tick;
+
+}
+
+// the region lock has to be held
+static upd_tick_t upd_pop_tick(upd_region_t* updates) {
+
+	const upd_tick_t first = updates->ticks.heap[0];
+	const upd_tick_t last = updates->ticks.heap[--updates->ticks.count];
+
+	uint32_t i = 0;
+	for (;;) {
+		uint32_t child = (i << 1) + 1;
+		if (child >= updates->ticks.count) {
+			break;
+		}
+		if (child + 1 < updates->ticks.count && upd_before(&updates->ticks.heap[child + 1], &updates->ticks.heap[child])) {
+			child += 1;
+		}
+		if (!upd_before(&updates->ticks.heap[child], &last)) {
+			break;
+		}
+		updates->ticks.heap[i] = updates->ticks.heap[child];
+		i = child;
+	}
+	updates->ticks.heap[i] = last;
+
+	return first;
+
+}
+
+// loaded chunk holding a block column, updates never generate chunks
+static inline wld_chunk_t* upd_get_chunk(wld_chunk_t* chunk, int32_t x, int32_t z) {
+	return wld_find_relative_chunk(chunk, (x >> 4) - wld_get_chunk_x(chunk), (z >> 4) - wld_get_chunk_z(chunk));
+}
+
+// block in a chunk, -1 if y is out of the world
+static inline int32_t upd_get_block(wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z) {
+
+	const mat_dimension_type_t environment = wld_get_environment(wld_chunk_get_world(chunk));
+	const int16_t min_y = mat_get_dimension_by_type(environment)->min_y;
+
+	if (y < min_y || ((y - min_y) >> 4) >= mat_get_chunk_height(environment)) {
+		return -1;
+	}
+
+	return mat_get_block_type_by_protocol_id(wld_chunk_get_section(chunk, (y - min_y) >> 4)->blocks[((y & 0xF) << 8) | ((z & 0xF) << 4) | (x & 0xF)]);
+
+}
+
+void upd_schedule_tick(wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z, mat_block_type_t block, uint32_t delay, upd_priority_t priority) {
+
+	chunk = upd_get_chunk(chunk, x, z);
+	if (chunk == NULL) {
+		return;
+	}
+
+	wld_region_t* region = wld_chunk_get_region(chunk);
+	upd_region_t* updates = &region->updates;
+
+	// a tick never comes up in the tick it was scheduled in
+	const upd_tick_t tick = {
+		.due = wld_get_age(wld_region_get_world(region)) + (delay == 0 ? 1 : delay),
+		.x = x,
+		.y = y,
+		.z = z,
+		.block = block,
+		.priority = priority
+	};
+
+	with_lock (&updates->lock) {
+		if (upd_add_key(updates, upd_tick_key(x, y, z, block))) {
+			upd_push_tick(updates, tick);
+		}
+	}
+
+}
+
+void upd_update_neighbor(wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z, mat_block_type_t source) {
+
+	const uint16_t depth = upd_depth + 1;
+	if (depth > UPD_MAX_DEPTH) {
+		return;
+	}
+
+	chunk = upd_get_chunk(chunk, x, z);
+	if (chunk == NULL) {
+		return;
+	}
+
+	// most blocks don't care, keep them out of the queue
+	const int32_t block = upd_get_block(chunk, x, y, z);
+	if (block < 0 || upd_behaviors[block] == NULL || upd_behaviors[block]->neighbor_update == NULL) {
+		return;
+	}
+
+	upd_region_t* updates = &wld_chunk_get_region(chunk)->updates;
+
+	with_lock (&updates->lock) {
+
+		if (updates->neighbors.count == updates->neighbors.capacity) {
+
+			const uint32_t capacity = updates->neighbors.capacity == 0 ? 256 : updates->neighbors.capacity * 2;
+			upd_neighbor_t* queue = malloc(sizeof(upd_neighbor_t) * capacity);
+
+			// unwrap the ring while copying
+			for (uint32_t i = 0; i < updates->neighbors.count; ++i) {
+				queue[i] = updates->neighbors.queue[(updates->neighbors.first + i) & (updates->neighbors.capacity - 1)];
+			}
+
+			free(updates->neighbors.queue);
+			updates->neighbors.queue = queue;
+			updates->neighbors.first = 0;
+			updates->neighbors.capacity = capacity;
+
+		}
+
+		updates->neighbors.queue[(updates->neighbors.first + updates->neighbors.count++) & (updates->neighbors.capacity - 1)] = (upd_neighbor_t) {
+			.x = x,
+			.y = y,
+			.z = z,
+			.depth = depth,
+			.source = source
+		};
+
+	}
+
+}
+
+void upd_update_neighbors(wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z, mat_block_type_t source) {
+
+	// same order as vanilla
+	upd_update_neighbor(chunk, x - 1, y, z, source);
+	upd_update_neighbor(chunk, x + 1, y, z, source);
+	upd_update_neighbor(chunk, x, y - 1, z, source);
+	upd_update_neighbor(chunk, x, y + 1, z, source);
+	upd_update_neighbor(chunk, x, y, z - 1, source);
+	upd_update_neighbor(chunk, x, y, z + 1, source);
+
+}
+
+static uint32_t upd_run_ticks(wld_region_t* region, uint64_t now) {
+
+	upd_region_t* updates = &region->updates;
+	upd_tick_t batch[UPD_BATCH];
+	uint32_t ran = 0;
+
+	while (ran < UPD_TICKS_PER_TICK) {
+
+		uint32_t count = 0;
+
+		with_lock (&updates->lock) {
+			while (count < UPD_BATCH && updates->ticks.count != 0 && updates->ticks.heap[0].due <= now) {
+				batch[count] = upd_pop_tick(updates);
+				upd_remove_key(updates, upd_tick_key(batch[count].x, batch[count].y, batch[count].z, batch[count].block));
+				count += 1;
+			}
+		}
+
+		if (count == 0) {
+			break;
+		}
+
+		for (uint32_t i = 0; i < count; ++i) {
+
+			const upd_tick_t* tick = &batch[i];
+
+			wld_chunk_t* chunk = wld_region_get_chunk(region, (tick->x >> 4) & 0x1F, (tick->z >> 4) & 0x1F);
+			if (chunk == NULL) {
+				continue;
+			}
+
+			if (wld_chunk_get_ticket(chunk) > WLD_TICKET_TICK) {
+				upd_schedule_tick(chunk, tick->x, tick->y, tick->z, tick->block, UPD_RETRY_DELAY, tick->priority);
+				continue;
+			}
+
+			// the block could have changed since
+			const upd_behavior_t* behavior = upd_behaviors[tick->block];
+			if (behavior != NULL && behavior->scheduled_tick != NULL && upd_get_block(chunk, tick->x, tick->y, tick->z) == (int32_t) tick->block) {
+				behavior->scheduled_tick(chunk, tick->x, tick->y, tick->z);
+			}
+
+		}
+
+		ran += count;
+
+	}
+
+	return ran;
+
+}
+
+static uint32_t upd_run_neighbors(wld_region_t* region) {
+
+	upd_region_t* updates = &region->updates;
+	upd_neighbor_t batch[UPD_BATCH];
+	uint32_t ran = 0;
+
+	while (ran < UPD_UPDATES_PER_TICK) {
+
+		uint32_t count = 0;
+
+		with_lock (&updates->lock) {
+			while (count < UPD_BATCH && ran + count < UPD_UPDATES_PER_TICK && updates->neighbors.count != 0) {
+				batch[count++] = updates->neighbors.queue[updates->neighbors.first];
+				updates->neighbors.first = (updates->neighbors.first + 1) & (updates->neighbors.capacity - 1);
+				updates->neighbors.count -= 1;
+			}
+		}
+
+		if (count == 0) {
+			break;
+		}
+
+		for (uint32_t i = 0; i < count; ++i) {
+
+			const upd_neighbor_t* update = &batch[i];
+
+			wld_chunk_t* chunk = wld_region_get_chunk(region, (update->x >> 4) & 0x1F, (update->z >> 4) & 0x1F);
+			if (chunk == NULL) {
+				continue;
+			}
+
+			const int32_t block = upd_get_block(chunk, update->x, update->y, update->z);
+			if (block < 0 || upd_behaviors[block] == NULL || upd_behaviors[block]->neighbor_update == NULL) {
+				continue;
+			}
+
+			// whatever this causes goes to the back of the queue one level deeper
+			upd_depth = update->depth;
+			upd_behaviors[block]->neighbor_update(chunk, update->x, update->y, update->z, update->source);
+			upd_depth = 0;
+
+		}
+
+		ran += count;
+
+	}
+
+	return ran;
+
+}
+
+uint32_t upd_tick_region(wld_region_t* region) {
+
+	const uint64_t now = wld_get_age(wld_region_get_world(region));
+
+	return upd_run_ticks(region, now) + upd_run_neighbors(region);
+
+}
+
+uint32_t upd_random_tick_chunk(wld_chunk_t* chunk, uint8_t speed) {
+
+	if (speed == 0 || wld_chunk_get_random_tick_count(chunk) == 0) {
+		return 0;
+	}
+
+	const mat_dimension_type_t environment = wld_get_environment(wld_chunk_get_world(chunk));
+	const int16_t min_y = mat_get_dimension_by_type(environment)->min_y;
+	const uint16_t chunk_height = mat_get_chunk_height(environment);
+
+	uint32_t ticked = 0;
+
+	for (uint16_t i = 0; i < chunk_height; ++i) {
+
+		wld_chunk_section_t* section = wld_chunk_get_section(chunk, i);
+		if (wld_chunk_section_get_random_tick_count(section) == 0) {
+			continue;
+		}
+
+		for (uint8_t j = 0; j < speed; ++j) {
+
+			// x, z and y from the same bits vanilla takes them from
+			upd_random = upd_random * 3 + 1013904223;
+			const uint32_t bits = upd_random >> 2;
+			const uint16_t index = (((bits >> 16) & 0xF) << 8) | (((bits >> 8) & 0xF) << 4) | (bits & 0xF);
+
+			const mat_block_protocol_id_t protocol = section->blocks[index];
+			if (!mat_block_gets_random_ticks(protocol)) {
+				continue;
+			}
+			const mat_block_type_t block = mat_get_block_type_by_protocol_id(protocol);
+
+			ticked += 1;
+
+			const upd_behavior_t* behavior = upd_behaviors[block];
+			if (behavior != NULL && behavior->random_tick != NULL) {
+				behavior->random_tick(chunk, (wld_get_chunk_x(chunk) << 4) | (index & 0xF), min_y + (i << 4) + (index >> 8), (wld_get_chunk_z(chunk) << 4) | ((index >> 4) & 0xF));
+			}
+
+		}
+
+	}
+
+	return ticked;
+
+}
+
+uint32_t upd_get_scheduled_count(wld_region_t* region) {
+
+	uint32_t count = 0;
+
+	with_lock (&region->updates.lock) {
+		count = region->updates.ticks.count;
+	}
+
+	return count;
+
+}
+
+uint32_t upd_get_queued_count(wld_region_t* region) {
+
+	uint32_t count = 0;
+
+	with_lock (&region->updates.lock) {
+		count = region->updates.neighbors.count;
+	}
+
+	return count;
+
+}
+
+void upd_term_region(upd_region_t* updates) {
+
+	free(updates->ticks.heap);
+	free(updates->ticks.keys);
+	free(updates->neighbors.queue);
+
+	pthread_mutex_destroy(&updates->lock);
+
+}
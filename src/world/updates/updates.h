@@ -0,0 +1,163 @@
+#pragma once
+#include <pthread.h>
+#include "../world.d.h"
+#include "../../main.h"
+#include "../material/material.h"
+
+/*
+	Block updates
+
+	Every region keeps the ticks scheduled for its blocks in a heap ordered by due tick, priority
+	and scheduling order, and a queue of neighbor updates. Both run during the region tick.
+	Neighbor updates caused while handling another one are queued one level deeper instead of
+	being handled right away, so long chains never recurse and runaway ones get cut off
+
+	Random ticks pick a few blocks of every section of ticking chunks. Chunks and sections keep
+	count of their blocks that get random ticks at all, so empty terrain costs one check per chunk
+*/
+
+// neighbor updates caused by a chain of more than this many updates are dropped
+#define UPD_MAX_DEPTH 4096
+
+// per region and tick, whatever is left waits for the next tick
+#define UPD_UPDATES_PER_TICK 262144
+#define UPD_TICKS_PER_TICK 65536
+
+#define UPD_REGION_INITIALIZER (upd_region_t) { .lock = PTHREAD_MUTEX_INITIALIZER }
+
+typedef enum {
+
+	upd_priority_extremely_high = -3,
+	upd_priority_very_high = -2,
+	upd_priority_high = -1,
+	upd_priority_normal = 0,
+	upd_priority_low = 1,
+	upd_priority_very_low = 2,
+	upd_priority_extremely_low = 3
+
+} upd_priority_t;
+
+typedef struct {
+
+	// world age the tick is due at
+	uint64_t due;
+	uint32_t order;
+
+	int32_t x;
+	int32_t z;
+	int16_t y;
+
+	mat_block_type_t block : 16;
+	int8_t priority;
+
+} upd_tick_t;
+
+typedef struct {
+
+	int32_t x;
+	int32_t z;
+	int16_t y;
+
+	uint16_t depth;
+	mat_block_type_t source : 16;
+
+} upd_neighbor_t;
+
+typedef struct {
+
+	pthread_mutex_t lock;
+
+	struct {
+
+		upd_tick_t* heap;
+		uint32_t count;
+		uint32_t capacity;
+
+		uint32_t order;
+
+		// position and block of everything in the heap, a block is only scheduled once at a time
+		uint64_t* keys;
+		uint32_t key_mask;
+
+	} ticks;
+
+	// ring buffer
+	struct {
+
+		upd_neighbor_t* queue;
+		uint32_t first;
+		uint32_t count;
+		uint32_t capacity;
+
+	} neighbors;
+
+} upd_region_t;
+
+typedef struct {
+
+	// the block was just set, or changed state
+	void (*placed) (wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z);
+
+	// a neighbor of the block changed into `source`
+	void (*neighbor_update) (wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z, mat_block_type_t source);
+
+	// a tick scheduled for the block came up and the block is still there
+	void (*scheduled_tick) (wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z);
+
+	// the block was picked for a random tick, only for blocks flagged with `random_ticks`
+	void (*random_tick) (wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z);
+
+} upd_behavior_t;
+
+extern const upd_behavior_t* upd_behaviors[mat_block_count];
+
+/*
+Set what happens to a block on updates, NULL for nothing
+*/
+static inline void upd_set_behavior(mat_block_type_t block, const upd_behavior_t* behavior) {
+	upd_behaviors[block] = behavior;
+}
+
+/*
+Let a block that was just set know about it
+*/
+static inline void upd_place(wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z, mat_block_type_t block) {
+
+	const upd_behavior_t* behavior = upd_behaviors[block];
+
+	if (behavior != NULL && behavior->placed != NULL) {
+		behavior->placed(chunk, x, y, z);
+	}
+
+}
+
+/*
+Schedule a tick for the block at a position in `delay` ticks, if it isn't scheduled already
+*/
+extern void upd_schedule_tick(wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z, mat_block_type_t block, uint32_t delay, upd_priority_t priority);
+
+/*
+Tell the block at a position that a neighbor changed into `source`
+Nothing is queued for blocks without a neighbor update or in chunks that aren't there
+*/
+extern void upd_update_neighbor(wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z, mat_block_type_t source);
+
+/*
+Update the 6 blocks around a position
+*/
+extern void upd_update_neighbors(wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z, mat_block_type_t source);
+
+/*
+Run due scheduled ticks and queued neighbor updates of a region, returns how many were handled
+*/
+extern uint32_t upd_tick_region(wld_region_t* region);
+
+/*
+Give `speed` random blocks of every section of a chunk a random tick, returns how many blocks were picked that get random ticks
+*/
+extern uint32_t upd_random_tick_chunk(wld_chunk_t* chunk, uint8_t speed);
+
+extern uint32_t upd_get_scheduled_count(wld_region_t* region);
+extern uint32_t upd_get_queued_count(wld_region_t* region);
+
+extern void upd_term_region(upd_region_t* updates);
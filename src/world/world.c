@@ -2,6 +2,7 @@
 #include "../util/vector.h"
 #include "../util/id_vector.h"
 #include "../listening/listening.h"
+#include "../listening/phd/play.h"
 #include "../io/logger/logger.h"
 #include "../motor.h"
 #include "../jobs/scheduler/scheduler.h"
@@ -68,6 +69,7 @@ wld_world_t* wld_new(const string_t name, int64_t seed, mat_dimension_type_t env
 		},
 		.age = 0,
 		.time = 0,
+		.random_tick_speed = WLD_RANDOM_TICK_SPEED,
 		.time_progressing = true,
 	};
 	memcpy(world, &world_init, sizeof(wld_world_t));
@@ -91,6 +93,7 @@ wld_world_t* wld_load(const string_t name) {
 		.id = id,
 		.age = 0,
 		.time = 0,
+		.random_tick_speed = WLD_RANDOM_TICK_SPEED,
 		.time_progressing = true,
 	};
 	memcpy(world, &world_init, sizeof(wld_world_t));
@@ -136,6 +139,7 @@ wld_region_t* wld_gen_region(wld_world_t* world, int16_t x, int16_t z) {
 			.world = world,
 			.x = x,
 			.z = z,
+			.updates = UPD_REGION_INITIALIZER,
 			.relative = {
 				.north = utl_tree_get(&world->regions, ((uint64_t) (uint16_t) x << 16) | (uint16_t) (z - 1)),
 				.south = utl_tree_get(&world->regions, ((uint64_t) (uint16_t) x << 16) | (uint16_t) (z + 1)),
@@ -239,15 +243,6 @@ void wld_recalc_chunk_ticket_l(wld_chunk_t* chunk) {
 	wld_set_chunk_ticket(chunk, new_ticket);
 }
 
-static inline void wld_set_block_send(uint32_t client_id, void* arg) {
-
-	pck_packet_t* packet = arg;
-	ltg_client_t* client = ltg_get_client_by_id(sky_get_listener(), client_id);
-
-	ltg_send(client, packet);
-
-}
-
 void wld_set_block_at(wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z, mat_block_protocol_id_t type) {
 
 	const int16_t min_y = mat_get_dimension_by_type(wld_get_environment(wld_chunk_get_world(chunk)))->min_y;
@@ -260,8 +255,10 @@ void wld_set_block_at(wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z, mat_b
 	const uint8_t s_z = z & 0xF;
 
 	const mat_block_protocol_id_t old_type = section->blocks[(s_y << 8) | (s_z << 4) | s_x];
-	const bool old_type_air = mat_get_block_by_type(mat_get_block_type_by_protocol_id(old_type))->air;
-	const bool type_air = mat_get_block_by_type(mat_get_block_type_by_protocol_id(type))->air;
+	const mat_block_state_t old_state = mat_get_block_state(old_type);
+	const mat_block_state_t state = mat_get_block_state(type);
+	const bool old_type_air = old_state & MAT_STATE_AIR;
+	const bool type_air = state & MAT_STATE_AIR;
 	if (old_type_air && !type_air) {
 		section->block_count++;
 
@@ -275,19 +272,151 @@ void wld_set_block_at(wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z, mat_b
 			// TODO calculate new highest motion_blocking block
 		}
 	}
+
+	const bool old_type_random_ticks = old_state & MAT_STATE_RANDOM_TICKS;
+	const bool type_random_ticks = state & MAT_STATE_RANDOM_TICKS;
+	if (!old_type_random_ticks && type_random_ticks) {
+		section->random_tick_count++;
+		block_chunk->random_tick_count++;
+	} else if (old_type_random_ticks && !type_random_ticks) {
+		section->random_tick_count--;
+		block_chunk->random_tick_count--;
+	}
+
 	section->blocks[(s_y << 8) | (s_z << 4) | s_x] = type;
 
-	// send block to player
-	PCK_INLINE(packet, 14, io_big_endian);
-	pck_write_var_int(packet, 0x0C);
-	pck_write_position(packet, (pck_position_t) {
-		.x = x,
-		.y = y,
-		.z = z
-	});
-	pck_write_var_int(packet, type);
+	if (old_type != type) {
+
+		// sent at the end of the tick, section first so a flush never misses it
+		const uint16_t index = (s_y << 8) | (s_z << 4) | s_x;
+		section->changed[index >> 6] |= (uint64_t) 1 << (index & 0x3F);
+		block_chunk->changed_sections |= (uint64_t) 1 << ((y - min_y) >> 4);
+
+		upd_place(block_chunk, x, y, z, mat_get_block_type_by_protocol_id(type));
+		upd_update_neighbors(block_chunk, x, y, z, mat_get_block_type_by_protocol_id(type));
+
+	}
+
+}
+
+static inline void wld_send_blob(uint32_t client_id, void* blob) {
+	ltg_send_blob(ltg_get_client_by_id(sky_get_listener(), client_id), blob);
+}
+
+static inline void wld_send_chunk(uint32_t client_id, void* chunk) {
+	phd_send_chunk_data_and_update_light(ltg_get_client_by_id(sky_get_listener(), client_id), chunk);
+}
+
+wld_sent_changes_t wld_send_changes(wld_chunk_t* chunk) {
+
+	wld_sent_changes_t sent = { 0, 0, 0 };
+
+	const uint64_t changed_sections = atomic_exchange(&chunk->changed_sections, 0);
+	if (changed_sections == 0) {
+		return sent;
+	}
+
+	// take the changes first, they might be sent with the whole chunk
+	const uint32_t count = __builtin_popcountll(changed_sections);
+	uint64_t changed[count][16 * 16 * 16 / 64];
+	uint16_t sections[count];
+	bool resend = false;
+
+	uint32_t i = 0;
+	for (uint64_t bits = changed_sections; bits != 0; bits &= bits - 1) {
+
+		sections[i] = __builtin_ctzll(bits);
+		wld_chunk_section_t* section = wld_chunk_get_section(chunk, sections[i]);
+
+		uint32_t blocks = 0;
+		for (uint32_t j = 0; j < 16 * 16 * 16 / 64; ++j) {
+			changed[i][j] = atomic_exchange(&section->changed[j], 0);
+			blocks += __builtin_popcountll(changed[i][j]);
+		}
+
+		resend |= blocks > WLD_RESEND_CHANGES;
+		i += 1;
+
+	}
+
+	const bool subscribed = utl_bit_vector_popcount(&chunk->subscribers) != 0;
+
+	if (resend) {
+		if (subscribed) {
+			utl_bit_vector_foreach(&chunk->subscribers, wld_send_chunk, chunk);
+		}
+		sent.chunks = 1;
+		return sent;
+	}
+
+	const int16_t min_y = mat_get_dimension_by_type(wld_get_environment(wld_chunk_get_world(chunk)))->min_y;
+
+	for (i = 0; i < count; ++i) {
+
+		wld_chunk_section_t* section = wld_chunk_get_section(chunk, sections[i]);
+
+		uint16_t indices[16 * 16 * 16];
+		mat_block_protocol_id_t blocks[16 * 16 * 16];
+		uint16_t length = 0;
+
+		for (uint32_t j = 0; j < 16 * 16 * 16 / 64; ++j) {
+			for (uint64_t bits = changed[i][j]; bits != 0; bits &= bits - 1) {
+				indices[length] = (j << 6) | __builtin_ctzll(bits);
+				blocks[length] = section->blocks[indices[length]];
+				length += 1;
+			}
+		}
+
+		if (length == 0) {
+			continue;
+		}
+
+		const int32_t s_y = (min_y >> 4) + sections[i];
+
+		if (length == 1) {
+			sent.blocks += 1;
+		} else {
+			sent.sections += 1;
+		}
+
+		if (!subscribed) {
+			continue;
+		}
+
+		ltg_blob_t* blob;
+		if (length == 1) {
+			blob = phd_create_block_change((wld_get_chunk_x(chunk) << 4) | (indices[0] & 0xF), (s_y << 4) | (indices[0] >> 8), (wld_get_chunk_z(chunk) << 4) | ((indices[0] >> 4) & 0xF), blocks[0]);
+		} else {
+			blob = phd_create_multi_block_change(wld_get_chunk_x(chunk), s_y, wld_get_chunk_z(chunk), indices, blocks, length);
+		}
+
+		utl_bit_vector_foreach(&chunk->subscribers, wld_send_blob, blob);
+		ltg_release_blob(blob);
 
-	utl_bit_vector_foreach(&block_chunk->subscribers, wld_set_block_send, packet);
+	}
+
+	return sent;
+
+}
+
+wld_sent_changes_t wld_send_region_changes(wld_region_t* region) {
+
+	wld_sent_changes_t sent = { 0, 0, 0 };
+
+	for (uint32_t i = 0; i < 32 * 32; ++i) {
+
+		wld_chunk_t* chunk = region->chunks[i];
+
+		if (chunk != NULL && chunk->changed_sections != 0) {
+			const wld_sent_changes_t chunk_sent = wld_send_changes(chunk);
+			sent.blocks += chunk_sent.blocks;
+			sent.sections += chunk_sent.sections;
+			sent.chunks += chunk_sent.chunks;
+		}
+
+	}
+
+	return sent;
 
 }
 
@@ -324,6 +453,8 @@ void wld_free_region(wld_region_t* region) {
 	
 	sch_cancel(region->tick);
 
+	upd_term_region(&region->updates);
+
 	for (size_t i = 0; i < 32 * 32; ++i) {
 		wld_chunk_t* chunk = region->chunks[i];
 		if (chunk != NULL) {
@@ -9,4 +9,10 @@ typedef struct wld_chunk_section wld_chunk_section_t;
 #define WLD_TICKET_TICK 13
 #define WLD_TICKET_BORDER 14
 #define WLD_TICKET_INACCESSIBLE 15
-#define WLD_TICKET_MAX 15
\ No newline at end of file
+#define WLD_TICKET_MAX 15
+
+// a section with more changes than this gets its whole chunk sent again
+#define WLD_RESEND_CHANGES 1024
+
+// vanilla default of randomTickSpeed
+#define WLD_RANDOM_TICK_SPEED 3
\ No newline at end of file
@@ -14,6 +14,7 @@
 #include "../jobs/board.h"
 #include "../jobs/scheduler/scheduler.h"
 #include "material/material.h"
+#include "updates/updates.h"
 
 struct wld_chunk_section {
 
@@ -23,6 +24,12 @@ struct wld_chunk_section {
 
 	atomic_uint_fast16_t block_count;
 
+	// blocks that get random ticks, sections without any are skipped
+	atomic_uint_fast16_t random_tick_count;
+
+	// blocks changed since they were last sent
+	_Atomic uint64_t changed[16 * 16 * 16 / 64];
+
 	// biome map
 	_Atomic uint8_t biomes[4 * 4 * 4];
 
@@ -57,6 +64,12 @@ struct wld_chunk {
 
 	_Atomic uint8_t subtick;
 
+	// blocks that get random ticks in all sections
+	atomic_uint_fast32_t random_tick_count;
+
+	// sections with changed blocks
+	_Atomic uint64_t changed_sections;
+
 	_Atomic uint8_t ticket;
 	const uint8_t max_ticket;
 
@@ -85,6 +98,9 @@ struct wld_region {
 
 	atomic_uint_fast16_t loaded_chunks;
 
+	// scheduled ticks and neighbor updates
+	upd_region_t updates;
+
 	const int16_t x;
 	const int16_t z;
 };
@@ -115,6 +131,9 @@ struct wld_world {
 	_Atomic uint16_t time;
 	const uint16_t id;
 
+	// random ticks per section and tick
+	_Atomic uint8_t random_tick_speed;
+
 	bool time_progressing : 1;
 	const bool debug : 1;
 	const bool flat : 1;
@@ -166,6 +185,14 @@ static inline uint16_t wld_get_time(wld_world_t* world) {
 	return world->time;
 }
 
+static inline uint8_t wld_get_random_tick_speed(wld_world_t* world) {
+	return world->random_tick_speed;
+}
+
+static inline void wld_set_random_tick_speed(wld_world_t* world, uint8_t speed) {
+	world->random_tick_speed = speed;
+}
+
 static inline bool wld_is_time_progressing(wld_world_t* world) {
 	return world->time_progressing;
 }
@@ -357,6 +384,46 @@ static inline wld_chunk_t* wld_relative_chunk(const wld_chunk_t* chunk, int32_t
 
 }
 
+// Same as wld_relative_chunk but never generates anything, NULL if the chunk isn't there
+static inline wld_chunk_t* wld_find_relative_chunk(const wld_chunk_t* chunk, int32_t x, int32_t z) {
+
+	if (x == 0 && z == 0) {
+		return (wld_chunk_t*) chunk;
+	}
+
+	const int32_t c_x = x + chunk->x;
+	const int32_t c_z = z + chunk->z;
+
+	int16_t r_x = c_x >> 5;
+	int16_t r_z = c_z >> 5;
+
+	wld_region_t* region = wld_chunk_get_region(chunk);
+
+	while (r_x < 0 && region != NULL) {
+		region = region->relative.west;
+		r_x++;
+	}
+	while (r_x > 0 && region != NULL) {
+		region = region->relative.east;
+		r_x--;
+	}
+	while (r_z < 0 && region != NULL) {
+		region = region->relative.north;
+		r_z++;
+	}
+	while (r_z > 0 && region != NULL) {
+		region = region->relative.south;
+		r_z--;
+	}
+
+	if (region == NULL) {
+		return NULL;
+	}
+
+	return region->chunks[((c_x & 0x1F) << 5) | (c_z & 0x1F)];
+
+}
+
 static inline bool wld_in_chunk(const wld_chunk_t* chunk, int32_t x, int32_t z) {
 	return (wld_get_chunk_x(chunk) == (x >> 4) && wld_get_chunk_z(chunk) == (z >> 4));
 }
@@ -423,6 +490,14 @@ static inline uint8_t wld_chunk_section_get_biome(wld_chunk_section_t* section,
 	return section->biomes[(x << 4) + (z << 2) + y];
 }
 
+static inline uint_fast32_t wld_chunk_get_random_tick_count(const wld_chunk_t* chunk) {
+	return chunk->random_tick_count;
+}
+
+static inline uint_fast16_t wld_chunk_section_get_random_tick_count(wld_chunk_section_t* section) {
+	return section->random_tick_count;
+}
+
 static inline mat_block_protocol_id_t* wld_chunk_section_get_blocks(wld_chunk_section_t* section) {
 	return (mat_block_protocol_id_t*) section->blocks;
 }
@@ -499,6 +574,9 @@ static inline mat_block_type_t wld_get_block_type_at(wld_chunk_t* chunk, int32_t
 
 }
 
+/*
+Set a block, subscribers of the chunk get it once changes are sent at the end of the tick
+*/
 extern void wld_set_block_at(wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z, mat_block_protocol_id_t type);
 
 static inline void wld_set_block_type_at(wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z, mat_block_type_t type) {
@@ -507,6 +585,21 @@ static inline void wld_set_block_type_at(wld_chunk_t* chunk, int32_t x, int16_t
 
 }
 
+typedef struct {
+
+	uint32_t blocks; // sections with a single changed block
+	uint32_t sections; // sections sent as a multi block change
+	uint32_t chunks; // chunks sent whole again
+
+} wld_sent_changes_t;
+
+/*
+Send the blocks changed in a chunk to its subscribers, a block change or multi block change per section
+or the whole chunk if a section changed a lot
+*/
+extern wld_sent_changes_t wld_send_changes(wld_chunk_t* chunk);
+extern wld_sent_changes_t wld_send_region_changes(wld_region_t* region);
+
 extern void wld_unload_region(wld_region_t* region);
 extern void wld_free_region(wld_region_t* region);
 extern void wld_unload(wld_world_t* world);